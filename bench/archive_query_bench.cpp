@@ -0,0 +1,108 @@
+/**
+ * @file archive_query_bench.cpp
+ * @brief Throughput scaling of parallel archive scans and ordered replay across thread counts
+ *
+ * Writes a synthetic archive (N instruments over one day) to a temporary directory,
+ * optionally seals it into compressed `.tcb` segments, then runs the same per-instrument
+ * VWAP scan and global-order replay with pools of 1, 2, 4, ... threads up to the
+ * hardware concurrency. Reports ticks/s and speed-up over one thread.
+ *
+ * Usage: archive_query_bench [instruments] [ticks per instrument] [raw|tcb]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "storage/archive_query.h"
+
+using IB::Storage::TickRecord;
+
+static void synthesize(const std::filesystem::path& root, long instruments, size_t perInstrument) {
+  IB::Storage::TickArchiveWriter writer(IB::Storage::TickArchiveConfig{.root = root, .ringBytes = 64u << 20});
+  const int64_t open = IB::Storage::dayStartNs(20261016) + 13LL * 3600 * 1'000'000'000LL + 30LL * 60 * 1'000'000'000LL;
+  const int64_t span = 390LL * 60 * 1'000'000'000LL;  // 6.5 h session
+  std::mt19937_64 rng(11);
+  for (long conId = 1; conId <= instruments; ++conId) {
+    const int64_t gap = span / static_cast<int64_t>(perInstrument);
+    int64_t ts = open + conId;
+    long mid = 10000 + conId * 37;
+    for (size_t i = 0; i < perInstrument; ++i) {
+      ts += gap / 2 + static_cast<int64_t>(rng() % static_cast<uint64_t>(gap));
+      mid += static_cast<long>(rng() % 3) - 1;
+      TickRecord t{};
+      t.timestampNs = ts;
+      t.price = static_cast<double>(mid) * 0.01;
+      t.size = static_cast<double>((rng() % 30 + 1) * 100);
+      t.field = 4;
+      while (!writer.append(conId, t)) std::this_thread::yield();
+    }
+  }
+  writer.stop();
+}
+
+int main(int argc, char** argv) {
+  const long instruments = argc > 1 ? std::strtol(argv[1], nullptr, 10) : 64;
+  const size_t perInstrument = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100'000;
+  const bool compressed = argc > 3 && std::strcmp(argv[3], "tcb") == 0;
+
+  const auto root = std::filesystem::temp_directory_path() / "ibw_archive_query_bench";
+  std::filesystem::remove_all(root);
+  synthesize(root, instruments, perInstrument);
+  if (compressed)
+    for (long conId = 1; conId <= instruments; ++conId) {
+      IB::Storage::CompressedSegment::compress(root, conId, 20261016);
+      std::filesystem::remove(IB::Storage::segmentPath(root, conId, 20261016));
+    }
+
+  IB::Storage::TickArchiveReader reader(root);
+  const auto ids = reader.instruments();
+  std::printf("archive query: %ld instruments x %zu ticks (%s segments), %u hardware threads\n", instruments,
+              perInstrument, compressed ? "compressed" : "raw", std::thread::hardware_concurrency());
+
+  std::vector<size_t> counts;
+  for (size_t t = 1; t < std::max(1u, std::thread::hardware_concurrency()); t *= 2) counts.push_back(t);
+  counts.push_back(std::max(1u, std::thread::hardware_concurrency()));
+
+  double scanBase = 0, replayBase = 0;
+  for (size_t threads : counts) {
+    // The caller participates in parallelFor, so a pool of threads - 1 workers uses `threads` cores
+    IB::Helpers::ThreadPool pool(std::max<size_t>(1, threads - 1));
+    IB::Storage::ArchiveQuery query(reader, pool);
+
+    std::vector<std::atomic<double>> notional(static_cast<size_t>(instruments) + 1);
+    double scan = 0;
+    for (int rep = 0; rep < 3; ++rep) {
+      const auto s = query.scan(ids, 0, INT64_MAX, [&](long conId, std::span<const TickRecord> ticks) {
+        double sum = 0;
+        for (const auto& t : ticks) sum += t.price * t.size;
+        notional[static_cast<size_t>(conId)].fetch_add(sum, std::memory_order_relaxed);
+      });
+      scan = std::max(scan, s.ticksPerSecond());
+    }
+
+    int64_t last = INT64_MIN;
+    bool ordered = true;
+    const auto r = query.replay(ids, 0, INT64_MAX, [&](long, const TickRecord& t) {
+      ordered &= t.timestampNs >= last;
+      last = t.timestampNs;
+    });
+
+    if (threads == 1) {
+      scanBase = scan;
+      replayBase = r.ticksPerSecond();
+    }
+    std::printf("%3zu threads  scan %8.1f Mticks/s (x%4.2f)  replay %7.1f Mticks/s (x%4.2f)  %s\n", threads,
+                scan / 1e6, scan / scanBase, r.ticksPerSecond() / 1e6, r.ticksPerSecond() / replayBase,
+                ordered ? "ordered" : "ORDER VIOLATION");
+  }
+
+  std::filesystem::remove_all(root);
+  return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file covariance_bench.cpp
+ * @brief Cost of one EWMA covariance update vs. a full recomputation from a return window
+ *
+ * Usage: covariance_bench [updates]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "analytics/covariance.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedUs(Clock::time_point t0) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+}
+
+/// Reference: sample covariance of a T x N window, upper triangle only
+static void recompute(const std::vector<double>& window, size_t t, size_t n, std::vector<double>& out) {
+  std::vector<double> mean(n, 0.0);
+  for (size_t k = 0; k < t; ++k)
+    for (size_t i = 0; i < n; ++i) mean[i] += window[k * n + i];
+  for (auto& m : mean) m /= static_cast<double>(t);
+  std::fill(out.begin(), out.end(), 0.0);
+  for (size_t k = 0; k < t; ++k) {
+    const double* r = window.data() + k * n;
+    for (size_t i = 0; i < n; ++i) {
+      double di = r[i] - mean[i];
+      for (size_t j = i; j < n; ++j) out[i * n + j] += di * (r[j] - mean[j]);
+    }
+  }
+}
+
+static void run(size_t n, size_t updates, IB::Helpers::ThreadPool* pool) {
+  std::mt19937_64 rng(42);
+  std::normal_distribution<double> noise(0.0, 1e-3);
+  std::vector<std::vector<double>> returns(updates, std::vector<double>(n));
+  for (auto& r : returns) {
+    double market = noise(rng);
+    for (auto& x : r) x = 0.8 * market + noise(rng);
+  }
+
+  IB::Analytics::EwmaCovariance cov(n, 0.97, pool);
+  cov.update(returns[0].data());   // touch the matrix once
+
+  auto t0 = Clock::now();
+  for (size_t k = 1; k < updates; ++k) cov.update(returns[k].data());
+  double perUpdate = elapsedUs(t0) / static_cast<double>(updates - 1);
+
+  cov.publish();                   // first publish allocates the spare buffer
+  cov.publish();
+  t0 = Clock::now();
+  cov.publish();
+  double publish = elapsedUs(t0);
+
+  const size_t window = 250;
+  std::vector<double> flat(window * n), full(n * n);
+  for (size_t k = 0; k < window; ++k)
+    std::copy(returns[k % updates].begin(), returns[k % updates].end(), flat.begin() + k * n);
+  t0 = Clock::now();
+  recompute(flat, window, n, full);
+  double naive = elapsedUs(t0);
+
+  double elems = static_cast<double>(n) * static_cast<double>(n + 1) / 2.0;
+  std::printf("N=%5zu threads=%zu  update %9.1f us (%5.2f ns/elem)  publish %9.1f us  recompute(T=%zu) %11.1f us  speedup x%.0f\n",
+              n, pool ? pool->size() + 1 : 1, perUpdate, perUpdate * 1e3 / elems, publish, window, naive, naive / perUpdate);
+}
+
+int main(int argc, char** argv) {
+  size_t updates = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200;
+  if (updates < 2) updates = 2;
+
+  for (size_t n : {500, 2000}) run(n, updates, nullptr);
+
+  IB::Helpers::ThreadPool pool;
+  if (pool.size() > 1)
+    for (size_t n : {500, 2000}) run(n, updates, &pool);
+  return 0;
+}
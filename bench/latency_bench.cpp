@@ -0,0 +1,64 @@
+/**
+ * @file latency_bench.cpp
+ * @brief Overhead of timing a call: labelled measure() vs named PerfTimer histograms
+ *
+ * Times an empty callable so the numbers are the instrumentation cost alone: the
+ * labelled overload (high_resolution_clock, std::string label, one log line to
+ * /dev/null per call) against the named-timer overload (two CycleClock reads and a
+ * histogram update). The multi-threaded rows have every thread recording into the
+ * same timer. The trace rows time an IBW_TRACE_SCOPE outside and inside a trace session.
+ *
+ * Usage: latency_bench [calls per thread]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "helpers/perf_timer.h"
+
+using Steady = std::chrono::steady_clock;
+
+namespace {
+
+  template <typename Body>
+  double perCallNs(int threads, int calls, Body body) {
+    std::vector<std::thread> workers;
+    const auto t0 = Steady::now();
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&] {
+        for (int i = 0; i < calls; ++i) body();
+      });
+    }
+    for (auto& w : workers) w.join();
+    return std::chrono::duration<double, std::nano>(Steady::now() - t0).count() / calls;
+  }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int calls = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+  if (!std::freopen("/dev/null", "w", stdout)) return 1;
+
+  auto& timer = IB::Helpers::PerfTimers::get("bench");
+  for (int threads : {1, 4}) {
+    const double labelled = perCallNs(threads, calls / 10, [] { IB::Helpers::measure([] {}, "getContractDetails"); });
+    const double named = perCallNs(threads, calls, [&] { IB::Helpers::measure(timer, [] {}); });
+    std::fprintf(stderr, "threads=%d  labelled measure %7.1f ns/call   named timer %6.1f ns/call\n", threads, labelled, named);
+  }
+
+  const double idle = perCallNs(1, calls, [] { IBW_TRACE_SCOPE("bench"); });
+  IB::Helpers::TraceEvents::start(2 * static_cast<size_t>(calls) + 2);
+  const double recording = perCallNs(1, calls, [] { IBW_TRACE_SCOPE("bench"); });
+  IB::Helpers::TraceEvents::stop();
+  std::fprintf(stderr, "trace scope: no session %5.1f ns/call   recording %5.1f ns/call\n", idle, recording);
+
+  const auto s = timer.histogram().summary();
+  std::fprintf(stderr, "empty callable: n=%llu p50=%llu ns p99=%llu ns p99.9=%llu ns max=%llu ns\n",
+               static_cast<unsigned long long>(s.count), static_cast<unsigned long long>(s.p50Ns),
+               static_cast<unsigned long long>(s.p99Ns), static_cast<unsigned long long>(s.p999Ns),
+               static_cast<unsigned long long>(s.maxNs));
+  return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file log_bench.cpp
+ * @brief Caller-side cost of a log call: synchronous vs asynchronous (text and binary) Logger
+ *
+ * Every thread logs a tickPrice-style line (ints, a string, a double) in a tight loop,
+ * so the numbers are the latency a market data callback pays per LOG_* call. Per-call
+ * times are taken over batches of 64 calls. Synchronous output goes to /dev/null, the
+ * asynchronous modes write to a temporary file whose size gives the bytes per call.
+ * The "disabled" row is a LOG_DEBUG with a std::to_string argument while the runtime
+ * level is INFO: the arguments are never evaluated. The "rate limited" row is the
+ * synchronous logger with the bench's category capped at 100 lines per second.
+ *
+ * Usage: log_bench [calls per thread]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "helpers/logger.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+  constexpr int BATCH = 64;
+
+  struct Result {
+    double meanNs;
+    double p50Ns;
+    double p99Ns;
+  };
+
+  Result run(int threads, int calls, bool disabled = false) {
+    std::vector<std::vector<double>> samples(static_cast<size_t>(threads));
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        auto& out = samples[static_cast<size_t>(t)];
+        out.reserve(static_cast<size_t>(calls / BATCH));
+        double price = 185.0;
+        const std::string field = "bidPrice";
+        for (int i = 0; i < calls; i += BATCH) {
+          const auto t0 = Clock::now();
+          for (int j = 0; j < BATCH; ++j) {
+            price += 0.01;
+            if (disabled)
+              LOG_DEBUG("[Bench] tickPrice ID=", 1000 + t, " Price=", std::to_string(price), " seq=", i + j);
+            else
+              LOG_INFO("[Bench] tickPrice ID=", 1000 + t, " Field=", field, " Price=", price, " seq=", i + j);
+          }
+          out.push_back(std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / BATCH);
+        }
+      });
+    }
+    for (auto& w : workers) w.join();
+    Logger::flush();
+
+    std::vector<double> all;
+    for (auto& s : samples) all.insert(all.end(), s.begin(), s.end());
+    std::sort(all.begin(), all.end());
+    double sum = 0.0;
+    for (double v : all) sum += v;
+    return {sum / static_cast<double>(all.size()), all[all.size() / 2], all[all.size() * 99 / 100]};
+  }
+
+  void report(const char* mode, int threads, const Result& r, double bytesPerCall = 0.0) {
+    std::fprintf(stderr, "%-16s threads=%d  mean %7.1f ns  p50 %7.1f ns  p99 %8.1f ns", mode, threads, r.meanNs, r.p50Ns,
+                 r.p99Ns);
+    if (bytesPerCall > 0.0) std::fprintf(stderr, "  %5.1f B/call", bytesPerCall);
+    std::fprintf(stderr, "\n");
+  }
+
+  /// One asynchronous run into a temporary file
+  void runAsync(const char* mode, int threads, int calls, IB::Helpers::Logging::AsyncOptions options) {
+    std::FILE* out = std::tmpfile();
+    if (!out) return;
+    options.ringBytes = 16 << 20;
+    options.output = out;
+    Logger::startAsync(options);
+    const Result r = run(threads, calls);
+    Logger::stopAsync();
+    report(mode, threads, r, static_cast<double>(std::ftell(out)) / (static_cast<double>(threads) * calls));
+    std::fclose(out);
+  }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int calls = argc > 1 ? std::atoi(argv[1]) : 200000;
+  if (!std::freopen("/dev/null", "w", stdout)) return 1;
+
+  for (int threads : {1, 4}) {
+    report("sync", threads, run(threads, calls));
+
+    using IB::Helpers::Logging::LogFormat;
+    using IB::Helpers::Logging::OverflowPolicy;
+    runAsync("text (block)", threads, calls, {.overflow = OverflowPolicy::BLOCK});
+    runAsync("text (drop)", threads, calls, {});
+    runAsync("binary (block)", threads, calls, {.overflow = OverflowPolicy::BLOCK, .format = LogFormat::BINARY});
+    runAsync("binary (drop)", threads, calls, {.format = LogFormat::BINARY});
+
+    Logger::setLevel(Logger::Level::INFO);
+    report("disabled", threads, run(threads, calls, true));
+    Logger::setLevel(Logger::Level::DEBUG);
+
+    Logger::setRateLimit("Bench", {.maxPerSecond = 100});
+    report("rate limited", threads, run(threads, calls));
+    Logger::clearRateLimits();
+  }
+  return 0;
+}
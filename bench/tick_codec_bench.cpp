@@ -0,0 +1,108 @@
+/**
+ * @file tick_codec_bench.cpp
+ * @brief Compression ratio and encode / decode throughput of the tick block codec
+ *
+ * Generates a synthetic quote stream (bid/ask/last prices on a $0.01 grid parsed from
+ * decimal strings as they arrive from IB, round-lot sizes, bursty microsecond
+ * timestamps), verifies a lossless round trip and reports throughput in GB/s of decoded
+ * 32-byte records.
+ *
+ * Usage: tick_codec_bench [ticks]
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "storage/tick_codec.h"
+
+using Clock = std::chrono::steady_clock;
+using IB::Storage::TickRecord;
+
+static std::vector<TickRecord> synthesize(size_t n) {
+  std::mt19937_64 rng(7);
+  std::exponential_distribution<double> gapUs(1.0 / 400.0);
+  std::bernoulli_distribution burst(0.3);
+  std::discrete_distribution<int> move({2, 90, 6, 2});          // -1, 0, +1, -2 ticks: zero drift
+  std::discrete_distribution<int> kind({45, 45, 10});           // bid, ask, last
+  std::uniform_int_distribution<int> lots(1, 30);
+
+  std::vector<TickRecord> out(n);
+  int64_t ts = 1760745600LL * 1000000000LL;
+  long mid = 18500;                                            // $185.00 in cents
+  for (auto& t : out) {
+    ts += burst(rng) ? 1000 : static_cast<int64_t>(gapUs(rng)) * 1000;
+    mid += std::array<int, 4>{-1, 0, 1, -2}[static_cast<size_t>(move(rng))];
+    const int k = kind(rng);
+    t.timestampNs = ts;
+    t.field = static_cast<int16_t>(k == 0 ? 1 : k == 1 ? 2 : 4);
+    const long cents = mid + (k == 1 ? 1 : 0);
+    char quote[32];
+    std::snprintf(quote, sizeof(quote), "%ld.%02ld", cents / 100, cents % 100);
+    t.price = std::strtod(quote, nullptr);
+    t.size = static_cast<double>(lots(rng) * 100);
+    t.flags = 0;
+  }
+  return out;
+}
+
+static void run(const std::vector<TickRecord>& ticks, IB::Storage::Packing packing, const char* label) {
+  const IB::Storage::CodecOptions options{.tickSize = 0.01, .packing = packing};
+  const size_t block = options.blockRecords;
+
+  std::vector<uint8_t> bytes;
+  auto t0 = Clock::now();
+  for (size_t i = 0; i < ticks.size(); i += block)
+    IB::Storage::TickBlockCodec::encode(std::span(ticks).subspan(i, std::min(block, ticks.size() - i)), options, bytes);
+  const double encodeS = std::chrono::duration<double>(Clock::now() - t0).count();
+
+  IB::Storage::TickBlockCodec codec;
+  std::vector<TickRecord> decoded;
+  decoded.reserve(ticks.size());
+  double decodeS = 1e300;
+  for (int rep = 0; rep < 5; ++rep) {
+    decoded.clear();
+    t0 = Clock::now();
+    for (size_t at = 0; at < bytes.size();) {
+      const size_t used = codec.decode(bytes.data() + at, bytes.size() - at, decoded);
+      if (!used) {
+        std::printf("decode error at %zu\n", at);
+        std::exit(1);
+      }
+      at += used;
+    }
+    decodeS = std::min(decodeS, std::chrono::duration<double>(Clock::now() - t0).count());
+  }
+
+  IB::Storage::TickColumns columns;
+  double columnS = 1e300;
+  for (int rep = 0; rep < 5; ++rep) {
+    t0 = Clock::now();
+    for (size_t at = 0; at < bytes.size();) at += codec.decode(bytes.data() + at, bytes.size() - at, columns);
+    columnS = std::min(columnS, std::chrono::duration<double>(Clock::now() - t0).count());
+  }
+
+  bool same = decoded.size() == ticks.size();
+  for (size_t i = 0; same && i < ticks.size(); ++i)
+    same = std::memcmp(&decoded[i], &ticks[i], sizeof(TickRecord)) == 0;
+
+  const double raw = static_cast<double>(ticks.size() * sizeof(TickRecord));
+  std::printf("%-8s ratio %5.2fx  (%5.2f B/tick)  encode %6.2f GB/s  decode %6.2f GB/s  columns %6.2f GB/s  %s\n",
+              label, raw / static_cast<double>(bytes.size()), static_cast<double>(bytes.size()) / ticks.size(),
+              raw / encodeS / 1e9, raw / decodeS / 1e9, raw / columnS / 1e9, same ? "round-trip OK" : "ROUND-TRIP MISMATCH");
+}
+
+int main(int argc, char** argv) {
+  const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+  std::printf("tick codec: %zu ticks (%.1f MB raw)\n", n, n * sizeof(TickRecord) / 1e6);
+  const auto ticks = synthesize(n);
+  run(ticks, IB::Storage::Packing::AUTO, "auto");
+  run(ticks, IB::Storage::Packing::VARINT, "varint");
+  run(ticks, IB::Storage::Packing::BITPACK, "bitpack");
+  return 0;
+}
@@ -16,6 +16,11 @@
  * - **3000-3999**: Market data subscriptions
  * - **4000-4999**: Market data snapshots
  * - **5000-5999**: Position queries
+ * - **6000-6999**: Market scanner subscriptions
+ * - **7000-7999**: News feeds and historical news
+ * - **8000-8999**: Historical bars and head timestamps
+ * - **9000-9999**: Historical ticks
+ * - **10000+**: Market data lines opened by the scanner-driven universe
  *
  * @note These are **base IDs**. Actual request IDs are typically generated by adding offsets or
  *       incrementing from these bases to handle multiple concurrent requests.
@@ -163,6 +168,63 @@ namespace IB::ReqId {
    */
   constexpr int POSITION_ID = 5000;
 
+  // --------------------------------------------------------------------------
+  // Scanner / Universe Base IDs
+  // --------------------------------------------------------------------------
+
+  /**
+   * @brief Base ID for market scanner subscriptions
+   *
+   * Used with `reqScannerSubscription()`. Each concurrent scan needs its own ID; IB
+   * allows a small number of simultaneous scanner subscriptions (10 by default).
+   */
+  constexpr int SCANNER_ID = 6000;
+
+  // --------------------------------------------------------------------------
+  // News Base IDs
+  // --------------------------------------------------------------------------
+
+  /**
+   * @brief Base ID for news requests
+   *
+   * Streaming headline feeds (`reqMktData` with generic tick 292) use IDs from here;
+   * `reqHistoricalNews()` requests default to NEWS_ID + 500.
+   */
+  constexpr int NEWS_ID = 7000;
+
+  // --------------------------------------------------------------------------
+  // Historical Data Base IDs
+  // --------------------------------------------------------------------------
+
+  /**
+   * @brief Base ID for historical bar requests
+   *
+   * `reqHistoricalData()` IDs run from here to HEAD_TIMESTAMP_ID - 1; the backfill cycles
+   * through the range, which is far wider than IB's 50 simultaneous requests.
+   */
+  constexpr int HISTORICAL_DATA_ID = 8000;
+
+  /**
+   * @brief Base ID for `reqHeadTimestamp()` (earliest available data point)
+   */
+  constexpr int HEAD_TIMESTAMP_ID = 8900;
+
+  /**
+   * @brief Base ID for `reqHistoricalTicks()`
+   *
+   * The tick backfill cycles through 9001-9999; HISTORICAL_TICKS_ID itself is left to
+   * ad-hoc requests.
+   */
+  constexpr int HISTORICAL_TICKS_ID = 9000;
+
+  /**
+   * @brief First ticker ID of the streaming subscriptions opened by UniverseManager
+   *
+   * The universe allocates IDs upward from here and recycles them as names leave,
+   * so the range never collides with the fixed IDs above.
+   */
+  constexpr int UNIVERSE_MARKET_DATA_ID = 10000;
+
 } // namespace IB::ReqId
 
 #endif  // QUANTDREAMCPP_IBREQUESTIDS_H
@@ -0,0 +1,334 @@
+#ifndef QUANTDREAMCPP_BATCH_INDICATORS_H
+#define QUANTDREAMCPP_BATCH_INDICATORS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "data_structures/quote_book.h"
+#include "helpers/simd.h"
+
+/**
+ * @file batch_indicators.h
+ * @brief Cross-sectional (vectorized) forms of the streaming indicators
+ *
+ * Each batch indicator holds its state as one column per state variable, aligned
+ * with the rows of `IB::MarketData::QuoteBook`, and advances every instrument in a
+ * single SIMD pass over an input column. This is the sampled counterpart of
+ * `analytics/indicators.h`: call `update()` on a fixed schedule (for example every
+ * 100 ms or on each bar close) with a fresh `QuoteBook::Columns` copy.
+ *
+ * **Missing data**
+ * - Rows whose input is `<= 0` (no quote yet) keep their previous state
+ * - Windowed indicators carry the last valid value forward so every row's window
+ *   advances in lockstep, which is what makes the pass vectorizable
+ * - A row joins a window with its first valid input and counts its own samples, so a
+ *   late quote never averages in the zeros of the samples before it
+ */
+
+namespace IB::Analytics {
+
+namespace Simd = IB::Helpers::Simd;
+
+// --------------------------------------------------------------------------
+//  Batch EMA
+// --------------------------------------------------------------------------
+
+/**
+ * @brief EMA of one input column for all instruments
+ *
+ * Example usage:
+ * @code
+ * IB::Analytics::BatchEma ema(ib.quoteBook.capacity(), 0.05);
+ * IB::MarketData::QuoteBook::Columns cols;
+ *
+ * ib.quoteBook.copyTo(cols);
+ * ema.update(cols, IB::MarketData::QuoteBook::LAST);
+ * double v = ema.values()[row];
+ * @endcode
+ */
+class BatchEma {
+public:
+  BatchEma(size_t capacity, double alpha) : alpha_(alpha), ema_(capacity, 0.0) {}
+
+  void update(const double* x, size_t n) noexcept {
+    n = std::min(n, ema_.size());
+    double* ema = ema_.data();
+    const double alpha = alpha_;
+
+    Simd::forEach(n, [&]<typename V>(size_t i) {
+      V v = Simd::loadAs<V>(x + i);
+      V e = Simd::loadAs<V>(ema + i);
+      V zero = Simd::broadcast<V>(0.0);
+      V next = Simd::fmadd(Simd::broadcast<V>(alpha), Simd::sub(v, e), e);
+      next = Simd::blend(v, next, Simd::cmpgt(e, zero));       // seed with first value
+      Simd::store(ema + i, Simd::blend(e, next, Simd::cmpgt(v, zero)));
+    });
+  }
+
+  void update(const IB::MarketData::QuoteBook::Columns& cols, IB::MarketData::QuoteBook::Field field) noexcept {
+    update(cols.column(field), cols.rows);
+  }
+
+  const double* values() const noexcept { return ema_.data(); }
+  size_t capacity() const noexcept { return ema_.size(); }
+
+private:
+  double alpha_;
+  std::vector<double> ema_;
+};
+
+// --------------------------------------------------------------------------
+//  Batch rolling mean / variance / z-score
+// --------------------------------------------------------------------------
+
+/**
+ * @brief Rolling mean and variance (Welford with removal) for all instruments
+ *
+ * The window history is stored as `window` contiguous rows of `capacity` values,
+ * so adding the new sample and removing the expiring one are both unit-stride.
+ * Each row keeps its own sample count from its first valid input on: while a row
+ * fills its window it only adds samples, then it slides. `ready(row)` tells when
+ * the row's window is full.
+ */
+class BatchRollingStats {
+public:
+  BatchRollingStats(size_t capacity, size_t window)
+    : capacity_(capacity), window_(window == 0 ? 1 : window),
+      ring_(capacity_ * window_, 0.0), last_(capacity_, 0.0),
+      mean_(capacity_, 0.0), m2_(capacity_, 0.0), count_(capacity_, 0.0) {}
+
+  void update(const double* x, size_t n) noexcept {
+    n = std::min(n, capacity_);
+    double* slot = ring_.data() + head_ * capacity_;
+    double* last = last_.data();
+    double* mean = mean_.data();
+    double* m2 = m2_.data();
+    double* count = count_.data();
+    const double window = static_cast<double>(window_);
+    const double invW = 1.0 / window;
+
+    Simd::forEach(n, [&]<typename V>(size_t i) {
+      V zero = Simd::broadcast<V>(0.0);
+      V v = carry<V>(x + i, last + i);
+      V started = Simd::cmpgt(v, zero);                       // row has had a valid input
+      V c = Simd::loadAs<V>(count + i);
+      V filling = Simd::cmpgt(Simd::broadcast<V>(window), c);
+      V mu = Simd::loadAs<V>(mean + i);
+      V acc = Simd::loadAs<V>(m2 + i);
+
+      // Filling: plain Welford step with the row's own count
+      V c1 = Simd::add(c, Simd::broadcast<V>(1.0));
+      V delta = Simd::sub(v, mu);
+      V muAdd = Simd::add(mu, Simd::div(delta, c1));
+      V m2Add = Simd::fmadd(delta, Simd::sub(v, muAdd), acc);
+
+      // Full window: replace the sample that expires
+      V old = Simd::loadAs<V>(slot + i);
+      V diff = Simd::sub(v, old);
+      V muSlide = Simd::fmadd(diff, Simd::broadcast<V>(invW), mu);
+      V term = Simd::add(Simd::sub(v, muSlide), Simd::sub(old, mu));
+      V m2Slide = Simd::max(Simd::fmadd(diff, term, acc), zero);
+
+      V mu1 = Simd::blend(muSlide, muAdd, filling);
+      V m21 = Simd::blend(m2Slide, m2Add, filling);
+      V cNext = Simd::blend(c, c1, filling);
+      Simd::store(mean + i, Simd::blend(mu, mu1, started));
+      Simd::store(m2 + i, Simd::blend(acc, m21, started));
+      Simd::store(count + i, Simd::blend(c, cNext, started));
+      Simd::store(slot + i, v);
+    });
+    head_ = (head_ + 1) % window_;
+  }
+
+  void update(const IB::MarketData::QuoteBook::Columns& cols, IB::MarketData::QuoteBook::Field field) noexcept {
+    update(cols.column(field), cols.rows);
+  }
+
+  const double* means() const noexcept { return mean_.data(); }
+
+  /// Writes the sample variance of the first `n` rows into `out` (0 for rows with fewer than 2 samples)
+  void variances(double* out, size_t n) const noexcept {
+    n = std::min(n, capacity_);
+    const double* m2 = m2_.data();
+    const double* count = count_.data();
+    Simd::forEach(n, [&]<typename V>(size_t i) {
+      V one = Simd::broadcast<V>(1.0);
+      V c = Simd::loadAs<V>(count + i);
+      V dof = Simd::sub(c, one);
+      V var = Simd::div(Simd::loadAs<V>(m2 + i), Simd::max(dof, one));
+      Simd::store(out + i, Simd::blend(Simd::broadcast<V>(0.0), var, Simd::cmpgt(c, one)));
+    });
+  }
+
+  /// Writes the standard deviation of the first `n` rows into `out`
+  void stddevs(double* out, size_t n) const noexcept {
+    variances(out, n);
+    Simd::forEach(std::min(n, capacity_), [&]<typename V>(size_t i) {
+      Simd::store(out + i, Simd::sqrt(Simd::loadAs<V>(out + i)));
+    });
+  }
+
+  /**
+   * @brief Writes the z-score of `x[i]` against row `i`'s window into `out`
+   *
+   * Rows whose window is not full yet, or has zero variance, get a z-score of 0.
+   */
+  void zscores(const double* x, double* out, size_t n) const noexcept {
+    stddevs(out, n);
+    const double* mean = mean_.data();
+    const double* count = count_.data();
+    const double full = static_cast<double>(window_) - 0.5;
+    Simd::forEach(std::min(n, capacity_), [&]<typename V>(size_t i) {
+      V sd = Simd::loadAs<V>(out + i);
+      V zero = Simd::broadcast<V>(0.0);
+      V usable = Simd::cmpgt(sd, zero);
+      V ready = Simd::cmpgt(Simd::loadAs<V>(count + i), Simd::broadcast<V>(full));
+      V safe = Simd::blend(Simd::broadcast<V>(1.0), sd, usable);
+      V z = Simd::div(Simd::sub(Simd::loadAs<V>(x + i), Simd::loadAs<V>(mean + i)), safe);
+      z = Simd::blend(zero, z, usable);
+      Simd::store(out + i, Simd::blend(zero, z, ready));
+    });
+  }
+
+  /// Samples in row `row`'s window (0 until its first valid input)
+  size_t count(size_t row) const noexcept { return row < capacity_ ? static_cast<size_t>(count_[row]) : 0; }
+  size_t window() const noexcept { return window_; }
+  bool ready(size_t row) const noexcept { return count(row) == window_; }
+
+private:
+  /// Loads `x`, replacing non-positive entries with the last valid value, and records it
+  template <typename V>
+  static V carry(const double* x, double* last) noexcept {
+    V v = Simd::loadAs<V>(x);
+    V prev = Simd::loadAs<V>(last);
+    v = Simd::blend(prev, v, Simd::cmpgt(v, Simd::broadcast<V>(0.0)));
+    Simd::store(last, v);
+    return v;
+  }
+
+  size_t capacity_;
+  size_t window_;
+  size_t head_ = 0;
+  std::vector<double> ring_;    ///< window_ x capacity_ history, row-major by sample
+  std::vector<double> last_;    ///< Last valid input per instrument
+  std::vector<double> mean_;
+  std::vector<double> m2_;
+  std::vector<double> count_;   ///< Samples per instrument (double so it lives in SIMD lanes)
+};
+
+// --------------------------------------------------------------------------
+//  Batch RSI / ATR (Wilder smoothing of sampled changes)
+// --------------------------------------------------------------------------
+
+/**
+ * @brief RSI of one input column for all instruments
+ *
+ * Uses the same Wilder smoothing as `IB::Analytics::Rsi`; rows without a previous
+ * valid sample contribute no change on their first valid update.
+ */
+class BatchRsi {
+public:
+  BatchRsi(size_t capacity, size_t period)
+    : period_(static_cast<double>(period == 0 ? 1 : period)),
+      prev_(capacity, 0.0), gain_(capacity, 0.0), loss_(capacity, 0.0), rsi_(capacity, 50.0) {}
+
+  void update(const double* x, size_t n) noexcept {
+    n = std::min(n, prev_.size());
+    if (primed_) count_ += 1.0;    // the first pass only records previous values
+    primed_ = true;
+    const double inv = 1.0 / std::max(1.0, std::min(count_, period_));
+    double* prev = prev_.data();
+    double* gain = gain_.data();
+    double* loss = loss_.data();
+    double* rsi = rsi_.data();
+
+    Simd::forEach(n, [&]<typename V>(size_t i) {
+      V zero = Simd::broadcast<V>(0.0);
+      V v = Simd::loadAs<V>(x + i);
+      V p = Simd::loadAs<V>(prev + i);
+      V valid = Simd::cmpgt(v, zero);
+      V change = Simd::blend(zero, Simd::sub(v, p), Simd::cmpgt(p, zero));
+      change = Simd::blend(zero, change, valid);
+
+      V w = Simd::broadcast<V>(inv);
+      V g = Simd::loadAs<V>(gain + i);
+      V l = Simd::loadAs<V>(loss + i);
+      g = Simd::fmadd(Simd::sub(Simd::max(change, zero), g), w, g);
+      l = Simd::fmadd(Simd::sub(Simd::max(Simd::sub(zero, change), zero), l), w, l);
+      Simd::store(gain + i, g);
+      Simd::store(loss + i, l);
+      Simd::store(prev + i, Simd::blend(p, v, valid));
+
+      // rsi = 100 * g / (g + l), 50 when both are zero
+      V total = Simd::add(g, l);
+      V hasMove = Simd::cmpgt(total, zero);
+      V safe = Simd::blend(Simd::broadcast<V>(1.0), total, hasMove);
+      V r = Simd::mul(Simd::broadcast<V>(100.0), Simd::div(g, safe));
+      Simd::store(rsi + i, Simd::blend(Simd::broadcast<V>(50.0), r, hasMove));
+    });
+  }
+
+  void update(const IB::MarketData::QuoteBook::Columns& cols, IB::MarketData::QuoteBook::Field field) noexcept {
+    update(cols.column(field), cols.rows);
+  }
+
+  const double* values() const noexcept { return rsi_.data(); }
+
+private:
+  double period_;
+  double count_ = 0.0;
+  bool primed_ = false;
+  std::vector<double> prev_;
+  std::vector<double> gain_;
+  std::vector<double> loss_;
+  std::vector<double> rsi_;
+};
+
+/**
+ * @brief ATR of one sampled price column for all instruments
+ *
+ * Between samples the true range degenerates to `|x - previous x|`; it is smoothed
+ * with Wilder's recurrence like `IB::Analytics::Atr`.
+ */
+class BatchAtr {
+public:
+  BatchAtr(size_t capacity, size_t period)
+    : period_(static_cast<double>(period == 0 ? 1 : period)), prev_(capacity, 0.0), atr_(capacity, 0.0) {}
+
+  void update(const double* x, size_t n) noexcept {
+    n = std::min(n, prev_.size());
+    count_ += 1.0;
+    const double inv = 1.0 / std::min(count_, period_);
+    double* prev = prev_.data();
+    double* atr = atr_.data();
+
+    Simd::forEach(n, [&]<typename V>(size_t i) {
+      V zero = Simd::broadcast<V>(0.0);
+      V v = Simd::loadAs<V>(x + i);
+      V p = Simd::loadAs<V>(prev + i);
+      V valid = Simd::cmpgt(v, zero);
+      V tr = Simd::blend(zero, Simd::abs(Simd::sub(v, p)), Simd::cmpgt(p, zero));
+      V a = Simd::loadAs<V>(atr + i);
+      V next = Simd::fmadd(Simd::sub(tr, a), Simd::broadcast<V>(inv), a);
+      Simd::store(atr + i, Simd::blend(a, next, valid));
+      Simd::store(prev + i, Simd::blend(p, v, valid));
+    });
+  }
+
+  void update(const IB::MarketData::QuoteBook::Columns& cols, IB::MarketData::QuoteBook::Field field) noexcept {
+    update(cols.column(field), cols.rows);
+  }
+
+  const double* values() const noexcept { return atr_.data(); }
+
+private:
+  double period_;
+  double count_ = 0.0;
+  std::vector<double> prev_;
+  std::vector<double> atr_;
+};
+
+} // namespace IB::Analytics
+
+#endif  // QUANTDREAMCPP_BATCH_INDICATORS_H
@@ -0,0 +1,286 @@
+#ifndef QUANTDREAMCPP_COVARIANCE_H
+#define QUANTDREAMCPP_COVARIANCE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "data_structures/quote_book.h"
+#include "helpers/simd.h"
+#include "helpers/thread_pool.h"
+
+/**
+ * @file covariance.h
+ * @brief Incremental EWMA return covariance / correlation across a universe
+ *
+ * Recomputing a covariance matrix from a window of bars costs O(N²·T) per update.
+ * `EwmaCovariance` instead folds each cross-section of returns into the matrix with
+ * a rank-1 update, O(N²) with a small constant:
+ *
+ *   d    = r - mean
+ *   mean = mean + (1 - λ) d
+ *   C    = λ (C + (1 - λ) d dᵀ)
+ *
+ * Only the upper triangle is maintained. It is walked in square tiles so the slice
+ * of `d` feeding a tile stays in L1, each tile row is one SIMD fused multiply-add
+ * sweep, and row tiles can be spread over a `ThreadPool`.
+ *
+ * Returns are sampled on bar closes by `BarSampler`, so all instruments contribute
+ * to the same cross-section even though their ticks arrive asynchronously.
+ *
+ * Readers never see the working matrix: `publish()` mirrors it into an immutable
+ * `CovarianceSnapshot` that is swapped in atomically.
+ */
+
+namespace IB::Analytics {
+
+/**
+ * @brief Immutable, full (symmetric) covariance matrix published to readers
+ */
+struct CovarianceSnapshot {
+  size_t n = 0;                 ///< Number of instruments
+  uint64_t updates = 0;         ///< Cross-sections folded in when published
+  std::vector<double> cov;      ///< Row-major n × n covariance
+  std::vector<double> mean;     ///< EWMA mean return per instrument
+
+  double covariance(size_t i, size_t j) const noexcept { return cov[i * n + j]; }
+  double variance(size_t i) const noexcept { return cov[i * n + i]; }
+  double volatility(size_t i) const noexcept { return std::sqrt(variance(i)); }
+
+  /// Pearson correlation (0 when either instrument has no variance yet)
+  double correlation(size_t i, size_t j) const noexcept {
+    double d = variance(i) * variance(j);
+    return d > 0.0 ? covariance(i, j) / std::sqrt(d) : 0.0;
+  }
+
+  /// Full row-major correlation matrix
+  std::vector<double> correlationMatrix() const {
+    std::vector<double> out(n * n, 0.0);
+    std::vector<double> inv(n, 0.0);
+    for (size_t i = 0; i < n; ++i) inv[i] = variance(i) > 0.0 ? 1.0 / volatility(i) : 0.0;
+    for (size_t i = 0; i < n; ++i)
+      for (size_t j = 0; j < n; ++j) out[i * n + j] = cov[i * n + j] * inv[i] * inv[j];
+    return out;
+  }
+};
+
+/**
+ * @brief Samples synchronized log returns from the quote book on bar closes
+ *
+ * Holds the previous close of every row; `close()` turns the current prices into a
+ * cross-section of log returns. Rows without a valid price on either side of the bar
+ * contribute a zero return, which keeps the cross-section aligned.
+ *
+ * Example usage:
+ * @code
+ * IB::Analytics::BarSampler sampler(universe, std::chrono::minutes(1));
+ * std::vector<double> r(universe);
+ *
+ * if (sampler.due(std::chrono::steady_clock::now())) {
+ *     wrapper.quoteBook.copyTo(cols);
+ *     sampler.close(cols, r.data());
+ *     cov.update(r.data());
+ * }
+ * @endcode
+ */
+class BarSampler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  BarSampler(size_t n, Clock::duration interval, IB::MarketData::QuoteBook::Field field = IB::MarketData::QuoteBook::LAST)
+    : prev_(n, 0.0), interval_(interval), field_(field) {}
+
+  /// True once per elapsed bar interval
+  bool due(Clock::time_point now) noexcept {
+    if (next_ == Clock::time_point{}) next_ = now + interval_;
+    if (now < next_) return false;
+    do next_ += interval_; while (next_ <= now);
+    return true;
+  }
+
+  /**
+   * @brief Closes a bar: writes `log(p / prevClose)` for the first `n` rows into `out`
+   * @return True if every row had a previous close (i.e. the cross-section is complete)
+   */
+  bool close(const IB::MarketData::QuoteBook::Columns& cols, double* out) {
+    const size_t n = prev_.size();
+    const size_t rows = std::min(n, cols.rows);
+    const double* px = cols.column(field_);
+    bool complete = rows == n;
+    for (size_t i = 0; i < rows; ++i) {
+      double p = px[i];
+      bool ok = p > 0.0 && prev_[i] > 0.0;
+      out[i] = ok ? std::log(p / prev_[i]) : 0.0;
+      complete &= ok;
+      if (p > 0.0) prev_[i] = p;
+    }
+    std::fill(out + rows, out + n, 0.0);
+    return complete;
+  }
+
+  size_t size() const noexcept { return prev_.size(); }
+
+private:
+  std::vector<double> prev_;
+  Clock::duration interval_;
+  IB::MarketData::QuoteBook::Field field_;
+  Clock::time_point next_{};
+};
+
+/**
+ * @brief Exponentially weighted covariance updated one cross-section at a time
+ *
+ * Single writer: `update()` and `publish()` must be called from the same thread.
+ * `snapshot()` may be called from any thread.
+ *
+ * Example usage:
+ * @code
+ * IB::Helpers::ThreadPool pool;
+ * IB::Analytics::EwmaCovariance cov(500, 0.97, &pool);
+ *
+ * cov.update(returns);          // once per bar
+ * cov.publish();                // whenever readers should see the new state
+ *
+ * auto snap = cov.snapshot();   // from any thread
+ * double rho = snap->correlation(0, 1);
+ * @endcode
+ */
+class EwmaCovariance {
+public:
+  /**
+   * @param n Number of instruments
+   * @param lambda Decay factor in (0, 1); RiskMetrics uses 0.94 (daily) / 0.97 (monthly)
+   * @param pool Optional pool used to split row tiles (nullptr = calling thread)
+   * @param tile Tile edge in elements (64 doubles = 512 bytes per tile row)
+   */
+  explicit EwmaCovariance(size_t n, double lambda = 0.94,
+                          IB::Helpers::ThreadPool* pool = nullptr, size_t tile = 64)
+    : n_(n), lambda_(lambda), pool_(pool), tile_(tile == 0 ? 64 : tile),
+      cov_(n * n, 0.0), mean_(n, 0.0), d_(n, 0.0),
+      published_(std::make_shared<CovarianceSnapshot>(CovarianceSnapshot{n, 0, std::vector<double>(n * n, 0.0), std::vector<double>(n, 0.0)})) {}
+
+  /**
+   * @brief Folds one cross-section of `n` returns into the estimate
+   */
+  void update(const double* returns) {
+    namespace Simd = IB::Helpers::Simd;
+    const double a = 1.0 - lambda_;
+    double* d = d_.data();
+    double* mean = mean_.data();
+
+    Simd::forEach(n_, [&]<typename V>(size_t i) {
+      V r = Simd::loadAs<V>(returns + i);
+      V m = Simd::loadAs<V>(mean + i);
+      V diff = Simd::sub(r, m);
+      Simd::store(d + i, diff);
+      Simd::store(mean + i, Simd::fmadd(Simd::broadcast<V>(a), diff, m));
+    });
+
+    const size_t tiles = (n_ + tile_ - 1) / tile_;
+    auto rows = [&](size_t tb, size_t te) {
+      for (size_t t = tb; t < te; ++t) updateRowTile(t);
+    };
+    if (pool_) pool_->parallelFor(tiles, 1, rows);
+    else rows(0, tiles);
+
+    ++updates_;
+  }
+
+  /**
+   * @brief Mirrors the upper triangle into a new snapshot and makes it visible to readers
+   */
+  void publish() {
+    // Reuse the snapshot retired by the previous publish once no reader holds it
+    std::shared_ptr<CovarianceSnapshot> snap = spare_ && spare_.use_count() == 1
+      ? std::move(spare_) : std::make_shared<CovarianceSnapshot>();
+    snap->n = n_;
+    snap->updates = updates_;
+    snap->mean = mean_;
+    snap->cov.resize(n_ * n_);
+    double* dst = snap->cov.data();
+    const double* src = cov_.data();
+    // Tiled mirror: each upper tile is copied in place and transposed into the lower half
+    for (size_t ib = 0; ib < n_; ib += tile_) {
+      const size_t ie = std::min(n_, ib + tile_);
+      for (size_t jb = ib; jb < n_; jb += tile_) {
+        const size_t je = std::min(n_, jb + tile_);
+        for (size_t i = ib; i < ie; ++i)
+          for (size_t j = std::max(i, jb); j < je; ++j) {
+            double v = src[i * n_ + j];
+            dst[i * n_ + j] = v;
+            dst[j * n_ + i] = v;
+          }
+      }
+    }
+    auto retired = published_.exchange(std::shared_ptr<const CovarianceSnapshot>(std::move(snap)), std::memory_order_acq_rel);
+    spare_ = std::const_pointer_cast<CovarianceSnapshot>(std::move(retired));
+  }
+
+  /// Latest published snapshot (never null)
+  std::shared_ptr<const CovarianceSnapshot> snapshot() const {
+    return published_.load(std::memory_order_acquire);
+  }
+
+  /// Working-matrix covariance (writer thread only)
+  double covariance(size_t i, size_t j) const noexcept {
+    return i <= j ? cov_[i * n_ + j] : cov_[j * n_ + i];
+  }
+
+  size_t size() const noexcept { return n_; }
+  uint64_t updates() const noexcept { return updates_; }
+  double lambda() const noexcept { return lambda_; }
+
+  void reset() {
+    std::fill(cov_.begin(), cov_.end(), 0.0);
+    std::fill(mean_.begin(), mean_.end(), 0.0);
+    updates_ = 0;
+  }
+
+private:
+  /// C[i, j] = λ C[i, j] + λ(1-λ) d_i d_j for every i in the tile and j >= i
+  void updateRowTile(size_t t) noexcept {
+    namespace Simd = IB::Helpers::Simd;
+    const double lam = lambda_;
+    const double scale = lambda_ * (1.0 - lambda_);
+    const double* d = d_.data();
+    const size_t ib = t * tile_;
+    const size_t ie = std::min(n_, ib + tile_);
+
+    for (size_t jb = ib; jb < n_; jb += tile_) {
+      const size_t je = std::min(n_, jb + tile_);
+      for (size_t i = ib; i < ie; ++i) {
+        const size_t j0 = std::max(i, jb);
+        if (j0 >= je) continue;
+        double* row = cov_.data() + i * n_;
+        const double di = scale * d[i];
+        Simd::forEach(je - j0, [&]<typename V>(size_t k) {
+          const size_t j = j0 + k;
+          V c = Simd::mul(Simd::loadAs<V>(row + j), Simd::broadcast<V>(lam));
+          Simd::store(row + j, Simd::fmadd(Simd::broadcast<V>(di), Simd::loadAs<V>(d + j), c));
+        });
+      }
+    }
+  }
+
+  size_t n_;
+  double lambda_;
+  IB::Helpers::ThreadPool* pool_;
+  size_t tile_;
+
+  std::vector<double> cov_;    ///< Row-major n × n; only j >= i is maintained
+  std::vector<double> mean_;   ///< EWMA mean return
+  std::vector<double> d_;      ///< Scratch: demeaned returns of the current update
+  uint64_t updates_ = 0;
+
+  std::atomic<std::shared_ptr<const CovarianceSnapshot>> published_;
+  std::shared_ptr<CovarianceSnapshot> spare_;   ///< Previously published snapshot, recycled when unreferenced
+};
+
+} // namespace IB::Analytics
+
+#endif  // QUANTDREAMCPP_COVARIANCE_H
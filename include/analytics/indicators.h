@@ -0,0 +1,373 @@
+#ifndef QUANTDREAMCPP_INDICATORS_H
+#define QUANTDREAMCPP_INDICATORS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @file indicators.h
+ * @brief Streaming technical indicators with O(1) updates, keyed by instrument
+ *
+ * Each indicator keeps only the state it needs to absorb the next observation:
+ * running sums for windowed statistics, a monotonic ring for windowed extrema,
+ * and Wilder smoothing for ATR/RSI. Window buffers are allocated once at
+ * construction, so updates never allocate. `IndicatorStore` keeps one copy of
+ * an indicator per instrument (ticker ID).
+ *
+ * For updating the same indicator across a whole universe at once, see
+ * `analytics/batch_indicators.h`.
+ */
+
+namespace IB::Analytics {
+
+// --------------------------------------------------------------------------
+//  Exponential moving average
+// --------------------------------------------------------------------------
+
+/**
+ * @brief Exponential moving average seeded with the first observation
+ *
+ * Example usage:
+ * @code
+ * auto ema = IB::Analytics::Ema::fromPeriod(20);
+ * double v = ema.update(snap.last);
+ * @endcode
+ */
+class Ema {
+public:
+  /// @param alpha Smoothing factor in (0, 1]
+  explicit Ema(double alpha = 0.1) : alpha_(alpha) {}
+
+  /// EMA with the conventional `alpha = 2 / (period + 1)`
+  static Ema fromPeriod(size_t period) { return Ema(2.0 / (static_cast<double>(period) + 1.0)); }
+
+  double update(double x) noexcept {
+    value_ = ready_ ? value_ + alpha_ * (x - value_) : x;
+    ready_ = true;
+    return value_;
+  }
+
+  double value() const noexcept { return value_; }
+  bool ready() const noexcept { return ready_; }
+  double alpha() const noexcept { return alpha_; }
+
+private:
+  double alpha_;
+  double value_ = 0.0;
+  bool ready_ = false;
+};
+
+// --------------------------------------------------------------------------
+//  Rolling mean / variance (Welford with removal)
+// --------------------------------------------------------------------------
+
+/**
+ * @brief Mean and variance over the last `window` observations
+ *
+ * Uses Welford's recurrence extended with removal of the value leaving the
+ * window, which is numerically far better behaved than raw sum / sum-of-squares.
+ */
+class RollingStats {
+public:
+  explicit RollingStats(size_t window = 20) : buf_(window == 0 ? 1 : window) {}
+
+  void update(double x) noexcept {
+    if (count_ < buf_.size()) {
+      ++count_;
+      double delta = x - mean_;
+      mean_ += delta / static_cast<double>(count_);
+      m2_ += delta * (x - mean_);
+    } else {
+      double old = buf_[head_];
+      double oldMean = mean_;
+      mean_ += (x - old) / static_cast<double>(count_);
+      m2_ += (x - old) * (x - mean_ + old - oldMean);
+      if (m2_ < 0.0) m2_ = 0.0;
+    }
+    buf_[head_] = x;
+    head_ = (head_ + 1) % buf_.size();
+  }
+
+  double mean() const noexcept { return mean_; }
+  double value() const noexcept { return mean_; }
+
+  /// Sample variance (n - 1 denominator); 0 with fewer than two observations
+  double variance() const noexcept {
+    return count_ > 1 ? m2_ / static_cast<double>(count_ - 1) : 0.0;
+  }
+
+  double stddev() const noexcept { return std::sqrt(variance()); }
+
+  /// Standard score of `x` against the current window (0 when the window is flat)
+  double zscore(double x) const noexcept {
+    double sd = stddev();
+    return sd > 0.0 ? (x - mean_) / sd : 0.0;
+  }
+
+  size_t count() const noexcept { return count_; }
+  size_t window() const noexcept { return buf_.size(); }
+  bool ready() const noexcept { return count_ == buf_.size(); }
+
+private:
+  std::vector<double> buf_;
+  size_t head_ = 0;
+  size_t count_ = 0;
+  double mean_ = 0.0;
+  double m2_ = 0.0;
+};
+
+// --------------------------------------------------------------------------
+//  Rolling min / max (monotonic deque)
+// --------------------------------------------------------------------------
+
+/**
+ * @brief Minimum and maximum over the last `window` observations
+ *
+ * Two monotonic deques (stored as fixed ring buffers of capacity `window`)
+ * give amortized O(1) updates and O(1) queries.
+ */
+class RollingMinMax {
+public:
+  explicit RollingMinMax(size_t window = 20)
+    : window_(window == 0 ? 1 : window), minQ_(window_), maxQ_(window_) {}
+
+  void update(double x) noexcept {
+    const size_t t = seq_++;
+    push(maxQ_, t, x, [](double a, double b) { return a <= b; });
+    push(minQ_, t, x, [](double a, double b) { return a >= b; });
+  }
+
+  double min() const noexcept { return minQ_.empty() ? 0.0 : minQ_.front().value; }
+  double max() const noexcept { return maxQ_.empty() ? 0.0 : maxQ_.front().value; }
+  bool ready() const noexcept { return seq_ >= window_; }
+
+private:
+  struct Entry {
+    size_t seq;
+    double value;
+  };
+
+  /// Fixed-capacity deque on a ring buffer
+  struct Ring {
+    explicit Ring(size_t cap) : data(cap) {}
+    std::vector<Entry> data;
+    size_t head = 0;
+    size_t size = 0;
+
+    bool empty() const noexcept { return size == 0; }
+    const Entry& front() const noexcept { return data[head]; }
+    const Entry& back() const noexcept { return data[(head + size - 1) % data.size()]; }
+    void popFront() noexcept { head = (head + 1) % data.size(); --size; }
+    void popBack() noexcept { --size; }
+    void pushBack(Entry e) noexcept { data[(head + size) % data.size()] = e; ++size; }
+  };
+
+  template <typename Dominated>
+  void push(Ring& q, size_t t, double x, Dominated dominated) noexcept {
+    while (!q.empty() && q.front().seq + window_ <= t) q.popFront();
+    while (!q.empty() && dominated(q.back().value, x)) q.popBack();
+    q.pushBack({t, x});
+  }
+
+  size_t window_;
+  size_t seq_ = 0;
+  Ring minQ_;
+  Ring maxQ_;
+};
+
+// --------------------------------------------------------------------------
+//  Z-score
+// --------------------------------------------------------------------------
+
+/**
+ * @brief Rolling z-score of each new observation against the trailing window
+ *
+ * The window includes the observation being scored, matching how most
+ * mean-reversion signals are defined.
+ */
+class ZScore {
+public:
+  explicit ZScore(size_t window = 20) : stats_(window) {}
+
+  double update(double x) noexcept {
+    stats_.update(x);
+    value_ = stats_.zscore(x);
+    return value_;
+  }
+
+  double value() const noexcept { return value_; }
+  bool ready() const noexcept { return stats_.ready(); }
+  const RollingStats& stats() const noexcept { return stats_; }
+
+private:
+  RollingStats stats_;
+  double value_ = 0.0;
+};
+
+// --------------------------------------------------------------------------
+//  Average true range (Wilder)
+// --------------------------------------------------------------------------
+
+/**
+ * @brief Average true range with Wilder smoothing
+ *
+ * The first `period` true ranges are averaged arithmetically; afterwards
+ * `atr = atr + (tr - atr) / period`.
+ */
+class Atr {
+public:
+  explicit Atr(size_t period = 14) : period_(static_cast<double>(period == 0 ? 1 : period)) {}
+
+  /// Updates with one bar
+  double update(double high, double low, double close) noexcept {
+    double tr = high - low;
+    if (hasPrev_)
+      tr = std::max({tr, std::fabs(high - prevClose_), std::fabs(low - prevClose_)});
+    prevClose_ = close;
+    hasPrev_ = true;
+
+    ++count_;
+    if (count_ <= period_) value_ += (tr - value_) / count_;
+    else                   value_ += (tr - value_) / period_;
+    return value_;
+  }
+
+  /// Updates with a single price (tick data): the bar degenerates to the price itself
+  double update(double price) noexcept { return update(price, price, price); }
+
+  double value() const noexcept { return value_; }
+  bool ready() const noexcept { return count_ >= period_; }
+
+private:
+  double period_;
+  double count_ = 0.0;
+  double value_ = 0.0;
+  double prevClose_ = 0.0;
+  bool hasPrev_ = false;
+};
+
+// --------------------------------------------------------------------------
+//  Relative strength index (Wilder)
+// --------------------------------------------------------------------------
+
+/**
+ * @brief Relative strength index in [0, 100] with Wilder smoothing
+ */
+class Rsi {
+public:
+  explicit Rsi(size_t period = 14) : period_(static_cast<double>(period == 0 ? 1 : period)) {}
+
+  double update(double close) noexcept {
+    if (!hasPrev_) {
+      prev_ = close;
+      hasPrev_ = true;
+      return value_;
+    }
+
+    double change = close - prev_;
+    prev_ = close;
+    double gain = change > 0.0 ? change : 0.0;
+    double loss = change < 0.0 ? -change : 0.0;
+
+    ++count_;
+    double n = count_ <= period_ ? count_ : period_;
+    avgGain_ += (gain - avgGain_) / n;
+    avgLoss_ += (loss - avgLoss_) / n;
+
+    value_ = avgLoss_ > 0.0 ? 100.0 - 100.0 / (1.0 + avgGain_ / avgLoss_)
+                            : (avgGain_ > 0.0 ? 100.0 : 50.0);
+    return value_;
+  }
+
+  double value() const noexcept { return value_; }
+  bool ready() const noexcept { return count_ >= period_; }
+
+private:
+  double period_;
+  double count_ = 0.0;
+  double prev_ = 0.0;
+  bool hasPrev_ = false;
+  double avgGain_ = 0.0;
+  double avgLoss_ = 0.0;
+  double value_ = 50.0;
+};
+
+// --------------------------------------------------------------------------
+//  Per-instrument store
+// --------------------------------------------------------------------------
+
+/**
+ * @brief One indicator instance per instrument, created from a prototype on first use
+ *
+ * @tparam Indicator Any of the indicators above (or a user type with the same shape)
+ *
+ * Thread-safe: updates and reads take a short lock, so a store can be fed from the
+ * IB reader thread and queried from strategy threads.
+ *
+ * Example usage:
+ * @code
+ * IB::Analytics::IndicatorStore<IB::Analytics::Rsi> rsi(IB::Analytics::Rsi(14));
+ *
+ * pm.setOnLastCallback([&](int tickerId, double last) {
+ *     rsi.update(tickerId, last);
+ * });
+ *
+ * double v = rsi.value(tickerId);
+ * @endcode
+ */
+template <typename Indicator>
+class IndicatorStore {
+public:
+  explicit IndicatorStore(Indicator prototype = Indicator()) : prototype_(std::move(prototype)) {}
+
+  /// Forwards `args` to the instrument's `update()` and returns its result
+  template <typename... Args>
+  auto update(int tickerId, Args&&... args) {
+    std::lock_guard<std::mutex> lock(m_);
+    return at(tickerId).update(std::forward<Args>(args)...);
+  }
+
+  /// Current value of the instrument's indicator (prototype value if unknown)
+  double value(int tickerId) const {
+    std::lock_guard<std::mutex> lock(m_);
+    auto it = items_.find(tickerId);
+    return it == items_.end() ? prototype_.value() : it->second.value();
+  }
+
+  /// Copy of the instrument's indicator (prototype if unknown)
+  Indicator get(int tickerId) const {
+    std::lock_guard<std::mutex> lock(m_);
+    auto it = items_.find(tickerId);
+    return it == items_.end() ? prototype_ : it->second;
+  }
+
+  void erase(int tickerId) {
+    std::lock_guard<std::mutex> lock(m_);
+    items_.erase(tickerId);
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(m_);
+    return items_.size();
+  }
+
+private:
+  Indicator& at(int tickerId) {
+    auto it = items_.find(tickerId);
+    if (it == items_.end()) it = items_.emplace(tickerId, prototype_).first;
+    return it->second;
+  }
+
+  Indicator prototype_;
+  mutable std::mutex m_;
+  std::unordered_map<int, Indicator> items_;
+};
+
+} // namespace IB::Analytics
+
+#endif  // QUANTDREAMCPP_INDICATORS_H
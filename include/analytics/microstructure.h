@@ -0,0 +1,324 @@
+#ifndef QUANTDREAMCPP_MICROSTRUCTURE_H
+#define QUANTDREAMCPP_MICROSTRUCTURE_H
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @file microstructure.h
+ * @brief Incrementally maintained market microstructure metrics per instrument
+ *
+ * This file provides order-flow imbalance, microprice, rolling VWAP and trade-sign
+ * classification. Every metric is updated in O(1) from the tick that just arrived,
+ * so nothing is ever recomputed from tick history.
+ */
+
+namespace IB::Analytics {
+
+/**
+ * @brief Trade direction inferred from the quote at the time of the trade
+ */
+enum class TradeSign : int {
+  SELL    = -1,  ///< Trade at or below the bid side of the mid
+  UNKNOWN = 0,   ///< Not classified yet (no quote and no previous trade)
+  BUY     = 1    ///< Trade at or above the ask side of the mid
+};
+
+/**
+ * @brief Plain copy of the derived metrics of one instrument
+ */
+struct MicrostructureMetrics {
+  double mid = 0.0;            ///< Plain mid price
+  double microprice = 0.0;     ///< Size-weighted mid price
+  double bookImbalance = 0.0;  ///< (bidSize - askSize) / (bidSize + askSize)
+  double ofi = 0.0;            ///< Cumulative order-flow imbalance
+  double ofiEwma = 0.0;        ///< Exponentially decayed order-flow imbalance
+  double vwap = 0.0;           ///< Rolling VWAP over the trade window
+  double buyVolume = 0.0;      ///< Volume classified as buyer-initiated
+  double sellVolume = 0.0;     ///< Volume classified as seller-initiated
+  TradeSign lastSign = TradeSign::UNKNOWN;  ///< Sign of the most recent trade
+};
+
+/**
+ * @brief Microstructure state for a single instrument
+ *
+ * **Order-flow imbalance (OFI)**
+ * - Cont/Kukanov/Stoikov event contribution on each best-quote change:
+ *   `e = [Pb >= Pb'] qb - [Pb <= Pb'] qb' - [Pa <= Pa'] qa + [Pa >= Pa'] qa'`
+ *   where primed values are the previous best quote
+ * - `ofi` accumulates all contributions; `ofiEwma` is an exponentially decayed version
+ *
+ * **Microprice**
+ * - Size-weighted mid: `(bid * askSize + ask * bidSize) / (bidSize + askSize)`
+ * - Falls back to the plain mid when sizes are unknown
+ *
+ * **Rolling VWAP**
+ * - VWAP over the last `window` trades, maintained with a ring buffer and running sums
+ *
+ * **Trade sign**
+ * - Lee-Ready: quote rule against the current mid, tick rule as tie-breaker
+ * - Buy and sell volumes are accumulated separately
+ *
+ * @note The ring buffer is allocated once at construction; updates never allocate.
+ */
+class MicrostructureState {
+public:
+  /**
+   * @param window Number of trades in the rolling VWAP window
+   * @param ofiAlpha Smoothing factor of the decayed OFI (0 < alpha <= 1)
+   */
+  explicit MicrostructureState(size_t window = 100, double ofiAlpha = 0.05)
+    : ofiAlpha_(ofiAlpha), trades_(window == 0 ? 1 : window) {}
+
+  /**
+   * @brief Applies a best-quote update
+   *
+   * Call once per best-quote change with the full current top of book; applying the
+   * same change twice counts its flow twice. Non-positive prices are ignored until
+   * both sides are known.
+   */
+  void onQuote(double bid, double bidSize, double ask, double askSize) noexcept {
+    if (bid <= 0.0 || ask <= 0.0) return;
+
+    if (hasQuote_) {
+      double e = (bid >= bid_ ? bidSize : 0.0) - (bid <= bid_ ? bidSize_ : 0.0)
+               - (ask <= ask_ ? askSize : 0.0) + (ask >= ask_ ? askSize_ : 0.0);
+      ofi_ += e;
+      ofiEwma_ += ofiAlpha_ * (e - ofiEwma_);
+    }
+
+    bid_ = bid; bidSize_ = bidSize;
+    ask_ = ask; askSize_ = askSize;
+    hasQuote_ = true;
+  }
+
+  /**
+   * @brief Applies a trade print
+   * @param price Trade price
+   * @param size Trade size
+   * @return Classified trade sign
+   */
+  TradeSign onTrade(double price, double size) noexcept {
+    if (price <= 0.0 || size <= 0.0) return TradeSign::UNKNOWN;
+
+    // --- Lee-Ready classification: quote rule, tick rule on ties ---
+    if (lastTradePrice_ > 0.0 && price != lastTradePrice_)
+      tickSign_ = price > lastTradePrice_ ? TradeSign::BUY : TradeSign::SELL;
+
+    TradeSign sign = tickSign_;
+    if (hasQuote_) {
+      double m = mid();
+      if (price > m)      sign = TradeSign::BUY;
+      else if (price < m) sign = TradeSign::SELL;
+    }
+
+    if (sign == TradeSign::BUY)       buyVolume_ += size;
+    else if (sign == TradeSign::SELL) sellVolume_ += size;
+    lastTradePrice_ = price;
+    lastSign_ = sign;
+
+    // --- Rolling VWAP (ring buffer with running sums) ---
+    Trade& slot = trades_[head_];
+    if (count_ == trades_.size()) {
+      pvSum_ -= slot.price * slot.size;
+      vSum_  -= slot.size;
+    } else {
+      ++count_;
+    }
+    slot = {price, size};
+    pvSum_ += price * size;
+    vSum_  += size;
+    head_ = (head_ + 1) % trades_.size();
+
+    // Re-anchor the running sums once per full window to bound floating-point drift
+    if (head_ == 0) recomputeSums();
+
+    return sign;
+  }
+
+  // ------------------------------------------------------------------
+  // Accessors
+  // ------------------------------------------------------------------
+
+  double mid() const noexcept { return hasQuote_ ? 0.5 * (bid_ + ask_) : 0.0; }
+
+  double microprice() const noexcept {
+    if (!hasQuote_) return 0.0;
+    double depth = bidSize_ + askSize_;
+    return depth > 0.0 ? (bid_ * askSize_ + ask_ * bidSize_) / depth : mid();
+  }
+
+  /// Top-of-book size imbalance in [-1, 1]
+  double bookImbalance() const noexcept {
+    double depth = bidSize_ + askSize_;
+    return depth > 0.0 ? (bidSize_ - askSize_) / depth : 0.0;
+  }
+
+  double ofi() const noexcept { return ofi_; }
+  double ofiEwma() const noexcept { return ofiEwma_; }
+  double vwap() const noexcept { return vSum_ > 0.0 ? pvSum_ / vSum_ : 0.0; }
+  double buyVolume() const noexcept { return buyVolume_; }
+  double sellVolume() const noexcept { return sellVolume_; }
+  double signedVolume() const noexcept { return buyVolume_ - sellVolume_; }
+  TradeSign lastSign() const noexcept { return lastSign_; }
+  size_t tradesInWindow() const noexcept { return count_; }
+
+  MicrostructureMetrics metrics() const noexcept {
+    return {mid(), microprice(), bookImbalance(), ofi_, ofiEwma_, vwap(),
+            buyVolume_, sellVolume_, lastSign_};
+  }
+
+private:
+  struct Trade {
+    double price = 0.0;
+    double size = 0.0;
+  };
+
+  void recomputeSums() noexcept {
+    pvSum_ = 0.0;
+    vSum_ = 0.0;
+    for (size_t i = 0; i < count_; ++i) {
+      pvSum_ += trades_[i].price * trades_[i].size;
+      vSum_  += trades_[i].size;
+    }
+  }
+
+  // --- Quote state ---
+  double bid_ = 0.0, bidSize_ = 0.0;
+  double ask_ = 0.0, askSize_ = 0.0;
+  bool hasQuote_ = false;
+
+  // --- Order flow ---
+  double ofi_ = 0.0;
+  double ofiEwma_ = 0.0;
+  double ofiAlpha_;
+
+  // --- Trades ---
+  std::vector<Trade> trades_;
+  size_t head_ = 0;
+  size_t count_ = 0;
+  double pvSum_ = 0.0;
+  double vSum_ = 0.0;
+  double lastTradePrice_ = 0.0;
+  TradeSign tickSign_ = TradeSign::UNKNOWN;
+  TradeSign lastSign_ = TradeSign::UNKNOWN;
+  double buyVolume_ = 0.0;
+  double sellVolume_ = 0.0;
+};
+
+/**
+ * @brief Microstructure states for all instruments, aligned with QuoteBook rows
+ *
+ * States are created lazily on the first tick of a row and reused afterwards.
+ * Row indices are the ones returned by `IB::MarketData::QuoteBook::rowFor()`;
+ * rows at or beyond `capacity` (including `QuoteBook::npos`) are ignored.
+ *
+ * The update methods (`onQuote`, `onTrade`, `reset`) must be called from a single
+ * writer thread, the IB reader thread, and take no lock. Each row carries its own
+ * sequence lock, so `get()` on any other thread returns a coherent copy and only
+ * retries while that row is being written.
+ */
+class MicrostructureBook {
+public:
+  /**
+   * @param window Rolling VWAP window (trades) for newly created states
+   * @param ofiAlpha Decayed-OFI smoothing factor for newly created states
+   * @param capacity Maximum number of rows (should match the quote book capacity)
+   */
+  explicit MicrostructureBook(size_t window = 100, double ofiAlpha = 0.05, size_t capacity = 4096)
+    : window_(window), ofiAlpha_(ofiAlpha), capacity_(capacity),
+      slots_(std::make_unique<std::atomic<Slot*>[]>(capacity)) {}
+
+  ~MicrostructureBook() {
+    for (size_t i = 0; i < capacity_; ++i) delete slots_[i].load(std::memory_order_relaxed);
+  }
+
+  MicrostructureBook(const MicrostructureBook&) = delete;
+  MicrostructureBook& operator=(const MicrostructureBook&) = delete;
+
+  /// Applies a quote update to `row` (writer thread)
+  void onQuote(size_t row, double bid, double bidSize, double ask, double askSize) {
+    Slot* s = slot(row);
+    if (!s) return;
+    s->beginWrite();
+    s->state.onQuote(bid, bidSize, ask, askSize);
+    s->endWrite();
+  }
+
+  /// Applies a trade print to `row` (writer thread)
+  TradeSign onTrade(size_t row, double price, double size) {
+    Slot* s = slot(row);
+    if (!s) return TradeSign::UNKNOWN;
+    s->beginWrite();
+    TradeSign sign = s->state.onTrade(price, size);
+    s->endWrite();
+    return sign;
+  }
+
+  /// Forgets the state of `row`, e.g. when its ticker ID is reused (writer thread)
+  void reset(size_t row) {
+    if (row >= capacity_) return;
+    Slot* s = slots_[row].load(std::memory_order_relaxed);
+    if (!s) return;
+    MicrostructureState fresh(window_, ofiAlpha_);
+    s->beginWrite();
+    s->state = std::move(fresh);
+    s->endWrite();
+  }
+
+  /**
+   * @brief Returns the current metrics of `row` (all zero if the row never ticked)
+   */
+  MicrostructureMetrics get(size_t row) const {
+    if (row >= capacity_) return {};
+    const Slot* s = slots_[row].load(std::memory_order_acquire);
+    if (!s) return {};
+    for (;;) {
+      uint64_t s0 = s->seq.load(std::memory_order_acquire);
+      if (s0 & 1) continue;
+      MicrostructureMetrics m = s->state.metrics();
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (s->seq.load(std::memory_order_relaxed) == s0) return m;
+    }
+  }
+
+private:
+  struct Slot {
+    Slot(size_t window, double ofiAlpha) : state(window, ofiAlpha) {}
+
+    void beginWrite() noexcept {
+      seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void endWrite() noexcept {
+      seq.store(seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    std::atomic<uint64_t> seq{0};   ///< Sequence lock (odd while writing)
+    MicrostructureState state;
+  };
+
+  /// Slot of `row`, created and published on first use; nullptr if out of range
+  Slot* slot(size_t row) {
+    if (row >= capacity_) return nullptr;
+    Slot* s = slots_[row].load(std::memory_order_relaxed);
+    if (!s) {
+      s = new Slot(window_, ofiAlpha_);
+      slots_[row].store(s, std::memory_order_release);
+    }
+    return s;
+  }
+
+  size_t window_;
+  double ofiAlpha_;
+  size_t capacity_;
+  std::unique_ptr<std::atomic<Slot*>[]> slots_;   ///< One lazily created slot per quote book row
+};
+
+} // namespace IB::Analytics
+
+#endif  // QUANTDREAMCPP_MICROSTRUCTURE_H
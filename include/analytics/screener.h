@@ -0,0 +1,349 @@
+#ifndef QUANTDREAMCPP_SCREENER_H
+#define QUANTDREAMCPP_SCREENER_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "data_structures/quote_book.h"
+#include "helpers/simd.h"
+#include "helpers/thread_pool.h"
+
+/**
+ * @file screener.h
+ * @brief Cross-sectional filter / rank / top-K queries over the quote book
+ *
+ * The screener derives a small feature matrix (mid, spread, return, relative
+ * volume, ...) from a `QuoteBook::Columns` copy plus any indicator columns the
+ * caller attaches, evaluates vectorized predicates over it, and returns the
+ * best K instruments by a ranking metric.
+ *
+ * **Incremental evaluation**
+ * - Derived features, filter outcome and score are cached per row
+ * - A run only re-evaluates rows whose quote book version moved since the previous
+ *   run, unless the query changed or an attached column was touched
+ * - Full sweeps (first run, new query, touched columns) are split across the pool
+ *   and use SIMD predicates; top-K is a per-chunk partial sort followed by a merge
+ */
+
+namespace IB::Analytics {
+
+/**
+ * @brief Features available to screen predicates and ranking
+ */
+enum class Metric : uint8_t {
+  BID = 0,
+  ASK,
+  LAST,
+  MID,          ///< (bid + ask) / 2, or last when the quote is one-sided
+  SPREAD_BPS,   ///< (ask - bid) / mid in basis points
+  RETURN,       ///< last / close - 1 (session return)
+  VOLUME,       ///< Cumulative session volume
+  REL_VOLUME,   ///< volume / attached AVG_VOLUME column
+  VOLATILITY,   ///< Attached column (e.g. BatchRollingStats stddev)
+  AVG_VOLUME,   ///< Attached column (e.g. historical average daily volume)
+  CUSTOM_0,     ///< Attached user column
+  CUSTOM_1,     ///< Attached user column
+  COUNT
+};
+
+/**
+ * @brief Comparison applied by a predicate
+ */
+enum class CompareOp : uint8_t { GT, LT, BETWEEN };
+
+/**
+ * @brief Single filter condition: `metric op lo [hi]`
+ *
+ * BETWEEN is inclusive of neither bound: `lo < value < hi`.
+ */
+struct Predicate {
+  Metric metric;
+  CompareOp op;
+  double lo = 0.0;
+  double hi = 0.0;
+
+  bool operator==(const Predicate&) const = default;
+};
+
+/**
+ * @brief Filter + rank + top-K query
+ *
+ * Example usage:
+ * @code
+ * IB::Analytics::ScreenQuery q;
+ * q.filters = {{Metric::LAST, CompareOp::GT, 5.0},
+ *              {Metric::SPREAD_BPS, CompareOp::LT, 20.0}};
+ * q.rankBy = Metric::RETURN;
+ * q.descending = true;   // top gainers
+ * q.topK = 25;
+ * @endcode
+ */
+struct ScreenQuery {
+  std::vector<Predicate> filters;
+  Metric rankBy = Metric::RETURN;
+  bool descending = true;
+  size_t topK = 20;
+
+  bool operator==(const ScreenQuery&) const = default;
+};
+
+/**
+ * @brief One ranked instrument
+ */
+struct ScreenHit {
+  size_t row = 0;     ///< Quote book row
+  int tickerId = -1;  ///< Market data request ID
+  double score = 0.0; ///< Value of the ranking metric
+};
+
+/**
+ * @brief Output of a screen run
+ */
+struct ScreenResult {
+  std::vector<ScreenHit> hits;  ///< Best `topK` rows, best first
+  size_t passed = 0;            ///< Rows that passed all filters
+  size_t evaluated = 0;         ///< Rows re-evaluated in this run
+  uint64_t sequence = 0;        ///< Quote book sequence the run is based on
+};
+
+/**
+ * @brief Incremental, parallel cross-sectional screener
+ *
+ * Not thread-safe: one screener per screening thread. Attached columns must have at
+ * least `capacity` entries and stay valid while attached.
+ */
+class Screener {
+public:
+  /**
+   * @param capacity Maximum number of rows (normally `QuoteBook::capacity()`)
+   * @param pool Optional pool for full sweeps (nullptr = run on the calling thread)
+   * @param grain Rows per parallel chunk
+   */
+  explicit Screener(size_t capacity, IB::Helpers::ThreadPool* pool = nullptr, size_t grain = 1024)
+    : capacity_(capacity), pool_(pool), grain_(grain == 0 ? 1 : grain),
+      pass_(capacity, 0), score_(capacity, 0.0) {
+    for (auto& f : features_) f.assign(capacity, 0.0);
+    external_.fill(nullptr);
+  }
+
+  /**
+   * @brief Attaches an external column (indicator output, average volume, ...)
+   *
+   * Only VOLATILITY, AVG_VOLUME and CUSTOM_* can be attached.
+   */
+  void attach(Metric metric, const double* values) {
+    external_[idx(metric)] = values;
+    fullSweep_ = true;
+  }
+
+  /// Signals that attached columns were updated; the next run re-evaluates every row
+  void touch() noexcept { fullSweep_ = true; }
+
+  /**
+   * @brief Runs a query against a quote book copy
+   */
+  ScreenResult run(const IB::MarketData::QuoteBook::Columns& cols, const ScreenQuery& q) {
+    const size_t n = std::min(cols.rows, capacity_);
+    ScreenResult out;
+    out.sequence = cols.sequence;
+
+    if (!(q == lastQuery_) || n < rows_) fullSweep_ = true;
+    lastQuery_ = q;
+
+    if (fullSweep_ || n > rows_) {
+      // New rows only ever appear at the end; treat them as changed
+      if (fullSweep_) {
+        auto body = [&](size_t b, size_t e) { deriveRange(cols, b, e); evaluateRange(q, b, e); };
+        if (pool_) pool_->parallelFor(n, grain_, body);
+        else body(0, n);
+        out.evaluated = n;
+      } else {
+        deriveRange(cols, rows_, n);
+        evaluateRange(q, rows_, n);
+        out.evaluated = n - rows_;
+        out.evaluated += evaluateChanged(cols, q, rows_);
+      }
+    } else {
+      out.evaluated = evaluateChanged(cols, q, n);
+    }
+
+    rows_ = n;
+    lastSequence_ = cols.sequence;
+    fullSweep_ = false;
+
+    collectTopK(cols, q, n, out);
+    return out;
+  }
+
+  /// Cached value of a derived feature for a row (valid after a run)
+  double feature(Metric m, size_t row) const noexcept { return features_[idx(m)][row]; }
+
+private:
+  static constexpr size_t idx(Metric m) noexcept { return static_cast<size_t>(m); }
+
+  /// Value column for a metric: attached pointer if present, otherwise the derived feature
+  const double* source(Metric m) const noexcept {
+    const double* ext = external_[idx(m)];
+    return ext ? ext : features_[idx(m)].data();
+  }
+
+  /// Recomputes the quote-derived features of rows [b, e)
+  void deriveRange(const IB::MarketData::QuoteBook::Columns& cols, size_t b, size_t e) noexcept {
+    namespace Simd = IB::Helpers::Simd;
+    using Book = IB::MarketData::QuoteBook;
+    const double* bid = cols.column(Book::BID);
+    const double* ask = cols.column(Book::ASK);
+    const double* last = cols.column(Book::LAST);
+    const double* close = cols.column(Book::CLOSE);
+    const double* vol = cols.column(Book::VOLUME);
+    const double* avgVol = external_[idx(Metric::AVG_VOLUME)];
+
+    double* fBid = features_[idx(Metric::BID)].data();
+    double* fAsk = features_[idx(Metric::ASK)].data();
+    double* fLast = features_[idx(Metric::LAST)].data();
+    double* fMid = features_[idx(Metric::MID)].data();
+    double* fSpread = features_[idx(Metric::SPREAD_BPS)].data();
+    double* fRet = features_[idx(Metric::RETURN)].data();
+    double* fVol = features_[idx(Metric::VOLUME)].data();
+    double* fRel = features_[idx(Metric::REL_VOLUME)].data();
+
+    Simd::forEach(e - b, [&]<typename V>(size_t k) {
+      const size_t i = b + k;
+      V zero = Simd::broadcast<V>(0.0);
+      V vb = Simd::loadAs<V>(bid + i);
+      V va = Simd::loadAs<V>(ask + i);
+      V vl = Simd::loadAs<V>(last + i);
+      V vc = Simd::loadAs<V>(close + i);
+      V vv = Simd::loadAs<V>(vol + i);
+
+      V twoSided = Simd::blend(zero, Simd::cmpgt(va, zero), Simd::cmpgt(vb, zero));
+      V mid = Simd::mul(Simd::add(vb, va), Simd::broadcast<V>(0.5));
+      mid = Simd::blend(vl, mid, twoSided);
+      V safeMid = Simd::blend(Simd::broadcast<V>(1.0), mid, Simd::cmpgt(mid, zero));
+      V spread = Simd::mul(Simd::div(Simd::sub(va, vb), safeMid), Simd::broadcast<V>(1e4));
+      spread = Simd::blend(Simd::broadcast<V>(1e9), spread, twoSided);   // one-sided quotes never pass "tight spread"
+
+      V hasClose = Simd::cmpgt(vc, zero);
+      V safeClose = Simd::blend(Simd::broadcast<V>(1.0), vc, hasClose);
+      V ret = Simd::sub(Simd::div(vl, safeClose), Simd::broadcast<V>(1.0));
+      ret = Simd::blend(zero, ret, Simd::blend(zero, hasClose, Simd::cmpgt(vl, zero)));
+
+      Simd::store(fBid + i, vb);
+      Simd::store(fAsk + i, va);
+      Simd::store(fLast + i, vl);
+      Simd::store(fMid + i, mid);
+      Simd::store(fSpread + i, spread);
+      Simd::store(fRet + i, ret);
+      Simd::store(fVol + i, vv);
+
+      if (avgVol) {
+        V av = Simd::loadAs<V>(avgVol + i);
+        V hasAvg = Simd::cmpgt(av, zero);
+        V rel = Simd::div(vv, Simd::blend(Simd::broadcast<V>(1.0), av, hasAvg));
+        Simd::store(fRel + i, Simd::blend(zero, rel, hasAvg));
+      } else {
+        Simd::store(fRel + i, zero);
+      }
+    });
+  }
+
+  /// Evaluates filters and score for rows [b, e) with vectorized predicates
+  void evaluateRange(const ScreenQuery& q, size_t b, size_t e) {
+    namespace Simd = IB::Helpers::Simd;
+    // score_ doubles as the filter mask until the final pass; chunks never overlap
+    double* mask = score_.data();
+    std::fill(mask + b, mask + e, 1.0);
+
+    for (const auto& p : q.filters) {
+      const double* x = source(p.metric);
+      Simd::forEach(e - b, [&]<typename V>(size_t k) {
+        const size_t i = b + k;
+        V v = Simd::loadAs<V>(x + i);
+        V ok;
+        switch (p.op) {
+          case CompareOp::GT: ok = Simd::cmpgt(v, Simd::broadcast<V>(p.lo)); break;
+          case CompareOp::LT: ok = Simd::cmpgt(Simd::broadcast<V>(p.lo), v); break;
+          default:
+            ok = Simd::blend(Simd::broadcast<V>(0.0), Simd::cmpgt(Simd::broadcast<V>(p.hi), v),
+                             Simd::cmpgt(v, Simd::broadcast<V>(p.lo)));
+            break;
+        }
+        V m = Simd::loadAs<V>(mask + i);
+        Simd::store(mask + i, Simd::blend(Simd::broadcast<V>(0.0), m, ok));
+      });
+    }
+
+    const double* rank = source(q.rankBy);
+    for (size_t i = b; i < e; ++i) {
+      pass_[i] = mask[i] != 0.0;
+      score_[i] = rank[i];
+    }
+  }
+
+  /// Scalar re-evaluation of rows whose version moved since the last run
+  size_t evaluateChanged(const IB::MarketData::QuoteBook::Columns& cols, const ScreenQuery& q, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+      if (cols.version[i] <= lastSequence_) continue;
+      deriveRange(cols, i, i + 1);
+      evaluateRange(q, i, i + 1);
+      ++count;
+    }
+    return count;
+  }
+
+  /// Per-chunk partial sort, then merge of the chunk winners
+  void collectTopK(const IB::MarketData::QuoteBook::Columns& cols, const ScreenQuery& q,
+                   size_t n, ScreenResult& out) {
+    const size_t k = q.topK;
+    auto better = [&](const ScreenHit& a, const ScreenHit& b) {
+      return q.descending ? a.score > b.score : a.score < b.score;
+    };
+
+    const size_t chunks = (n + grain_ - 1) / grain_;
+    std::vector<std::vector<ScreenHit>> partial(chunks);
+    std::vector<size_t> passed(chunks, 0);
+
+    auto body = [&](size_t b, size_t e) {
+      auto& local = partial[b / grain_];
+      for (size_t i = b; i < e; ++i)
+        if (pass_[i]) local.push_back({i, cols.tickerIds[i], score_[i]});
+      passed[b / grain_] = local.size();
+      if (local.size() > k) {
+        std::nth_element(local.begin(), local.begin() + k, local.end(), better);
+        local.resize(k);
+      }
+    };
+    if (pool_ && chunks > 1) pool_->parallelFor(n, grain_, body);
+    else for (size_t c = 0; c < chunks; ++c) body(c * grain_, std::min(n, (c + 1) * grain_));
+
+    for (size_t c = 0; c < chunks; ++c) {
+      out.passed += passed[c];
+      out.hits.insert(out.hits.end(), partial[c].begin(), partial[c].end());
+    }
+    const size_t keep = std::min(k, out.hits.size());
+    std::partial_sort(out.hits.begin(), out.hits.begin() + keep, out.hits.end(), better);
+    out.hits.resize(keep);
+  }
+
+  size_t capacity_;
+  IB::Helpers::ThreadPool* pool_;
+  size_t grain_;
+
+  std::array<std::vector<double>, static_cast<size_t>(Metric::COUNT)> features_;  ///< Derived feature columns
+  std::array<const double*, static_cast<size_t>(Metric::COUNT)> external_{};       ///< Attached columns
+  std::vector<uint8_t> pass_;   ///< Cached filter outcome per row
+  std::vector<double> score_;   ///< Cached ranking value per row
+
+  ScreenQuery lastQuery_;
+  uint64_t lastSequence_ = 0;
+  size_t rows_ = 0;
+  bool fullSweep_ = true;
+};
+
+} // namespace IB::Analytics
+
+#endif  // QUANTDREAMCPP_SCREENER_H
@@ -0,0 +1,301 @@
+#ifndef QUANTDREAMCPP_BACKTEST_H
+#define QUANTDREAMCPP_BACKTEST_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "backtest/fill_model.h"
+#include "backtest/tick_tape.h"
+#include "helpers/clock.h"
+#include "helpers/thread_pool.h"
+#include "strategy/order_execution.h"
+#include "strategy/strategy_base.h"
+#include "wrappers/IBStrategyWrapper.h"
+
+/**
+ * @file backtest.h
+ * @brief Event-driven backtests of the live strategy stack on a virtual clock
+ *
+ * Each run builds its own `IBStrategyWrapper` with a `PositionManager` attached and
+ * delivers the tape through the wrapper's `tickPrice` / `tickSize` handlers, so quote
+ * filtering, the quote book, microstructure analytics and PositionManager subscribers
+ * behave as in a live session. Orders the strategy pushes to the order queue (the queue
+ * an `OrderExecutor` consumes live) are drained after every tick and routed to a
+ * `FillModel` instead of TWS.
+ *
+ * **Time** is a `VirtualClock` installed on the run's thread and advanced to each tick's
+ * timestamp, so throttles and staleness checks see recorded time and the run proceeds
+ * as fast as the CPU allows.
+ *
+ * **Determinism**: a run executes entirely on one thread and depends only on the tape,
+ * the options and the strategy, so `runParallel` returns the same results for any
+ * number of threads.
+ */
+
+namespace IB::Backtest {
+
+  struct BacktestOptions {
+    FillModelOptions fills;
+  };
+
+  /**
+   * @brief What a strategy under test is wired to
+   *
+   * Strategies subscribe to `positions` as they would live and push orders to `orders`;
+   * `contract` of an OrderRequest selects the instrument (by conId, else by symbol).
+   */
+  struct BacktestContext {
+    IBStrategyWrapper& ib;                                   ///< Receives the tape's ticks
+    PositionManager& positions;                              ///< Attached to `ib`
+    std::shared_ptr<ConcurrentQueue<OrderRequest>> orders;   ///< Drained after every tick
+    const IB::Helpers::VirtualClock& clock;
+    std::function<void(const Fill&)> onFill;                 ///< Optional, set by the strategy
+  };
+
+  /// Final state of one instrument
+  struct InstrumentResult {
+    int tickerId = 0;
+    double position = 0.0;
+    double avgCost = 0.0;          ///< Per unit, including the contract multiplier
+    double realizedPnl = 0.0;
+    double unrealizedPnl = 0.0;    ///< Marked at the last mid (or last trade)
+    double commission = 0.0;
+  };
+
+  struct BacktestResult {
+    uint64_t ticks = 0;
+    uint64_t orders = 0;           ///< Orders accepted by the fill model
+    uint64_t rejected = 0;         ///< Unknown instrument or unsupported order type
+    std::vector<Fill> fills;
+    std::vector<InstrumentResult> instruments;
+    double elapsedSeconds = 0.0;
+
+    double realizedPnl() const { return sum(&InstrumentResult::realizedPnl); }
+    double unrealizedPnl() const { return sum(&InstrumentResult::unrealizedPnl); }
+    double commission() const { return sum(&InstrumentResult::commission); }
+    double netPnl() const { return realizedPnl() + unrealizedPnl() - commission(); }
+    double ticksPerSecond() const { return elapsedSeconds > 0 ? static_cast<double>(ticks) / elapsedSeconds : 0.0; }
+
+  private:
+    double sum(double InstrumentResult::*field) const {
+      double total = 0.0;
+      for (const auto& i : instruments) total += i.*field;
+      return total;
+    }
+  };
+
+  /**
+   * @brief Runs strategies over a TickTape
+   *
+   * Example usage:
+   * @code
+   * IB::Backtest::Backtest backtest(tape, {.fills = {.latencyNs = 2'000'000}});
+   *
+   * std::vector<double> thresholds = {0.01, 0.02, 0.05};
+   * auto results = backtest.runParallel(thresholds, pool, [](IB::Backtest::BacktestContext& ctx, double t) {
+   *     return std::make_unique<MeanReversion>(ctx, t);
+   * });
+   * for (const auto& r : results) LOG_INFO("net PnL ", r.netPnl());
+   * @endcode
+   */
+  class Backtest {
+  public:
+    using StrategyFactory = std::function<std::unique_ptr<StrategyBase>(BacktestContext&)>;
+
+    explicit Backtest(const TickTape& tape) : Backtest(tape, BacktestOptions{}) {}
+    Backtest(const TickTape& tape, BacktestOptions options) : tape_(tape), options_(options) {}
+
+    /// Runs one strategy over the whole tape on the calling thread
+    BacktestResult run(const StrategyFactory& make) const {
+      const auto wallStart = std::chrono::steady_clock::now();
+      BacktestResult result;
+
+      IB::Helpers::VirtualClock clock;
+      IB::Helpers::ScopedVirtualClock scope(clock);
+      if (!tape_.empty()) clock.reset(tape_.ticks().front().tick.timestampNs);
+
+      IBStrategyWrapper ib;
+      PositionManager positions;
+      ib.setPositionManager(&positions);
+      for (const auto& i : tape_.instruments()) {
+        ib.reqIdToContract[i.tickerId] = i.contract;
+        auto& snap = ib.snapshotData[i.tickerId];
+        snap.mode = IB::MarketData::PriceType::QUOTES_ONLY;
+        snap.streaming = true;
+      }
+
+      Book book(tape_.instruments());
+      FillModel fills(options_.fills);
+      BacktestContext ctx{ib, positions, std::make_shared<ConcurrentQueue<OrderRequest>>(), clock, {}};
+      fills.setOnFill([&](const Fill& f) {
+        book.apply(f);
+        result.fills.push_back(f);
+        if (ctx.onFill) ctx.onFill(f);
+      });
+
+      auto strategy = make(ctx);
+      if (!strategy) return result;
+      strategy->start();
+
+      const TickAttrib attrib;
+      for (const auto& t : tape_.ticks()) {
+        const int64_t now = t.tick.timestampNs;
+        clock.advanceTo(now);
+        fills.advance(now);   // orders that arrived since the last tick see the book as it was
+        deliver(ib, t, attrib);
+        fills.onPrice(t.tickerId, t.tick.field, t.tick.price, now);
+        if (drain(*ctx.orders, fills, book, result, now)) fills.advance(now);
+        ++result.ticks;
+      }
+      strategy->stop();
+      drain(*ctx.orders, fills, book, result, clock.nowNs());
+
+      result.instruments = book.results(fills);
+      result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+      return result;
+    }
+
+    /**
+     * @brief Runs one backtest per parameter set, spread over the pool
+     *
+     * @param make Called as `make(BacktestContext&, const Params&)` on the run's thread
+     * @return Results in the order of `sets`
+     */
+    template <typename Params, typename Factory>
+    std::vector<BacktestResult> runParallel(const std::vector<Params>& sets, IB::Helpers::ThreadPool& pool,
+                                            Factory make) const {
+      std::vector<BacktestResult> results(sets.size());
+      pool.parallelFor(sets.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+          results[i] = run([&](BacktestContext& ctx) -> std::unique_ptr<StrategyBase> { return make(ctx, sets[i]); });
+      });
+      return results;
+    }
+
+  private:
+    /// Positions and marks per instrument
+    class Book {
+    public:
+      explicit Book(const std::vector<TapeInstrument>& instruments) {
+        for (const auto& i : instruments) {
+          Entry e;
+          e.result.tickerId = i.tickerId;
+          e.multiplier = i.contract.multiplier.empty() ? 1.0 : std::stod(i.contract.multiplier);
+          if (i.contract.conId) byConId_[i.contract.conId] = i.tickerId;
+          if (!i.contract.symbol.empty()) bySymbol_.emplace(i.contract.symbol + "|" + i.contract.secType, i.tickerId);
+          index_[i.tickerId] = entries_.size();
+          entries_.push_back(e);
+        }
+      }
+
+      /// Ticker ID of an order's contract, or 0
+      int tickerOf(const Contract& c) const {
+        if (auto it = byConId_.find(c.conId); c.conId && it != byConId_.end()) return it->second;
+        if (auto it = bySymbol_.find(c.symbol + "|" + c.secType); it != bySymbol_.end()) return it->second;
+        return 0;
+      }
+
+      void apply(const Fill& f) {
+        auto& e = entries_[index_.at(f.tickerId)];
+        auto& r = e.result;
+        const double qty = f.side * f.quantity;
+        const double value = f.price * e.multiplier;
+        if (r.position == 0.0 || (r.position > 0) == (qty > 0)) {
+          r.avgCost = (r.avgCost * std::abs(r.position) + value * f.quantity) / (std::abs(r.position) + f.quantity);
+        } else {
+          const double closed = std::min(std::abs(qty), std::abs(r.position));
+          r.realizedPnl += closed * (value - r.avgCost) * (r.position > 0 ? 1.0 : -1.0);
+          if (std::abs(qty) > std::abs(r.position)) r.avgCost = value;   // flipped through zero
+        }
+        r.position += qty;
+        if (r.position == 0.0) r.avgCost = 0.0;
+        r.commission += f.commission;
+      }
+
+      std::vector<InstrumentResult> results(FillModel& fills) const {
+        std::vector<InstrumentResult> out;
+        for (const auto& e : entries_) {
+          auto r = e.result;
+          const double mark = fills.quote(r.tickerId).mark();
+          if (r.position != 0.0 && mark > 0.0) r.unrealizedPnl = r.position * (mark * e.multiplier - r.avgCost);
+          out.push_back(r);
+        }
+        return out;
+      }
+
+    private:
+      struct Entry {
+        InstrumentResult result;
+        double multiplier = 1.0;
+      };
+
+      std::vector<Entry> entries_;
+      std::unordered_map<int, size_t> index_;
+      std::unordered_map<long, int> byConId_;
+      std::unordered_map<std::string, int> bySymbol_;
+    };
+
+    static bool isSizeField(int field) {
+      switch (field) {
+        case BID_SIZE: case ASK_SIZE: case LAST_SIZE: case VOLUME:
+        case DELAYED_BID_SIZE: case DELAYED_ASK_SIZE: case DELAYED_LAST_SIZE: case DELAYED_VOLUME:
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    /// Size field paired with a price field (historical ticks carry both in one record)
+    static int sizeFieldOf(int field) {
+      switch (field) {
+        case BID: return BID_SIZE;
+        case ASK: return ASK_SIZE;
+        case LAST: return LAST_SIZE;
+        default: return -1;
+      }
+    }
+
+    static void deliver(IBStrategyWrapper& ib, const TapeTick& t, const TickAttrib& attrib) {
+      const int field = t.tick.field;
+      if (field < 0) return;   // archive MIDPOINT records have no tick type
+      if (isSizeField(field)) {
+        ib.tickSize(t.tickerId, static_cast<TickType>(field), DecimalFunctions::doubleToDecimal(t.tick.size));
+        return;
+      }
+      ib.tickPrice(t.tickerId, static_cast<TickType>(field), t.tick.price, attrib);
+      if (const int sizeField = sizeFieldOf(field); sizeField >= 0 && t.tick.size > 0.0)
+        ib.tickSize(t.tickerId, static_cast<TickType>(sizeField), DecimalFunctions::doubleToDecimal(t.tick.size));
+    }
+
+    /// Routes queued orders to the fill model; true if any was accepted
+    static bool drain(ConcurrentQueue<OrderRequest>& orders, FillModel& fills, const Book& book,
+                      BacktestResult& result, int64_t now) {
+      bool accepted = false;
+      while (!orders.empty()) {
+        OrderRequest req = orders.pop();
+        const int tickerId = book.tickerOf(req.contract);
+        if (tickerId == 0 || fills.submit(tickerId, req.order, req.localId, now) == 0) {
+          if (tickerId == 0) LOG_WARN("[Backtest] No instrument for order on ", req.contract.symbol);
+          ++result.rejected;
+          continue;
+        }
+        ++result.orders;
+        accepted = true;
+      }
+      return accepted;
+    }
+
+    const TickTape& tape_;
+    BacktestOptions options_;
+  };
+
+}  // namespace IB::Backtest
+
+#endif  // QUANTDREAMCPP_BACKTEST_H
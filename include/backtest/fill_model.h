@@ -0,0 +1,200 @@
+#ifndef QUANTDREAMCPP_FILL_MODEL_H
+#define QUANTDREAMCPP_FILL_MODEL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "EWrapper.h"
+#include "Order.h"
+#include "helpers/logger.h"
+
+/**
+ * @file fill_model.h
+ * @brief Top-of-book fill simulation for backtests
+ *
+ * Orders reach the simulated market `latencyNs` after submission. From then on:
+ * - MKT orders fill in full at the opposite touch (ask for BUY, bid for SELL) as soon
+ *   as that side is quoted
+ * - LMT orders that are marketable on arrival fill at the opposite touch; otherwise they
+ *   rest and fill at their limit once the opposite touch reaches it or a trade prints
+ *   through it
+ *
+ * Orders are matched in submission order and fills are full size, so results depend
+ * only on the tick sequence and the orders.
+ */
+
+namespace IB::Backtest {
+
+  /// One simulated execution
+  struct Fill {
+    int orderId = 0;            ///< Fill model order ID (submission order, from 1)
+    int localId = 0;            ///< OrderRequest::localId of the order
+    int tickerId = 0;
+    int64_t timestampNs = 0;    ///< Virtual time of the fill
+    int side = 0;               ///< +1 buy, -1 sell
+    double quantity = 0.0;
+    double price = 0.0;
+    double commission = 0.0;
+  };
+
+  struct FillModelOptions {
+    int64_t latencyNs = 0;              ///< Submission → arrival at the simulated market
+    double commissionPerShare = 0.0;
+    double minCommission = 0.0;         ///< Per fill
+    bool fillOnTradeThrough = true;     ///< Resting limits also fill on trades through the limit
+  };
+
+  /**
+   * @brief Matches submitted orders against the tape's quotes and trades
+   *
+   * Driven by the backtest thread only; not thread-safe.
+   */
+  class FillModel {
+  public:
+    using FillFn = std::function<void(const Fill&)>;
+
+    FillModel() : FillModel(FillModelOptions{}) {}
+    explicit FillModel(FillModelOptions options) : options_(options) {}
+
+    /// Receives every fill
+    void setOnFill(FillFn fn) { onFill_ = std::move(fn); }
+
+    /**
+     * @brief Queues an order for `tickerId`
+     *
+     * @return Fill model order ID, or 0 if the order is not a supported MKT / LMT order
+     */
+    int submit(int tickerId, const Order& order, int localId, int64_t nowNs) {
+      const int side = order.action == "BUY" ? 1 : order.action == "SELL" || order.action == "SSHORT" ? -1 : 0;
+      const double quantity = DecimalFunctions::decimalToDouble(order.totalQuantity);
+      const bool market = order.orderType == "MKT";
+      const bool limit = order.orderType == "LMT" && order.lmtPrice != UNSET_DOUBLE;
+      if (side == 0 || quantity <= 0.0 || (!market && !limit)) {
+        LOG_WARN("[FillModel] Rejected ", order.action, " ", order.orderType, " order (localId=", localId, ")");
+        return 0;
+      }
+      Pending p;
+      p.orderId = ++nextOrderId_;
+      p.localId = localId;
+      p.tickerId = tickerId;
+      p.side = side;
+      p.quantity = quantity;
+      p.market = market;
+      p.limit = order.lmtPrice;
+      p.arrivalNs = nowNs + options_.latencyNs;
+      pending_.push_back(p);
+      return p.orderId;
+    }
+
+    /// Removes an unfilled order; false if it already filled or is unknown
+    bool cancel(int orderId) {
+      return std::erase_if(pending_, [orderId](const Pending& p) { return p.orderId == orderId; }) > 0;
+    }
+
+    /// Matches orders that have arrived by `nowNs` against the current quotes
+    void advance(int64_t nowNs) {
+      if (pending_.empty()) return;
+      match(nowNs, [](const Pending&) { return true; });
+    }
+
+    /**
+     * @brief Applies a price tick, then matches the orders of its instrument
+     */
+    void onPrice(int tickerId, int field, double price, int64_t nowNs) {
+      Quote& q = quotes_[tickerId];
+      double trade = 0.0;
+      switch (field) {
+        case BID: case DELAYED_BID: q.bid = price; break;
+        case ASK: case DELAYED_ASK: q.ask = price; break;
+        case LAST: case DELAYED_LAST: q.last = price; trade = price; break;
+        default: return;
+      }
+      if (pending_.empty()) return;
+      match(nowNs, [&](const Pending& p) { return p.tickerId == tickerId; }, trade);
+    }
+
+    struct Quote {
+      double bid = 0.0;
+      double ask = 0.0;
+      double last = 0.0;
+
+      /// Mid if both sides are quoted, else last
+      double mark() const noexcept { return bid > 0.0 && ask > 0.0 ? (bid + ask) / 2.0 : last; }
+    };
+
+    const Quote& quote(int tickerId) { return quotes_[tickerId]; }
+    size_t openOrders() const noexcept { return pending_.size(); }
+
+  private:
+    struct Pending {
+      int orderId = 0;
+      int localId = 0;
+      int tickerId = 0;
+      int side = 0;
+      double quantity = 0.0;
+      bool market = false;
+      double limit = 0.0;
+      int64_t arrivalNs = 0;
+      bool resting = false;     ///< Arrived and not marketable on arrival
+    };
+
+    /// Price at which `p` fills now, or 0
+    double fillPrice(Pending& p, const Quote& q, double trade) const {
+      const double touch = p.side > 0 ? q.ask : q.bid;
+      if (p.market) return touch;
+      if (!p.resting) {
+        p.resting = true;
+        if (touch > 0.0 && (p.side > 0 ? touch <= p.limit : touch >= p.limit)) return touch;
+        return 0.0;
+      }
+      if (touch > 0.0 && (p.side > 0 ? touch <= p.limit : touch >= p.limit)) return p.limit;
+      if (options_.fillOnTradeThrough && trade > 0.0 && (p.side > 0 ? trade < p.limit : trade > p.limit))
+        return p.limit;
+      return 0.0;
+    }
+
+    template <typename Selected>
+    void match(int64_t nowNs, Selected&& selected, double trade = 0.0) {
+      for (auto it = pending_.begin(); it != pending_.end();) {
+        if (it->arrivalNs > nowNs || !selected(*it)) {
+          ++it;
+          continue;
+        }
+        const double price = fillPrice(*it, quotes_[it->tickerId], trade);
+        if (price <= 0.0) {
+          ++it;
+          continue;
+        }
+        Fill f;
+        f.orderId = it->orderId;
+        f.localId = it->localId;
+        f.tickerId = it->tickerId;
+        f.timestampNs = nowNs;
+        f.side = it->side;
+        f.quantity = it->quantity;
+        f.price = price;
+        f.commission = std::max(options_.minCommission, options_.commissionPerShare * it->quantity);
+        it = pending_.erase(it);
+        fills_.push_back(f);
+      }
+      // Callbacks run after matching, so they may submit or cancel orders
+      for (const auto& f : fills_)
+        if (onFill_) onFill_(f);
+      fills_.clear();
+    }
+
+    FillModelOptions options_;
+    FillFn onFill_;
+    std::vector<Pending> pending_;                  ///< Open orders in submission order
+    std::unordered_map<int, Quote> quotes_;         ///< Current touch by ticker ID
+    std::vector<Fill> fills_;                       ///< Fills of the current match pass
+    int nextOrderId_ = 0;
+  };
+
+}  // namespace IB::Backtest
+
+#endif  // QUANTDREAMCPP_FILL_MODEL_H
@@ -0,0 +1,131 @@
+#ifndef QUANTDREAMCPP_TICK_TAPE_H
+#define QUANTDREAMCPP_TICK_TAPE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Contract.h"
+#include "helpers/logger.h"
+#include "replay/record_format.h"
+#include "storage/archive_query.h"
+
+/**
+ * @file tick_tape.h
+ * @brief In-memory, time-ordered tick sequence that backtests run over
+ *
+ * A tape is loaded once and then shared read-only by every backtest run, so many
+ * parameter sets can replay the same ticks in parallel without touching the disk again.
+ * Ticks are addressed by ticker ID, the same key the market data callbacks use.
+ */
+
+namespace IB::Backtest {
+
+  /// One tick of the tape
+  struct TapeTick {
+    int tickerId = 0;
+    IB::Storage::TickRecord tick;      ///< Price ticks have size 0, size ticks price 0
+  };
+
+  /// Instrument of a tape: the ticker ID its ticks are delivered under
+  struct TapeInstrument {
+    int tickerId = 0;                  ///< Nonzero; unique within the tape
+    Contract contract;
+  };
+
+  /**
+   * @brief Ticks of several instruments in timestamp order
+   *
+   * Example usage:
+   * @code
+   * IB::Storage::TickArchiveReader reader("/data/ticks");
+   * IB::Helpers::ThreadPool pool;
+   * auto tape = IB::Backtest::TickTape::fromArchive(reader, pool, {{1, aapl}, {2, msft}}, from, to);
+   * @endcode
+   */
+  class TickTape {
+  public:
+    TickTape() = default;
+
+    TickTape(std::vector<TapeInstrument> instruments, std::vector<TapeTick> ticks)
+        : instruments_(std::move(instruments)), ticks_(std::move(ticks)) {
+      std::stable_sort(ticks_.begin(), ticks_.end(), [](const TapeTick& a, const TapeTick& b) {
+        return a.tick.timestampNs < b.tick.timestampNs;
+      });
+    }
+
+    const std::vector<TapeInstrument>& instruments() const noexcept { return instruments_; }
+    const std::vector<TapeTick>& ticks() const noexcept { return ticks_; }
+    size_t size() const noexcept { return ticks_.size(); }
+    bool empty() const noexcept { return ticks_.empty(); }
+
+    /**
+     * @brief Loads `[fromNs, toNs)` of the instruments' archived ticks
+     *
+     * Instruments are matched to archive segments by `contract.conId`.
+     */
+    static TickTape fromArchive(IB::Storage::TickArchiveReader& reader, IB::Helpers::ThreadPool& pool,
+                                std::vector<TapeInstrument> instruments, int64_t fromNs, int64_t toNs) {
+      std::vector<long> conIds;
+      std::unordered_map<long, int> tickerOf;
+      for (const auto& i : instruments) {
+        conIds.push_back(i.contract.conId);
+        tickerOf[i.contract.conId] = i.tickerId;
+      }
+      std::vector<TapeTick> ticks;
+      IB::Storage::ArchiveQuery query(reader, pool);
+      query.replay(conIds, fromNs, toNs, [&](long conId, const IB::Storage::TickRecord& r) {
+        ticks.push_back({tickerOf[conId], r});
+      });
+      LOG_INFO("[TickTape] Loaded ", ticks.size(), " ticks of ", instruments.size(), " instruments");
+      return TickTape(std::move(instruments), std::move(ticks));
+    }
+
+    /**
+     * @brief Extracts the tickPrice / tickSize records of a callback recording
+     *
+     * Ticker IDs are kept as recorded; `instruments` supplies their contracts.
+     */
+    static TickTape fromRecording(const std::string& path, std::vector<TapeInstrument> instruments) {
+      using namespace IB::Replay;
+      std::vector<TapeTick> ticks;
+      std::ifstream in(path, std::ios::binary);
+      FileHeader header{};
+      if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+          std::memcmp(header.magic, FILE_MAGIC, sizeof(header.magic)) != 0 || header.version != FILE_VERSION) {
+        LOG_ERROR("[TickTape] ", path, " is not a recording");
+        return {};
+      }
+      std::vector<char> payload;
+      RecordHeader rh{};
+      while (in.read(reinterpret_cast<char*>(&rh), sizeof(rh))) {
+        payload.resize(rh.size);
+        if (rh.size && !in.read(payload.data(), rh.size)) break;
+        const auto type = static_cast<RecordType>(rh.type);
+        if (type != RecordType::TICK_PRICE && type != RecordType::TICK_SIZE) continue;
+
+        RecordReader r(payload.data(), payload.size());
+        TapeTick t;
+        t.tickerId = static_cast<int>(r.read<int64_t>());
+        t.tick.field = static_cast<int16_t>(r.read<int32_t>());
+        t.tick.timestampNs = rh.timestampNs;
+        if (type == RecordType::TICK_PRICE) t.tick.price = r.read<double>();
+        else t.tick.size = DecimalFunctions::decimalToDouble(r.read<Decimal>());
+        if (r.ok()) ticks.push_back(t);
+      }
+      LOG_INFO("[TickTape] Loaded ", ticks.size(), " ticks from ", path);
+      return TickTape(std::move(instruments), std::move(ticks));
+    }
+
+  private:
+    std::vector<TapeInstrument> instruments_;
+    std::vector<TapeTick> ticks_;
+  };
+
+}  // namespace IB::Backtest
+
+#endif  // QUANTDREAMCPP_TICK_TAPE_H
@@ -0,0 +1,76 @@
+#ifndef QUANTDREAMCPP_CONTRACT_CACHE_H
+#define QUANTDREAMCPP_CONTRACT_CACHE_H
+
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "Contract.h"
+
+/**
+ * @file contract_cache.h
+ * @brief Thread-safe cache of resolved contracts keyed by IB contract ID
+ *
+ * Every `contractDetails()` and `scannerData()` callback deposits its contract here,
+ * so later consumers (universe manager, archive, order helpers) can turn a conId into
+ * a routable `Contract` without another round trip to TWS.
+ */
+
+namespace IB::Contracts {
+
+/**
+ * @brief conId → ContractDetails cache
+ *
+ * Example usage:
+ * @code
+ * if (auto details = ib.contractCache.find(conId))
+ *     ib.client->reqMktData(tickerId, details->contract, "", false, false, nullptr);
+ * @endcode
+ */
+class ContractCache {
+public:
+  /// Inserts or replaces the entry for `details.contract.conId` (ignored when conId is 0)
+  void put(const ContractDetails& details) {
+    if (details.contract.conId == 0) return;
+    std::lock_guard<std::mutex> lk(m_);
+    entries_[details.contract.conId] = details;
+  }
+
+  /// Inserts only if the conId is not cached yet (keeps richer contractDetails() data)
+  void putIfAbsent(const ContractDetails& details) {
+    if (details.contract.conId == 0) return;
+    std::lock_guard<std::mutex> lk(m_);
+    entries_.try_emplace(details.contract.conId, details);
+  }
+
+  /// Cached details for `conId`, if any
+  std::optional<ContractDetails> find(long conId) const {
+    std::lock_guard<std::mutex> lk(m_);
+    auto it = entries_.find(conId);
+    if (it == entries_.end()) return std::nullopt;
+    return it->second;
+  }
+
+  bool contains(long conId) const {
+    std::lock_guard<std::mutex> lk(m_);
+    return entries_.count(conId) != 0;
+  }
+
+  void erase(long conId) {
+    std::lock_guard<std::mutex> lk(m_);
+    entries_.erase(conId);
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return entries_.size();
+  }
+
+private:
+  mutable std::mutex m_;
+  std::unordered_map<long, ContractDetails> entries_;
+};
+
+} // namespace IB::Contracts
+
+#endif  // QUANTDREAMCPP_CONTRACT_CACHE_H
@@ -0,0 +1,125 @@
+#ifndef QUANTDREAMCPP_HISTORICAL_PACER_H
+#define QUANTDREAMCPP_HISTORICAL_PACER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @file historical_pacer.h
+ * @brief Scheduler for IB's historical data pacing limits
+ *
+ * IB rejects historical requests (error 162, "pacing violation") when any of these
+ * is broken:
+ *  - an identical request within 15 seconds,
+ *  - six or more requests for the same contract, exchange and tick type within 2 seconds,
+ *  - more than 60 requests within any 10-minute period.
+ * The pacer hands out send times that respect all three, so callers sleep instead of
+ * getting throttled by the server.
+ */
+
+namespace IB::MarketData {
+
+/**
+ * @brief Thread-safe send-time allocator for historical data requests
+ *
+ * Reservations are non-decreasing in time, which keeps every rule a check against the
+ * N-th most recent send. A retry that must wait for the identical-request gap holds back
+ * later requests too; retries are rare enough that this is cheaper than tracking gaps.
+ *
+ * Example usage:
+ * @code
+ * IB::MarketData::HistoricalPacer pacer;
+ * auto at = pacer.reserve(requestKey, contractKey);
+ * std::this_thread::sleep_until(at);
+ * ib.client->reqHistoricalData(...);
+ * @endcode
+ */
+class HistoricalPacer {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Limits {
+    size_t windowRequests = 60;                          ///< Requests allowed per window
+    Clock::duration window = std::chrono::minutes(10);
+    Clock::duration identicalGap = std::chrono::seconds(15);
+    size_t burstRequests = 5;                            ///< Requests per contract allowed per burst window
+    Clock::duration burstWindow = std::chrono::seconds(2);
+  };
+
+  HistoricalPacer() : HistoricalPacer(Limits{}) {}
+  explicit HistoricalPacer(Limits limits) : limits_(limits) {}
+
+  /**
+   * @brief Books the earliest send time allowed for a request
+   *
+   * @param requestKey Identifies identical requests (contract, end, duration, bar size, type)
+   * @param contractKey Identifies the contract / exchange / tick type
+   * @return Time at which the request may be sent (>= now)
+   */
+  Clock::time_point reserve(const std::string& requestKey, const std::string& contractKey,
+                            Clock::time_point now = Clock::now()) {
+    std::lock_guard<std::mutex> lk(m_);
+    prune(now);
+
+    Clock::time_point t = std::max({now, blockedUntil_, last_});
+    if (sends_.size() >= limits_.windowRequests)
+      t = std::max(t, sends_[sends_.size() - limits_.windowRequests] + limits_.window);
+
+    auto& burst = contracts_[contractKey];
+    if (burst.size() >= limits_.burstRequests)
+      t = std::max(t, burst[burst.size() - limits_.burstRequests] + limits_.burstWindow);
+
+    if (auto it = identical_.find(requestKey); it != identical_.end())
+      t = std::max(t, it->second + limits_.identicalGap);
+
+    sends_.push_back(t);
+    burst.push_back(t);
+    identical_[requestKey] = t;
+    last_ = t;
+    return t;
+  }
+
+  /// Holds every request back until `until` (after the server reported a pacing violation)
+  void penalize(Clock::time_point until) {
+    std::lock_guard<std::mutex> lk(m_);
+    blockedUntil_ = std::max(blockedUntil_, until);
+  }
+
+  /// Requests booked within the last window
+  size_t booked(Clock::time_point now = Clock::now()) {
+    std::lock_guard<std::mutex> lk(m_);
+    prune(now);
+    return sends_.size();
+  }
+
+  const Limits& limits() const noexcept { return limits_; }
+
+private:
+  void prune(Clock::time_point now) {
+    while (!sends_.empty() && sends_.front() + limits_.window <= now) sends_.pop_front();
+    for (auto it = contracts_.begin(); it != contracts_.end();) {
+      auto& q = it->second;
+      while (!q.empty() && q.front() + limits_.burstWindow <= now) q.pop_front();
+      it = q.empty() ? contracts_.erase(it) : std::next(it);
+    }
+    for (auto it = identical_.begin(); it != identical_.end();)
+      it = it->second + limits_.identicalGap <= now ? identical_.erase(it) : std::next(it);
+  }
+
+  Limits limits_;
+  std::mutex m_;
+  std::deque<Clock::time_point> sends_;                                      ///< All bookings, ascending
+  std::unordered_map<std::string, std::deque<Clock::time_point>> contracts_; ///< Bookings per contract key
+  std::unordered_map<std::string, Clock::time_point> identical_;             ///< Last booking per request key
+  Clock::time_point last_{};
+  Clock::time_point blockedUntil_{};
+};
+
+} // namespace IB::MarketData
+
+#endif  // QUANTDREAMCPP_HISTORICAL_PACER_H
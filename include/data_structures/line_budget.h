@@ -0,0 +1,58 @@
+#ifndef QUANTDREAMCPP_LINE_BUDGET_H
+#define QUANTDREAMCPP_LINE_BUDGET_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @file line_budget.h
+ * @brief Counter for IB's simultaneous market data line allowance
+ *
+ * IB limits the number of concurrent `reqMktData` subscriptions (100 lines by
+ * default, more with quote booster packs). Requests beyond the allowance fail with
+ * error 101. Components that open streaming subscriptions acquire a line first and
+ * release it when they cancel.
+ */
+
+namespace IB::MarketData {
+
+/**
+ * @brief Lock-free market data line counter
+ */
+class LineBudget {
+public:
+  explicit LineBudget(size_t capacity = 100) : capacity_(capacity) {}
+
+  /// Takes one line if available
+  bool tryAcquire() noexcept {
+    size_t used = used_.load(std::memory_order_relaxed);
+    do {
+      if (used >= capacity_.load(std::memory_order_relaxed)) return false;
+    } while (!used_.compare_exchange_weak(used, used + 1, std::memory_order_acq_rel));
+    return true;
+  }
+
+  /// Returns one line
+  void release() noexcept {
+    size_t used = used_.load(std::memory_order_relaxed);
+    while (used > 0 && !used_.compare_exchange_weak(used, used - 1, std::memory_order_acq_rel)) {}
+  }
+
+  /// Changes the allowance; lines already held above the new capacity stay held
+  void setCapacity(size_t capacity) noexcept { capacity_.store(capacity, std::memory_order_relaxed); }
+
+  size_t capacity() const noexcept { return capacity_.load(std::memory_order_relaxed); }
+  size_t used() const noexcept { return used_.load(std::memory_order_relaxed); }
+  size_t available() const noexcept {
+    size_t c = capacity(), u = used();
+    return u >= c ? 0 : c - u;
+  }
+
+private:
+  std::atomic<size_t> capacity_;
+  std::atomic<size_t> used_{0};
+};
+
+} // namespace IB::MarketData
+
+#endif  // QUANTDREAMCPP_LINE_BUDGET_H
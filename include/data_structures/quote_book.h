@@ -0,0 +1,235 @@
+#ifndef QUANTDREAMCPP_QUOTE_BOOK_H
+#define QUANTDREAMCPP_QUOTE_BOOK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file quote_book.h
+ * @brief Structure-of-arrays top-of-book store shared by all streaming instruments
+ *
+ * The quote book keeps one row per market data subscription and one contiguous
+ * column per field (bid, ask, sizes, volume, ...). It is written by the IB reader
+ * thread from the tick callbacks and read by analytics that want to sweep the
+ * whole universe at once (indicators, screens, risk), which is why the columns
+ * are laid out contiguously instead of inside per-instrument snapshots.
+ */
+
+namespace IB::MarketData {
+
+/**
+ * @brief Top-of-book store in structure-of-arrays layout
+ *
+ * **Layout**
+ * - Rows are dense indices assigned on first use of a ticker ID
+ * - Every field lives in its own contiguous `std::vector<double>`
+ * - `version[row]` holds the book-wide update sequence of the last write to that row,
+ *   so readers can cheaply find instruments that changed since a previous pass
+ *
+ * **Threading**
+ * - Single writer (the IB reader thread); any number of readers
+ * - Columns are sized to `capacity` at construction and never reallocate, so raw
+ *   column pointers stay valid for the lifetime of the book
+ * - Writers bracket each update with a sequence lock; readers that need a coherent
+ *   view across rows use `copyTo()`, which retries while a write is in flight
+ *
+ * @note Rows are never removed. A cancelled subscription simply stops updating and
+ *       keeps its last values until `clear()` when its ticker ID is reused.
+ *
+ * Example usage:
+ * @code
+ * IB::MarketData::QuoteBook book(1024);
+ * size_t row = book.rowFor(tickerId);
+ * book.set(row, IB::MarketData::QuoteBook::BID, 101.25);
+ *
+ * IB::MarketData::QuoteBook::Columns view;
+ * book.copyTo(view);  // consistent copy for a cross-sectional pass
+ * @endcode
+ */
+class QuoteBook {
+public:
+  /// Column identifiers, in storage order
+  enum Field : uint8_t {
+    BID = 0,
+    ASK,
+    LAST,
+    BID_SIZE,
+    ASK_SIZE,
+    LAST_SIZE,
+    VOLUME,
+    OPEN,
+    CLOSE,
+    HIGH,
+    LOW,
+    FIELD_COUNT
+  };
+
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();  ///< Returned when no row is available
+
+  /**
+   * @brief Owning copy of the book columns for cross-sectional readers
+   *
+   * `fields[f][row]` is the value of field `f` for `row`; `tickerIds[row]` maps the
+   * row back to its market data request ID.
+   */
+  struct Columns {
+    size_t rows = 0;                                ///< Number of populated rows
+    uint64_t sequence = 0;                          ///< Book update sequence at copy time
+    std::vector<double> fields[FIELD_COUNT];        ///< One column per Field
+    std::vector<uint64_t> version;                  ///< Last update sequence per row
+    std::vector<int> tickerIds;                     ///< Ticker ID per row
+
+    const double* column(Field f) const noexcept { return fields[f].data(); }
+  };
+
+  /**
+   * @brief Construct a book with a fixed row capacity
+   * @param capacity Maximum number of instruments (rows) the book can hold
+   */
+  explicit QuoteBook(size_t capacity = 4096) : capacity_(capacity) {
+    for (auto& col : columns_) col.assign(capacity_, 0.0);
+    version_.assign(capacity_, 0);
+    tickerIds_.assign(capacity_, -1);
+  }
+
+  QuoteBook(const QuoteBook&) = delete;
+  QuoteBook& operator=(const QuoteBook&) = delete;
+
+  // ------------------------------------------------------------------
+  // Row management
+  // ------------------------------------------------------------------
+
+  /**
+   * @brief Returns the row for a ticker ID, assigning a new one on first use
+   * @param tickerId Market data request ID
+   * @return Row index, or `npos` if the book is full
+   */
+  size_t rowFor(int tickerId) {
+    std::lock_guard<std::mutex> lock(indexMutex_);
+    if (auto it = index_.find(tickerId); it != index_.end()) return it->second;
+
+    size_t row = rows_.load(std::memory_order_relaxed);
+    if (row >= capacity_) return npos;
+
+    tickerIds_[row] = tickerId;
+    index_.emplace(tickerId, row);
+    rows_.store(row + 1, std::memory_order_release);
+    return row;
+  }
+
+  /**
+   * @brief Looks up the row of a ticker ID without assigning one
+   * @return Row index, or `npos` if the ticker is unknown
+   */
+  size_t find(int tickerId) const {
+    std::lock_guard<std::mutex> lock(indexMutex_);
+    auto it = index_.find(tickerId);
+    return it == index_.end() ? npos : it->second;
+  }
+
+  size_t size() const noexcept { return rows_.load(std::memory_order_acquire); }
+  size_t capacity() const noexcept { return capacity_; }
+  int tickerId(size_t row) const noexcept { return tickerIds_[row]; }
+
+  // ------------------------------------------------------------------
+  // Writer side (IB reader thread)
+  // ------------------------------------------------------------------
+
+  /**
+   * @brief Writes a single field of a row
+   *
+   * Bumps the book sequence and stamps the row version. Out-of-range rows are ignored.
+   */
+  void set(size_t row, Field field, double value) noexcept {
+    if (row >= capacity_) return;
+    beginWrite();
+    columns_[field][row] = value;
+    version_[row] = updates_;
+    endWrite();
+  }
+
+  /**
+   * @brief Zeroes every field of a row (e.g. when its ticker ID is handed to a new instrument)
+   */
+  void clear(size_t row) noexcept {
+    if (row >= capacity_) return;
+    beginWrite();
+    for (auto& col : columns_) col[row] = 0.0;
+    version_[row] = updates_;
+    endWrite();
+  }
+
+  // ------------------------------------------------------------------
+  // Reader side
+  // ------------------------------------------------------------------
+
+  /// Field value of a row (may race with the writer for a single double; use copyTo for coherence)
+  double get(size_t row, Field field) const noexcept { return columns_[field][row]; }
+
+  /// Raw column pointer, valid for the lifetime of the book
+  const double* column(Field field) const noexcept { return columns_[field].data(); }
+
+  /// Raw version column pointer, valid for the lifetime of the book
+  const uint64_t* versions() const noexcept { return version_.data(); }
+
+  /// Number of updates applied so far
+  uint64_t sequence() const noexcept { return seq_.load(std::memory_order_acquire) / 2; }
+
+  /**
+   * @brief Copies all populated rows into `out` under the sequence lock
+   *
+   * Reuses the capacity already held by `out`, so a reader that keeps its
+   * `Columns` object around performs no allocation after the first call.
+   */
+  void copyTo(Columns& out) const {
+    for (;;) {
+      uint64_t s0 = seq_.load(std::memory_order_acquire);
+      if (s0 & 1) continue;
+
+      size_t n = size();
+      out.rows = n;
+      for (size_t f = 0; f < FIELD_COUNT; ++f)
+        out.fields[f].assign(columns_[f].begin(), columns_[f].begin() + n);
+      out.version.assign(version_.begin(), version_.begin() + n);
+      out.tickerIds.assign(tickerIds_.begin(), tickerIds_.begin() + n);
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq_.load(std::memory_order_relaxed) == s0) {
+        out.sequence = s0 / 2;
+        return;
+      }
+    }
+  }
+
+private:
+  void beginWrite() noexcept {
+    seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    ++updates_;
+  }
+
+  void endWrite() noexcept {
+    seq_.store(seq_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  size_t capacity_;                              ///< Fixed row capacity
+  std::atomic<size_t> rows_{0};                  ///< Number of assigned rows
+  std::vector<double> columns_[FIELD_COUNT];     ///< Field columns (SoA)
+  std::vector<uint64_t> version_;                ///< Last update sequence per row
+  std::vector<int> tickerIds_;                   ///< Ticker ID per row
+
+  std::atomic<uint64_t> seq_{0};                 ///< Sequence lock (odd while writing)
+  uint64_t updates_ = 0;                         ///< Writer-side update counter
+
+  mutable std::mutex indexMutex_;                ///< Protects index_ (row assignment is rare)
+  std::unordered_map<int, size_t> index_;        ///< Ticker ID to row
+};
+
+} // namespace IB::MarketData
+
+#endif  // QUANTDREAMCPP_QUOTE_BOOK_H
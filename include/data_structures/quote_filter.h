@@ -0,0 +1,163 @@
+#ifndef QUANTDREAMCPP_QUOTE_FILTER_H
+#define QUANTDREAMCPP_QUOTE_FILTER_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "data_structures/snapshots.h"
+
+/**
+ * @file quote_filter.h
+ * @brief Per-instrument quote sanity stage applied once on ingest
+ *
+ * `IBMarketWrapper::tickPrice` runs every BID / ASK / LAST tick through
+ * `QuoteFilter::apply()` before anything downstream sees it. The filter writes the
+ * price into the snapshot, recomputes `MarketSnapshot::quality` and stamps
+ * `MarketSnapshot::updatedNs`, so consumers test one bitmask instead of re-validating.
+ *
+ * **Checks**
+ * - **Crossed / locked**: flagged from the post-update bid and ask
+ * - **Band**: a price further than `band` (relative) plus half the spread from the recent
+ *   two-sided mid is dropped and flagged as OUTLIER; after `confirmTicks` consecutive
+ *   out-of-band ticks on the same side the move is accepted as a genuine gap and the
+ *   reference is re-anchored. Until both sides are quoted there is no reference, so the
+ *   first quote of the opposite side is never judged against a lone price
+ * - **Halt**: the HALTED generic tick sets / clears HALTED; on resumption the quote is
+ *   flagged STALE and the band check is suspended until both sides have been refreshed
+ * - **Staleness**: if the reference is older than `staleAfterNs`, the band check is
+ *   skipped and the reference is re-anchored on the incoming price
+ *
+ * State is a fixed array indexed by quote book row, allocated once; `apply()` never
+ * allocates and uses flag arithmetic instead of branches except for the reject path.
+ */
+
+namespace IB::MarketData {
+
+/**
+ * @brief Tuning for QuoteFilter
+ */
+struct QuoteFilterConfig {
+  double band = 0.10;                       ///< Max relative deviation from the recent mid (beyond half the spread)
+  uint32_t confirmTicks = 3;                ///< Consecutive out-of-band ticks of one side accepted as a real move
+  int64_t staleAfterNs = 60'000'000'000LL;  ///< Band reference expires after this long without ticks
+};
+
+/**
+ * @brief Branch-light, allocation-free quote validation keyed by quote book row
+ *
+ * Single writer (the IB reader thread).
+ *
+ * Example usage:
+ * @code
+ * if (quoteFilter.apply(row, IB::MarketData::QuoteFilter::BID, price, nowNs, snap)) {
+ *     // price accepted and written into snap.bid; snap.quality is current
+ *     if (snap.usable()) pm->onBid(tickerId, price);
+ * }
+ * @endcode
+ */
+class QuoteFilter {
+public:
+  /// Price tick being validated
+  enum Side : uint8_t { BID = 0, ASK = 1, LAST = 2 };
+
+  /**
+   * @param capacity Number of rows (normally the quote book capacity); out-of-range
+   *                 rows keep no state, so they get quality flags but no band check
+   * @param config Band / confirmation / staleness settings
+   */
+  explicit QuoteFilter(size_t capacity = 4096, QuoteFilterConfig config = {})
+    : config_(config), states_(capacity) {}
+
+  /**
+   * @brief Validates a price tick and, if accepted, writes it into `snap`
+   * @return False if the tick was dropped as an outlier (only the OUTLIER flag changes)
+   */
+  bool apply(size_t row, Side side, double price, int64_t nowNs, MarketSnapshot& snap) noexcept {
+    State scratch;
+    State& s = row < states_.size() ? states_[row] : scratch;
+
+    // --- Band check against the recent two-sided mid ---
+    const bool fresh = (s.stampNs != 0) & (nowNs - s.stampNs <= config_.staleAfterNs) & (s.pending == 0);
+    const double limit = config_.band * s.refMid + s.refHalfSpread;
+    const bool outOfBand = fresh & (s.refMid > 0.0) & (std::fabs(price - s.refMid) > limit);
+    uint32_t& rejects = s.rejects[side];
+    rejects = outOfBand * (rejects + 1);
+    if (outOfBand & (rejects < config_.confirmTicks)) {
+      snap.quality |= QUALITY_OUTLIER;
+      return false;
+    }
+    rejects = 0;
+
+    double* fields[3] = {&snap.bid, &snap.ask, &snap.last};
+    *fields[side] = price;
+
+    // --- Flags from the post-update quote ---
+    const bool twoSided = (snap.bid > 0.0) & (snap.ask > 0.0);
+    const bool crossed = twoSided & (snap.bid > snap.ask);
+    const bool locked = twoSided & (snap.bid == snap.ask);
+    s.pending &= static_cast<uint8_t>(~(1u << side));
+
+    uint16_t q = snap.quality & QUALITY_HALTED;
+    q |= crossed * QUALITY_CROSSED;
+    q |= locked * QUALITY_LOCKED;
+    const bool stale = (s.pending & BOTH_SIDES) != 0;
+    q |= stale * QUALITY_STALE;
+    snap.quality = q;
+
+    // --- Reference update: mid and half spread when two-sided and current, otherwise none ---
+    const bool quoted = twoSided & !stale;
+    s.refMid = crossed ? s.refMid : quoted * 0.5 * (snap.bid + snap.ask);
+    s.refHalfSpread = crossed ? s.refHalfSpread : quoted * 0.5 * (snap.ask - snap.bid);
+    s.stampNs = nowNs;
+    snap.updatedNs = nowNs;
+    return true;
+  }
+
+  /**
+   * @brief Applies a HALTED / DELAYED_HALTED generic tick
+   * @param value IB halt code: 0 = trading, 1 = general halt, 2 = volatility halt, -1 = n/a
+   */
+  void onHalted(size_t row, double value, MarketSnapshot& snap) noexcept {
+    State scratch;
+    State& s = row < states_.size() ? states_[row] : scratch;
+    const bool halted = value > 0.0;
+    const bool resumed = !halted & ((snap.quality & QUALITY_HALTED) != 0);
+
+    // After a halt the book is rebuilt: require fresh quotes on both sides, drop the band reference
+    s.pending |= resumed * BOTH_SIDES;
+    s.stampNs = resumed ? 0 : s.stampNs;
+    s.rejects[BID] = s.rejects[ASK] = s.rejects[LAST] = 0;
+
+    uint16_t q = snap.quality & static_cast<uint16_t>(~(QUALITY_HALTED | QUALITY_STALE));
+    q |= halted * QUALITY_HALTED;
+    q |= ((s.pending & BOTH_SIDES) != 0) * QUALITY_STALE;
+    snap.quality = q;
+  }
+
+  /// Forgets the state of a row (e.g. when its ticker ID is reused)
+  void reset(size_t row) noexcept {
+    if (row < states_.size()) states_[row] = State{};
+  }
+
+  const QuoteFilterConfig& config() const noexcept { return config_; }
+
+private:
+  static constexpr uint8_t BOTH_SIDES = (1u << BID) | (1u << ASK);
+
+  struct State {
+    double refMid = 0.0;          ///< Recent two-sided mid (0 = no reference)
+    double refHalfSpread = 0.0;   ///< Half the spread at refMid
+    int64_t stampNs = 0;          ///< Time the reference was set (0 = none)
+    uint32_t rejects[3] = {};     ///< Consecutive out-of-band ticks per side
+    uint8_t pending = 0;     ///< Sides still awaiting a refresh after a halt
+  };
+
+  QuoteFilterConfig config_;
+  std::vector<State> states_;
+};
+
+} // namespace IB::MarketData
+
+#endif  // QUANTDREAMCPP_QUOTE_FILTER_H
@@ -1,6 +1,10 @@
 #ifndef QUANTDREAMCPP_SNAPSHOTS_H
 #define QUANTDREAMCPP_SNAPSHOTS_H
 
+#include <cstdint>
+
+#include "helpers/tick_trace.h"
+
 /**
  * @file snapshots.h
  * @brief Market data snapshot structures for Interactive Brokers API
@@ -13,6 +17,21 @@
 
 namespace IB::MarketData {
 
+/**
+ * @brief Quality flags set on a snapshot by the quote sanity filter
+ *
+ * Flags combine as a bitmask in `MarketSnapshot::quality`; zero means a clean quote.
+ * See `data_structures/quote_filter.h` for how each flag is raised and cleared.
+ */
+enum QuoteQuality : uint16_t {
+  QUALITY_OK      = 0,
+  QUALITY_CROSSED = 1 << 0,  ///< bid > ask
+  QUALITY_LOCKED  = 1 << 1,  ///< bid == ask
+  QUALITY_OUTLIER = 1 << 2,  ///< Last price tick fell outside the band around the recent mid and was dropped
+  QUALITY_HALTED  = 1 << 3,  ///< Instrument halted (HALTED generic tick)
+  QUALITY_STALE   = 1 << 4,  ///< Quote not refreshed on both sides since the last halt
+};
+
 /**
  * @brief Defines the type of price data requested in a market snapshot
  *
@@ -48,6 +67,15 @@ enum class PriceType {
  * - Standard price data: bid, ask, last, open, close, high, low
  * - All initialized to 0.0 until IB sends updates
  *
+ * **Size Fields**
+ * - Top-of-book sizes (bidSize, askSize), size of the last trade (lastSize)
+ * - Cumulative session volume as reported by the VOLUME tick
+ * - Sizes never participate in fulfillment; they are filled as IB sends them
+ *
+ * **Quality Fields**
+ * - `quality`: bitmask of `QuoteQuality` flags computed once on ingest
+ * - `updatedNs`: steady-clock receive time of the last accepted price tick
+ *
  * **Option Model Fields (Greeks)**
  * - Greeks: delta, gamma, vega, theta, impliedVol
  * - Option price and underlying price
@@ -58,6 +86,7 @@ enum class PriceType {
  * - `fulfilled`: True when snapshot meets fulfillment criteria
  * - `cancelled`: True if market data request was cancelled
  * - `streaming`: False for one-time snapshots (auto-cancel), true for live streaming
+ * - `bookRow` / `hasBookRow`: QuoteBook row cached by the tick handlers
  *
  * **Fulfillment Logic:**
  *
@@ -108,6 +137,16 @@ struct MarketSnapshot {
   double high = 0.0;   ///< Daily high price
   double low = 0.0;    ///< Daily low price
 
+  // --- Size fields ---
+  double bidSize = 0.0;   ///< Size available at the bid
+  double askSize = 0.0;   ///< Size available at the ask
+  double lastSize = 0.0;  ///< Size of the last trade
+  double volume = 0.0;    ///< Cumulative session volume
+
+  // --- Quality fields ---
+  uint16_t quality = QUALITY_OK;  ///< Bitmask of QuoteQuality flags
+  int64_t updatedNs = 0;          ///< Steady-clock time (ns) of the last accepted price tick
+
   // --- Option model fields (Greeks) ---
   double impliedVol = 0.0;  ///< Implied volatility (IV)
   double delta = 0.0;       ///< Delta (rate of change w.r.t. underlying)
@@ -123,6 +162,11 @@ struct MarketSnapshot {
   bool fulfilled = false;                 ///< True when snapshot meets fulfillment criteria
   bool cancelled = false;                 ///< True if market data request was cancelled
   bool streaming = false;                 ///< False for snapshot (auto-cancel), true for live stream
+  size_t bookRow = 0;                     ///< QuoteBook row of the ticker, valid once hasBookRow is set
+  bool hasBookRow = false;                ///< Row looked up on the first tick; later ticks skip the book index
+
+  /// Tick-to-trade stamps of the latest price tick (an empty type unless built with IBW_TRACE)
+  [[no_unique_address]] IB::Helpers::TickTrace trace;
 
   /**
    * @brief Checks if both bid and ask prices are available
@@ -132,6 +176,23 @@ struct MarketSnapshot {
    */
   bool hasBidAsk() const noexcept { return bid > 0 && ask > 0; }
 
+  /**
+   * @brief Checks if the quote can be acted upon
+   * @return True unless the quote is crossed, halted or stale (locked and outlier flags are informational)
+   */
+  bool usable() const noexcept {
+    return (quality & (QUALITY_CROSSED | QUALITY_HALTED | QUALITY_STALE)) == 0;
+  }
+
+  /**
+   * @brief Age of the last accepted price tick
+   * @param nowNs Current steady-clock time in nanoseconds
+   * @return Nanoseconds since the last accepted tick (INT64_MAX if none yet)
+   */
+  int64_t ageNs(int64_t nowNs) const noexcept {
+    return updatedNs == 0 ? INT64_MAX : nowNs - updatedNs;
+  }
+
   /**
    * @brief Checks if Greeks data is valid and complete
    * @return True if hasGreeks flag is set, IV > 0, option price > 0, and delta != 0
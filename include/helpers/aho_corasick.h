@@ -0,0 +1,219 @@
+#ifndef QUANTDREAMCPP_AHO_CORASICK_H
+#define QUANTDREAMCPP_AHO_CORASICK_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file aho_corasick.h
+ * @brief Multi-pattern string matcher (Aho-Corasick automaton compiled to a DFA)
+ *
+ * All patterns are matched in a single left-to-right pass over the text, so the cost
+ * of scanning a headline is linear in its length regardless of how many keywords are
+ * watched.
+ *
+ * **Layout**
+ * - Input bytes are first mapped to a compact alphabet of the bytes that occur in
+ *   any pattern (plus one class for "anything else"), optionally case-folded
+ * - Failure links are resolved at build time into a dense `states × classes`
+ *   transition table, so matching is one table lookup per byte with no backtracking
+ * - Each state stores its own pattern IDs plus a link to the nearest accepting
+ *   suffix state, so reporting matches costs only the matches themselves
+ */
+
+namespace IB::Helpers {
+
+/**
+ * @brief Immutable Aho-Corasick matcher built from a fixed pattern set
+ *
+ * Example usage:
+ * @code
+ * IB::Helpers::AhoCorasick::Builder b(true);          // case-insensitive
+ * b.add("AAPL", 0, true);                            // whole word only
+ * b.add("downgrade", 1);
+ * IB::Helpers::AhoCorasick ac = b.build();
+ *
+ * ac.match(headline, [](uint32_t id, size_t begin, size_t end) { ... });
+ * @endcode
+ */
+class AhoCorasick {
+  /// Pattern reported when a state is reached
+  struct Output {
+    uint32_t id;
+    uint32_t length;
+    bool wholeWord;
+  };
+
+public:
+  /**
+   * @brief Collects patterns and compiles the automaton
+   */
+  class Builder {
+  public:
+    explicit Builder(bool caseInsensitive = true) : fold_(caseInsensitive) {
+      nodes_.emplace_back();
+    }
+
+    /**
+     * @brief Adds a pattern
+     * @param pattern Non-empty byte string
+     * @param id Caller-defined identifier reported on match
+     * @param wholeWord Only report matches not surrounded by letters or digits
+     */
+    void add(std::string_view pattern, uint32_t id, bool wholeWord = false) {
+      if (pattern.empty()) return;
+      uint32_t s = 0;
+      for (unsigned char c : pattern) {
+        c = fold(c);
+        auto& edges = nodes_[s].edges;
+        uint32_t next = 0;
+        for (const auto& [ch, to] : edges)
+          if (ch == c) { next = to; break; }
+        if (next == 0) {
+          next = static_cast<uint32_t>(nodes_.size());
+          nodes_[s].edges.emplace_back(c, next);
+          nodes_.emplace_back();
+          nodes_.back().depth = nodes_[s].depth + 1;
+        }
+        s = next;
+      }
+      nodes_[s].outputs.push_back({id, static_cast<uint32_t>(pattern.size()), wholeWord});
+      ++patterns_;
+    }
+
+    size_t patterns() const noexcept { return patterns_; }
+
+    /// Compiles the trie into a DFA
+    AhoCorasick build() const {
+      AhoCorasick ac;
+      ac.fold_ = fold_;
+
+      // Compact alphabet: class 0 = bytes absent from every pattern
+      ac.classes_.fill(0);
+      uint32_t nclass = 1;
+      for (const auto& n : nodes_)
+        for (const auto& [ch, to] : n.edges)
+          if (ac.classes_[ch] == 0) ac.classes_[ch] = static_cast<uint16_t>(nclass++);
+      if (fold_)
+        for (int c = 'a'; c <= 'z'; ++c) ac.classes_[c - 'a' + 'A'] = ac.classes_[c];
+      ac.stride_ = nclass;
+
+      const size_t n = nodes_.size();
+      ac.delta_.assign(n * nclass, 0);
+      ac.dictLink_.assign(n, NONE);
+      ac.outStart_.assign(n + 1, 0);
+      std::vector<uint32_t> failure(n, 0);
+
+      // BFS: resolve failure links into full transitions
+      std::queue<uint32_t> q;
+      for (const auto& [ch, to] : nodes_[0].edges) {
+        ac.delta_[ac.classes_[ch]] = to;
+        q.push(to);
+      }
+      while (!q.empty()) {
+        uint32_t s = q.front();
+        q.pop();
+        const uint32_t f = failure[s];
+        for (uint32_t c = 0; c < nclass; ++c) ac.delta_[s * nclass + c] = ac.delta_[f * nclass + c];
+        for (const auto& [ch, to] : nodes_[s].edges) {
+          const uint16_t c = ac.classes_[ch];
+          failure[to] = ac.delta_[f * nclass + c];
+          ac.delta_[s * nclass + c] = to;
+          q.push(to);
+        }
+        // Nearest proper suffix state that accepts something
+        ac.dictLink_[s] = nodes_[f].outputs.empty() ? ac.dictLink_[f] : f;
+      }
+
+      for (size_t s = 0; s < n; ++s) {
+        ac.outStart_[s] = static_cast<uint32_t>(ac.outputs_.size());
+        ac.outputs_.insert(ac.outputs_.end(), nodes_[s].outputs.begin(), nodes_[s].outputs.end());
+      }
+      ac.outStart_[n] = static_cast<uint32_t>(ac.outputs_.size());
+      ac.patterns_ = patterns_;
+      return ac;
+    }
+
+  private:
+    friend class AhoCorasick;
+
+    unsigned char fold(unsigned char c) const noexcept {
+      return fold_ && c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+    }
+
+    struct Node {
+      std::vector<std::pair<unsigned char, uint32_t>> edges;
+      std::vector<Output> outputs;
+      uint32_t depth = 0;
+    };
+
+    bool fold_;
+    std::vector<Node> nodes_;
+    size_t patterns_ = 0;
+  };
+
+  AhoCorasick() { classes_.fill(0); }
+
+  /**
+   * @brief Reports every pattern occurrence in `text`
+   * @param onMatch Called as `onMatch(id, begin, end)` with the byte range of the match
+   */
+  template <typename OnMatch>
+  void match(std::string_view text, OnMatch&& onMatch) const {
+    if (delta_.empty()) return;
+    uint32_t s = 0;
+    const auto* p = reinterpret_cast<const unsigned char*>(text.data());
+    for (size_t i = 0; i < text.size(); ++i) {
+      s = delta_[s * stride_ + classes_[p[i]]];
+      for (uint32_t t = s; t != NONE; t = dictLink_[t]) {
+        for (uint32_t k = outStart_[t]; k < outStart_[t + 1]; ++k) {
+          const Output& o = outputs_[k];
+          const size_t end = i + 1;
+          const size_t begin = end - o.length;
+          if (o.wholeWord && !isBoundary(text, begin, end)) continue;
+          onMatch(o.id, begin, end);
+        }
+      }
+    }
+  }
+
+  /// True if any pattern occurs in `text`
+  bool contains(std::string_view text) const {
+    bool found = false;
+    match(text, [&](uint32_t, size_t, size_t) { found = true; });
+    return found;
+  }
+
+  size_t states() const noexcept { return outStart_.empty() ? 0 : outStart_.size() - 1; }
+  size_t patterns() const noexcept { return patterns_; }
+  bool caseInsensitive() const noexcept { return fold_; }
+
+private:
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  static bool isWordChar(char c) noexcept {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+  }
+
+  static bool isBoundary(std::string_view text, size_t begin, size_t end) noexcept {
+    return (begin == 0 || !isWordChar(text[begin - 1])) && (end >= text.size() || !isWordChar(text[end]));
+  }
+
+  bool fold_ = true;
+  std::array<uint16_t, 256> classes_;  ///< Byte → alphabet class
+  uint32_t stride_ = 1;                ///< Number of classes (row width of delta_)
+  std::vector<uint32_t> delta_;        ///< Dense DFA transitions
+  std::vector<uint32_t> dictLink_;     ///< Nearest accepting proper-suffix state
+  std::vector<uint32_t> outStart_;     ///< Per-state offset into outputs_
+  std::vector<Output> outputs_;        ///< Pattern outputs grouped by state
+  size_t patterns_ = 0;
+};
+
+} // namespace IB::Helpers
+
+#endif  // QUANTDREAMCPP_AHO_CORASICK_H
@@ -0,0 +1,301 @@
+#ifndef QUANTDREAMCPP_ASYNC_LOG_H
+#define QUANTDREAMCPP_ASYNC_LOG_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "helpers/log_file.h"
+#include "helpers/log_ring.h"
+#include "helpers/log_sites.h"
+
+/**
+ * @file async_log.h
+ * @brief Background writer of the asynchronous logger
+ *
+ * Once `Logger::startAsync()` is called, every log call encodes its level, a timestamp
+ * and its arguments into a ring owned by the calling thread (no lock, no formatting, no
+ * I/O) and returns. A background thread drains all rings every `flushInterval`, merges
+ * the records by timestamp, formats them exactly as the synchronous logger would and
+ * writes each batch with a single `fwrite`.
+ *
+ * A full ring drops the record (`OverflowPolicy::DROP`, counted and reported as a WARN
+ * line) or makes the caller wait (`BLOCK`).
+ *
+ * With `LogFormat::BINARY` nothing is formatted at all: the writer transcodes the records
+ * into the compact file format of log_file.h, preceded by the definitions of the call
+ * sites they reference, and `tools/log_decoder` renders the file as text or CSV later.
+ */
+
+namespace IB::Helpers::Logging {
+
+  enum class OverflowPolicy {
+    DROP,    ///< Never stall the caller; lost records are reported
+    BLOCK,   ///< Wait for the writer to make room
+  };
+
+  enum class LogFormat {
+    TEXT,     ///< The synchronous logger's lines
+    BINARY,   ///< log_file.h entries; `output` must be opened in binary mode
+  };
+
+  struct AsyncOptions {
+    size_t ringBytes = 1 << 20;                                 ///< Per thread
+    std::chrono::microseconds flushInterval{2000};              ///< Writer wake-up period
+    OverflowPolicy overflow = OverflowPolicy::DROP;
+    LogFormat format = LogFormat::TEXT;
+    std::FILE* output = stdout;
+  };
+
+  inline int64_t logClockNs() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+
+  class AsyncBackend {
+  public:
+    static AsyncBackend& instance() {
+      static AsyncBackend backend;
+      return backend;
+    }
+
+    /// True while log calls go to the rings
+    static bool active() noexcept { return active_.load(std::memory_order_relaxed); }
+
+    void start(const AsyncOptions& options) {
+      std::lock_guard lk(controlMutex_);
+      if (writer_.joinable()) return;
+      options_ = options;
+      sites_.clear();   // a new output gets the whole site table again
+      {
+        std::lock_guard wl(wakeMutex_);
+        stopping_ = false;
+        flushCompleted_ = flushRequested_;
+      }
+      writer_ = std::thread([this] { run(); });
+      active_.store(true, std::memory_order_release);
+    }
+
+    /// Routes logging back to the caller's thread and writes everything still queued
+    void stop() {
+      std::lock_guard lk(controlMutex_);
+      if (!writer_.joinable()) return;
+      active_.store(false, std::memory_order_release);
+      {
+        std::lock_guard wl(wakeMutex_);
+        stopping_ = true;
+      }
+      wake_.notify_all();
+      writer_.join();
+    }
+
+    /// Returns once every record logged before the call is written
+    void flush() {
+      if (!active()) return;
+      std::unique_lock lk(wakeMutex_);
+      const uint64_t ticket = ++flushRequested_;
+      wake_.notify_all();
+      flushed_.wait(lk, [&] { return flushCompleted_ >= ticket; });
+    }
+
+    /**
+     * @brief Encodes one log call into the calling thread's ring
+     *
+     * With a site id the string literals are left out (the site table has them).
+     *
+     * @return false if the record was dropped
+     */
+    template <typename... Args>
+    bool write(uint8_t level, uint8_t flags, uint16_t site, const Args&... args) {
+      if (site != 0) return writeEncoded(level, flags, site, prepareSiteArg(args)...);
+      return writeEncoded(level, flags, 0, prepareArg(args)...);
+    }
+
+    ~AsyncBackend() { stop(); }
+
+  private:
+    AsyncBackend() = default;
+
+    template <typename... Args>
+    bool writeEncoded(uint8_t level, uint8_t flags, uint16_t site, const Args&... args) {
+      LogRing& ring = threadRing();
+      const size_t bytes = (sizeof(RecordHeader) + (size_t{0} + ... + encodedSize(args)) + 7) & ~size_t{7};
+      if (bytes > ring.maxRecord()) {
+        ring.countDrop();
+        return false;
+      }
+      char* p = ring.reserve(bytes);
+      while (!p) {
+        if (options_.overflow == OverflowPolicy::DROP || !active()) {
+          ring.countDrop();
+          return false;
+        }
+        std::this_thread::yield();
+        p = ring.reserve(bytes);
+      }
+      RecordHeader h{static_cast<uint32_t>(bytes), site, level, flags, logClockNs()};
+      std::memcpy(p, &h, sizeof(h));
+      char* out = p + sizeof(h);
+      ((out = encodeArg(out, args)), ...);
+      std::memset(out, 0, static_cast<size_t>(p + bytes - out));   // padding ends the arguments
+      ring.commit();
+      return true;
+    }
+
+    /// Ring of the calling thread, created and registered on first use
+    LogRing& threadRing() {
+      struct Slot {
+        std::shared_ptr<LogRing> ring;
+        ~Slot() {
+          if (ring) ring->retire();
+        }
+      };
+      thread_local Slot slot;
+      if (!slot.ring) {
+        slot.ring = std::make_shared<LogRing>(options_.ringBytes);
+        std::lock_guard lk(registryMutex_);
+        rings_.push_back(slot.ring);
+      }
+      return *slot.ring;
+    }
+
+    /// Position of one ring within a drain pass
+    struct Cursor {
+      LogRing* ring;
+      uint64_t pos;
+      uint64_t end;
+      const RecordHeader* head = nullptr;
+
+      bool load() {
+        if (pos >= end) return false;
+        head = ring->recordAt(pos);
+        return true;
+      }
+    };
+
+    void run() {
+      std::string text;
+      if (options_.format == LogFormat::BINARY) {
+        fileWriter_.begin(text);
+        flushText(text);
+      }
+      for (;;) {
+        uint64_t ticket;
+        bool stopping;
+        {
+          std::unique_lock lk(wakeMutex_);
+          wake_.wait_for(lk, options_.flushInterval,
+                         [&] { return stopping_ || flushRequested_ > flushCompleted_; });
+          ticket = flushRequested_;
+          stopping = stopping_;
+        }
+        drain(text);
+        {
+          std::lock_guard lk(wakeMutex_);
+          flushCompleted_ = ticket;
+        }
+        flushed_.notify_all();
+        if (stopping) break;
+      }
+      drain(text);   // records of callers that raced with stop()
+      {
+        std::lock_guard lk(wakeMutex_);
+        flushCompleted_ = flushRequested_;
+      }
+      flushed_.notify_all();
+    }
+
+    /// Writes everything committed so far, merged across threads by timestamp
+    void drain(std::string& text) {
+      std::vector<std::shared_ptr<LogRing>> rings;
+      {
+        std::lock_guard lk(registryMutex_);
+        rings = rings_;
+      }
+      std::vector<Cursor> cursors;
+      cursors.reserve(rings.size());
+      for (auto& r : rings) {
+        Cursor c{r.get(), r->readPosition(), r->committed()};
+        if (c.load()) cursors.push_back(c);
+      }
+
+      // Sites are registered before their first record is committed, so the table read
+      // after the ring positions covers every record of this pass
+      const size_t knownSites = sites_.size();
+      SiteRegistry::copyNew(sites_);
+
+      text.clear();
+      const bool binary = options_.format == LogFormat::BINARY;
+      if (binary) {
+        for (size_t i = knownSites; i < sites_.size(); ++i) fileWriter_.site(static_cast<uint16_t>(i + 1), sites_[i], text);
+      }
+      while (!cursors.empty()) {
+        auto next = std::min_element(cursors.begin(), cursors.end(), [](const Cursor& a, const Cursor& b) {
+          return a.head->timestampNs < b.head->timestampNs;
+        });
+        const RecordHeader& h = *next->head;
+        if (binary) fileWriter_.record(h, text);
+        else renderRecord(h, h.site != 0 && h.site <= sites_.size() ? &sites_[h.site - 1] : nullptr, text);
+        next->pos += next->head->size;
+        next->ring->release(next->pos);   // the text is copied out, the producer may reuse the space
+        if (!next->load()) cursors.erase(next);
+        if (text.size() >= (1 << 16)) flushText(text);
+      }
+
+      for (auto& r : rings) {
+        const uint64_t dropped = r->takeDropped();
+        if (dropped == 0) continue;
+        const std::string note = "[Logger] " + std::to_string(dropped) + " log records dropped (ring full)";
+        if (binary) {
+          fileWriter_.note(WARN_LEVEL, logClockNs(), note, text);
+        } else {
+          text += "[WARN] " + note + "\n";
+        }
+      }
+      flushText(text);
+
+      std::lock_guard lk(registryMutex_);
+      std::erase_if(rings_, [](const auto& r) { return r->retired() && r->readPosition() == r->committed(); });
+    }
+
+    void flushText(std::string& text) {
+      if (text.empty()) return;
+      std::fwrite(text.data(), 1, text.size(), options_.output);
+      std::fflush(options_.output);
+      text.clear();
+    }
+
+    static constexpr uint8_t WARN_LEVEL = 4;   ///< Logger::Level::WARN
+
+    static inline std::atomic<bool> active_{false};
+
+    AsyncOptions options_;
+    std::vector<SiteInfo> sites_;   ///< Writer's copy of the site table
+    LogFileWriter fileWriter_;
+    std::mutex controlMutex_;
+    std::thread writer_;
+
+    std::mutex registryMutex_;
+    std::vector<std::shared_ptr<LogRing>> rings_;
+
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    std::condition_variable flushed_;
+    bool stopping_ = false;
+    uint64_t flushRequested_ = 0;
+    uint64_t flushCompleted_ = 0;
+  };
+
+}  // namespace IB::Helpers::Logging
+
+#endif  // QUANTDREAMCPP_ASYNC_LOG_H
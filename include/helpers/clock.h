@@ -0,0 +1,136 @@
+#ifndef QUANTDREAMCPP_CLOCK_H
+#define QUANTDREAMCPP_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+#if !defined(IBW_NO_TSC) && (defined(__x86_64__) || defined(_M_X64))
+#define IBW_HAS_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+/**
+ * @file clock.h
+ * @brief Monotonic time source of the ingest path, replaceable by a virtual clock
+ *
+ * Quote staleness checks and PositionManager throttles read the time through
+ * `steadyNowNs()`. Normally that is `std::chrono::steady_clock`; a backtest installs a
+ * `VirtualClock` on its thread with `ScopedVirtualClock`, so the same code runs on
+ * recorded time as fast as the CPU allows. The override is thread-local, so backtests
+ * on different threads each keep their own time.
+ *
+ * `CycleClock` is separate: a raw tick counter for measuring short intervals (the TSC
+ * on x86-64 unless built with `IBW_NO_TSC`), never virtual.
+ */
+
+namespace IB::Helpers {
+
+  /**
+   * @brief Manually advanced clock (nanoseconds)
+   *
+   * Only the owning backtest thread moves it; time never goes backwards.
+   */
+  class VirtualClock {
+  public:
+    int64_t nowNs() const noexcept { return nowNs_; }
+
+    /// Moves to `ns`; earlier values are ignored
+    void advanceTo(int64_t ns) noexcept {
+      if (ns > nowNs_) nowNs_ = ns;
+    }
+
+    void reset(int64_t ns = 0) noexcept { nowNs_ = ns; }
+
+  private:
+    int64_t nowNs_ = 0;
+  };
+
+  namespace detail {
+    inline thread_local const VirtualClock* activeClock = nullptr;
+  }
+
+  /// Monotonic nanoseconds: the virtual clock of this thread if one is installed, else steady_clock
+  inline int64_t steadyNowNs() noexcept {
+    if (const auto* clock = detail::activeClock) return clock->nowNs();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /// Wall-clock nanoseconds since epoch; under a virtual clock its time (backtests run on recorded UTC timestamps)
+  inline int64_t wallNowNs() noexcept {
+    if (const auto* clock = detail::activeClock) return clock->nowNs();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+  }
+
+  /// `steadyNowNs()` as a steady_clock time point
+  inline std::chrono::steady_clock::time_point steadyNow() noexcept {
+    return std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(steadyNowNs())));
+  }
+
+  /**
+   * @brief Installs a virtual clock on the current thread for the scope's lifetime
+   */
+  class ScopedVirtualClock {
+  public:
+    explicit ScopedVirtualClock(const VirtualClock& clock) noexcept : previous_(detail::activeClock) {
+      detail::activeClock = &clock;
+    }
+
+    ~ScopedVirtualClock() { detail::activeClock = previous_; }
+
+    ScopedVirtualClock(const ScopedVirtualClock&) = delete;
+    ScopedVirtualClock& operator=(const ScopedVirtualClock&) = delete;
+
+  private:
+    const VirtualClock* previous_;
+  };
+
+  /**
+   * @brief Cheapest available interval counter: the TSC on x86-64, steady_clock ticks elsewhere
+   *
+   * Only differences of `now()` are meaningful. The tick length is calibrated against
+   * steady_clock over ~5 ms on the first `nsPerTick()` call; call it once up front to
+   * keep that pause off a measured path. Assumes an invariant TSC (every x86-64 CPU of
+   * the last decade).
+   */
+  struct CycleClock {
+    static uint64_t now() noexcept {
+#ifdef IBW_HAS_TSC
+      return __rdtsc();
+#else
+      return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    static double nsPerTick() {
+      static const double value = calibrate();
+      return value;
+    }
+
+    static uint64_t toNs(uint64_t ticks) { return static_cast<uint64_t>(static_cast<double>(ticks) * nsPerTick()); }
+
+  private:
+    static double calibrate() {
+#ifdef IBW_HAS_TSC
+      using Steady = std::chrono::steady_clock;
+      const auto t0 = Steady::now();
+      const uint64_t c0 = now();
+      auto t1 = t0;
+      while (t1 - t0 < std::chrono::milliseconds(5)) t1 = Steady::now();
+      const uint64_t c1 = now();
+      return std::chrono::duration<double, std::nano>(t1 - t0).count() / static_cast<double>(c1 - c0);
+#else
+      return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::duration(1)).count();
+#endif
+    }
+  };
+
+}  // namespace IB::Helpers
+
+#endif  // QUANTDREAMCPP_CLOCK_H
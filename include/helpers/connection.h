@@ -33,7 +33,7 @@ namespace IB::Helpers {
                ". Next open at ", buf);
     }
 
-    return IB::Helpers::measure([&]() -> bool {
+    return IB::Helpers::measure(IBW_PERF_TIMER("ensureConnected"), [&]() -> bool {
       int attempt = 0;
 
       while (true) {
@@ -68,7 +68,7 @@ namespace IB::Helpers {
         ib.disconnect();
         std::this_thread::sleep_for(std::chrono::seconds(2));
       }
-    }, "ensureConnected");
+    });
   }
 } // namespace IB::Helpers
 
@@ -0,0 +1,471 @@
+#ifndef QUANTDREAMCPP_LOG_FILE_H
+#define QUANTDREAMCPP_LOG_FILE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "helpers/log_ring.h"
+#include "helpers/log_sites.h"
+
+/**
+ * @file log_file.h
+ * @brief Compact on-disk format of the binary logger
+ *
+ * A 16-byte file header followed by entries. Each entry starts with a varint
+ * `id << 2 | kind`:
+ *
+ * | Kind   | id          | Body                                                            |
+ * |--------|-------------|-----------------------------------------------------------------|
+ * | RECORD | site (or 0) | zig-zag varint timestamp delta, [site 0: level, flags], args, 0 |
+ * | SITE   | site        | level, varint line, file, varint count, per argument: literal flag [+ text] |
+ * | STRING | index       | text (defines a dictionary string)                              |
+ *
+ * Strings are varint length + bytes. Arguments are a tag byte and a value: integers as
+ * (zig-zag) varints, doubles that are exact decimals as `m / 10^k` (`TAG_DECIMAL`, so
+ * prices and sizes take 2-5 bytes) or else raw, short strings as a reference into the
+ * dictionary after their first occurrence. The writer transcodes the ring records on the
+ * background thread; the reader turns entries back into ring records, so rendering is
+ * shared with the text writer.
+ */
+
+namespace IB::Helpers::Logging {
+
+  constexpr char FILE_MAGIC[8] = {'I', 'B', 'W', 'L', 'O', 'G', '\0', '\1'};
+  constexpr uint32_t FILE_VERSION = 1;
+
+  /// Header at offset 0 of a binary log file
+  struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+  };
+  static_assert(sizeof(FileHeader) == 16);
+
+  namespace FileFormat {
+    enum EntryKind : uint8_t { RECORD = 0, SITE = 1, STRING = 2 };
+
+    /// Argument tags beyond ArgTag
+    constexpr uint8_t TAG_DECIMAL = 7;      ///< F64 as m / 10^k: u8 k, zig-zag varint m
+    constexpr uint8_t TAG_STRING_REF = 8;   ///< STR as varint dictionary index
+
+    constexpr size_t MAX_INTERNED = 64;         ///< Longer strings are always written inline
+    constexpr uint32_t MAX_DICTIONARY = 1 << 16;
+    constexpr int MAX_DECIMALS = 8;
+
+    inline uint64_t zigzag(int64_t v) noexcept { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+    inline int64_t unzigzag(uint64_t z) noexcept { return static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1); }
+
+    inline void putVarint(std::string& out, uint64_t v) {
+      while (v >= 0x80) {
+        out.push_back(static_cast<char>(v | 0x80));
+        v >>= 7;
+      }
+      out.push_back(static_cast<char>(v));
+    }
+
+    inline void putString(std::string& out, std::string_view s) {
+      putVarint(out, s.size());
+      out.append(s);
+    }
+
+    inline constexpr double POW10[MAX_DECIMALS + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8};
+
+    /// Smallest `k` with `v == m / 10^k` exactly; false if there is none up to MAX_DECIMALS
+    inline bool toDecimal(double v, int& k, int64_t& m) noexcept {
+      if (v == 0.0 && std::signbit(v)) return false;   // -0 would come back as 0
+      for (k = 0; k <= MAX_DECIMALS; ++k) {
+        const double scaled = v * POW10[k];
+        if (!(std::fabs(scaled) < 9007199254740992.0)) return false;   // also NaN / inf
+        const double r = std::nearbyint(scaled);
+        if (r / POW10[k] == v) {
+          m = static_cast<int64_t>(r);
+          return true;
+        }
+      }
+      return false;
+    }
+  }  // namespace FileFormat
+
+  /**
+   * @brief Transcodes ring records into file entries (background writer thread)
+   *
+   * Stateful: timestamps are deltas and strings are interned, so one writer serves one
+   * file from its header on.
+   */
+  class LogFileWriter {
+  public:
+    /// Starts a new file: appends the header and forgets the dictionary
+    void begin(std::string& out) {
+      lastTs_ = 0;
+      strings_.clear();
+      FileHeader fh{};
+      std::memcpy(fh.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+      fh.version = FILE_VERSION;
+      out.append(reinterpret_cast<const char*>(&fh), sizeof(fh));
+    }
+
+    void site(uint16_t id, const SiteInfo& s, std::string& out) const {
+      using namespace FileFormat;
+      putVarint(out, uint64_t{id} << 2 | SITE);
+      out.push_back(static_cast<char>(s.level));
+      putVarint(out, static_cast<uint64_t>(s.line));
+      putString(out, s.file);
+      putVarint(out, s.segments.size());
+      for (const auto& seg : s.segments) {
+        out.push_back(seg.literal ? 1 : 0);
+        if (seg.literal) putString(out, seg.text);
+      }
+    }
+
+    void record(const RecordHeader& h, std::string& out) {
+      using namespace FileFormat;
+      body_.clear();
+      startRecord(h.timestampNs, h.site, h.level, h.flags);
+      const char* p = payloadOf(h);
+      const char* const end = recordEnd(h);
+      while (p < end && *p != 0) {
+        const auto tag = static_cast<ArgTag>(*p);
+        switch (tag) {
+          case ArgTag::I64: {
+            int64_t v;
+            std::memcpy(&v, p + 1, 8);
+            body_.push_back(static_cast<char>(tag));
+            putVarint(body_, zigzag(v));
+            p += 9;
+            break;
+          }
+          case ArgTag::U64: {
+            uint64_t v;
+            std::memcpy(&v, p + 1, 8);
+            body_.push_back(static_cast<char>(tag));
+            putVarint(body_, v);
+            p += 9;
+            break;
+          }
+          case ArgTag::F64: {
+            double v;
+            std::memcpy(&v, p + 1, 8);
+            int k;
+            int64_t m;
+            if (toDecimal(v, k, m)) {
+              body_.push_back(static_cast<char>(TAG_DECIMAL));
+              body_.push_back(static_cast<char>(k));
+              putVarint(body_, zigzag(m));
+            } else {
+              body_.push_back(static_cast<char>(tag));
+              body_.append(p + 1, 8);
+            }
+            p += 9;
+            break;
+          }
+          case ArgTag::BOOL:
+          case ArgTag::CHAR:
+            body_.append(p, 2);
+            p += 2;
+            break;
+          case ArgTag::STR: {
+            uint32_t n;
+            std::memcpy(&n, p + 1, 4);
+            string(std::string_view(p + 5, n), out);
+            p += 5 + n;
+            break;
+          }
+          default:
+            p = end;   // corrupt record: keep what was decoded
+        }
+      }
+      finish(h.site, out);
+    }
+
+    /// A site-less record with one string argument (the writer's own notices)
+    void note(uint8_t level, int64_t timestampNs, std::string_view text, std::string& out) {
+      body_.clear();
+      startRecord(timestampNs, 0, level, 0);
+      body_.push_back(static_cast<char>(ArgTag::STR));
+      FileFormat::putString(body_, text);
+      finish(0, out);
+    }
+
+  private:
+    void startRecord(int64_t timestampNs, uint16_t site, uint8_t level, uint8_t flags) {
+      FileFormat::putVarint(body_, FileFormat::zigzag(timestampNs - lastTs_));
+      lastTs_ = timestampNs;
+      if (site == 0) {
+        body_.push_back(static_cast<char>(level));
+        body_.push_back(static_cast<char>(flags));
+      }
+    }
+
+    void finish(uint16_t site, std::string& out) {
+      body_.push_back(0);
+      FileFormat::putVarint(out, uint64_t{site} << 2 | FileFormat::RECORD);
+      out += body_;
+    }
+
+    /// Dictionary reference, preceded by the STRING entry on first use, or inline text
+    void string(std::string_view s, std::string& out) {
+      using namespace FileFormat;
+      if (s.size() <= MAX_INTERNED) {
+        auto it = strings_.find(std::string(s));
+        if (it == strings_.end() && strings_.size() < MAX_DICTIONARY) {
+          const auto index = static_cast<uint32_t>(strings_.size());
+          it = strings_.emplace(std::string(s), index).first;
+          putVarint(out, uint64_t{index} << 2 | STRING);
+          putString(out, s);
+        }
+        if (it != strings_.end()) {
+          body_.push_back(static_cast<char>(TAG_STRING_REF));
+          putVarint(body_, it->second);
+          return;
+        }
+      }
+      body_.push_back(static_cast<char>(ArgTag::STR));
+      putString(body_, s);
+    }
+
+    int64_t lastTs_ = 0;
+    std::unordered_map<std::string, uint32_t> strings_;
+    std::string body_;
+  };
+
+  /**
+   * @brief Reads a binary log file back into ring records
+   */
+  class LogFileReader {
+  public:
+    enum class Entry { RECORD, SITE, END, CORRUPT };
+
+    explicit LogFileReader(std::FILE* in) : in_(in), buf_(1 << 16) {}
+
+    /// Checks the file header
+    bool open() {
+      FileHeader fh{};
+      if (!bytes(reinterpret_cast<char*>(&fh), sizeof(fh)) || std::memcmp(fh.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+        return fail("not a binary log");
+      if (fh.version != FILE_VERSION) return fail("unsupported version " + std::to_string(fh.version));
+      return true;
+    }
+
+    /// Next record or site definition; dictionary entries are consumed on the way
+    Entry next() {
+      using namespace FileFormat;
+      for (;;) {
+        uint64_t head;
+        if (!fill(1)) return Entry::END;
+        if (!varint(head)) return corrupt("truncated entry");
+        const uint64_t id = head >> 2;
+        switch (head & 3) {
+          case STRING: {
+            std::string s;
+            if (!string(s) || id != strings_.size()) return corrupt("bad dictionary entry");
+            strings_.push_back(std::move(s));
+            break;
+          }
+          case SITE:
+            return readSite(id);
+          case RECORD:
+            return readRecord(id);
+          default:
+            return corrupt("unknown entry kind");
+        }
+      }
+    }
+
+    /// The record of the last RECORD entry, in ring layout
+    const RecordHeader& record() const noexcept { return *reinterpret_cast<const RecordHeader*>(record_.data()); }
+
+    /// Id of the last SITE entry
+    uint16_t siteId() const noexcept { return lastSite_; }
+    const SiteInfo& site(uint16_t id) const { return sites_[id - 1]; }
+
+    /// Definition of a record's site; null for site 0
+    const SiteInfo* siteOf(const RecordHeader& h) const noexcept {
+      return h.site != 0 && h.site <= sites_.size() ? &sites_[h.site - 1] : nullptr;
+    }
+
+    const std::string& error() const noexcept { return error_; }
+
+  private:
+    Entry readSite(uint64_t id) {
+      SiteInfo s;
+      uint8_t level;
+      uint64_t line, count;
+      if (id == 0 || id >= NO_SITE || !byte(level) || !varint(line) || !string(s.file) || !varint(count))
+        return corrupt("bad site definition");
+      s.level = level;
+      s.line = static_cast<int>(line);
+      for (uint64_t i = 0; i < count; ++i) {
+        uint8_t literal;
+        SiteInfo::Segment seg{false, {}};
+        if (!byte(literal) || (literal && !string(seg.text))) return corrupt("bad site definition");
+        seg.literal = literal != 0;
+        s.segments.push_back(std::move(seg));
+      }
+      if (sites_.size() < id) sites_.resize(id);
+      sites_[id - 1] = std::move(s);
+      lastSite_ = static_cast<uint16_t>(id);
+      return Entry::SITE;
+    }
+
+    Entry readRecord(uint64_t id) {
+      using namespace FileFormat;
+      RecordHeader h{0, static_cast<uint16_t>(id), 0, 0, 0};
+      uint64_t delta;
+      if (!varint(delta)) return corrupt("truncated record");
+      lastTs_ += unzigzag(delta);
+      h.timestampNs = lastTs_;
+      if (id == 0) {
+        if (!byte(h.level) || !byte(h.flags)) return corrupt("truncated record");
+      } else if (id <= sites_.size()) {
+        h.level = sites_[id - 1].level;
+      } else {
+        return corrupt("record of an undefined site");
+      }
+
+      payload_.clear();
+      for (;;) {
+        uint8_t tag;
+        if (!byte(tag)) return corrupt("truncated record");
+        if (tag == 0) break;
+        uint64_t u;
+        switch (tag) {
+          case static_cast<uint8_t>(ArgTag::I64):
+            if (!varint(u)) return corrupt("truncated record");
+            append(unzigzag(u));
+            break;
+          case static_cast<uint8_t>(ArgTag::U64):
+            if (!varint(u)) return corrupt("truncated record");
+            append(u);
+            break;
+          case static_cast<uint8_t>(ArgTag::F64): {
+            double d;
+            if (!bytes(reinterpret_cast<char*>(&d), 8)) return corrupt("truncated record");
+            append(d);
+            break;
+          }
+          case TAG_DECIMAL: {
+            uint8_t k;
+            if (!byte(k) || k > MAX_DECIMALS || !varint(u)) return corrupt("bad decimal");
+            append(static_cast<double>(unzigzag(u)) / POW10[k]);
+            break;
+          }
+          case static_cast<uint8_t>(ArgTag::BOOL):
+          case static_cast<uint8_t>(ArgTag::CHAR): {
+            uint8_t v;
+            if (!byte(v)) return corrupt("truncated record");
+            payload_.push_back(static_cast<char>(tag));
+            payload_.push_back(static_cast<char>(v));
+            break;
+          }
+          case static_cast<uint8_t>(ArgTag::STR): {
+            std::string s;
+            if (!string(s)) return corrupt("truncated record");
+            append(std::string_view(s));
+            break;
+          }
+          case TAG_STRING_REF:
+            if (!varint(u) || u >= strings_.size()) return corrupt("bad string reference");
+            append(std::string_view(strings_[u]));
+            break;
+          default:
+            return corrupt("unknown argument tag");
+        }
+      }
+
+      const size_t bytes = (sizeof(RecordHeader) + payload_.size() + 7) & ~size_t{7};
+      h.size = static_cast<uint32_t>(bytes);
+      record_.assign(bytes / 8, 0);
+      std::memcpy(record_.data(), &h, sizeof(h));
+      std::memcpy(reinterpret_cast<char*>(record_.data()) + sizeof(h), payload_.data(), payload_.size());
+      return Entry::RECORD;
+    }
+
+    template <typename T>
+    void append(const T& v) {
+      const size_t at = payload_.size();
+      payload_.resize(at + encodedSize(v));
+      encodeArg(payload_.data() + at, v);
+    }
+
+    // --- buffered input ---------------------------------------------
+
+    /// At least `n` bytes buffered (n <= buffer size); false at end of file
+    bool fill(size_t n) {
+      if (len_ - pos_ >= n) return true;
+      std::memmove(buf_.data(), buf_.data() + pos_, len_ - pos_);
+      len_ -= pos_;
+      pos_ = 0;
+      len_ += std::fread(buf_.data() + len_, 1, buf_.size() - len_, in_);
+      return len_ >= n;
+    }
+
+    bool byte(uint8_t& v) {
+      if (!fill(1)) return false;
+      v = static_cast<uint8_t>(buf_[pos_++]);
+      return true;
+    }
+
+    bool varint(uint64_t& v) {
+      v = 0;
+      for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t b;
+        if (!byte(b)) return false;
+        v |= uint64_t{b & 0x7Fu} << shift;
+        if (!(b & 0x80)) return true;
+      }
+      return false;
+    }
+
+    bool bytes(char* out, size_t n) {
+      while (n > 0) {
+        if (!fill(1)) return false;
+        const size_t take = std::min(n, len_ - pos_);
+        std::memcpy(out, buf_.data() + pos_, take);
+        pos_ += take;
+        out += take;
+        n -= take;
+      }
+      return true;
+    }
+
+    bool string(std::string& s) {
+      uint64_t n;
+      if (!varint(n) || n > (uint64_t{1} << 32)) return false;
+      s.resize(n);
+      return bytes(s.data(), n);
+    }
+
+    bool fail(std::string msg) {
+      error_ = std::move(msg);
+      return false;
+    }
+
+    Entry corrupt(std::string msg) {
+      fail(std::move(msg));
+      return Entry::CORRUPT;
+    }
+
+    std::FILE* in_;
+    std::vector<char> buf_;
+    size_t pos_ = 0;
+    size_t len_ = 0;
+
+    std::vector<SiteInfo> sites_;
+    std::vector<std::string> strings_;
+    uint16_t lastSite_ = 0;
+    int64_t lastTs_ = 0;
+    std::string payload_;
+    std::vector<uint64_t> record_;
+    std::string error_;
+  };
+
+}  // namespace IB::Helpers::Logging
+
+#endif  // QUANTDREAMCPP_LOG_FILE_H
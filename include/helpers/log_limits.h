@@ -0,0 +1,145 @@
+#ifndef QUANTDREAMCPP_LOG_LIMITS_H
+#define QUANTDREAMCPP_LOG_LIMITS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "helpers/log_sites.h"
+
+/**
+ * @file log_limits.h
+ * @brief Per-call-site rate limiting and sampling of LOG_* statements
+ *
+ * Rules are set per category: the "[Tag]"s a statement's message starts with, e.g.
+ * `"[IB] [tickPrice] Fulfilled "` belongs to `IB` and `tickPrice` (the innermost tag
+ * with a rule wins), `"[PerfTimer] "` to `PerfTimer`. A rule applies to each call site
+ * of the category separately:
+ *
+ * - `sampleEvery = M`: only every M-th call of the site is logged
+ * - `maxPerSecond = N`: at most N lines of the site per one-second window
+ *
+ * Suppressed calls skip their argument evaluation altogether. Their count is reported
+ * as one "[Logger] N lines suppressed at file:line" line when the site's next window
+ * opens. Without any rule the check is a single relaxed load.
+ */
+
+namespace IB::Helpers::Logging {
+
+  struct RateLimit {
+    uint32_t maxPerSecond = 0;   ///< Lines per site and second; 0 = unlimited
+    uint32_t sampleEvery = 1;    ///< Log one call in this many; 1 = every call
+  };
+
+  class RateLimits {
+  public:
+    /// True once any rule is set
+    static bool active() noexcept { return active_.load(std::memory_order_relaxed); }
+
+    /// Rule for a category (the tag without brackets); replaces an earlier one
+    static void set(std::string category, RateLimit limit) {
+      std::lock_guard lk(mutex_);
+      rules_[std::move(category)] = limit;
+      changed();
+    }
+
+    /// Rule for the sites no category rule matches
+    static void setDefault(RateLimit limit) {
+      std::lock_guard lk(mutex_);
+      default_ = limit;
+      changed();
+    }
+
+    static void clear() {
+      std::lock_guard lk(mutex_);
+      rules_.clear();
+      default_.reset();
+      changed();
+      active_.store(false, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Decides whether one call of `site` is logged
+     *
+     * @param suppressed Set to the number of calls suppressed since the last report
+     *                   when this call opens a new window; left alone otherwise
+     *
+     * Counting is approximate when threads race on a window boundary.
+     */
+    static bool admit(LogSite& site, uint64_t& suppressed) {
+      if (site.limitVersion.load(std::memory_order_acquire) != version_.load(std::memory_order_acquire)) resolve(site);
+      const uint32_t maxPerSecond = site.maxPerSecond.load(std::memory_order_relaxed);
+      const uint32_t every = site.sampleEvery.load(std::memory_order_relaxed);
+      if (maxPerSecond == 0 && every <= 1) return true;
+
+      const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count();
+      int64_t start = site.windowStartNs.load(std::memory_order_relaxed);
+      if (now - start >= 1'000'000'000 &&
+          site.windowStartNs.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+        site.windowCount.store(0, std::memory_order_relaxed);
+        suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+      }
+
+      bool pass = every <= 1 || site.calls.fetch_add(1, std::memory_order_relaxed) % every == 0;
+      if (pass && maxPerSecond != 0) pass = site.windowCount.fetch_add(1, std::memory_order_relaxed) < maxPerSecond;
+      if (!pass) site.suppressed.fetch_add(1, std::memory_order_relaxed);
+      return pass;
+    }
+
+    /// Leading "[Tag]"s of a statement's source text, outermost first
+    static std::vector<std::string_view> categoriesOf(std::string_view source) {
+      std::vector<std::string_view> tags;
+      size_t i = source.find_first_not_of(" \t\r\n");
+      if (i == std::string_view::npos || source[i] != '"') return tags;
+      ++i;
+      for (;;) {
+        while (i < source.size() && source[i] == ' ') ++i;
+        if (i >= source.size() || source[i] != '[') break;
+        const size_t close = source.find_first_of("]\"", i);
+        if (close == std::string_view::npos || source[close] != ']') break;
+        tags.push_back(source.substr(i + 1, close - i - 1));
+        i = close + 1;
+      }
+      return tags;
+    }
+
+  private:
+    /// Caches the rule of `site` for the current version
+    static void resolve(LogSite& site) {
+      std::lock_guard lk(mutex_);
+      RateLimit rule = default_.value_or(RateLimit{});
+      const auto tags = categoriesOf(site.source ? site.source : "");
+      for (auto it = tags.rbegin(); it != tags.rend(); ++it) {
+        if (auto r = rules_.find(std::string(*it)); r != rules_.end()) {
+          rule = r->second;
+          break;
+        }
+      }
+      site.maxPerSecond.store(rule.maxPerSecond, std::memory_order_relaxed);
+      site.sampleEvery.store(rule.sampleEvery, std::memory_order_relaxed);
+      site.limitVersion.store(version_.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+
+    /// Invalidates the rules cached by the sites; called with the mutex held
+    static void changed() {
+      version_.fetch_add(1, std::memory_order_release);
+      active_.store(true, std::memory_order_relaxed);
+    }
+
+    static inline std::mutex mutex_;
+    static inline std::unordered_map<std::string, RateLimit> rules_;
+    static inline std::optional<RateLimit> default_;
+    static inline std::atomic<uint32_t> version_{1};
+    static inline std::atomic<bool> active_{false};
+  };
+
+}  // namespace IB::Helpers::Logging
+
+#endif  // QUANTDREAMCPP_LOG_LIMITS_H
@@ -0,0 +1,304 @@
+#ifndef QUANTDREAMCPP_LOG_RING_H
+#define QUANTDREAMCPP_LOG_RING_H
+
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @file log_ring.h
+ * @brief Per-thread record ring and compact argument encoding of the asynchronous logger
+ *
+ * A log call encodes its arguments as tagged raw values (integers and doubles as 8 bytes,
+ * strings as length + bytes) straight into the calling thread's ring; the background
+ * thread turns them into text. Only arguments without a raw encoding (types with a
+ * custom `operator<<`) are formatted on the caller, through `std::ostringstream`.
+ *
+ * Records of a `LOG_*` call site carry the site's id and leave out its string literals,
+ * which are kept once in the site table (log_sites.h). The encoded arguments run to the
+ * end of the record; the padding up to the next 8-byte boundary is zero.
+ */
+
+namespace IB::Helpers::Logging {
+
+  /// Value kinds of the encoded arguments
+  enum class ArgTag : uint8_t { I64 = 1, U64, F64, BOOL, CHAR, STR };
+
+  /// Header of one record; the encoded arguments follow
+  struct RecordHeader {
+    uint32_t size;          ///< Bytes including the header, multiple of 8; 0 marks a wrap to the ring start
+    uint16_t site;          ///< LogSite id; 0 when every argument is in the record
+    uint8_t level;          ///< Logger::Level
+    uint8_t flags;
+    int64_t timestampNs;    ///< system_clock, orders the threads' records
+  };
+  static_assert(sizeof(RecordHeader) == 16);
+
+  /// RecordHeader::flags
+  constexpr uint8_t RECORD_RAW = 1;   ///< Printed without the "[LEVEL] " prefix (sections, empty lines)
+
+  // ------------------------------------------------------------------
+  // Argument encoding
+  // ------------------------------------------------------------------
+
+  namespace detail {
+    template <typename T>
+    using Plain = std::remove_cvref_t<T>;
+
+    template <typename T>
+    constexpr bool isString = std::is_same_v<Plain<T>, std::string> || std::is_same_v<Plain<T>, std::string_view> ||
+                              std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>;
+
+    template <typename T>
+    constexpr bool isChar = std::is_same_v<Plain<T>, char> || std::is_same_v<Plain<T>, signed char> ||
+                            std::is_same_v<Plain<T>, unsigned char>;
+
+    /// Unscoped enums print as their value
+    template <typename T>
+    constexpr bool isUnscopedEnum = std::is_enum_v<Plain<T>> && std::is_convertible_v<Plain<T>, int>;
+  }
+
+  /// A `const char[N]` argument: a string literal, kept in the site table instead of the record
+  template <typename T>
+  constexpr bool isLiteral = std::is_array_v<std::remove_reference_t<T>> &&
+                             std::is_same_v<std::remove_extent_t<std::remove_reference_t<T>>, const char>;
+
+  /// Stands for a literal left out of a site record
+  struct Omitted {};
+
+  /// True if `T` has a raw encoding; other types are formatted on the caller
+  template <typename T>
+  constexpr bool isEncodable = std::is_arithmetic_v<detail::Plain<T>> || detail::isString<T> || detail::isUnscopedEnum<T>;
+
+  /// An encodable argument as is, anything else as its `operator<<` text
+  template <typename T>
+  decltype(auto) prepareArg(const T& v) {
+    if constexpr (isEncodable<T>) {
+      return (v);
+    } else {
+      std::ostringstream oss;
+      oss << v;
+      return oss.str();
+    }
+  }
+
+  /// For a site record: literals are left out, the rest as prepareArg()
+  template <typename T>
+  decltype(auto) prepareSiteArg(const T& v) {
+    if constexpr (isLiteral<const T&>) return Omitted{};
+    else return prepareArg(v);
+  }
+
+  inline std::string_view stringOf(const char* s) noexcept { return s ? std::string_view(s) : std::string_view("(null)"); }
+  inline std::string_view stringOf(std::string_view s) noexcept { return s; }
+
+  /// Encoded size of one argument
+  template <typename T>
+  size_t encodedSize(const T& v) noexcept {
+    if constexpr (std::is_same_v<T, Omitted>) return 0;
+    else if constexpr (std::is_same_v<detail::Plain<T>, bool> || detail::isChar<T>) return 2;
+    else if constexpr (detail::isString<T>) return 5 + stringOf(v).size();
+    else return 9;
+  }
+
+  /// Writes one argument at `p`; returns the end
+  template <typename T>
+  char* encodeArg(char* p, const T& v) noexcept {
+    using U = detail::Plain<T>;
+    auto put = [&p](ArgTag tag, const void* data, size_t n) {
+      *p++ = static_cast<char>(tag);
+      std::memcpy(p, data, n);
+      p += n;
+    };
+    if constexpr (std::is_same_v<U, Omitted>) {
+      return p;
+    } else if constexpr (std::is_same_v<U, bool>) {
+      const char b = v ? 1 : 0;
+      put(ArgTag::BOOL, &b, 1);
+    } else if constexpr (detail::isChar<T>) {
+      const char c = static_cast<char>(v);
+      put(ArgTag::CHAR, &c, 1);
+    } else if constexpr (detail::isString<T>) {
+      const std::string_view s = stringOf(v);
+      const auto n = static_cast<uint32_t>(s.size());
+      *p++ = static_cast<char>(ArgTag::STR);
+      std::memcpy(p, &n, 4);
+      std::memcpy(p + 4, s.data(), n);
+      p += 4 + n;
+    } else if constexpr (std::is_floating_point_v<U>) {
+      const double d = static_cast<double>(v);
+      put(ArgTag::F64, &d, 8);
+    } else if constexpr (std::is_signed_v<U> || detail::isUnscopedEnum<T>) {
+      const int64_t i = static_cast<int64_t>(v);
+      put(ArgTag::I64, &i, 8);
+    } else {
+      const uint64_t u = static_cast<uint64_t>(v);
+      put(ArgTag::U64, &u, 8);
+    }
+    return p;
+  }
+
+  /**
+   * @brief Appends the text of the encoded argument at `p`, as `std::ostream <<` would print it
+   *
+   * Advances `p`. Returns false at the zero padding, the end, or a truncated argument.
+   */
+  inline bool formatArg(const char*& p, const char* end, std::string& out) {
+    if (p >= end || *p == 0) return false;
+    const auto tag = static_cast<ArgTag>(*p);
+    const size_t avail = static_cast<size_t>(end - p) - 1;
+    char buf[32];
+    switch (tag) {
+      case ArgTag::I64: {
+        if (avail < 8) return false;
+        int64_t v;
+        std::memcpy(&v, p + 1, 8);
+        out.append(buf, std::to_chars(buf, buf + sizeof(buf), v).ptr);
+        p += 9;
+        return true;
+      }
+      case ArgTag::U64: {
+        if (avail < 8) return false;
+        uint64_t v;
+        std::memcpy(&v, p + 1, 8);
+        out.append(buf, std::to_chars(buf, buf + sizeof(buf), v).ptr);
+        p += 9;
+        return true;
+      }
+      case ArgTag::F64: {
+        if (avail < 8) return false;
+        double v;
+        std::memcpy(&v, p + 1, 8);
+        out.append(buf, static_cast<size_t>(std::snprintf(buf, sizeof(buf), "%g", v)));   // ostream default
+        p += 9;
+        return true;
+      }
+      case ArgTag::BOOL:
+        if (avail < 1) return false;
+        out.push_back(p[1] ? '1' : '0');
+        p += 2;
+        return true;
+      case ArgTag::CHAR:
+        if (avail < 1) return false;
+        out.push_back(p[1]);
+        p += 2;
+        return true;
+      case ArgTag::STR: {
+        uint32_t n;
+        if (avail < 4) return false;
+        std::memcpy(&n, p + 1, 4);
+        if (avail - 4 < n) return false;
+        out.append(p + 5, n);
+        p += 5 + n;
+        return true;
+      }
+      default:
+        return false;   // corrupt record
+    }
+  }
+
+  /// Appends the text of every argument in [p, end)
+  inline void formatArgs(const char* p, const char* end, std::string& out) {
+    while (formatArg(p, end, out)) {}
+  }
+
+  // ------------------------------------------------------------------
+  // Ring
+  // ------------------------------------------------------------------
+
+  /**
+   * @brief Single-producer / single-consumer byte ring of variable-size records
+   *
+   * The owning thread reserves and commits records; the background thread reads them in
+   * order and releases the space. Records are contiguous: when one does not fit before
+   * the end of the buffer, a wrap marker sends both sides back to the start.
+   */
+  class LogRing {
+  public:
+    explicit LogRing(size_t capacity) {
+      size_t cap = 4096;
+      while (cap < capacity) cap <<= 1;
+      data_.reset(new char[cap]);   // left uninitialised: pages are touched as records arrive
+      capacity_ = cap;
+      mask_ = cap - 1;
+    }
+
+    size_t capacity() const noexcept { return capacity_; }
+
+    /// Largest record that is guaranteed to fit an empty ring
+    size_t maxRecord() const noexcept { return capacity_ / 2; }
+
+    /**
+     * @brief Reserves `bytes` (multiple of 8) for a record; nullptr if the ring is full
+     *
+     * Producer only. The record becomes visible with commit().
+     */
+    char* reserve(size_t bytes) noexcept {
+      const uint64_t head = head_.load(std::memory_order_relaxed);
+      const size_t toEnd = capacity_ - (head & mask_);
+      const size_t need = bytes + (toEnd < bytes ? toEnd : 0);
+      if (capacity_ - (head - cachedTail_) < need) {
+        cachedTail_ = tail_.load(std::memory_order_acquire);
+        if (capacity_ - (head - cachedTail_) < need) return nullptr;
+      }
+      pendingHead_ = head;
+      if (toEnd < bytes) {
+        const uint32_t wrap = 0;
+        std::memcpy(data_.get() + (head & mask_), &wrap, sizeof(wrap));
+        pendingHead_ += toEnd;
+      }
+      pendingBytes_ = bytes;
+      return data_.get() + (pendingHead_ & mask_);
+    }
+
+    void commit() noexcept { head_.store(pendingHead_ + pendingBytes_, std::memory_order_release); }
+
+    /// Records the producer could not fit
+    void countDrop() noexcept { dropped_.fetch_add(1, std::memory_order_relaxed); }
+    uint64_t takeDropped() noexcept { return dropped_.exchange(0, std::memory_order_relaxed); }
+
+    // --- consumer ----------------------------------------------------
+
+    /// Read position and committed end, for a pass over the available records
+    uint64_t readPosition() const noexcept { return tail_.load(std::memory_order_relaxed); }
+    uint64_t committed() const noexcept { return head_.load(std::memory_order_acquire); }
+
+    /// Record at `pos`, skipping a wrap marker (advances `pos` past it)
+    const RecordHeader* recordAt(uint64_t& pos) const noexcept {
+      uint32_t size;
+      std::memcpy(&size, data_.get() + (pos & mask_), sizeof(size));
+      if (size == 0) pos += capacity_ - (pos & mask_);
+      return reinterpret_cast<const RecordHeader*>(data_.get() + (pos & mask_));
+    }
+
+    void release(uint64_t pos) noexcept { tail_.store(pos, std::memory_order_release); }
+
+    /// Set when the owning thread exits; the ring is dropped once drained
+    void retire() noexcept { retired_.store(true, std::memory_order_release); }
+    bool retired() const noexcept { return retired_.load(std::memory_order_acquire); }
+
+  private:
+    std::unique_ptr<char[]> data_;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+
+    alignas(64) std::atomic<uint64_t> head_{0};   ///< Written by the producer
+    uint64_t cachedTail_ = 0;
+    uint64_t pendingHead_ = 0;
+    size_t pendingBytes_ = 0;
+    std::atomic<uint64_t> dropped_{0};
+
+    alignas(64) std::atomic<uint64_t> tail_{0};   ///< Written by the consumer
+    std::atomic<bool> retired_{false};
+  };
+
+}  // namespace IB::Helpers::Logging
+
+#endif  // QUANTDREAMCPP_LOG_RING_H
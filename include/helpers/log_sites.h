@@ -0,0 +1,144 @@
+#ifndef QUANTDREAMCPP_LOG_SITES_H
+#define QUANTDREAMCPP_LOG_SITES_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "helpers/log_ring.h"
+
+/**
+ * @file log_sites.h
+ * @brief Call-site table of the asynchronous and binary logger
+ *
+ * Every `LOG_*` statement owns a static `LogSite`. Its first asynchronous call registers
+ * the site (file, line, level and the text of its string-literal arguments) and gets a
+ * 16-bit id; from then on its records carry the id and only the non-literal arguments.
+ * The background writer renders them with the table, or, in binary mode, writes the
+ * table and the records to a log file (log_file.h) for `tools/log_decoder`.
+ */
+
+namespace IB::Helpers::Logging {
+
+  /// Names indexed by Logger::Level
+  inline const char* levelName(uint8_t level) noexcept {
+    static constexpr const char* names[] = {"DEBUG", "TIMER", "INFO", "STRATEGY", "WARN", "ERROR"};
+    return level < std::size(names) ? names[level] : "";
+  }
+
+  /// Static descriptor of one LOG_* statement, constant-initialised
+  struct LogSite {
+    constexpr LogSite(const char* f, int l, const char* src) noexcept : file(f), line(l), source(src) {}
+
+    const char* file;
+    int line;
+    const char* source;            ///< The statement's arguments as written; its leading "[Tag]"s are the categories
+    std::atomic<uint16_t> id{0};   ///< 0 until registered
+
+    // Rate limiting state (log_limits.h)
+    std::atomic<uint32_t> limitVersion{0};   ///< RateLimits version of the cached rule; 0 = unresolved
+    std::atomic<uint32_t> maxPerSecond{0};
+    std::atomic<uint32_t> sampleEvery{0};
+    std::atomic<int64_t> windowStartNs{0};
+    std::atomic<uint32_t> windowCount{0};
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> suppressed{0};
+  };
+
+  /// LogSite::id once the table is full: the site's records carry every argument
+  constexpr uint16_t NO_SITE = 0xFFFF;
+
+  /// Table entry: the literal arguments' text and placeholders for the recorded ones
+  struct SiteInfo {
+    struct Segment {
+      bool literal;
+      std::string text;   ///< Empty for a placeholder
+    };
+
+    std::string file;
+    int line = 0;
+    uint8_t level = 0;
+    std::vector<Segment> segments;
+  };
+
+  template <typename T>
+  SiteInfo::Segment segmentOf(const T& v) {
+    if constexpr (isLiteral<const T&>) return {true, std::string(v, strnlen(v, std::extent_v<T>))};
+    else return {false, {}};
+  }
+
+  class SiteRegistry {
+  public:
+    /// Id of `site` (registering it on first use); 0 if the table is full
+    template <typename... Args>
+    static uint16_t idOf(LogSite& site, uint8_t level, const Args&... args) {
+      const uint16_t id = site.id.load(std::memory_order_acquire);
+      if (id != 0) [[likely]] return id == NO_SITE ? 0 : id;
+      return add(site, level, {segmentOf(args)...});
+    }
+
+    /// Appends the entries from index `out.size()` on (site ids `out.size() + 1` ...)
+    static void copyNew(std::vector<SiteInfo>& out) {
+      std::lock_guard lk(mutex_);
+      out.insert(out.end(), sites_.begin() + static_cast<std::ptrdiff_t>(out.size()), sites_.end());
+    }
+
+  private:
+    static uint16_t add(LogSite& site, uint8_t level, std::vector<SiteInfo::Segment> segments) {
+      std::lock_guard lk(mutex_);
+      uint16_t id = site.id.load(std::memory_order_relaxed);
+      if (id == 0) {
+        if (sites_.size() + 1 >= NO_SITE) {
+          id = NO_SITE;
+        } else {
+          sites_.push_back({site.file, site.line, level, std::move(segments)});
+          id = static_cast<uint16_t>(sites_.size());
+        }
+        site.id.store(id, std::memory_order_release);
+      }
+      return id == NO_SITE ? 0 : id;
+    }
+
+    static inline std::mutex mutex_;
+    static inline std::vector<SiteInfo> sites_;
+  };
+
+  // ------------------------------------------------------------------
+  // Rendering
+  // ------------------------------------------------------------------
+
+  inline const char* payloadOf(const RecordHeader& h) noexcept { return reinterpret_cast<const char*>(&h + 1); }
+  inline const char* recordEnd(const RecordHeader& h) noexcept { return reinterpret_cast<const char*>(&h) + h.size; }
+
+  /// Appends the message of a record without level prefix or newline; `site` is null for site 0
+  inline void renderMessage(const RecordHeader& h, const SiteInfo* site, std::string& out) {
+    const char* p = payloadOf(h);
+    const char* const end = recordEnd(h);
+    if (site) {
+      for (const auto& seg : site->segments) {
+        if (seg.literal) out += seg.text;
+        else formatArg(p, end, out);
+      }
+    }
+    formatArgs(p, end, out);
+  }
+
+  /// Appends the line the synchronous logger would print for a record
+  inline void renderRecord(const RecordHeader& h, const SiteInfo* site, std::string& out) {
+    if (!(h.flags & RECORD_RAW)) {
+      out.push_back('[');
+      out += levelName(h.level);
+      out += "] ";
+    }
+    renderMessage(h, site, out);
+    out.push_back('\n');
+  }
+
+}  // namespace IB::Helpers::Logging
+
+#endif  // QUANTDREAMCPP_LOG_SITES_H
@@ -11,24 +11,79 @@
 #include <sstream>
 #include <string>
 
+#include "helpers/async_log.h"
+#include "helpers/log_limits.h"
+
+// --------------------------------------------------------------------------
+// Compile-time minimum level
+//
+// Build with -DIBW_LOG_LEVEL=IBW_LOG_LEVEL_INFO (or the CMake option
+// IBWRAPPER_LOG_LEVEL=INFO) and every LOG_DEBUG / LOG_TIMER compiles to nothing.
+// Values follow Logger::Level.
+// --------------------------------------------------------------------------
+#define IBW_LOG_LEVEL_DEBUG     0
+#define IBW_LOG_LEVEL_TIMER     1
+#define IBW_LOG_LEVEL_INFO      2
+#define IBW_LOG_LEVEL_STRATEGY  3
+#define IBW_LOG_LEVEL_WARN      4
+#define IBW_LOG_LEVEL_ERROR     5
+#define IBW_LOG_LEVEL_NONE      6
+
+#ifndef IBW_LOG_LEVEL
+#define IBW_LOG_LEVEL IBW_LOG_LEVEL_DEBUG
+#endif
+
+/**
+ * Statements below the compile-time level sit in a discarded `if constexpr` branch: they
+ * are type-checked (no unused-variable warnings) but emit no code. The others evaluate
+ * their arguments only after the runtime level check passes, so a disabled
+ * `LOG_DEBUG("x=", std::to_string(x))` costs one load and a branch.
+ */
+#define IBW_LOG_CALL(compiledIn, lvl, fn, ...)                    \
+  do {                                                            \
+    if constexpr (compiledIn) {                                   \
+      if (Logger::shouldLog(lvl)) Logger::fn(__VA_ARGS__);        \
+    }                                                             \
+  } while (0)
+
+/// As IBW_LOG_CALL, with the statement's LogSite (log_sites.h) and rate limit (log_limits.h)
+#define IBW_LOG_AT(compiledIn, lvl, ...)                                                                  \
+  do {                                                                                                    \
+    if constexpr (compiledIn) {                                                                           \
+      if (Logger::shouldLog(lvl)) {                                                                       \
+        static constinit IB::Helpers::Logging::LogSite ibwLogSite_{__FILE__, __LINE__, #__VA_ARGS__};      \
+        if (Logger::admit(ibwLogSite_, lvl)) Logger::logAt(ibwLogSite_, lvl, __VA_ARGS__);                \
+      }                                                                                                   \
+    }                                                                                                     \
+  } while (0)
+
 // --------------------------------------------------------------------------
 // Macros for easy logging
 // --------------------------------------------------------------------------
-#define LOG_DEBUG(...)       Logger::debug(__VA_ARGS__)
-#define LOG_TIMER(...)       Logger::timer(__VA_ARGS__)
-#define LOG_INFO(...)        Logger::info(__VA_ARGS__)
-#define LOG_STRATEGY(...)    Logger::strategy(__VA_ARGS__)
-#define LOG_WARN(...)        Logger::warn(__VA_ARGS__)
-#define LOG_ERROR(...)       Logger::error(__VA_ARGS__)
-#define LOG_EMPTY()          Logger::empty()
-#define LOG_SECTION(title)   Logger::section(title)
-#define LOG_SECTION_END()    Logger::sectionEnd()
+#define LOG_DEBUG(...)       IBW_LOG_AT(IBW_LOG_LEVEL <= IBW_LOG_LEVEL_DEBUG,    Logger::Level::DEBUG,    __VA_ARGS__)
+#define LOG_TIMER(...)       IBW_LOG_AT(IBW_LOG_LEVEL <= IBW_LOG_LEVEL_TIMER,    Logger::Level::TIMER,    __VA_ARGS__)
+#define LOG_INFO(...)        IBW_LOG_AT(IBW_LOG_LEVEL <= IBW_LOG_LEVEL_INFO,     Logger::Level::INFO,     __VA_ARGS__)
+#define LOG_STRATEGY(...)    IBW_LOG_AT(IBW_LOG_LEVEL <= IBW_LOG_LEVEL_STRATEGY, Logger::Level::STRATEGY, __VA_ARGS__)
+#define LOG_WARN(...)        IBW_LOG_AT(IBW_LOG_LEVEL <= IBW_LOG_LEVEL_WARN,     Logger::Level::WARN,     __VA_ARGS__)
+#define LOG_ERROR(...)       IBW_LOG_AT(IBW_LOG_LEVEL <= IBW_LOG_LEVEL_ERROR,    Logger::Level::ERROR,    __VA_ARGS__)
+#define LOG_SECTION(title)   IBW_LOG_CALL(IBW_LOG_LEVEL <= IBW_LOG_LEVEL_INFO,     Logger::Level::INFO,     section,  title)
+#define LOG_SECTION_END()    IBW_LOG_CALL(IBW_LOG_LEVEL <= IBW_LOG_LEVEL_INFO,     Logger::Level::INFO,     sectionEnd)
+#define LOG_EMPTY()                                                   \
+  do {                                                                \
+    if constexpr (IBW_LOG_LEVEL < IBW_LOG_LEVEL_NONE) Logger::empty(); \
+  } while (0)
 
 /**
  * @brief Thread-safe logger with multiple log levels, including TIMER and STRATEGY.
  *
  * Order of severity:
  *   DEBUG < TIMER < INFO < STRATEGY < WARN < ERROR < NONE
+ *
+ * By default every call formats and writes on the caller's thread. After `startAsync()`
+ * calls only encode their arguments into a per-thread ring and a background thread does
+ * the formatting and I/O (see async_log.h); the output is the same. With
+ * `AsyncOptions::format = LogFormat::BINARY` the records are written unformatted, for
+ * `tools/log_decoder`.
  */
 class Logger {
 public:
@@ -45,27 +100,72 @@ public:
 private:
   static inline std::atomic<bool> enabled{true};
   static inline std::mutex logMutex;
-  static inline Level minLevel = Level::DEBUG;
+  static inline std::atomic<Level> minLevel{Level::DEBUG};
 
   static const char* levelName(Level lvl) {
-    switch (lvl) {
-      case Level::DEBUG:    return "DEBUG";
-      case Level::TIMER:    return "TIMER";
-      case Level::INFO:     return "INFO";
-      case Level::STRATEGY: return "STRATEGY";
-      case Level::WARN:     return "WARN";
-      case Level::ERROR:    return "ERROR";
-      default:              return "";
-    }
+    return IB::Helpers::Logging::levelName(static_cast<uint8_t>(lvl));
+  }
+
+  using Async = IB::Helpers::Logging::AsyncBackend;
+  using Limits = IB::Helpers::Logging::RateLimits;
+
+  /// Hands a line to the background writer when async logging is on
+  template <typename... Args>
+  static bool logAsync(Level lvl, uint8_t flags, const Args&... args) {
+    if (!Async::active()) return false;
+    Async::instance().write(static_cast<uint8_t>(lvl), flags, 0, args...);
+    return true;
   }
 
 public:
   static void setEnabled(bool on) { enabled = on; }
-  static void setLevel(Level lvl) { minLevel = lvl; }
+  static void setLevel(Level lvl) { minLevel.store(lvl, std::memory_order_relaxed); }
+
+  /// Runtime filter; the LOG_* macros test it before evaluating their arguments
+  static bool shouldLog(Level lvl) noexcept {
+    return enabled.load(std::memory_order_relaxed) && lvl >= minLevel.load(std::memory_order_relaxed);
+  }
+
+  // --------------------------------------------------------------------------
+  // Rate limiting and sampling (see log_limits.h)
+  //
+  //   Logger::setRateLimit("PerfTimer", {.maxPerSecond = 5});
+  //   Logger::setRateLimit("tickPrice", {.sampleEvery = 100});
+  // --------------------------------------------------------------------------
+  using RateLimit = IB::Helpers::Logging::RateLimit;
+
+  /// Limits every LOG_* site whose message starts with "[category]" (also after other tags)
+  static void setRateLimit(std::string category, RateLimit limit) { Limits::set(std::move(category), limit); }
+
+  /// Limits the sites of categories without their own rule
+  static void setDefaultRateLimit(RateLimit limit) { Limits::setDefault(limit); }
+
+  static void clearRateLimits() { Limits::clear(); }
+
+  /// Rate limit check of a LOG_* statement, before its arguments are evaluated
+  static bool admit(IB::Helpers::Logging::LogSite& site, Level lvl) {
+    if (!Limits::active()) [[likely]] return true;
+    uint64_t suppressed = 0;
+    const bool pass = Limits::admit(site, suppressed);
+    if (suppressed) log(lvl, "[Logger] ", suppressed, " lines suppressed at ", site.file, ":", site.line);
+    return pass;
+  }
+
+  // --------------------------------------------------------------------------
+  // Asynchronous mode
+  // --------------------------------------------------------------------------
+  static void startAsync(const IB::Helpers::Logging::AsyncOptions& options = {}) { Async::instance().start(options); }
+
+  /// Writes what is queued and returns to synchronous logging
+  static void stopAsync() { Async::instance().stop(); }
+
+  /// Blocks until everything logged so far is written (no-op when synchronous)
+  static void flush() { Async::instance().flush(); }
 
   template <typename... Args>
   static void log(Level lvl, Args&&... args) {
-    if (!enabled || lvl < minLevel) return;
+    if (!shouldLog(lvl)) return;
+    if (logAsync(lvl, 0, args...)) return;
     std::lock_guard<std::mutex> lock(logMutex);
 
     std::ostringstream oss;
@@ -73,6 +173,15 @@ public:
     std::cout << "[" << levelName(lvl) << "] " << oss.str() << std::endl;
   }
 
+  /// log() for a LOG_* statement: asynchronous records carry the site id instead of its literals
+  template <typename... Args>
+  static void logAt(IB::Helpers::Logging::LogSite& site, Level lvl, Args&&... args) {
+    if (!Async::active()) return log(lvl, std::forward<Args>(args)...);
+    if (!shouldLog(lvl)) return;
+    const auto level = static_cast<uint8_t>(lvl);
+    Async::instance().write(level, 0, IB::Helpers::Logging::SiteRegistry::idOf(site, level, args...), args...);
+  }
+
   // --------------------------------------------------------------------------
   // Convenience helpers
   // --------------------------------------------------------------------------
@@ -88,6 +197,7 @@ public:
   // --------------------------------------------------------------------------
   static void empty() {
     if (!enabled) return;
+    if (logAsync(Level::INFO, IB::Helpers::Logging::RECORD_RAW)) return;
     std::lock_guard<std::mutex> lock(logMutex);
     std::cout << std::endl;
   }
@@ -99,8 +209,7 @@ public:
                       Level lvl = Level::INFO,
                       size_t totalWidth = 70)
   {
-    if (!enabled || lvl < minLevel) return;
-    std::lock_guard<std::mutex> lock(logMutex);
+    if (!shouldLog(lvl)) return;
 
     // Use Unicode dash if the terminal supports UTF-8, otherwise ASCII
 #ifdef _WIN32
@@ -125,14 +234,15 @@ public:
 
     std::ostringstream oss;
     oss << left << " " << title << " " << right;
+    if (logAsync(lvl, IB::Helpers::Logging::RECORD_RAW, "\n[", levelName(lvl), "] ", oss.str())) return;
+    std::lock_guard<std::mutex> lock(logMutex);
     std::cout << "\n[" << levelName(lvl) << "] " << oss.str() << std::endl;
   }
 
   static void sectionEnd(Level lvl = Level::INFO,
                        size_t totalWidth = 70)
   {
-    if (!enabled || lvl < minLevel) return;
-    std::lock_guard<std::mutex> lock(logMutex);
+    if (!shouldLog(lvl)) return;
 
 #ifdef _WIN32
     const std::string dash = "-";
@@ -145,6 +255,8 @@ public:
     for (size_t i = 0; i < totalWidth; ++i)
       line += dash;
 
+    if (logAsync(lvl, IB::Helpers::Logging::RECORD_RAW, "[", levelName(lvl), "] ", line)) return;
+    std::lock_guard<std::mutex> lock(logMutex);
     std::cout << "[" << levelName(lvl) << "] " << line << std::endl;
   }
 };
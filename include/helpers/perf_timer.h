@@ -5,9 +5,21 @@
 #ifndef QUANTDREAMCPP_PERF_TIMER_H
 #define QUANTDREAMCPP_PERF_TIMER_H
 #include <chrono>
+#include <condition_variable>
+#include <cstdio>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <type_traits>
+#include <utility>
+#include <vector>
+#include "clock.h"
+#include "latency_histogram.h"
 #include "logger.h"
+#include "trace_events.h"
 
 /**
  * @file perf_timer.h
@@ -15,13 +27,192 @@
  *
  * This file provides templated functions to measure execution time of callables, futures,
  * and async operations. It automatically handles both void and non-void return types,
- * logging execution duration while preserving return values.
+ * preserving return values.
+ *
+ * Two flavours:
+ * - **Named timers** (`measure(IBW_PERF_TIMER("name"), func)`): every call records into
+ *   the timer's lock-free `LatencyHistogram` via `CycleClock`; nothing is logged per
+ *   call. `PerfTimers::dump()` (or a periodic dump) logs count, mean, p50 / p90 / p99 /
+ *   p99.9 and max per timer. The library's own call sites use these. While a trace
+ *   session runs (trace_events.h), each call is also a scope on the timeline.
+ * - **Labelled** (`measure(func, "label")`): one "[PerfTimer]" line per call, for ad-hoc
+ *   timing. On hot paths they can be capped with
+ *   `Logger::setRateLimit("PerfTimer", {.maxPerSecond = N})`.
  */
 
+/// The PerfTimer named `name` (a string literal), looked up once per call site
+#define IBW_PERF_TIMER(name)                                                        \
+  ([]() -> IB::Helpers::PerfTimer& {                                                \
+    static IB::Helpers::PerfTimer& ibwPerfTimer_ = IB::Helpers::PerfTimers::get(name); \
+    return ibwPerfTimer_;                                                           \
+  }())
+
 namespace IB::Helpers {
 
   using Clock = std::chrono::high_resolution_clock;  ///< High-precision clock for performance measurements
 
+  // --------------------------------------------------------------------------
+  //  Named timers
+  // --------------------------------------------------------------------------
+
+  /**
+   * @brief Named latency histogram fed by every call of one code path
+   *
+   * Obtain one with `IBW_PERF_TIMER("name")` or `PerfTimers::get("name")`; a timer lives
+   * until the program exits.
+   */
+  class PerfTimer {
+  public:
+    explicit PerfTimer(std::string name) : name_(std::move(name)) {}
+
+    const std::string& name() const noexcept { return name_; }
+
+    void record(uint64_t ns) noexcept { histogram_.record(ns); }
+    void recordTicks(uint64_t ticks) noexcept { histogram_.record(CycleClock::toNs(ticks)); }
+
+    LatencyHistogram& histogram() noexcept { return histogram_; }
+    const LatencyHistogram& histogram() const noexcept { return histogram_; }
+
+    /// Records the lifetime of the scope, and traces it under the timer's name
+    class Scope {
+    public:
+      explicit Scope(PerfTimer& timer) noexcept
+          : timer_(timer), trace_(timer.name().c_str()), start_(CycleClock::now()) {}
+      ~Scope() { timer_.recordTicks(CycleClock::now() - start_); }
+
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+
+    private:
+      PerfTimer& timer_;
+      TraceScope trace_;
+      uint64_t start_;
+    };
+
+  private:
+    std::string name_;
+    LatencyHistogram histogram_;
+  };
+
+  namespace detail {
+    /// Background thread of PerfTimers::startPeriodicDump()
+    struct PeriodicDumper {
+      std::mutex mutex;
+      std::condition_variable cv;
+      std::thread thread;
+      bool stop = false;
+
+      void shutdown() {
+        std::thread t;
+        {
+          std::lock_guard lk(mutex);
+          stop = true;
+          t = std::move(thread);
+        }
+        cv.notify_all();
+        if (t.joinable()) t.join();
+      }
+
+      ~PeriodicDumper() { shutdown(); }
+    };
+  }
+
+  /**
+   * @brief Registry of the named timers, with on-demand and periodic dumps
+   */
+  class PerfTimers {
+  public:
+    /// Timer named `name`, created on first use
+    static PerfTimer& get(std::string_view name) {
+      CycleClock::nsPerTick();   // calibrate now, not inside the first measured interval
+      std::lock_guard lk(mutex_);
+      for (auto& t : timers_) {
+        if (t->name() == name) return *t;
+      }
+      return *timers_.emplace_back(std::make_unique<PerfTimer>(std::string(name)));
+    }
+
+    /// Name and summary of every timer with samples; `reset` starts a new interval
+    static std::vector<std::pair<std::string, LatencyHistogram::Summary>> snapshot(bool reset = false) {
+      std::vector<std::pair<std::string, LatencyHistogram::Summary>> out;
+      std::lock_guard lk(mutex_);
+      for (auto& t : timers_) {
+        if (t->histogram().count() == 0) continue;
+        out.emplace_back(t->name(), t->histogram().summary());
+        if (reset) t->histogram().reset();
+      }
+      return out;
+    }
+
+    /// Logs one "[Latency]" line per timer with samples
+    static void dump(bool reset = false) {
+      for (const auto& [name, s] : snapshot(reset)) {
+        LOG_INFO("[Latency] ", name, " n=", s.count, " mean=", formatNs(static_cast<uint64_t>(s.meanNs)),
+                 " p50=", formatNs(s.p50Ns), " p90=", formatNs(s.p90Ns), " p99=", formatNs(s.p99Ns),
+                 " p99.9=", formatNs(s.p999Ns), " max=", formatNs(s.maxNs));
+      }
+    }
+
+    /// Calls dump(reset) every `interval` on a background thread until stopPeriodicDump()
+    static void startPeriodicDump(std::chrono::milliseconds interval, bool reset = true) {
+      stopPeriodicDump();
+      std::lock_guard lk(dumper_.mutex);
+      dumper_.stop = false;
+      dumper_.thread = std::thread([interval, reset] {
+        std::unique_lock wl(dumper_.mutex);
+        while (!dumper_.cv.wait_for(wl, interval, [] { return dumper_.stop; })) {
+          wl.unlock();
+          dump(reset);
+          wl.lock();
+        }
+      });
+    }
+
+    static void stopPeriodicDump() { dumper_.shutdown(); }
+
+    /// "850ns", "12.3us", "153.2ms", "2.10s"
+    static std::string formatNs(uint64_t ns) {
+      char buf[32];
+      if (ns < 1'000) std::snprintf(buf, sizeof(buf), "%lluns", static_cast<unsigned long long>(ns));
+      else if (ns < 1'000'000) std::snprintf(buf, sizeof(buf), "%.1fus", static_cast<double>(ns) / 1e3);
+      else if (ns < 1'000'000'000) std::snprintf(buf, sizeof(buf), "%.1fms", static_cast<double>(ns) / 1e6);
+      else std::snprintf(buf, sizeof(buf), "%.2fs", static_cast<double>(ns) / 1e9);
+      return buf;
+    }
+
+  private:
+    static inline std::mutex mutex_;
+    static inline std::vector<std::unique_ptr<PerfTimer>> timers_;
+    static inline detail::PeriodicDumper dumper_;
+  };
+
+  /**
+   * @brief Times a callable into a named timer; nothing is logged
+   *
+   * @code
+   * auto c = IB::Helpers::measure(IBW_PERF_TIMER("getContractDetails"), [&] { return fetch(); });
+   * @endcode
+   */
+  template <typename Func>
+  auto measure(PerfTimer& timer, Func&& func) {
+    PerfTimer::Scope scope(timer);
+    return func();
+  }
+
+  /// Times the wait for `fut` into a named timer
+  template <typename T>
+  auto measureFuture(PerfTimer& timer, std::future<T>& fut) {
+    PerfTimer::Scope scope(timer);
+    return fut.get();
+  }
+
+  /// Times `func()` and the wait for the future it returns into a named timer
+  template <typename Func>
+  auto measureAsync(PerfTimer& timer, Func&& func) {
+    PerfTimer::Scope scope(timer);
+    return func().get();
+  }
+
   // --------------------------------------------------------------------------
   //  Measure synchronous callable
   // --------------------------------------------------------------------------
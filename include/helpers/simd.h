@@ -0,0 +1,145 @@
+#ifndef QUANTDREAMCPP_SIMD_H
+#define QUANTDREAMCPP_SIMD_H
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+/**
+ * @file simd.h
+ * @brief Minimal packed-double abstraction used by the cross-sectional kernels
+ *
+ * Kernels in `analytics/` are written once as templates over a lane type and
+ * instantiated twice: with `Simd::Vec` for the bulk of a column and with plain
+ * `double` for the tail. The overloads below give both types the same vocabulary.
+ *
+ * **Instruction sets**
+ * - AVX2 (4 lanes) when compiled with `-mavx2` / `-march=native`
+ * - SSE2 (2 lanes) otherwise on x86-64
+ * - Scalar fallback (1 lane) on other targets
+ */
+
+namespace IB::Helpers::Simd {
+
+// --------------------------------------------------------------------------
+//  Scalar lane (used for column tails and the non-x86 fallback)
+// --------------------------------------------------------------------------
+
+inline double load(const double* p) noexcept { return *p; }
+inline void store(double* p, double v) noexcept { *p = v; }
+inline double add(double a, double b) noexcept { return a + b; }
+inline double sub(double a, double b) noexcept { return a - b; }
+inline double mul(double a, double b) noexcept { return a * b; }
+inline double div(double a, double b) noexcept { return a / b; }
+inline double fmadd(double a, double b, double c) noexcept { return a * b + c; }
+inline double max(double a, double b) noexcept { return a > b ? a : b; }
+inline double min(double a, double b) noexcept { return a < b ? a : b; }
+inline double sqrt(double a) noexcept { return std::sqrt(a); }
+inline double abs(double a) noexcept { return std::fabs(a); }
+/// Lane mask as a double: all-bits-set when true is not needed for scalars, any non-zero works
+inline double cmpgt(double a, double b) noexcept { return a > b ? 1.0 : 0.0; }
+/// Select `b` where `mask` is set, `a` elsewhere
+inline double blend(double a, double b, double mask) noexcept { return mask != 0.0 ? b : a; }
+
+template <typename V> inline V broadcast(double v) noexcept;
+template <> inline double broadcast<double>(double v) noexcept { return v; }
+
+// --------------------------------------------------------------------------
+//  Packed lane
+// --------------------------------------------------------------------------
+
+#if defined(__AVX2__)
+
+using Vec = __m256d;
+constexpr size_t width = 4;
+
+inline Vec load(const Vec*, const double* p) noexcept { return _mm256_loadu_pd(p); }
+inline void store(double* p, Vec v) noexcept { _mm256_storeu_pd(p, v); }
+inline Vec add(Vec a, Vec b) noexcept { return _mm256_add_pd(a, b); }
+inline Vec sub(Vec a, Vec b) noexcept { return _mm256_sub_pd(a, b); }
+inline Vec mul(Vec a, Vec b) noexcept { return _mm256_mul_pd(a, b); }
+inline Vec div(Vec a, Vec b) noexcept { return _mm256_div_pd(a, b); }
+#if defined(__FMA__)
+inline Vec fmadd(Vec a, Vec b, Vec c) noexcept { return _mm256_fmadd_pd(a, b, c); }
+#else
+inline Vec fmadd(Vec a, Vec b, Vec c) noexcept { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+#endif
+inline Vec max(Vec a, Vec b) noexcept { return _mm256_max_pd(a, b); }
+inline Vec min(Vec a, Vec b) noexcept { return _mm256_min_pd(a, b); }
+inline Vec sqrt(Vec a) noexcept { return _mm256_sqrt_pd(a); }
+inline Vec abs(Vec a) noexcept { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+inline Vec cmpgt(Vec a, Vec b) noexcept { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+inline Vec blend(Vec a, Vec b, Vec mask) noexcept { return _mm256_blendv_pd(a, b, mask); }
+template <> inline Vec broadcast<Vec>(double v) noexcept { return _mm256_set1_pd(v); }
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+using Vec = __m128d;
+constexpr size_t width = 2;
+
+inline Vec load(const Vec*, const double* p) noexcept { return _mm_loadu_pd(p); }
+inline void store(double* p, Vec v) noexcept { _mm_storeu_pd(p, v); }
+inline Vec add(Vec a, Vec b) noexcept { return _mm_add_pd(a, b); }
+inline Vec sub(Vec a, Vec b) noexcept { return _mm_sub_pd(a, b); }
+inline Vec mul(Vec a, Vec b) noexcept { return _mm_mul_pd(a, b); }
+inline Vec div(Vec a, Vec b) noexcept { return _mm_div_pd(a, b); }
+inline Vec fmadd(Vec a, Vec b, Vec c) noexcept { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+inline Vec max(Vec a, Vec b) noexcept { return _mm_max_pd(a, b); }
+inline Vec min(Vec a, Vec b) noexcept { return _mm_min_pd(a, b); }
+inline Vec sqrt(Vec a) noexcept { return _mm_sqrt_pd(a); }
+inline Vec abs(Vec a) noexcept { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+inline Vec cmpgt(Vec a, Vec b) noexcept { return _mm_cmpgt_pd(a, b); }
+inline Vec blend(Vec a, Vec b, Vec mask) noexcept {
+  return _mm_or_pd(_mm_and_pd(mask, b), _mm_andnot_pd(mask, a));
+}
+template <> inline Vec broadcast<Vec>(double v) noexcept { return _mm_set1_pd(v); }
+
+#else
+
+using Vec = double;
+constexpr size_t width = 1;
+
+inline Vec load(const Vec*, const double* p) noexcept { return *p; }
+
+#endif
+
+/**
+ * @brief Loads a lane of type `V` from `p`
+ *
+ * `loadAs<double>` reads one value, `loadAs<Vec>` reads `width` values.
+ */
+template <typename V>
+inline V loadAs(const double* p) noexcept {
+  if constexpr (std::is_same_v<V, double>) return load(p);
+  else return load(static_cast<const V*>(nullptr), p);
+}
+
+/**
+ * @brief Applies `kernel(lane_tag, i)` over `[0, n)`: packed lanes first, scalar tail after
+ *
+ * The kernel is a generic lambda taking the lane type as a template argument:
+ * @code
+ * Simd::forEach(n, [&]<typename V>(size_t i) {
+ *   V x = Simd::loadAs<V>(in + i);
+ *   Simd::store(out + i, Simd::mul(x, Simd::broadcast<V>(2.0)));
+ * });
+ * @endcode
+ */
+template <typename Kernel>
+inline void forEach(size_t n, Kernel&& kernel) {
+  size_t i = 0;
+  if constexpr (width > 1) {
+    for (; i + width <= n; i += width) kernel.template operator()<Vec>(i);
+  }
+  for (; i < n; ++i) kernel.template operator()<double>(i);
+}
+
+}  // namespace IB::Helpers::Simd
+
+#endif  // QUANTDREAMCPP_SIMD_H
@@ -0,0 +1,104 @@
+#ifndef QUANTDREAMCPP_SPSC_RING_H
+#define QUANTDREAMCPP_SPSC_RING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+/**
+ * @file spsc_ring.h
+ * @brief Lock-free single-producer / single-consumer byte ring
+ *
+ * Moves variable-length records from a latency-sensitive thread (the IB reader) to a
+ * background consumer without locks or allocation. A write is all-or-nothing: the
+ * producer publishes the head only after the whole record is copied, so the consumer
+ * never observes a partial record, even when it drains arbitrary byte counts.
+ */
+
+namespace IB::Helpers {
+
+/**
+ * @brief Bounded byte FIFO for exactly one producer and one consumer thread
+ *
+ * Capacity is rounded up to a power of two. Head and tail live on separate cache
+ * lines so the two threads do not false-share.
+ *
+ * Example usage:
+ * @code
+ * IB::Helpers::SpscByteRing ring(1 << 20);
+ * ring.tryWrite(record.data(), record.size());   // producer
+ * size_t n = ring.read(buf, sizeof(buf));        // consumer
+ * @endcode
+ */
+class SpscByteRing {
+public:
+  explicit SpscByteRing(size_t capacity) {
+    cap_ = 1;
+    while (cap_ < capacity) cap_ <<= 1;
+    mask_ = cap_ - 1;
+    data_ = std::make_unique<char[]>(cap_);
+  }
+
+  SpscByteRing(const SpscByteRing&) = delete;
+  SpscByteRing& operator=(const SpscByteRing&) = delete;
+
+  /**
+   * @brief Appends `n` bytes, or nothing if they do not fit (producer thread)
+   * @return False if the ring lacks space for the whole record
+   */
+  bool tryWrite(const void* src, size_t n) noexcept {
+    const size_t h = head_.load(std::memory_order_relaxed);
+    if (cap_ - (h - cachedTail_) < n) {
+      cachedTail_ = tail_.load(std::memory_order_acquire);
+      if (cap_ - (h - cachedTail_) < n) return false;
+    }
+    copyIn(h & mask_, static_cast<const char*>(src), n);
+    head_.store(h + n, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Removes up to `max` bytes into `dst` (consumer thread)
+   * @return Number of bytes copied
+   */
+  size_t read(void* dst, size_t max) noexcept {
+    const size_t t = tail_.load(std::memory_order_relaxed);
+    const size_t n = std::min(head_.load(std::memory_order_acquire) - t, max);
+    if (n == 0) return 0;
+    const size_t at = t & mask_;
+    const size_t first = std::min(n, cap_ - at);
+    std::memcpy(dst, data_.get() + at, first);
+    std::memcpy(static_cast<char*>(dst) + first, data_.get(), n - first);
+    tail_.store(t + n, std::memory_order_release);
+    return n;
+  }
+
+  /// Bytes currently buffered (approximate when called concurrently)
+  size_t size() const noexcept {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  bool empty() const noexcept { return size() == 0; }
+  size_t capacity() const noexcept { return cap_; }
+
+private:
+  void copyIn(size_t at, const char* src, size_t n) noexcept {
+    const size_t first = std::min(n, cap_ - at);
+    std::memcpy(data_.get() + at, src, first);
+    std::memcpy(data_.get(), src + first, n - first);
+  }
+
+  size_t cap_;
+  size_t mask_;
+  std::unique_ptr<char[]> data_;
+
+  alignas(64) std::atomic<size_t> head_{0};   ///< Written by the producer
+  size_t cachedTail_ = 0;                     ///< Producer's last view of tail_
+  alignas(64) std::atomic<size_t> tail_{0};   ///< Written by the consumer
+};
+
+} // namespace IB::Helpers
+
+#endif  // QUANTDREAMCPP_SPSC_RING_H
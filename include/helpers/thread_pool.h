@@ -0,0 +1,161 @@
+#ifndef QUANTDREAMCPP_THREAD_POOL_H
+#define QUANTDREAMCPP_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * @file thread_pool.h
+ * @brief Fixed-size worker pool with a blocking parallel-for
+ *
+ * Used by the cross-sectional analytics and the storage/replay engines to spread
+ * work over cores without spawning threads per call.
+ */
+
+namespace IB::Helpers {
+
+/**
+ * @brief Fixed-size thread pool
+ *
+ * Workers are started in the constructor and joined in the destructor. Tasks are
+ * plain `std::function<void()>` objects executed in FIFO order.
+ *
+ * Example usage:
+ * @code
+ * IB::Helpers::ThreadPool pool;  // one worker per hardware thread
+ *
+ * pool.parallelFor(rows, 256, [&](size_t begin, size_t end) {
+ *     for (size_t i = begin; i < end; ++i) process(i);
+ * });
+ * @endcode
+ */
+class ThreadPool {
+public:
+  /// @param threads Number of workers (0 = `std::thread::hardware_concurrency()`)
+  explicit ThreadPool(size_t threads = 0) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i)
+      workers_.emplace_back([this] { loop(); });
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lk(m_);
+      stopped_ = true;
+    }
+    cv_.notify_all();
+    for (auto& w : workers_)
+      if (w.joinable()) w.join();
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  size_t size() const noexcept { return workers_.size(); }
+
+  /**
+   * @brief Enqueues a task and returns a future for its result
+   */
+  template <typename Func>
+  auto submit(Func&& func) -> std::future<std::invoke_result_t<Func>> {
+    using R = std::invoke_result_t<Func>;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<Func>(func));
+    auto fut = task->get_future();
+    {
+      std::lock_guard<std::mutex> lk(m_);
+      tasks_.emplace([task] { (*task)(); });
+    }
+    cv_.notify_one();
+    return fut;
+  }
+
+  /**
+   * @brief Runs `body(begin, end)` over `[0, n)` split into chunks of `grain` items
+   *
+   * The calling thread executes chunks too, so the call never deadlocks when
+   * invoked from inside a pool task. Blocks until all chunks are done and
+   * rethrows the first exception raised by any chunk.
+   */
+  template <typename Body>
+  void parallelFor(size_t n, size_t grain, Body&& body) {
+    if (n == 0) return;
+    grain = std::max<size_t>(1, grain);
+    const size_t chunks = (n + grain - 1) / grain;
+    if (chunks == 1 || workers_.empty()) {
+      body(size_t{0}, n);
+      return;
+    }
+
+    struct Shared {
+      std::atomic<size_t> next{0};
+      std::atomic<size_t> done{0};
+      std::mutex m;
+      std::condition_variable cv;
+      std::exception_ptr error;
+    };
+    auto shared = std::make_shared<Shared>();
+
+    auto drain = [shared, chunks, grain, n, &body] {
+      for (size_t c; (c = shared->next.fetch_add(1)) < chunks;) {
+        try {
+          body(c * grain, std::min(n, (c + 1) * grain));
+        } catch (...) {
+          std::lock_guard<std::mutex> lk(shared->m);
+          if (!shared->error) shared->error = std::current_exception();
+        }
+        if (shared->done.fetch_add(1) + 1 == chunks) {
+          std::lock_guard<std::mutex> lk(shared->m);
+          shared->cv.notify_all();
+        }
+      }
+    };
+
+    const size_t helpers = std::min(workers_.size(), chunks - 1);
+    {
+      std::lock_guard<std::mutex> lk(m_);
+      for (size_t i = 0; i < helpers; ++i) tasks_.emplace(drain);
+    }
+    cv_.notify_all();
+
+    drain();
+
+    std::unique_lock<std::mutex> lk(shared->m);
+    shared->cv.wait(lk, [&] { return shared->done.load() == chunks; });
+    if (shared->error) std::rethrow_exception(shared->error);
+  }
+
+private:
+  void loop() {
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [&] { return stopped_ || !tasks_.empty(); });
+        if (stopped_ && tasks_.empty()) return;
+        task = std::move(tasks_.front());
+        tasks_.pop();
+      }
+      task();
+    }
+  }
+
+  std::vector<std::thread> workers_;          ///< Worker threads
+  std::queue<std::function<void()>> tasks_;   ///< Pending tasks
+  std::mutex m_;                              ///< Protects tasks_ and stopped_
+  std::condition_variable cv_;                ///< Signals new tasks / shutdown
+  bool stopped_ = false;                      ///< Set by the destructor
+};
+
+}  // namespace IB::Helpers
+
+#endif  // QUANTDREAMCPP_THREAD_POOL_H
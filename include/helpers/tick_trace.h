@@ -0,0 +1,161 @@
+#ifndef QUANTDREAMCPP_TICK_TRACE_H
+#define QUANTDREAMCPP_TICK_TRACE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "clock.h"
+
+#ifndef IBW_TRACE
+#define IBW_TRACE 0
+#endif
+
+/**
+ * @file tick_trace.h
+ * @brief Tick-to-trade trace stamps carried from a price tick to the order it triggers
+ *
+ * Built with `IBW_TRACE=1` (CMake `-DIBWRAPPER_TRACE=ON`), every price tick starts a
+ * `TickTrace` that records the CycleClock tick of each stage it passes:
+ *
+ * | Stage            | Stamped when                                                    |
+ * |------------------|-----------------------------------------------------------------|
+ * | SOCKET_READ      | the reader thread woke to dispatch the batch holding the tick   |
+ * | TICK_PRICE       | IBMarketWrapper::tickPrice found the ticker's snapshot          |
+ * | POSITION_MANAGER | PositionManager invoked its first callback for the tick         |
+ * | ENGINE_SNAPSHOT  | StrategyEngine::onSnapshot stored the snapshot                  |
+ * | ENGINE_DECISION  | the strategy loop decided to send an order                      |
+ * | QUEUE_PUSH/POP   | the order request entered / left its ConcurrentQueue           |
+ * | EXECUTE          | OrderExecutor is about to call its ExecuteFn                    |
+ * | PLACE_ORDER      | IBBaseWrapper::placeOrder handed the order to TWS or the gateway|
+ *
+ * The trace travels with the event in `MarketSnapshot::trace` and `OrderRequest::trace`.
+ * Where only plain values are passed on (PositionManager price callbacks, the ExecuteFn
+ * calling placeOrder), the stage stamps the thread's current trace, installed with
+ * `TickTrace::Current`. A trace reaching PLACE_ORDER is recorded into per-hop latency
+ * histograms (tick_trace_stats.h). Stamps taken on different cores are compared
+ * directly, which assumes an invariant TSC.
+ *
+ * Without IBW_TRACE `TickTrace` is an empty type and all of its calls compile to nothing.
+ */
+
+namespace IB::Helpers {
+
+  enum class TraceStage : uint8_t {
+    SOCKET_READ,
+    TICK_PRICE,
+    POSITION_MANAGER,
+    ENGINE_SNAPSHOT,
+    ENGINE_DECISION,
+    QUEUE_PUSH,
+    QUEUE_POP,
+    EXECUTE,
+    PLACE_ORDER,
+    COUNT
+  };
+
+  inline constexpr size_t TRACE_STAGES = static_cast<size_t>(TraceStage::COUNT);
+
+  inline const char* stageName(TraceStage stage) noexcept {
+    switch (stage) {
+      case TraceStage::SOCKET_READ:      return "socketRead";
+      case TraceStage::TICK_PRICE:       return "tickPrice";
+      case TraceStage::POSITION_MANAGER: return "positionManager";
+      case TraceStage::ENGINE_SNAPSHOT:  return "engineSnapshot";
+      case TraceStage::ENGINE_DECISION:  return "engineDecision";
+      case TraceStage::QUEUE_PUSH:       return "queuePush";
+      case TraceStage::QUEUE_POP:        return "queuePop";
+      case TraceStage::EXECUTE:          return "execute";
+      case TraceStage::PLACE_ORDER:      return "placeOrder";
+      default:                           return "?";
+    }
+  }
+
+#if IBW_TRACE
+
+  class TickTrace;
+
+  namespace detail {
+    inline thread_local uint64_t socketReadTicks = 0;       ///< Set by the reader thread per batch
+    inline thread_local TickTrace* currentTrace = nullptr;
+  }
+
+  class TickTrace {
+  public:
+    static constexpr bool enabled = true;
+
+    /// Stamps `stage` unless it already has a stamp; true if this call stamped it
+    bool stamp(TraceStage stage) noexcept {
+      uint64_t& t = ticks_[static_cast<size_t>(stage)];
+      if (t != 0) return false;
+      t = CycleClock::now();
+      return true;
+    }
+
+    /// Restarts the trace for a tick handled on this thread: its socket-read stamp, then `stage`
+    void begin(TraceStage stage) noexcept {
+      ticks_.fill(0);
+      ticks_[static_cast<size_t>(TraceStage::SOCKET_READ)] = detail::socketReadTicks;
+      stamp(stage);
+    }
+
+    uint64_t ticks(TraceStage stage) const noexcept { return ticks_[static_cast<size_t>(stage)]; }
+    bool has(TraceStage stage) const noexcept { return ticks(stage) != 0; }
+
+    /// Called by the reader thread before it dispatches a freshly read batch of messages
+    static void markSocketRead() noexcept { detail::socketReadTicks = CycleClock::now(); }
+
+    /// Trace of the event being handled on this thread, if any
+    static TickTrace* current() noexcept { return detail::currentTrace; }
+
+    /// Stamps the current trace of this thread; true if this call stamped it
+    static bool stampCurrent(TraceStage stage) noexcept {
+      auto* trace = detail::currentTrace;
+      return trace && trace->stamp(stage);
+    }
+
+    /// Makes a trace the current one of this thread for the scope's lifetime
+    class Current {
+    public:
+      explicit Current(TickTrace& trace) noexcept : previous_(detail::currentTrace) { detail::currentTrace = &trace; }
+      ~Current() { detail::currentTrace = previous_; }
+
+      Current(const Current&) = delete;
+      Current& operator=(const Current&) = delete;
+
+    private:
+      TickTrace* previous_;
+    };
+
+  private:
+    std::array<uint64_t, TRACE_STAGES> ticks_{};   ///< CycleClock ticks per stage; 0 = not reached
+  };
+
+#else
+
+  class TickTrace {
+  public:
+    static constexpr bool enabled = false;
+
+    bool stamp(TraceStage) noexcept { return false; }
+    void begin(TraceStage) noexcept {}
+    uint64_t ticks(TraceStage) const noexcept { return 0; }
+    bool has(TraceStage) const noexcept { return false; }
+
+    static void markSocketRead() noexcept {}
+    static TickTrace* current() noexcept { return nullptr; }
+    static bool stampCurrent(TraceStage) noexcept { return false; }
+
+    class Current {
+    public:
+      explicit Current(TickTrace&) noexcept {}
+      Current(const Current&) = delete;
+      Current& operator=(const Current&) = delete;
+    };
+  };
+
+#endif
+
+}  // namespace IB::Helpers
+
+#endif  // QUANTDREAMCPP_TICK_TRACE_H
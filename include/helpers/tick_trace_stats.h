@@ -0,0 +1,73 @@
+#ifndef QUANTDREAMCPP_TICK_TRACE_STATS_H
+#define QUANTDREAMCPP_TICK_TRACE_STATS_H
+
+#include <array>
+#include <atomic>
+#include <string>
+
+#include "perf_timer.h"
+#include "tick_trace.h"
+
+/**
+ * @file tick_trace_stats.h
+ * @brief Per-hop latency histograms of completed tick-to-trade traces
+ *
+ * Each finished trace is split into hops between consecutive stages it reached, e.g.
+ * "tick2trade engineSnapshot->engineDecision" (a stage the event skipped just joins
+ * its neighbours into one hop), plus "tick2trade total" from the first stamp to the
+ * last. The hops are ordinary PerfTimers, so `PerfTimers::dump()` and the periodic dump
+ * report them next to the other timers and show which hop dominates.
+ */
+
+namespace IB::Helpers {
+
+  class TickTraceStats {
+  public:
+    /// Records the hops of a trace that reached its final stage
+    static void record(const TickTrace& trace) {
+      if constexpr (TickTrace::enabled) {
+        size_t first = TRACE_STAGES;
+        size_t prev = TRACE_STAGES;
+        for (size_t i = 0; i < TRACE_STAGES; ++i) {
+          const uint64_t t = trace.ticks(static_cast<TraceStage>(i));
+          if (t == 0) continue;
+          if (prev == TRACE_STAGES) first = i;
+          else hop(prev, i).recordTicks(elapsed(trace, prev, i));
+          prev = i;
+        }
+        if (first != TRACE_STAGES && prev != first) total().recordTicks(elapsed(trace, first, prev));
+      } else {
+        (void)trace;
+      }
+    }
+
+  private:
+    /// Ticks from stage `from` to `to`; 0 if the stamps went backwards across cores
+    static uint64_t elapsed(const TickTrace& trace, size_t from, size_t to) noexcept {
+      const uint64_t a = trace.ticks(static_cast<TraceStage>(from));
+      const uint64_t b = trace.ticks(static_cast<TraceStage>(to));
+      return b > a ? b - a : 0;
+    }
+
+    /// Timer of the hop from -> to, looked up once per pair
+    static PerfTimer& hop(size_t from, size_t to) {
+      static std::array<std::atomic<PerfTimer*>, TRACE_STAGES * TRACE_STAGES> timers{};
+      auto& slot = timers[from * TRACE_STAGES + to];
+      PerfTimer* timer = slot.load(std::memory_order_acquire);
+      if (!timer) {
+        timer = &PerfTimers::get(std::string("tick2trade ") + stageName(static_cast<TraceStage>(from)) + "->" +
+                                 stageName(static_cast<TraceStage>(to)));
+        slot.store(timer, std::memory_order_release);
+      }
+      return *timer;
+    }
+
+    static PerfTimer& total() {
+      static PerfTimer& timer = PerfTimers::get("tick2trade total");
+      return timer;
+    }
+  };
+
+}  // namespace IB::Helpers
+
+#endif  // QUANTDREAMCPP_TICK_TRACE_STATS_H
@@ -0,0 +1,287 @@
+#ifndef QUANTDREAMCPP_TRACE_EVENTS_H
+#define QUANTDREAMCPP_TRACE_EVENTS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "clock.h"
+
+/**
+ * @file trace_events.h
+ * @brief RAII trace scopes recorded per thread and exported as Chrome trace-event JSON
+ *
+ * Between `TraceEvents::start()` and `stop()`, every `IBW_TRACE_SCOPE("name")` (and
+ * every named PerfTimer scope, i.e. each `measure(IBW_PERF_TIMER(...), ...)` call)
+ * records a begin and an end event, and every IB request waiting on a promise records
+ * an async span from `createPromise` to `fulfillPromise`. `exportChromeTrace(path)`
+ * writes them as a trace-event JSON file for chrome://tracing or ui.perfetto.dev, with
+ * one track per thread and one async track per round trip, so overlapping requests and
+ * the critical path of a workflow are visible on one timeline.
+ *
+ * Each thread appends to its own fixed-size buffer without locks (the first event of a
+ * thread in a session registers the buffer). When a buffer is full, new events are
+ * dropped and counted; a begin is only taken if its end still fits. Outside a session a
+ * scope costs one relaxed load. Names must outlive the session (string literals or
+ * PerfTimer names).
+ */
+
+#define IBW_TRACE_CONCAT_(a, b) a##b
+#define IBW_TRACE_CONCAT(a, b) IBW_TRACE_CONCAT_(a, b)
+
+/// Traces the rest of the enclosing block as `name`, with an optional detail string
+#define IBW_TRACE_SCOPE(...) IB::Helpers::TraceScope IBW_TRACE_CONCAT(ibwTraceScope_, __LINE__)(__VA_ARGS__)
+
+namespace IB::Helpers {
+
+  class TraceEvents {
+  public:
+    static constexpr size_t DETAIL_CHARS = 22;   ///< Longer details are truncated
+
+    struct Event {
+      uint64_t ticks;                ///< CycleClock ticks
+      const char* name;
+      uint64_t id;                   ///< Async span id; 0 for scopes
+      char phase;                    ///< 'B'/'E' scope, 'b'/'e' async span
+      char detail[DETAIL_CHARS + 1];  ///< NUL-terminated; empty for none
+    };
+
+    /// Starts a new session, discarding the events of the previous one
+    static void start(size_t eventsPerThread = 1 << 16) {
+      CycleClock::nsPerTick();   // calibrate outside the recorded interval
+      std::lock_guard lk(mutex_);
+      buffers_.clear();
+      capacity_ = std::max<size_t>(eventsPerThread, 2);
+      startTicks_ = CycleClock::now();
+      generation_.fetch_add(1, std::memory_order_release);
+      recording_.store(true, std::memory_order_relaxed);
+    }
+
+    /// Stops recording; the events stay available for export until the next start()
+    static void stop() noexcept { recording_.store(false, std::memory_order_relaxed); }
+
+    static bool recording() noexcept { return recording_.load(std::memory_order_relaxed); }
+
+    /// Opens a scope on this thread; false if not recorded (no session or buffer full)
+    static bool begin(const char* name, std::string_view detail = {}) noexcept {
+      if (!recording()) return false;
+      Buffer* buf = local();
+      if (!buf) return false;
+      const size_t n = buf->size.load(std::memory_order_relaxed);
+      if (n + buf->open + 2 > buf->capacity) {   // room for this begin, its end and the pending ends
+        buf->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      ++buf->open;
+      append(*buf, 'B', name, 0, detail);
+      return true;
+    }
+
+    /// Closes the scope opened by a begin() that returned true
+    static void end(const char* name) noexcept {
+      Buffer* buf = threadBuffer_.get();
+      if (!buf || buf->generation != generation_.load(std::memory_order_acquire)) return;
+      --buf->open;
+      append(*buf, 'E', name, 0, {});
+    }
+
+    /// Starts an async span, e.g. a request whose answer arrives on another thread
+    static void asyncBegin(const char* name, uint64_t id, std::string_view detail = {}) noexcept {
+      if (!recording()) return;
+      if (Buffer* buf = local(); buf && buf->size.load(std::memory_order_relaxed) + buf->open < buf->capacity)
+        append(*buf, 'b', name, id, detail);
+      else if (buf)
+        buf->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Ends the async span `name`/`id`, on any thread
+    static void asyncEnd(const char* name, uint64_t id) noexcept {
+      if (!recording()) return;
+      if (Buffer* buf = local(); buf && buf->size.load(std::memory_order_relaxed) + buf->open < buf->capacity)
+        append(*buf, 'e', name, id, {});
+      else if (buf)
+        buf->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// Names the calling thread's track ("IB reader", "OrderExecutor", ...)
+    static void nameThread(std::string name) {
+      threadName_ = std::move(name);
+      if (Buffer* buf = threadBuffer_.get()) {
+        std::lock_guard lk(mutex_);
+        buf->name = threadName_;
+      }
+    }
+
+    /// Events dropped in this session because a thread's buffer was full
+    static uint64_t dropped() {
+      std::lock_guard lk(mutex_);
+      uint64_t n = 0;
+      for (const auto& buf : buffers_) n += buf->dropped.load(std::memory_order_relaxed);
+      return n;
+    }
+
+    /// Writes the session as Chrome trace-event JSON; may run while threads still record
+    static void writeChromeTrace(std::FILE* out) {
+      std::lock_guard lk(mutex_);
+      std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+      json += R"({"name":"process_name","ph":"M","pid":1,"tid":0,"args":{"name":"IBWrapper"}})";
+      uint64_t dropped = 0;
+      for (const auto& buf : buffers_) {
+        if (!buf->name.empty()) {
+          json += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(buf->tid) +
+                  ",\"args\":{\"name\":";
+          appendString(buf->name, json);
+          json += "}}";
+        }
+        const size_t n = buf->size.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; ++i) {
+          json += ",\n";
+          appendEvent(buf->events[i], buf->tid, json);
+        }
+        dropped += buf->dropped.load(std::memory_order_relaxed);
+        if (json.size() >= (1 << 16)) {
+          std::fwrite(json.data(), 1, json.size(), out);
+          json.clear();
+        }
+      }
+      json += "\n],\"otherData\":{\"droppedEvents\":" + std::to_string(dropped) + "}}\n";
+      std::fwrite(json.data(), 1, json.size(), out);
+    }
+
+    /// writeChromeTrace() into `path`; false if the file cannot be written
+    static bool exportChromeTrace(const std::string& path) {
+      std::FILE* out = std::fopen(path.c_str(), "w");
+      if (!out) return false;
+      writeChromeTrace(out);
+      return std::fclose(out) == 0;
+    }
+
+  private:
+    struct Buffer {
+      uint32_t tid = 0;
+      uint32_t generation = 0;
+      std::string name;                     ///< Guarded by mutex_
+      std::unique_ptr<Event[]> events;
+      size_t capacity = 0;
+      size_t open = 0;                      ///< Scopes begun and not yet ended (owner thread only)
+      std::atomic<size_t> size{0};         ///< Published events; written by the owner only
+      std::atomic<uint64_t> dropped{0};
+    };
+
+    /// This thread's buffer of the current session, registered on first use
+    static Buffer* local() noexcept {
+      const uint32_t gen = generation_.load(std::memory_order_acquire);
+      Buffer* buf = threadBuffer_.get();
+      if (buf && buf->generation == gen) return buf;
+      try {
+        auto fresh = std::make_shared<Buffer>();
+        std::lock_guard lk(mutex_);
+        fresh->tid = nextTid_++;
+        fresh->generation = generation_.load(std::memory_order_relaxed);
+        fresh->capacity = capacity_;
+        fresh->events = std::make_unique<Event[]>(capacity_);
+        fresh->name = threadName_;
+        buffers_.push_back(fresh);
+        threadBuffer_ = std::move(fresh);
+      } catch (...) {
+        return nullptr;
+      }
+      return threadBuffer_.get();
+    }
+
+    static void append(Buffer& buf, char phase, const char* name, uint64_t id, std::string_view detail) noexcept {
+      const size_t n = buf.size.load(std::memory_order_relaxed);
+      if (n >= buf.capacity) return;
+      Event& e = buf.events[n];
+      e.ticks = CycleClock::now();
+      e.name = name;
+      e.id = id;
+      e.phase = phase;
+      const size_t len = std::min(detail.size(), DETAIL_CHARS);
+      detail.copy(e.detail, len);
+      e.detail[len] = '\0';
+      buf.size.store(n + 1, std::memory_order_release);
+    }
+
+    static void appendString(std::string_view s, std::string& out) {
+      out.push_back('"');
+      for (char c : s) {
+        if (c == '"' || c == '\\') {
+          out.push_back('\\');
+          out.push_back(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+          char esc[8];
+          std::snprintf(esc, sizeof(esc), "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(c)));
+          out += esc;
+        } else {
+          out.push_back(c);
+        }
+      }
+      out.push_back('"');
+    }
+
+    static void appendEvent(const Event& e, uint32_t tid, std::string& out) {
+      const uint64_t rel = e.ticks > startTicks_ ? e.ticks - startTicks_ : 0;
+      char ts[32];
+      std::snprintf(ts, sizeof(ts), "%.3f", static_cast<double>(CycleClock::toNs(rel)) / 1e3);
+      out += "{\"name\":";
+      appendString(e.name ? e.name : "?", out);
+      out += ",\"cat\":\"ibwrapper\",\"ph\":\"";
+      out.push_back(e.phase);
+      out += "\",\"ts\":";
+      out += ts;
+      out += ",\"pid\":1,\"tid\":" + std::to_string(tid);
+      if (e.phase == 'b' || e.phase == 'e') out += ",\"id\":" + std::to_string(e.id);
+      if (e.detail[0] != '\0') {
+        out += ",\"args\":{\"detail\":";
+        appendString(e.detail, out);
+        out += "}";
+      }
+      out += "}";
+    }
+
+    static inline std::mutex mutex_;
+    static inline std::vector<std::shared_ptr<Buffer>> buffers_;   ///< Buffers of the current session
+    static inline size_t capacity_ = 1 << 16;
+    static inline uint64_t startTicks_ = 0;
+    static inline uint32_t nextTid_ = 1;
+    static inline std::atomic<uint32_t> generation_{0};
+    static inline std::atomic<bool> recording_{false};
+    static inline thread_local std::shared_ptr<Buffer> threadBuffer_;
+    static inline thread_local std::string threadName_;
+  };
+
+  /**
+   * @brief Traces its lifetime as a begin/end pair on the calling thread
+   *
+   * @code
+   * IBW_TRACE_SCOPE("getGreeksTable", underlying.symbol);
+   * @endcode
+   */
+  class TraceScope {
+  public:
+    explicit TraceScope(const char* name, std::string_view detail = {}) noexcept
+        : name_(name), active_(TraceEvents::begin(name, detail)) {}
+
+    ~TraceScope() {
+      if (active_) TraceEvents::end(name_);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+  private:
+    const char* name_;
+    bool active_;
+  };
+
+}  // namespace IB::Helpers
+
+#endif  // QUANTDREAMCPP_TRACE_EVENTS_H
@@ -16,59 +16,59 @@ namespace IB::Orders::Management::Open {
    * @brief Request all open orders for this client only (non-blocking).
    */
   inline void requestClientOpenOrders(const IBBaseWrapper& ib) {
-    IB::Helpers::measure([&]() {
+    IB::Helpers::measure(IBW_PERF_TIMER("requestClientOpenOrders"), [&]() {
       LOG_INFO("[IB] Requesting open orders for this client...");
-      ib.client->reqOpenOrders();
-    }, "requestClientOpenOrders");
+      ib.reqOpenOrders();
+    });
   }
 
   /**
    * @brief Request all open orders for all clients across all API connections.
    */
   inline void requestAllOpenOrders(const IBBaseWrapper& ib) {
-    IB::Helpers::measure([&]() {
+    IB::Helpers::measure(IBW_PERF_TIMER("requestAllOpenOrders"), [&]() {
       LOG_INFO("[IB] Requesting all open orders (across all clients)...");
-      ib.client->reqAllOpenOrders();
-    }, "requestAllOpenOrders");
+      ib.reqAllOpenOrders();
+    });
   }
 
   /**
    * @brief Enables or disables automatic open order updates from TWS.
    */
   inline void subscribeAutoOpenOrders(const IBBaseWrapper& ib, bool enable = true) {
-    IB::Helpers::measure([&]() {
+    IB::Helpers::measure(IBW_PERF_TIMER("subscribeAutoOpenOrders"), [&]() {
       LOG_INFO("[IB] Setting auto-open order subscription: ", enable);
-      ib.client->reqAutoOpenOrders(enable);
-    }, "subscribeAutoOpenOrders");
+      ib.reqAutoOpenOrders(enable);
+    });
   }
 
   /**
    * @brief Cancels a specific open order by ID.
    */
   inline void cancel(const IBBaseWrapper& ib, int orderId) {
-    IB::Helpers::measure([&]() {
+    IB::Helpers::measure(IBW_PERF_TIMER("cancelOrder"), [&]() {
       LOG_INFO("[IB] Cancelling order #", orderId);
       OrderCancel cancelParams;
       cancelParams.manualOrderCancelTime = "";
       cancelParams.extOperator = "";
       cancelParams.manualOrderIndicator = UNSET_INTEGER;
-      ib.client->cancelOrder(orderId, cancelParams);
-    }, "cancelOrder");
+      ib.cancelOrder(orderId, cancelParams);
+    });
   }
 
   /**
    * @brief Cancels all open orders globally for the account.
    */
   inline void cancelAll(const IBBaseWrapper& ib) {
-    IB::Helpers::measure([&]() {
+    IB::Helpers::measure(IBW_PERF_TIMER("cancelAllOrders"), [&]() {
       LOG_SECTION("Global Cancel of All Open Orders");
       LOG_WARN("[IB] Sending global cancel — ALL open orders will be cancelled!");
       OrderCancel cancelParams;
       cancelParams.extOperator = "";
       cancelParams.manualOrderIndicator = UNSET_INTEGER;
-      ib.client->reqGlobalCancel(cancelParams);
+      ib.reqGlobalCancel(cancelParams);
       LOG_SECTION_END();
-    }, "cancelAllOrders");
+    });
   }
 
 }  // namespace IB::Orders::Management::Open
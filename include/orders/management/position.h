@@ -22,7 +22,7 @@ namespace IB::Orders::Management {
     auto positions = IBBaseWrapper::getSync<std::vector<IB::Accounts::PositionInfo>>(
         ib,
         reqId,
-        [&]() { ib.client->reqPositions(); }
+        [&]() { ib.reqPositions(); }
     );
 
     // Log results
@@ -80,7 +80,7 @@ namespace IB::Orders::Management {
       order.totalQuantity = DecimalFunctions::doubleToDecimal(qty);
 
       int orderId = ib.nextOrderId();
-      ib.client->placeOrder(orderId, contract, order);
+      ib.placeOrder(orderId, contract, order);
 
       LOG_INFO("[IB] Closing position: ", contract.symbol,
                " ", contract.secType,
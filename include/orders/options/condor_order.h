@@ -146,7 +146,7 @@ inline void placeIronCondor(
     return std::round(price / tick) * tick;
   };
 
-  IB::Helpers::measure([&]() {
+  IB::Helpers::measure(IBW_PERF_TIMER("placeIronCondor"), [&]() {
     LOG_SECTION("Iron Condor Order Placement");
     std::array<double,4> usedStrikes{};
 
@@ -257,7 +257,7 @@ inline void placeIronCondor(
 
     // Place order
     const int orderId = ib.nextOrderId();
-    ib.client->placeOrder(orderId, combo, comboOrder);
+    ib.placeOrder(orderId, combo, comboOrder);
 
     LOG_INFO("[IB] Sent Adaptive Iron Condor order #", orderId,
              " (", comboOrder.action, " ", totalQuantity, "x ",
@@ -265,7 +265,7 @@ inline void placeIronCondor(
              ", limit=", fairPrice, ")");
 
     LOG_SECTION_END();
-  }, "placeIronCondor");
+  });
 }
 
 } // namespace IB::Orders::Options
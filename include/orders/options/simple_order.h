@@ -121,7 +121,7 @@ inline void placeSimpleOrder(
     const Order& order,
     const std::string& right = "C")
 {
-  IB::Helpers::measure([&]() {
+  IB::Helpers::measure(IBW_PERF_TIMER("placeSimpleOrder"), [&]() {
     if (chain.expirations.empty() || chain.strikes.empty()) {
       LOG_ERROR("[IB] Option chain is empty — cannot place order.");
       return;
@@ -156,13 +156,13 @@ inline void placeSimpleOrder(
 
     // --- Place the order ---
     const int orderId = ib.nextValidOrderId++; // track IDs internally
-    ib.client->placeOrder(orderId, opt, order);
+    ib.placeOrder(orderId, opt, order);
 
     LOG_INFO("[IB] Sent order #", orderId, " → ",
              order.action, " ", opt.localSymbol,
              " @ ", (order.orderType == "LMT" ? std::to_string(order.lmtPrice) : order.orderType));
 
-  }, "placeSimpleOrder");
+  });
 }
 
 }  // namespace IB::Orders::Options
@@ -0,0 +1,50 @@
+#ifndef QUANTDREAMCPP_ORDER_GATEWAY_H
+#define QUANTDREAMCPP_ORDER_GATEWAY_H
+
+#include "Contract.h"
+#include "Order.h"
+#include "OrderCancel.h"
+
+/**
+ * @file order_gateway.h
+ * @brief Replaceable destination of the wrapper's order-entry calls
+ *
+ * `IBBaseWrapper::placeOrder` and friends send to TWS through the `EClientSocket` unless
+ * an `OrderGateway` is attached to the wrapper, in which case every order path
+ * (`placeSimpleOrder`, `placeIronCondor`, `closeAllPositions`, an `OrderExecutor`
+ * calling `ib.placeOrder`) goes to the gateway instead. The gateway answers through the
+ * wrapper's regular EWrapper callbacks.
+ */
+
+namespace IB::Orders {
+
+  class OrderGateway {
+  public:
+    virtual ~OrderGateway() = default;
+
+    virtual void placeOrder(OrderId orderId, const Contract& contract, const Order& order) = 0;
+    virtual void cancelOrder(OrderId orderId, const OrderCancel& cancel) = 0;
+    virtual void reqGlobalCancel(const OrderCancel& cancel) = 0;
+
+    /// Answers with openOrder for every working order, then openOrderEnd
+    virtual void reqOpenOrders() = 0;
+
+    /// Answers with position for every position, then positionEnd; later changes stream as position
+    virtual void reqPositions() = 0;
+
+    /**
+     * @brief Market data seen by the wrapper (price ticks have size 0, size ticks price 0)
+     *
+     * Lets a simulated gateway match against the same quote stream the strategy sees.
+     */
+    virtual void onMarketData(const Contract& contract, int field, double price, double size) {
+      (void)contract;
+      (void)field;
+      (void)price;
+      (void)size;
+    }
+  };
+
+}  // namespace IB::Orders
+
+#endif  // QUANTDREAMCPP_ORDER_GATEWAY_H
@@ -0,0 +1,367 @@
+#ifndef QUANTDREAMCPP_RECORD_FORMAT_H
+#define QUANTDREAMCPP_RECORD_FORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Contract.h"
+#include "EWrapper.h"
+#include "Order.h"
+#include "OrderState.h"
+
+/**
+ * @file record_format.h
+ * @brief Binary layout of recorded EWrapper callback streams
+ *
+ * A recording is a 16-byte file header followed by records. Each record is a fixed
+ * 16-byte header (payload size, callback type, wall-clock timestamp) and a payload
+ * holding the callback arguments in declaration order:
+ *
+ * - Arithmetic values and enums: little-endian, native width (`Decimal` as raw bits)
+ * - Strings: `uint32` length + bytes
+ * - Sets and vectors: `uint32` count + elements
+ * - Contract / ContractDetails / Order / OrderState: the fields the wrappers consume
+ * - Bar / HistoricalTick / HistoricalTickBidAsk / HistoricalTickLast: all fields
+ *
+ * New record types are appended to `RecordType`, so older recordings keep their meaning.
+ *
+ * The same `put()` / `get()` overloads are used by the recorder and the replayer,
+ * so the two sides cannot drift apart.
+ */
+
+namespace IB::Replay {
+
+  /// Identifies the EWrapper callback a record replays into
+  enum class RecordType : uint16_t {
+    TICK_PRICE = 1,
+    TICK_SIZE,
+    TICK_STRING,
+    TICK_GENERIC,
+    TICK_OPTION_COMPUTATION,
+    TICK_SNAPSHOT_END,
+    TICK_NEWS,
+    ORDER_STATUS,
+    OPEN_ORDER,
+    OPEN_ORDER_END,
+    POSITION,
+    POSITION_END,
+    ACCOUNT_SUMMARY,
+    ACCOUNT_SUMMARY_END,
+    CONTRACT_DETAILS,
+    CONTRACT_DETAILS_END,
+    SEC_DEF_OPTIONAL_PARAMETER,
+    SEC_DEF_OPTIONAL_PARAMETER_END,
+    NEXT_VALID_ID,
+    ERROR,
+    SCANNER_DATA,
+    SCANNER_DATA_END,
+    HISTORICAL_NEWS,
+    HISTORICAL_NEWS_END,
+    CONNECTION_CLOSED,
+    HISTORICAL_DATA,
+    HISTORICAL_DATA_END,
+    HEAD_TIMESTAMP,
+    HISTORICAL_TICKS,
+    HISTORICAL_TICKS_BID_ASK,
+    HISTORICAL_TICKS_LAST
+  };
+
+  constexpr char FILE_MAGIC[8] = {'I', 'B', 'W', 'R', 'E', 'C', '\0', '\1'};
+  constexpr uint32_t FILE_VERSION = 1;
+
+  /// File header written once at offset 0
+  struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+  };
+
+  /// Per-record header; `size` counts payload bytes only
+  struct RecordHeader {
+    uint32_t size;
+    uint16_t type;
+    uint16_t reserved;
+    int64_t timestampNs;   ///< system_clock nanoseconds when the callback fired
+  };
+
+  static_assert(sizeof(FileHeader) == 16 && sizeof(RecordHeader) == 16, "record layout must be packed");
+
+  // --------------------------------------------------------------------------
+  // Encoding
+  // --------------------------------------------------------------------------
+
+  template <typename T>
+  requires (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+  inline void put(std::vector<char>& out, T v) {
+    const size_t at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &v, sizeof(T));
+  }
+
+  inline void put(std::vector<char>& out, const std::string& s) {
+    put(out, static_cast<uint32_t>(s.size()));
+    out.insert(out.end(), s.begin(), s.end());
+  }
+
+  template <typename T>
+  inline void put(std::vector<char>& out, const std::set<T>& s) {
+    put(out, static_cast<uint32_t>(s.size()));
+    for (const auto& v : s) put(out, v);
+  }
+
+  inline void put(std::vector<char>& out, const Contract& c) {
+    put(out, static_cast<int64_t>(c.conId));
+    put(out, c.symbol);
+    put(out, c.secType);
+    put(out, c.lastTradeDateOrContractMonth);
+    put(out, c.strike);
+    put(out, c.right);
+    put(out, c.multiplier);
+    put(out, c.exchange);
+    put(out, c.primaryExchange);
+    put(out, c.currency);
+    put(out, c.localSymbol);
+    put(out, c.tradingClass);
+  }
+
+  inline void put(std::vector<char>& out, const ContractDetails& d) {
+    put(out, d.contract);
+    put(out, d.marketName);
+    put(out, d.minTick);
+    put(out, d.validExchanges);
+    put(out, d.longName);
+    put(out, d.timeZoneId);
+    put(out, d.tradingHours);
+    put(out, d.liquidHours);
+  }
+
+  inline void put(std::vector<char>& out, const Order& o) {
+    put(out, static_cast<int64_t>(o.orderId));
+    put(out, static_cast<int64_t>(o.permId));
+    put(out, static_cast<int64_t>(o.parentId));
+    put(out, o.action);
+    put(out, o.totalQuantity);
+    put(out, o.orderType);
+    put(out, o.lmtPrice);
+    put(out, o.auxPrice);
+    put(out, o.tif);
+    put(out, o.account);
+    put(out, o.transmit);
+  }
+
+  inline void put(std::vector<char>& out, const OrderState& s) {
+    put(out, s.status);
+    put(out, s.warningText);
+  }
+
+  inline void put(std::vector<char>& out, const Bar& b) {
+    put(out, b.time);
+    put(out, b.high);
+    put(out, b.low);
+    put(out, b.open);
+    put(out, b.close);
+    put(out, b.wap);
+    put(out, b.volume);
+    put(out, static_cast<int32_t>(b.count));
+  }
+
+  inline void put(std::vector<char>& out, const HistoricalTick& t) {
+    put(out, static_cast<int64_t>(t.time));
+    put(out, t.price);
+    put(out, t.size);
+  }
+
+  inline void put(std::vector<char>& out, const HistoricalTickBidAsk& t) {
+    put(out, static_cast<int64_t>(t.time));
+    put(out, t.tickAttribBidAsk.bidPastLow);
+    put(out, t.tickAttribBidAsk.askPastHigh);
+    put(out, t.priceBid);
+    put(out, t.priceAsk);
+    put(out, t.sizeBid);
+    put(out, t.sizeAsk);
+  }
+
+  inline void put(std::vector<char>& out, const HistoricalTickLast& t) {
+    put(out, static_cast<int64_t>(t.time));
+    put(out, t.tickAttribLast.pastLimit);
+    put(out, t.tickAttribLast.unreported);
+    put(out, t.price);
+    put(out, t.size);
+    put(out, t.exchange);
+    put(out, t.specialConditions);
+  }
+
+  template <typename T>
+  inline void put(std::vector<char>& out, const std::vector<T>& v) {
+    put(out, static_cast<uint32_t>(v.size()));
+    for (const auto& x : v) put(out, x);
+  }
+
+  // --------------------------------------------------------------------------
+  // Decoding
+  // --------------------------------------------------------------------------
+
+  /**
+   * @brief Bounds-checked cursor over one record payload
+   *
+   * Reading past the end yields default values and clears `ok()`, so a truncated or
+   * corrupt record is detected once after decoding instead of at every field.
+   */
+  class RecordReader {
+  public:
+    RecordReader(const char* data, size_t size) : p_(data), end_(data + size) {}
+
+    bool ok() const noexcept { return ok_; }
+
+    template <typename T>
+    requires (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+    void get(T& v) {
+      if (!take(sizeof(T))) { v = T{}; return; }
+      std::memcpy(&v, p_ - sizeof(T), sizeof(T));
+    }
+
+    void get(std::string& s) {
+      uint32_t n = 0;
+      get(n);
+      if (!take(n)) { s.clear(); return; }
+      s.assign(p_ - n, n);
+    }
+
+    template <typename T>
+    void get(std::set<T>& s) {
+      uint32_t n = 0;
+      get(n);
+      s.clear();
+      for (uint32_t i = 0; i < n && ok_; ++i) {
+        T v{};
+        get(v);
+        s.insert(v);
+      }
+    }
+
+    template <typename T>
+    void get(std::vector<T>& v) {
+      uint32_t n = 0;
+      get(n);
+      v.clear();
+      for (uint32_t i = 0; i < n && ok_; ++i) get(v.emplace_back());
+    }
+
+    void get(Contract& c) {
+      int64_t conId = 0;
+      get(conId);
+      c.conId = static_cast<decltype(c.conId)>(conId);
+      get(c.symbol);
+      get(c.secType);
+      get(c.lastTradeDateOrContractMonth);
+      get(c.strike);
+      get(c.right);
+      get(c.multiplier);
+      get(c.exchange);
+      get(c.primaryExchange);
+      get(c.currency);
+      get(c.localSymbol);
+      get(c.tradingClass);
+    }
+
+    void get(ContractDetails& d) {
+      get(d.contract);
+      get(d.marketName);
+      get(d.minTick);
+      get(d.validExchanges);
+      get(d.longName);
+      get(d.timeZoneId);
+      get(d.tradingHours);
+      get(d.liquidHours);
+    }
+
+    void get(Order& o) {
+      int64_t orderId = 0, permId = 0, parentId = 0;
+      get(orderId);
+      get(permId);
+      get(parentId);
+      o.orderId = static_cast<decltype(o.orderId)>(orderId);
+      o.permId = static_cast<decltype(o.permId)>(permId);
+      o.parentId = static_cast<decltype(o.parentId)>(parentId);
+      get(o.action);
+      get(o.totalQuantity);
+      get(o.orderType);
+      get(o.lmtPrice);
+      get(o.auxPrice);
+      get(o.tif);
+      get(o.account);
+      get(o.transmit);
+    }
+
+    void get(OrderState& s) {
+      get(s.status);
+      get(s.warningText);
+    }
+
+    void get(Bar& b) {
+      get(b.time);
+      get(b.high);
+      get(b.low);
+      get(b.open);
+      get(b.close);
+      get(b.wap);
+      get(b.volume);
+      b.count = read<int32_t>();
+    }
+
+    void get(HistoricalTick& t) {
+      t.time = read<int64_t>();
+      get(t.price);
+      get(t.size);
+    }
+
+    void get(HistoricalTickBidAsk& t) {
+      t.time = read<int64_t>();
+      get(t.tickAttribBidAsk.bidPastLow);
+      get(t.tickAttribBidAsk.askPastHigh);
+      get(t.priceBid);
+      get(t.priceAsk);
+      get(t.sizeBid);
+      get(t.sizeAsk);
+    }
+
+    void get(HistoricalTickLast& t) {
+      t.time = read<int64_t>();
+      get(t.tickAttribLast.pastLimit);
+      get(t.tickAttribLast.unreported);
+      get(t.price);
+      get(t.size);
+      get(t.exchange);
+      get(t.specialConditions);
+    }
+
+    /// Decodes a value of type T
+    template <typename T>
+    T read() {
+      T v{};
+      get(v);
+      return v;
+    }
+
+  private:
+    bool take(size_t n) {
+      if (!ok_ || static_cast<size_t>(end_ - p_) < n) {
+        ok_ = false;
+        return false;
+      }
+      p_ += n;
+      return true;
+    }
+
+    const char* p_;
+    const char* end_;
+    bool ok_ = true;
+  };
+
+}  // namespace IB::Replay
+
+#endif  // QUANTDREAMCPP_RECORD_FORMAT_H
@@ -0,0 +1,373 @@
+#ifndef QUANTDREAMCPP_RECORDER_H
+#define QUANTDREAMCPP_RECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "EWrapper.h"
+#include "helpers/logger.h"
+#include "helpers/spsc_ring.h"
+#include "replay/record_format.h"
+
+/**
+ * @file recorder.h
+ * @brief Captures the EWrapper callback stream of a live session to a binary file
+ *
+ * `RecordingWrapper<W>` decorates any wrapper type: every callback the wrappers handle
+ * is encoded into a compact timestamped record and then forwarded unchanged to `W`.
+ *
+ * **Reader-thread cost**
+ * - Arguments are encoded into a reused scratch buffer (no allocation once warm)
+ * - The record is copied into a lock-free SPSC ring; a background thread writes the
+ *   ring to disk, so the reader thread never touches the file
+ * - If the ring is full the record is dropped and counted rather than blocking the
+ *   reader; size the ring for the burst rate of the session
+ */
+
+namespace IB::Replay {
+
+/**
+ * @brief Background writer of a recording file
+ *
+ * `record()` must be called from a single thread (the IB reader thread).
+ */
+class Recorder {
+public:
+  /**
+   * @param ringBytes In-memory buffer between the reader thread and the file writer
+   */
+  explicit Recorder(size_t ringBytes = 8u << 20) : ring_(ringBytes) {}
+
+  ~Recorder() { stop(); }
+
+  Recorder(const Recorder&) = delete;
+  Recorder& operator=(const Recorder&) = delete;
+
+  /**
+   * @brief Opens `path` (truncating it) and starts the writer thread
+   * @return False if already recording or the file cannot be opened
+   */
+  bool start(const std::string& path) {
+    if (active_.load(std::memory_order_acquire)) return false;
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_) {
+      LOG_ERROR("[Recorder] Cannot open ", path);
+      return false;
+    }
+    FileHeader header{};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+    header.version = FILE_VERSION;
+    out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    recorded_ = dropped_ = 0;
+    bytesWritten_ = sizeof(header);
+    running_.store(true, std::memory_order_release);
+    writer_ = std::thread([this] { writeLoop(); });
+    active_.store(true, std::memory_order_release);
+    LOG_INFO("[Recorder] Recording to ", path);
+    return true;
+  }
+
+  /**
+   * @brief Stops recording, flushing every buffered record to disk
+   *
+   * Call after disconnecting (or from the reader thread) so no callback races the
+   * final drain.
+   */
+  void stop() {
+    if (!active_.exchange(false, std::memory_order_acq_rel)) return;
+    running_.store(false, std::memory_order_release);
+    if (writer_.joinable()) writer_.join();
+    out_.close();
+    LOG_INFO("[Recorder] Stopped: ", recorded_.load(), " records, ", dropped_.load(), " dropped, ",
+             bytesWritten_.load(), " bytes");
+  }
+
+  bool active() const noexcept { return active_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Encodes one callback and queues it for the writer (reader thread)
+   */
+  template <typename... Args>
+  void record(RecordType type, const Args&... args) {
+    scratch_.resize(sizeof(RecordHeader));
+    (put(scratch_, args), ...);
+
+    RecordHeader header{};
+    header.size = static_cast<uint32_t>(scratch_.size() - sizeof(RecordHeader));
+    header.type = static_cast<uint16_t>(type);
+    header.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    std::memcpy(scratch_.data(), &header, sizeof(header));
+
+    if (ring_.tryWrite(scratch_.data(), scratch_.size()))
+      recorded_.fetch_add(1, std::memory_order_relaxed);
+    else
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  uint64_t recorded() const noexcept { return recorded_.load(std::memory_order_relaxed); }
+  uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+  uint64_t bytesWritten() const noexcept { return bytesWritten_.load(std::memory_order_relaxed); }
+
+private:
+  void writeLoop() {
+    std::vector<char> buf(1u << 16);
+    for (;;) {
+      const bool stopping = !running_.load(std::memory_order_acquire);
+      const size_t n = ring_.read(buf.data(), buf.size());
+      if (n > 0) {
+        out_.write(buf.data(), static_cast<std::streamsize>(n));
+        bytesWritten_.fetch_add(n, std::memory_order_relaxed);
+        continue;
+      }
+      if (stopping) break;
+      std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    out_.flush();
+  }
+
+  IB::Helpers::SpscByteRing ring_;
+  std::vector<char> scratch_;             ///< Producer-side encode buffer
+  std::ofstream out_;
+  std::thread writer_;
+  std::atomic<bool> running_{false};      ///< Writer keeps draining while true
+  std::atomic<bool> active_{false};       ///< Callbacks are recorded while true
+  std::atomic<uint64_t> recorded_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> bytesWritten_{0};
+};
+
+}  // namespace IB::Replay
+
+/**
+ * @class RecordingWrapper
+ * @brief Decorator that records every handled callback before forwarding it to `Base`
+ *
+ * Example usage:
+ * @code
+ * RecordingWrapper<IBStrategyWrapper> ib;
+ * ib.recorder.start("session.ibrec");
+ * ib.connect("127.0.0.1", 7497, 1);
+ * ...
+ * ib.disconnect();
+ * ib.recorder.stop();
+ * @endcode
+ */
+template <typename Base>
+requires std::is_base_of_v<EWrapper, Base>
+class RecordingWrapper : public Base {
+public:
+  using Base::Base;
+  using Type = IB::Replay::RecordType;
+
+  IB::Replay::Recorder recorder;   ///< Inactive until start()
+
+  void tickPrice(TickerId tickerId, TickType field, double price, const TickAttrib& attrib) override {
+    if (recorder.active())
+      recorder.record(Type::TICK_PRICE, static_cast<int64_t>(tickerId), static_cast<int32_t>(field), price,
+                      attrib.canAutoExecute, attrib.pastLimit, attrib.preOpen);
+    Base::tickPrice(tickerId, field, price, attrib);
+  }
+
+  void tickSize(TickerId tickerId, TickType field, Decimal size) override {
+    if (recorder.active())
+      recorder.record(Type::TICK_SIZE, static_cast<int64_t>(tickerId), static_cast<int32_t>(field), size);
+    Base::tickSize(tickerId, field, size);
+  }
+
+  void tickString(TickerId tickerId, TickType field, const std::string& value) override {
+    if (recorder.active())
+      recorder.record(Type::TICK_STRING, static_cast<int64_t>(tickerId), static_cast<int32_t>(field), value);
+    Base::tickString(tickerId, field, value);
+  }
+
+  void tickGeneric(TickerId tickerId, TickType field, double value) override {
+    if (recorder.active())
+      recorder.record(Type::TICK_GENERIC, static_cast<int64_t>(tickerId), static_cast<int32_t>(field), value);
+    Base::tickGeneric(tickerId, field, value);
+  }
+
+  void tickOptionComputation(TickerId tickerId, TickType field, int tickAttrib, double impliedVol,
+                             double delta, double optPrice, double pvDividend, double gamma,
+                             double vega, double theta, double undPrice) override {
+    if (recorder.active())
+      recorder.record(Type::TICK_OPTION_COMPUTATION, static_cast<int64_t>(tickerId), static_cast<int32_t>(field),
+                      static_cast<int32_t>(tickAttrib), impliedVol, delta, optPrice, pvDividend, gamma, vega,
+                      theta, undPrice);
+    Base::tickOptionComputation(tickerId, field, tickAttrib, impliedVol, delta, optPrice, pvDividend,
+                                gamma, vega, theta, undPrice);
+  }
+
+  void tickSnapshotEnd(int reqId) override {
+    if (recorder.active()) recorder.record(Type::TICK_SNAPSHOT_END, static_cast<int32_t>(reqId));
+    Base::tickSnapshotEnd(reqId);
+  }
+
+  void tickNews(int tickerId, time_t timeStamp, const std::string& providerCode, const std::string& articleId,
+                const std::string& headline, const std::string& extraData) override {
+    if (recorder.active())
+      recorder.record(Type::TICK_NEWS, static_cast<int32_t>(tickerId), static_cast<int64_t>(timeStamp),
+                      providerCode, articleId, headline, extraData);
+    Base::tickNews(tickerId, timeStamp, providerCode, articleId, headline, extraData);
+  }
+
+  void orderStatus(OrderId orderId, const std::string& status, Decimal filled, Decimal remaining,
+                   double avgFillPrice, long long permId, int parentId, double lastFillPrice,
+                   int clientId, const std::string& whyHeld, double mktCapPrice) override {
+    if (recorder.active())
+      recorder.record(Type::ORDER_STATUS, static_cast<int64_t>(orderId), status, filled, remaining,
+                      avgFillPrice, static_cast<int64_t>(permId), static_cast<int32_t>(parentId),
+                      lastFillPrice, static_cast<int32_t>(clientId), whyHeld, mktCapPrice);
+    Base::orderStatus(orderId, status, filled, remaining, avgFillPrice, permId, parentId,
+                      lastFillPrice, clientId, whyHeld, mktCapPrice);
+  }
+
+  void openOrder(OrderId orderId, const Contract& contract, const Order& order,
+                 const OrderState& orderState) override {
+    if (recorder.active())
+      recorder.record(Type::OPEN_ORDER, static_cast<int64_t>(orderId), contract, order, orderState);
+    Base::openOrder(orderId, contract, order, orderState);
+  }
+
+  void openOrderEnd() override {
+    if (recorder.active()) recorder.record(Type::OPEN_ORDER_END);
+    Base::openOrderEnd();
+  }
+
+  void position(const std::string& account, const Contract& contract, Decimal position,
+                double avgCost) override {
+    if (recorder.active()) recorder.record(Type::POSITION, account, contract, position, avgCost);
+    Base::position(account, contract, position, avgCost);
+  }
+
+  void positionEnd() override {
+    if (recorder.active()) recorder.record(Type::POSITION_END);
+    Base::positionEnd();
+  }
+
+  void accountSummary(int reqId, const std::string& account, const std::string& tag,
+                      const std::string& value, const std::string& currency) override {
+    if (recorder.active())
+      recorder.record(Type::ACCOUNT_SUMMARY, static_cast<int32_t>(reqId), account, tag, value, currency);
+    Base::accountSummary(reqId, account, tag, value, currency);
+  }
+
+  void accountSummaryEnd(int reqId) override {
+    if (recorder.active()) recorder.record(Type::ACCOUNT_SUMMARY_END, static_cast<int32_t>(reqId));
+    Base::accountSummaryEnd(reqId);
+  }
+
+  void contractDetails(int reqId, const ContractDetails& details) override {
+    if (recorder.active()) recorder.record(Type::CONTRACT_DETAILS, static_cast<int32_t>(reqId), details);
+    Base::contractDetails(reqId, details);
+  }
+
+  void contractDetailsEnd(int reqId) override {
+    if (recorder.active()) recorder.record(Type::CONTRACT_DETAILS_END, static_cast<int32_t>(reqId));
+    Base::contractDetailsEnd(reqId);
+  }
+
+  void securityDefinitionOptionalParameter(int reqId, const std::string& exchange, int underlyingConId,
+                                           const std::string& tradingClass, const std::string& multiplier,
+                                           const std::set<std::string>& expirations,
+                                           const std::set<double>& strikes) override {
+    if (recorder.active())
+      recorder.record(Type::SEC_DEF_OPTIONAL_PARAMETER, static_cast<int32_t>(reqId), exchange,
+                      static_cast<int32_t>(underlyingConId), tradingClass, multiplier, expirations, strikes);
+    Base::securityDefinitionOptionalParameter(reqId, exchange, underlyingConId, tradingClass, multiplier,
+                                              expirations, strikes);
+  }
+
+  void securityDefinitionOptionalParameterEnd(int reqId) override {
+    if (recorder.active())
+      recorder.record(Type::SEC_DEF_OPTIONAL_PARAMETER_END, static_cast<int32_t>(reqId));
+    Base::securityDefinitionOptionalParameterEnd(reqId);
+  }
+
+  void nextValidId(OrderId orderId) override {
+    if (recorder.active()) recorder.record(Type::NEXT_VALID_ID, static_cast<int64_t>(orderId));
+    Base::nextValidId(orderId);
+  }
+
+  void error(int id, time_t errorTime, int errorCode, const std::string& errorString,
+             const std::string& advancedOrderRejectJson) override {
+    if (recorder.active())
+      recorder.record(Type::ERROR, static_cast<int32_t>(id), static_cast<int64_t>(errorTime),
+                      static_cast<int32_t>(errorCode), errorString, advancedOrderRejectJson);
+    Base::error(id, errorTime, errorCode, errorString, advancedOrderRejectJson);
+  }
+
+  void scannerData(int reqId, int rank, const ContractDetails& details, const std::string& distance,
+                   const std::string& benchmark, const std::string& projection,
+                   const std::string& legsStr) override {
+    if (recorder.active())
+      recorder.record(Type::SCANNER_DATA, static_cast<int32_t>(reqId), static_cast<int32_t>(rank), details,
+                      distance, benchmark, projection, legsStr);
+    Base::scannerData(reqId, rank, details, distance, benchmark, projection, legsStr);
+  }
+
+  void scannerDataEnd(int reqId) override {
+    if (recorder.active()) recorder.record(Type::SCANNER_DATA_END, static_cast<int32_t>(reqId));
+    Base::scannerDataEnd(reqId);
+  }
+
+  void historicalNews(int requestId, const std::string& time, const std::string& providerCode,
+                      const std::string& articleId, const std::string& headline) override {
+    if (recorder.active())
+      recorder.record(Type::HISTORICAL_NEWS, static_cast<int32_t>(requestId), time, providerCode, articleId,
+                      headline);
+    Base::historicalNews(requestId, time, providerCode, articleId, headline);
+  }
+
+  void historicalNewsEnd(int requestId, bool hasMore) override {
+    if (recorder.active()) recorder.record(Type::HISTORICAL_NEWS_END, static_cast<int32_t>(requestId), hasMore);
+    Base::historicalNewsEnd(requestId, hasMore);
+  }
+
+  void historicalData(TickerId reqId, const Bar& bar) override {
+    if (recorder.active()) recorder.record(Type::HISTORICAL_DATA, static_cast<int64_t>(reqId), bar);
+    Base::historicalData(reqId, bar);
+  }
+
+  void historicalDataEnd(int reqId, const std::string& startDateStr, const std::string& endDateStr) override {
+    if (recorder.active())
+      recorder.record(Type::HISTORICAL_DATA_END, static_cast<int32_t>(reqId), startDateStr, endDateStr);
+    Base::historicalDataEnd(reqId, startDateStr, endDateStr);
+  }
+
+  void headTimestamp(int reqId, const std::string& headTimestamp) override {
+    if (recorder.active()) recorder.record(Type::HEAD_TIMESTAMP, static_cast<int32_t>(reqId), headTimestamp);
+    Base::headTimestamp(reqId, headTimestamp);
+  }
+
+  void historicalTicks(int reqId, const std::vector<HistoricalTick>& ticks, bool done) override {
+    if (recorder.active()) recorder.record(Type::HISTORICAL_TICKS, static_cast<int32_t>(reqId), ticks, done);
+    Base::historicalTicks(reqId, ticks, done);
+  }
+
+  void historicalTicksBidAsk(int reqId, const std::vector<HistoricalTickBidAsk>& ticks, bool done) override {
+    if (recorder.active())
+      recorder.record(Type::HISTORICAL_TICKS_BID_ASK, static_cast<int32_t>(reqId), ticks, done);
+    Base::historicalTicksBidAsk(reqId, ticks, done);
+  }
+
+  void historicalTicksLast(int reqId, const std::vector<HistoricalTickLast>& ticks, bool done) override {
+    if (recorder.active())
+      recorder.record(Type::HISTORICAL_TICKS_LAST, static_cast<int32_t>(reqId), ticks, done);
+    Base::historicalTicksLast(reqId, ticks, done);
+  }
+
+  void connectionClosed() override {
+    if (recorder.active()) recorder.record(Type::CONNECTION_CLOSED);
+    Base::connectionClosed();
+  }
+};
+
+#endif  // QUANTDREAMCPP_RECORDER_H
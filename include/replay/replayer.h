@@ -0,0 +1,402 @@
+#ifndef QUANTDREAMCPP_REPLAYER_H
+#define QUANTDREAMCPP_REPLAYER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "helpers/logger.h"
+#include "replay/record_format.h"
+#include "wrappers/IBBaseWrapper.h"
+
+/**
+ * @file replayer.h
+ * @brief Drives a wrapper from a recorded callback stream
+ *
+ * Records are decoded and invoked on the target exactly as the IB reader thread would
+ * invoke them, so strategies, the quote book, analytics and PositionManager callbacks
+ * see the same sequence as in the live session. The calling thread plays the role of
+ * the reader thread; no TWS connection is needed.
+ *
+ * **Pacing**
+ * - `speed = 1.0`: real time, preserving the recorded gaps between callbacks
+ * - `speed > 1.0`: accelerated (gaps divided by `speed`)
+ * - `speed = MAX_SPEED` (0): no pacing, as fast as the wrapper consumes records
+ */
+
+namespace IB::Replay {
+
+/**
+ * @brief Replays a recording into an IBBaseWrapper-derived wrapper
+ *
+ * Example usage:
+ * @code
+ * IBStrategyWrapper ib;
+ * IB::Replay::Replayer replay("session.ibrec", {.speed = 10.0});
+ * auto stats = replay.run(ib);
+ * @endcode
+ */
+class Replayer {
+public:
+  static constexpr double MAX_SPEED = 0.0;
+
+  struct Options {
+    double speed = 1.0;          ///< Pacing factor (MAX_SPEED disables pacing)
+    bool primeStreams = true;    ///< Create streaming snapshot entries for unknown ticker IDs
+  };
+
+  struct Stats {
+    uint64_t records = 0;        ///< Records dispatched
+    uint64_t skipped = 0;        ///< Unknown or corrupt records
+    int64_t recordedSpanNs = 0;  ///< Timestamp span covered by the recording
+    double elapsedSeconds = 0;   ///< Wall time the replay took
+  };
+
+  explicit Replayer(std::string path) : Replayer(std::move(path), Options{}) {}
+
+  Replayer(std::string path, Options options) : path_(std::move(path)), options_(options) {}
+
+  /// Requests an early stop of a running replay (any thread)
+  void stop() noexcept { stop_.store(true, std::memory_order_relaxed); }
+
+  /**
+   * @brief Replays the whole file into `ib` on the calling thread
+   *
+   * Blocks until the end of the file, a stop() request, or a read error.
+   */
+  Stats run(IBBaseWrapper& ib) {
+    Stats stats;
+    std::ifstream in(path_, std::ios::binary);
+    FileHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, FILE_MAGIC, sizeof(header.magic)) != 0) {
+      LOG_ERROR("[Replayer] ", path_, " is not a recording");
+      return stats;
+    }
+    if (header.version != FILE_VERSION) {
+      LOG_ERROR("[Replayer] Unsupported recording version ", header.version);
+      return stats;
+    }
+
+    stop_.store(false, std::memory_order_relaxed);
+    const auto wallStart = std::chrono::steady_clock::now();
+    int64_t firstNs = 0;
+    int64_t lastNs = 0;
+    std::vector<char> payload;
+    RecordHeader rh{};
+
+    while (!stop_.load(std::memory_order_relaxed) && in.read(reinterpret_cast<char*>(&rh), sizeof(rh))) {
+      payload.resize(rh.size);
+      if (rh.size && !in.read(payload.data(), rh.size)) {
+        LOG_WARN("[Replayer] Truncated record at end of ", path_);
+        ++stats.skipped;
+        break;
+      }
+      if (stats.records + stats.skipped == 0) firstNs = rh.timestampNs;
+      lastNs = rh.timestampNs;
+
+      if (options_.speed > 0.0) {
+        const auto due = wallStart + std::chrono::nanoseconds(
+            static_cast<int64_t>(static_cast<double>(rh.timestampNs - firstNs) / options_.speed));
+        std::this_thread::sleep_until(due);
+      }
+
+      RecordReader r(payload.data(), payload.size());
+      if (dispatch(ib, static_cast<RecordType>(rh.type), r)) ++stats.records;
+      else ++stats.skipped;
+    }
+
+    stats.recordedSpanNs = lastNs - firstNs;
+    stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    LOG_INFO("[Replayer] ", stats.records, " records replayed in ", stats.elapsedSeconds, " s (",
+             stats.skipped, " skipped)");
+    return stats;
+  }
+
+private:
+  /// Mirrors what a market data request would have set up for this ticker
+  void prime(IBBaseWrapper& ib, TickerId tickerId) const {
+    if (!options_.primeStreams || ib.snapshotData.count(tickerId)) return;
+    auto& snap = ib.snapshotData[tickerId];
+    snap.mode = IB::MarketData::PriceType::QUOTES_ONLY;
+    snap.streaming = true;
+  }
+
+  /// Decodes one record and invokes the matching callback; false if unknown or corrupt
+  bool dispatch(IBBaseWrapper& ib, RecordType type, RecordReader& r) const {
+    // Arguments are decoded into locals first: the evaluation order of call
+    // arguments is unspecified, the payload order is not
+    switch (type) {
+      case RecordType::TICK_PRICE: {
+        const auto id = r.read<int64_t>();
+        const auto field = r.read<int32_t>();
+        const auto price = r.read<double>();
+        TickAttrib attrib;
+        attrib.canAutoExecute = r.read<bool>();
+        attrib.pastLimit = r.read<bool>();
+        attrib.preOpen = r.read<bool>();
+        if (!r.ok()) return false;
+        prime(ib, id);
+        ib.tickPrice(id, static_cast<TickType>(field), price, attrib);
+        return true;
+      }
+      case RecordType::TICK_SIZE: {
+        const auto id = r.read<int64_t>();
+        const auto field = r.read<int32_t>();
+        const auto size = r.read<Decimal>();
+        if (!r.ok()) return false;
+        prime(ib, id);
+        ib.tickSize(id, static_cast<TickType>(field), size);
+        return true;
+      }
+      case RecordType::TICK_STRING: {
+        const auto id = r.read<int64_t>();
+        const auto field = r.read<int32_t>();
+        const auto value = r.read<std::string>();
+        if (!r.ok()) return false;
+        ib.tickString(id, static_cast<TickType>(field), value);
+        return true;
+      }
+      case RecordType::TICK_GENERIC: {
+        const auto id = r.read<int64_t>();
+        const auto field = r.read<int32_t>();
+        const auto value = r.read<double>();
+        if (!r.ok()) return false;
+        prime(ib, id);
+        ib.tickGeneric(id, static_cast<TickType>(field), value);
+        return true;
+      }
+      case RecordType::TICK_OPTION_COMPUTATION: {
+        const auto id = r.read<int64_t>();
+        const auto field = r.read<int32_t>();
+        const auto attrib = r.read<int32_t>();
+        double v[8];
+        for (double& x : v) x = r.read<double>();
+        if (!r.ok()) return false;
+        prime(ib, id);
+        ib.tickOptionComputation(id, static_cast<TickType>(field), attrib, v[0], v[1], v[2], v[3], v[4],
+                                 v[5], v[6], v[7]);
+        return true;
+      }
+      case RecordType::TICK_SNAPSHOT_END: {
+        const auto id = r.read<int32_t>();
+        if (!r.ok()) return false;
+        ib.tickSnapshotEnd(id);
+        return true;
+      }
+      case RecordType::TICK_NEWS: {
+        const auto id = r.read<int32_t>();
+        const auto ts = r.read<int64_t>();
+        const auto provider = r.read<std::string>();
+        const auto articleId = r.read<std::string>();
+        const auto headline = r.read<std::string>();
+        const auto extra = r.read<std::string>();
+        if (!r.ok()) return false;
+        ib.tickNews(id, static_cast<time_t>(ts), provider, articleId, headline, extra);
+        return true;
+      }
+      case RecordType::ORDER_STATUS: {
+        const auto orderId = r.read<int64_t>();
+        const auto status = r.read<std::string>();
+        const auto filled = r.read<Decimal>();
+        const auto remaining = r.read<Decimal>();
+        const auto avgFillPrice = r.read<double>();
+        const auto permId = r.read<int64_t>();
+        const auto parentId = r.read<int32_t>();
+        const auto lastFillPrice = r.read<double>();
+        const auto clientId = r.read<int32_t>();
+        const auto whyHeld = r.read<std::string>();
+        const auto mktCapPrice = r.read<double>();
+        if (!r.ok()) return false;
+        ib.orderStatus(orderId, status, filled, remaining, avgFillPrice, permId, parentId, lastFillPrice,
+                       clientId, whyHeld, mktCapPrice);
+        return true;
+      }
+      case RecordType::OPEN_ORDER: {
+        const auto orderId = r.read<int64_t>();
+        const auto contract = r.read<Contract>();
+        const auto order = r.read<Order>();
+        const auto state = r.read<OrderState>();
+        if (!r.ok()) return false;
+        ib.openOrder(orderId, contract, order, state);
+        return true;
+      }
+      case RecordType::OPEN_ORDER_END:
+        ib.openOrderEnd();
+        return true;
+      case RecordType::POSITION: {
+        const auto account = r.read<std::string>();
+        const auto contract = r.read<Contract>();
+        const auto position = r.read<Decimal>();
+        const auto avgCost = r.read<double>();
+        if (!r.ok()) return false;
+        ib.position(account, contract, position, avgCost);
+        return true;
+      }
+      case RecordType::POSITION_END:
+        ib.positionEnd();
+        return true;
+      case RecordType::ACCOUNT_SUMMARY: {
+        const auto reqId = r.read<int32_t>();
+        const auto account = r.read<std::string>();
+        const auto tag = r.read<std::string>();
+        const auto value = r.read<std::string>();
+        const auto currency = r.read<std::string>();
+        if (!r.ok()) return false;
+        ib.accountSummary(reqId, account, tag, value, currency);
+        return true;
+      }
+      case RecordType::ACCOUNT_SUMMARY_END: {
+        const auto reqId = r.read<int32_t>();
+        if (!r.ok()) return false;
+        ib.accountSummaryEnd(reqId);
+        return true;
+      }
+      case RecordType::CONTRACT_DETAILS: {
+        const auto reqId = r.read<int32_t>();
+        const auto details = r.read<ContractDetails>();
+        if (!r.ok()) return false;
+        ib.contractDetails(reqId, details);
+        return true;
+      }
+      case RecordType::CONTRACT_DETAILS_END: {
+        const auto reqId = r.read<int32_t>();
+        if (!r.ok()) return false;
+        ib.contractDetailsEnd(reqId);
+        return true;
+      }
+      case RecordType::SEC_DEF_OPTIONAL_PARAMETER: {
+        const auto reqId = r.read<int32_t>();
+        const auto exchange = r.read<std::string>();
+        const auto underlyingConId = r.read<int32_t>();
+        const auto tradingClass = r.read<std::string>();
+        const auto multiplier = r.read<std::string>();
+        const auto expirations = r.read<std::set<std::string>>();
+        const auto strikes = r.read<std::set<double>>();
+        if (!r.ok()) return false;
+        ib.securityDefinitionOptionalParameter(reqId, exchange, underlyingConId, tradingClass, multiplier,
+                                               expirations, strikes);
+        return true;
+      }
+      case RecordType::SEC_DEF_OPTIONAL_PARAMETER_END: {
+        const auto reqId = r.read<int32_t>();
+        if (!r.ok()) return false;
+        ib.securityDefinitionOptionalParameterEnd(reqId);
+        return true;
+      }
+      case RecordType::NEXT_VALID_ID: {
+        const auto orderId = r.read<int64_t>();
+        if (!r.ok()) return false;
+        ib.nextValidId(orderId);
+        return true;
+      }
+      case RecordType::ERROR: {
+        const auto id = r.read<int32_t>();
+        const auto time = r.read<int64_t>();
+        const auto code = r.read<int32_t>();
+        const auto message = r.read<std::string>();
+        const auto rejectJson = r.read<std::string>();
+        if (!r.ok()) return false;
+        ib.error(id, static_cast<time_t>(time), code, message, rejectJson);
+        return true;
+      }
+      case RecordType::SCANNER_DATA: {
+        const auto reqId = r.read<int32_t>();
+        const auto rank = r.read<int32_t>();
+        const auto details = r.read<ContractDetails>();
+        const auto distance = r.read<std::string>();
+        const auto benchmark = r.read<std::string>();
+        const auto projection = r.read<std::string>();
+        const auto legs = r.read<std::string>();
+        if (!r.ok()) return false;
+        ib.scannerData(reqId, rank, details, distance, benchmark, projection, legs);
+        return true;
+      }
+      case RecordType::SCANNER_DATA_END: {
+        const auto reqId = r.read<int32_t>();
+        if (!r.ok()) return false;
+        ib.scannerDataEnd(reqId);
+        return true;
+      }
+      case RecordType::HISTORICAL_NEWS: {
+        const auto reqId = r.read<int32_t>();
+        const auto time = r.read<std::string>();
+        const auto provider = r.read<std::string>();
+        const auto articleId = r.read<std::string>();
+        const auto headline = r.read<std::string>();
+        if (!r.ok()) return false;
+        ib.historicalNews(reqId, time, provider, articleId, headline);
+        return true;
+      }
+      case RecordType::HISTORICAL_NEWS_END: {
+        const auto reqId = r.read<int32_t>();
+        const auto hasMore = r.read<bool>();
+        if (!r.ok()) return false;
+        ib.historicalNewsEnd(reqId, hasMore);
+        return true;
+      }
+      case RecordType::CONNECTION_CLOSED:
+        ib.connectionClosed();
+        return true;
+      case RecordType::HISTORICAL_DATA: {
+        const auto reqId = r.read<int64_t>();
+        const auto bar = r.read<Bar>();
+        if (!r.ok()) return false;
+        ib.historicalData(reqId, bar);
+        return true;
+      }
+      case RecordType::HISTORICAL_DATA_END: {
+        const auto reqId = r.read<int32_t>();
+        const auto start = r.read<std::string>();
+        const auto end = r.read<std::string>();
+        if (!r.ok()) return false;
+        ib.historicalDataEnd(reqId, start, end);
+        return true;
+      }
+      case RecordType::HEAD_TIMESTAMP: {
+        const auto reqId = r.read<int32_t>();
+        const auto head = r.read<std::string>();
+        if (!r.ok()) return false;
+        ib.headTimestamp(reqId, head);
+        return true;
+      }
+      case RecordType::HISTORICAL_TICKS: {
+        const auto reqId = r.read<int32_t>();
+        const auto ticks = r.read<std::vector<HistoricalTick>>();
+        const auto done = r.read<bool>();
+        if (!r.ok()) return false;
+        ib.historicalTicks(reqId, ticks, done);
+        return true;
+      }
+      case RecordType::HISTORICAL_TICKS_BID_ASK: {
+        const auto reqId = r.read<int32_t>();
+        const auto ticks = r.read<std::vector<HistoricalTickBidAsk>>();
+        const auto done = r.read<bool>();
+        if (!r.ok()) return false;
+        ib.historicalTicksBidAsk(reqId, ticks, done);
+        return true;
+      }
+      case RecordType::HISTORICAL_TICKS_LAST: {
+        const auto reqId = r.read<int32_t>();
+        const auto ticks = r.read<std::vector<HistoricalTickLast>>();
+        const auto done = r.read<bool>();
+        if (!r.ok()) return false;
+        ib.historicalTicksLast(reqId, ticks, done);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::string path_;
+  Options options_;
+  std::atomic<bool> stop_{false};
+};
+
+}  // namespace IB::Replay
+
+#endif  // QUANTDREAMCPP_REPLAYER_H
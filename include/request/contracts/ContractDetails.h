@@ -69,7 +69,7 @@ namespace IB::Requests {
                                      const Contract& contract,
                                      int reqId = IB::ReqId::BASE_CONTRACT_ID)
   {
-    return IB::Helpers::measure([&]() -> Contract {
+    return IB::Helpers::measure(IBW_PERF_TIMER("getContractDetails"), [&]() -> Contract {
 
       // Submit contract details request and wait synchronously for response
       auto contractDetails = IBBaseWrapper::getSync<Contract>(ib, reqId, [&]() {
@@ -84,7 +84,7 @@ namespace IB::Requests {
 
       return contractDetails;
 
-    }, "getContractDetails");
+    });
   }
 }  // namespace IB::Requests
 
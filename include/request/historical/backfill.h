@@ -0,0 +1,277 @@
+#ifndef QUANTDREAMCPP_BACKFILL_H
+#define QUANTDREAMCPP_BACKFILL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "request/historical/historical.h"
+#include "storage/bar_store.h"
+
+/**
+ * @file backfill.h
+ * @brief Paced historical bar backfill into a BarStore
+ *
+ * A date range is cut into chunks on a fixed grid whose length is the longest duration
+ * IB accepts for the bar size (e.g. one day of 1-minute bars). Because the grid does not
+ * depend on the requested range, a later run with a different range maps onto the same
+ * chunk files and only fetches what is missing. Requests are spaced by the connection's
+ * `HistoricalPacer`, pipelined up to `maxInFlight` outstanding, and each response is
+ * written as one immutable chunk.
+ */
+
+namespace IB::Requests {
+
+  /**
+   * @brief Chunk length in seconds for a bar size
+   *
+   * Follows IB's documented maximum duration per request for each bar size.
+   */
+  inline int64_t backfillChunkSeconds(const std::string& barSize) {
+    constexpr int64_t DAY = 86400;
+    static const std::pair<const char*, int64_t> table[] = {
+        {"1 secs", 1800},       {"5 secs", 3600},      {"10 secs", 14400},   {"15 secs", 14400},
+        {"30 secs", 28800},     {"1 min", DAY},        {"2 mins", 2 * DAY},  {"3 mins", 7 * DAY},
+        {"5 mins", 7 * DAY},    {"10 mins", 7 * DAY},  {"15 mins", 14 * DAY}, {"20 mins", 14 * DAY},
+        {"30 mins", 28 * DAY},  {"1 hour", 28 * DAY},  {"2 hours", 28 * DAY}, {"3 hours", 28 * DAY},
+        {"4 hours", 28 * DAY},  {"8 hours", 28 * DAY}, {"1 day", 364 * DAY},  {"1 week", 364 * DAY},
+        {"1 month", 364 * DAY}};
+    for (const auto& [size, seconds] : table)
+      if (barSize == size) return seconds;
+    LOG_WARN("[Backfill] Unknown bar size \"", barSize, "\", using one-day chunks");
+    return DAY;
+  }
+
+  /// IB duration string covering `seconds` ("1800 S", "7 D", ...)
+  inline std::string durationString(int64_t seconds) {
+    if (seconds < 86400 || seconds % 86400) return std::to_string(seconds) + " S";
+    return std::to_string(seconds / 86400) + " D";
+  }
+
+  /// One series to backfill over `[from, to)` (seconds since epoch)
+  struct BackfillJob {
+    Contract contract;                     ///< Must carry a conId (chunks are stored by conId)
+    std::string barSize = "1 min";
+    std::string whatToShow = "TRADES";
+    bool useRTH = true;
+    int64_t from = 0;
+    int64_t to = 0;
+  };
+
+  struct BackfillOptions {
+    size_t maxInFlight = 6;                          ///< Outstanding requests (IB allows 50)
+    std::chrono::seconds timeout{120};               ///< Per request, then cancelled and retried
+    int maxAttempts = 3;                             ///< Per chunk, counting timeouts and errors
+    std::chrono::seconds pacingPenalty{60};          ///< Pause after a pacing violation
+    bool clipToHeadTimestamp = true;                 ///< Skip chunks before the first available data
+  };
+
+  struct BackfillReport {
+    size_t chunks = 0;      ///< Chunks in the requested ranges
+    size_t skipped = 0;     ///< Already stored complete
+    size_t fetched = 0;     ///< Stored with bars
+    size_t empty = 0;       ///< Stored empty (no data: weekend, holiday, before listing)
+    size_t failed = 0;      ///< Gave up after maxAttempts
+    size_t bars = 0;        ///< Bars written
+  };
+
+  /**
+   * @brief Fills gaps of historical bar series in a BarStore
+   *
+   * `run()` blocks the calling thread (never the IB reader thread) until every chunk is
+   * stored or failed, or `stop()` is called from another thread.
+   *
+   * Example usage:
+   * @code
+   * IB::Storage::BarStore store("/data/bars");
+   * IB::Requests::BarBackfill backfill(ib, store);
+   *
+   * auto report = backfill.run({{.contract = aapl, .barSize = "1 min",
+   *                              .from = now - 90 * 86400, .to = now}});
+   * LOG_INFO("fetched ", report.fetched, " chunks, skipped ", report.skipped);
+   * @endcode
+   */
+  class BarBackfill {
+  public:
+    BarBackfill(IBHistoricalWrapper& ib, IB::Storage::BarStore& store)
+        : BarBackfill(ib, store, BackfillOptions{}) {}
+
+    BarBackfill(IBHistoricalWrapper& ib, IB::Storage::BarStore& store, BackfillOptions options)
+        : ib_(ib), store_(store), options_(options) {
+      options_.maxInFlight = std::clamp<size_t>(options_.maxInFlight, 1, 50);
+    }
+
+    /// Plans, fetches and stores every missing chunk of `jobs`
+    BackfillReport run(const std::vector<BackfillJob>& jobs) {
+      stopped_ = false;
+      BackfillReport report;
+      std::deque<Chunk> queue;
+      const int64_t now = nowSeconds();
+
+      for (size_t j = 0; j < jobs.size() && !stopped_; ++j) {
+        const auto& job = jobs[j];
+        if (job.contract.conId == 0) {
+          LOG_ERROR("[Backfill] ", job.contract.symbol, ": contract has no conId, skipped");
+          continue;
+        }
+        int64_t from = job.from;
+        if (options_.clipToHeadTimestamp) {
+          const int64_t head = getHeadTimestamp(ib_, job.contract, job.whatToShow, job.useRTH);
+          if (head > from) from = head;
+        }
+        const int64_t length = backfillChunkSeconds(job.barSize);
+        const int64_t to = std::min(job.to, now);
+        for (int64_t start = floorTo(from, length); start < to; start += length) {
+          ++report.chunks;
+          if (store_.hasComplete(series(job), start)) {
+            ++report.skipped;
+            continue;
+          }
+          queue.push_back({j, start, start + length, 0});
+        }
+      }
+      LOG_INFO("[Backfill] ", report.chunks, " chunks, ", report.skipped, " already stored, ", queue.size(),
+               " to fetch");
+
+      std::deque<InFlight> inFlight;
+      while (!stopped_ && (!queue.empty() || !inFlight.empty())) {
+        while (!stopped_ && !queue.empty() && inFlight.size() < options_.maxInFlight) {
+          send(jobs, queue.front(), inFlight);
+          queue.pop_front();
+        }
+        if (inFlight.empty()) continue;
+
+        // Wait on the oldest request, then collect everything that has completed
+        const auto deadline = inFlight.front().sentAt + options_.timeout;
+        inFlight.front().result.wait_until(std::min(deadline, Clock::now() + std::chrono::milliseconds(100)));
+        for (auto it = inFlight.begin(); it != inFlight.end();) {
+          if (it->result.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            complete(jobs, *it, it->result.get(), queue, report);
+          } else if (Clock::now() >= it->sentAt + options_.timeout) {
+            LOG_WARN("[Backfill] reqId=", it->reqId, " timed out");
+            abandon(*it);
+            retry(it->chunk, queue, report);
+          } else {
+            ++it;
+            continue;
+          }
+          it = inFlight.erase(it);
+        }
+      }
+
+      for (auto& f : inFlight) abandon(f);
+      LOG_INFO("[Backfill] Done: ", report.fetched, " fetched, ", report.empty, " empty, ", report.failed,
+               " failed, ", report.bars, " bars");
+      return report;
+    }
+
+    /// Makes a running `run()` return after its current wait; outstanding requests are cancelled
+    void stop() { stopped_ = true; }
+
+    static IB::Storage::BarSeries series(const BackfillJob& job) {
+      return {job.contract.conId, job.barSize, job.whatToShow, job.useRTH};
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Chunk {
+      size_t job;
+      int64_t from;
+      int64_t to;
+      int attempts;
+    };
+
+    struct InFlight {
+      Chunk chunk;
+      int reqId;
+      Clock::time_point sentAt;
+      std::future<HistoricalBars> result;
+    };
+
+    static int64_t nowSeconds() {
+      return std::chrono::duration_cast<std::chrono::seconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    static int64_t floorTo(int64_t t, int64_t step) { return (t >= 0 ? t : t - step + 1) / step * step; }
+
+    void send(const std::vector<BackfillJob>& jobs, const Chunk& chunk, std::deque<InFlight>& inFlight) {
+      const auto& job = jobs[chunk.job];
+      const std::string end = formatUtc(chunk.to);
+      const std::string duration = durationString(chunk.to - chunk.from);
+      waitForPacing(ib_, pacingContractKey(job.contract, job.whatToShow) + "|" + end + "|" + duration + "|" +
+                             job.barSize, pacingContractKey(job.contract, job.whatToShow));
+
+      const int reqId = nextReqId(inFlight);
+      auto result = ib_.createPromise<HistoricalBars>(reqId);
+      ib_.client->reqHistoricalData(reqId, job.contract, end, duration, job.barSize, job.whatToShow,
+                                    job.useRTH ? 1 : 0, 2, false, TagValueListSPtr());
+      LOG_DEBUG("[Backfill] reqId=", reqId, " ", job.contract.symbol, " ", job.barSize, " ", duration, " ending ", end);
+      inFlight.push_back({chunk, reqId, Clock::now(), std::move(result)});
+    }
+
+    void complete(const std::vector<BackfillJob>& jobs, const InFlight& f, HistoricalBars result,
+                  std::deque<Chunk>& queue, BackfillReport& report) {
+      const auto& job = jobs[f.chunk.job];
+      const int64_t now = nowSeconds();
+      if (result.ok() || result.noData()) {
+        // Responses may reach outside the chunk; only the part inside is stored
+        const auto kept = static_cast<size_t>(std::count_if(result.bars.begin(), result.bars.end(), [&](const auto& b) {
+          return b.time >= f.chunk.from && b.time < f.chunk.to;
+        }));
+        if (!store_.write(series(job), f.chunk.from, f.chunk.to, std::move(result.bars), f.chunk.to <= now, now)) {
+          ++report.failed;
+          return;
+        }
+        kept ? ++report.fetched : ++report.empty;
+        report.bars += kept;
+        return;
+      }
+      if (result.pacingViolation()) {
+        LOG_WARN("[Backfill] Pacing violation, pausing ", options_.pacingPenalty.count(), " s");
+        ib_.historicalPacer.penalize(Clock::now() + options_.pacingPenalty);
+        queue.push_front(f.chunk);   // not the chunk's fault
+        return;
+      }
+      LOG_WARN("[Backfill] ", job.contract.symbol, " chunk ", formatUtc(f.chunk.from), " failed [", result.errorCode,
+               "] ", result.errorMessage);
+      retry(f.chunk, queue, report);
+    }
+
+    void retry(Chunk chunk, std::deque<Chunk>& queue, BackfillReport& report) {
+      if (++chunk.attempts < options_.maxAttempts) queue.push_back(chunk);
+      else ++report.failed;
+    }
+
+    /// Cancels a request and drops its promise so a late answer is ignored
+    void abandon(const InFlight& f) {
+      ib_.client->cancelHistoricalData(f.reqId);
+      ib_.dropPromise(f.reqId);
+    }
+
+    int nextReqId(const std::deque<InFlight>& inFlight) {
+      constexpr int range = IB::ReqId::HEAD_TIMESTAMP_ID - IB::ReqId::HISTORICAL_DATA_ID - 1;
+      for (;;) {
+        // HISTORICAL_DATA_ID itself is left to ad-hoc getHistoricalBars calls
+        const int id = IB::ReqId::HISTORICAL_DATA_ID + 1 + (reqSeq_++ % range);
+        if (std::none_of(inFlight.begin(), inFlight.end(), [id](const InFlight& f) { return f.reqId == id; }))
+          return id;
+      }
+    }
+
+    IBHistoricalWrapper& ib_;
+    IB::Storage::BarStore& store_;
+    BackfillOptions options_;
+    std::atomic<bool> stopped_{false};
+    int reqSeq_ = 0;
+  };
+
+}  // namespace IB::Requests
+
+#endif  // QUANTDREAMCPP_BACKFILL_H
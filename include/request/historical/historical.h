@@ -0,0 +1,123 @@
+#ifndef QUANTDREAMCPP_HISTORICAL_H
+#define QUANTDREAMCPP_HISTORICAL_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "IBRequestIds.h"
+#include "helpers/logger.h"
+#include "wrappers/IBHistoricalWrapper.h"
+
+/**
+ * @file historical.h
+ * @brief Historical bar, tick and head-timestamp requests
+ *
+ * Every request goes through `IBHistoricalWrapper::historicalPacer` first, so ad-hoc
+ * calls and a running backfill share one view of IB's pacing limits.
+ */
+
+namespace IB::Requests {
+
+  /// "yyyyMMdd-HH:mm:ss" in UTC, the explicit-timezone form IB accepts for endDateTime
+  inline std::string formatUtc(int64_t epochSeconds) {
+    using namespace std::chrono;
+    const sys_seconds t{seconds(epochSeconds)};
+    const auto day = floor<days>(t);
+    const year_month_day ymd{day};
+    const hh_mm_ss hms{t - day};
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%04d%02u%02u-%02d:%02d:%02d", static_cast<int>(ymd.year()),
+                  static_cast<unsigned>(ymd.month()), static_cast<unsigned>(ymd.day()),
+                  static_cast<int>(hms.hours().count()), static_cast<int>(hms.minutes().count()),
+                  static_cast<int>(hms.seconds().count()));
+    return buf;
+  }
+
+  /// Pacing key of a contract / data type (the "same contract" rule)
+  inline std::string pacingContractKey(const Contract& contract, const std::string& whatToShow) {
+    return std::to_string(contract.conId) + "|" + contract.symbol + "|" + contract.exchange + "|" + whatToShow;
+  }
+
+  /// Blocks until the pacer allows a request with the given keys
+  template <typename T>
+  requires std::is_base_of_v<IBHistoricalWrapper, T>
+  inline void waitForPacing(T& ib, const std::string& requestKey, const std::string& contractKey) {
+    const auto at = ib.historicalPacer.reserve(requestKey, contractKey);
+    if (at > IB::MarketData::HistoricalPacer::Clock::now()) {
+      LOG_DEBUG("[Historical] Pacing: waiting ",
+                std::chrono::duration_cast<std::chrono::milliseconds>(at - IB::MarketData::HistoricalPacer::Clock::now()).count(),
+                " ms");
+      std::this_thread::sleep_until(at);
+    }
+  }
+
+  /**
+   * @brief Requests historical bars and waits for the response
+   *
+   * Example usage:
+   * @code
+   * auto result = IB::Requests::getHistoricalBars(ib, aapl, "", "1 D", "1 min");
+   * if (result.ok())
+   *     for (const auto& bar : result.bars) ...
+   * @endcode
+   *
+   * @param endDateTime "yyyyMMdd-HH:mm:ss" UTC (see formatUtc) or empty for now
+   * @param duration IB duration string ("1800 S", "1 D", "2 W", ...)
+   * @param barSize IB bar size setting ("1 min", "1 hour", ...)
+   */
+  template <typename T>
+  requires std::is_base_of_v<IBHistoricalWrapper, T>
+  inline HistoricalBars getHistoricalBars(T& ib, const Contract& contract, const std::string& endDateTime,
+                                          const std::string& duration, const std::string& barSize,
+                                          const std::string& whatToShow = "TRADES", bool useRTH = true,
+                                          int reqId = IB::ReqId::HISTORICAL_DATA_ID) {
+    waitForPacing(ib, pacingContractKey(contract, whatToShow) + "|" + endDateTime + "|" + duration + "|" + barSize,
+                  pacingContractKey(contract, whatToShow));
+    return IBBaseWrapper::getSync<HistoricalBars>(ib, reqId, [&]() {
+      ib.client->reqHistoricalData(reqId, contract, endDateTime, duration, barSize, whatToShow, useRTH ? 1 : 0,
+                                   2, false, TagValueListSPtr());
+    });
+  }
+
+  /**
+   * @brief Requests up to `count` historical ticks forward from `startDateTime`
+   *
+   * @param whatToShow TRADES, BID_ASK or MIDPOINT (see HistoricalTicks for the record mapping)
+   */
+  template <typename T>
+  requires std::is_base_of_v<IBHistoricalWrapper, T>
+  inline HistoricalTicks getHistoricalTicks(T& ib, const Contract& contract, const std::string& startDateTime,
+                                            int count = 1000, const std::string& whatToShow = "TRADES",
+                                            bool useRTH = false, int reqId = IB::ReqId::HISTORICAL_TICKS_ID) {
+    waitForPacing(ib, pacingContractKey(contract, whatToShow) + "|ticks|" + startDateTime,
+                  pacingContractKey(contract, whatToShow));
+    return IBBaseWrapper::getSync<HistoricalTicks>(ib, reqId, [&]() {
+      ib.client->reqHistoricalTicks(reqId, contract, startDateTime, "", count, whatToShow, useRTH ? 1 : 0, false,
+                                    TagValueListSPtr());
+    });
+  }
+
+  /**
+   * @brief Earliest available data point for a contract / data type
+   *
+   * @return Seconds since epoch, or 0 if IB has none or rejected the request
+   */
+  template <typename T>
+  requires std::is_base_of_v<IBHistoricalWrapper, T>
+  inline int64_t getHeadTimestamp(T& ib, const Contract& contract, const std::string& whatToShow = "TRADES",
+                                  bool useRTH = true, int reqId = IB::ReqId::HEAD_TIMESTAMP_ID) {
+    waitForPacing(ib, pacingContractKey(contract, whatToShow) + "|head|" + std::to_string(useRTH),
+                  pacingContractKey(contract, whatToShow));
+    const auto text = IBBaseWrapper::getSync<std::string>(ib, reqId, [&]() {
+      ib.client->reqHeadTimestamp(reqId, contract, whatToShow, useRTH ? 1 : 0, 2);
+    });
+    ib.client->cancelHeadTimestamp(reqId);
+    return IBHistoricalWrapper::parseBarTime(text);
+  }
+
+}  // namespace IB::Requests
+
+#endif  // QUANTDREAMCPP_HISTORICAL_H
@@ -0,0 +1,434 @@
+#ifndef QUANTDREAMCPP_TICK_BACKFILL_H
+#define QUANTDREAMCPP_TICK_BACKFILL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <list>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "request/historical/historical.h"
+#include "storage/tick_archive.h"
+
+/**
+ * @file tick_backfill.h
+ * @brief Historical tick download into the tick archive with adaptive windows
+ *
+ * IB answers `reqHistoricalTicks` with at most ~1,000 ticks counted forward from a start
+ * time (always completing the last second), so a liquid day takes hundreds of chained
+ * requests. The planner works per instrument-day on a list of time windows:
+ *  - each window is a chain of requests whose cursor advances to the last returned
+ *    second; ticks of that second are remembered and dropped from the next response,
+ *    which starts at the same second
+ *  - a window that is still far from its end after a request (dense period) is split
+ *    in two, so the second half downloads concurrently
+ *  - a response that runs past the window end (sparse period) absorbs the following
+ *    window if that one has not started yet, saving its requests
+ *
+ * Requests for many instruments run concurrently under the connection's
+ * `HistoricalPacer`. Windows of one instrument-day are appended to the archive strictly
+ * in time order (later windows buffer until the earlier ones finish), which the
+ * segment format requires.
+ *
+ * **Resuming**: a fully downloaded past day gets an empty `<conId>.hist` marker next to
+ * its segment and is skipped on the next run; an interrupted day resumes from its last
+ * archived second, again dropping the ticks already stored for that second.
+ */
+
+namespace IB::Requests {
+
+  /// One instrument over a range of UTC days
+  struct TickBackfillJob {
+    Contract contract;                    ///< Must carry a conId (segments are stored by conId)
+    std::string whatToShow = "TRADES";    ///< TRADES, BID_ASK or MIDPOINT
+    bool useRTH = false;
+    int firstDay = 0;                     ///< YYYYMMDD (UTC)
+    int lastDay = 0;                      ///< YYYYMMDD (UTC), inclusive; today is fetched up to now
+  };
+
+  struct TickBackfillOptions {
+    size_t maxInFlight = 6;                  ///< Outstanding requests (IB allows 50)
+    int ticksPerRequest = 1000;              ///< IB maximum
+    size_t maxWindows = 8;                   ///< Concurrent windows per instrument-day
+    double splitRatio = 4.0;                 ///< Split when the rest needs more than this many requests
+    std::chrono::seconds timeout{120};       ///< Per request, then abandoned and retried
+    int maxAttempts = 3;                     ///< Per window, counting timeouts and errors
+    std::chrono::seconds pacingPenalty{60};  ///< Pause after a pacing violation
+  };
+
+  struct TickBackfillReport {
+    size_t days = 0;          ///< Instrument-days in the jobs (up to today)
+    size_t skipped = 0;       ///< Already complete (marker present)
+    size_t completed = 0;     ///< Downloaded completely in this run
+    size_t failed = 0;        ///< Stopped at a window that exhausted its attempts
+    size_t requests = 0;
+    size_t ticks = 0;         ///< Records appended to the archive
+    size_t duplicates = 0;    ///< Records dropped at window / request boundaries
+    size_t splits = 0;
+    size_t coalesced = 0;
+  };
+
+  /**
+   * @brief Downloads historical ticks into a TickArchiveWriter
+   *
+   * The writer must not receive live ticks for the same instrument-days (use a separate
+   * writer from the one attached to `IBMarketWrapper`, or backfill past days only), and
+   * `run()` must be its only producer while it runs.
+   *
+   * Example usage:
+   * @code
+   * IB::Storage::TickArchiveWriter archive({.root = "/data/ticks"});
+   * IB::Requests::TickBackfill backfill(ib, archive);
+   * auto report = backfill.run({{.contract = aapl, .firstDay = 20261001, .lastDay = 20261017},
+   *                             {.contract = msft, .firstDay = 20261001, .lastDay = 20261017}});
+   * @endcode
+   */
+  class TickBackfill {
+  public:
+    TickBackfill(IBHistoricalWrapper& ib, IB::Storage::TickArchiveWriter& archive)
+        : TickBackfill(ib, archive, TickBackfillOptions{}) {}
+
+    TickBackfill(IBHistoricalWrapper& ib, IB::Storage::TickArchiveWriter& archive, TickBackfillOptions options)
+        : ib_(ib), archive_(archive), options_(options) {
+      options_.maxInFlight = std::clamp<size_t>(options_.maxInFlight, 1, 50);
+      options_.maxWindows = std::max<size_t>(1, options_.maxWindows);
+    }
+
+    /// Plans and downloads every missing instrument-day of `jobs`
+    TickBackfillReport run(const std::vector<TickBackfillJob>& jobs) {
+      stopped_ = false;
+      TickBackfillReport report;
+      const uint64_t droppedBefore = archive_.dropped();
+      IB::Storage::TickArchiveReader reader(archive_.root());
+      const int64_t now = IB::Helpers::wallNowNs() / NS;
+
+      std::deque<Day> pending;
+      for (size_t j = 0; j < jobs.size(); ++j) {
+        const auto& job = jobs[j];
+        if (job.contract.conId == 0) {
+          LOG_ERROR("[TickBackfill] ", job.contract.symbol, ": contract has no conId, skipped");
+          continue;
+        }
+        for (int64_t t = IB::Storage::dayStartNs(job.firstDay); IB::Storage::dayOf(t) <= job.lastDay;
+             t += IB::Storage::NS_PER_DAY) {
+          if (t / NS >= now) break;
+          ++report.days;
+          Day d{j, job.contract.conId, IB::Storage::dayOf(t), {}, false};
+          if (std::filesystem::exists(marker(d))) {
+            ++report.skipped;
+            continue;
+          }
+          Window w;
+          w.from = w.cursor = t / NS;
+          w.to = std::min((t + IB::Storage::NS_PER_DAY) / NS, now);
+          resume(reader, d, w);
+          d.windows.push_back(std::move(w));
+          pending.push_back(std::move(d));
+        }
+      }
+      LOG_INFO("[TickBackfill] ", report.days, " instrument-days, ", report.skipped, " already complete, ",
+               pending.size(), " to download");
+
+      std::deque<InFlight> inFlight;
+      while (!stopped_ && !pending.empty()) {
+        while (!stopped_ && inFlight.size() < options_.maxInFlight) {
+          if (!sendNext(jobs, pending, inFlight, report)) break;
+        }
+
+        if (!inFlight.empty()) {
+          const auto deadline = inFlight.front().sentAt + options_.timeout;
+          inFlight.front().result.wait_until(std::min(deadline, Clock::now() + std::chrono::milliseconds(100)));
+          for (auto it = inFlight.begin(); it != inFlight.end();) {
+            if (it->result.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+              complete(*it, it->result.get(), report);
+            } else if (Clock::now() >= it->sentAt + options_.timeout) {
+              LOG_WARN("[TickBackfill] reqId=", it->reqId, " timed out");
+              abandon(*it);
+              it->window->inFlight = false;
+              if (!it->window->done) fail(*it->day, it->window, "timeout");
+            } else {
+              ++it;
+              continue;
+            }
+            report.ticks += drain(*it->day);
+            it = inFlight.erase(it);
+          }
+        }
+
+        // Retire finished days from the front; markers wait until the writer has flushed
+        while (!pending.empty() && finishedDay(pending.front())) {
+          Day& d = pending.front();
+          if (d.failed) {
+            ++report.failed;
+          } else {
+            ++report.completed;
+            if (d.windows.back().to * NS >= IB::Storage::dayStartNs(d.day) + IB::Storage::NS_PER_DAY)
+              markers_.push_back(marker(d));
+          }
+          pending.pop_front();
+        }
+      }
+
+      for (auto& f : inFlight) abandon(f);
+      writeMarkers(droppedBefore);
+      LOG_INFO("[TickBackfill] Done: ", report.completed, " days complete, ", report.failed, " failed, ",
+               report.requests, " requests, ", report.ticks, " ticks, ", report.duplicates, " duplicates dropped, ",
+               report.splits, " splits, ", report.coalesced, " coalesced");
+      return report;
+    }
+
+    /// Makes a running `run()` return after its current wait; outstanding requests are cancelled
+    void stop() { stopped_ = true; }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    using TickRecord = IB::Storage::TickRecord;
+    static constexpr int64_t NS = 1'000'000'000LL;
+
+    /// A chain of requests covering `[from, to)` seconds
+    struct Window {
+      int64_t from = 0;
+      int64_t to = 0;
+      int64_t cursor = 0;                 ///< Start of the next request
+      std::vector<TickRecord> boundary;   ///< Records already taken at second `cursor`
+      std::vector<TickRecord> buffer;     ///< Accepted, waiting for earlier windows
+      bool started = false;
+      bool inFlight = false;
+      bool done = false;
+      bool failed = false;
+      int attempts = 0;
+    };
+
+    struct Day {
+      size_t job;
+      long conId;
+      int day;
+      std::list<Window> windows;          ///< Ascending, contiguous
+      bool failed = false;
+    };
+
+    struct InFlight {
+      Day* day;
+      std::list<Window>::iterator window;
+      int reqId;
+      int64_t start;
+      Clock::time_point sentAt;
+      std::future<HistoricalTicks> result;
+    };
+
+    std::filesystem::path marker(const Day& d) const {
+      return IB::Storage::segmentPath(archive_.root(), d.conId, d.day, ".hist");
+    }
+
+    /// Continues an interrupted day after its last archived second
+    static void resume(IB::Storage::TickArchiveReader& reader, const Day& d, Window& w) {
+      const auto slices = reader.query(d.conId, w.from * NS, w.to * NS);
+      if (slices.empty() || slices.back().ticks.empty()) return;
+      const auto ticks = slices.back().ticks;
+      w.cursor = ticks.back().timestampNs / NS;
+      for (auto it = ticks.rbegin(); it != ticks.rend() && it->timestampNs / NS == w.cursor; ++it)
+        w.boundary.push_back(*it);
+      LOG_INFO("[TickBackfill] conId=", d.conId, " day=", d.day, " resuming at ", formatUtc(w.cursor));
+    }
+
+    /// All windows done and none awaiting an answer (an InFlight still points into the day)
+    static bool finishedDay(const Day& d) {
+      return std::all_of(d.windows.begin(), d.windows.end(), [](const Window& w) { return w.done && !w.inFlight; });
+    }
+
+    /// Sends the next idle window, favouring the oldest instrument-days
+    bool sendNext(const std::vector<TickBackfillJob>& jobs, std::deque<Day>& pending, std::deque<InFlight>& inFlight,
+                  TickBackfillReport& report) {
+      // Bound buffering to as many instrument-days as there are request slots
+      const size_t active = std::min(pending.size(), options_.maxInFlight);
+      for (size_t i = 0; i < active; ++i) {
+        Day& d = pending[i];
+        for (auto w = d.windows.begin(); w != d.windows.end(); ++w) {
+          if (w->done || w->inFlight) continue;
+          send(jobs[d.job], d, w, inFlight);
+          ++report.requests;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void send(const TickBackfillJob& job, Day& d, std::list<Window>::iterator w, std::deque<InFlight>& inFlight) {
+      const std::string start = formatUtc(w->cursor);
+      const std::string contractKey = pacingContractKey(job.contract, job.whatToShow);
+      waitForPacing(ib_, contractKey + "|ticks|" + start, contractKey);
+
+      const int reqId = nextReqId(inFlight);
+      auto result = ib_.createPromise<HistoricalTicks>(reqId);
+      ib_.client->reqHistoricalTicks(reqId, job.contract, start, "", options_.ticksPerRequest, job.whatToShow,
+                                     job.useRTH ? 1 : 0, false, TagValueListSPtr());
+      w->started = w->inFlight = true;
+      inFlight.push_back({&d, w, reqId, w->cursor, Clock::now(), std::move(result)});
+    }
+
+    void complete(InFlight& f, HistoricalTicks result, TickBackfillReport& report) {
+      Day& d = *f.day;
+      Window& w = *f.window;
+      w.inFlight = false;
+      if (w.done) return;   // closed by a failed earlier window while this request was out
+      if (!result.ok() && !result.noData()) {
+        if (result.pacingViolation()) {
+          LOG_WARN("[TickBackfill] Pacing violation, pausing ", options_.pacingPenalty.count(), " s");
+          ib_.historicalPacer.penalize(Clock::now() + options_.pacingPenalty);
+          return;
+        }
+        fail(d, f.window, "[" + std::to_string(result.errorCode) + "] " + result.errorMessage);
+        return;
+      }
+
+      auto& ticks = result.ticks;
+      report.duplicates += dropBoundary(ticks, w.boundary, f.start);
+
+      // Past the window end: absorb following windows that have not started yet
+      auto beyond = [&] {
+        return std::lower_bound(ticks.begin(), ticks.end(), w.to * NS,
+                                [](const TickRecord& r, int64_t t) { return r.timestampNs < t; });
+      };
+      auto cut = beyond();
+      for (auto next = std::next(f.window); cut != ticks.end() && next != d.windows.end() && !next->started;) {
+        w.to = next->to;
+        next = d.windows.erase(next);
+        ++report.coalesced;
+        cut = beyond();
+      }
+      const bool crossed = cut != ticks.end();
+      ticks.erase(cut, ticks.end());
+
+      const int64_t last = ticks.empty() ? f.start : ticks.back().timestampNs / NS;
+      if (crossed || result.received < static_cast<size_t>(options_.ticksPerRequest)) {
+        w.done = true;
+      } else if (last <= f.start) {
+        // A full response inside one second cannot move the cursor; skip that second
+        LOG_WARN("[TickBackfill] conId=", d.conId, " more than ", options_.ticksPerRequest, " ticks at ",
+                 formatUtc(f.start), ", rest of that second skipped");
+        w.cursor = f.start + 1;
+        w.boundary.clear();
+      } else {
+        w.cursor = last;
+        w.boundary.clear();
+        for (auto it = ticks.rbegin(); it != ticks.rend() && it->timestampNs / NS == last; ++it)
+          w.boundary.push_back(*it);
+      }
+      if (w.cursor >= w.to) w.done = true;
+
+      // Dense: hand the second half of the rest to a new concurrent window
+      const int64_t covered = std::max<int64_t>(1, last - f.start);
+      const int64_t remaining = w.to - w.cursor;
+      if (!w.done && d.windows.size() < options_.maxWindows &&
+          static_cast<double>(remaining) > options_.splitRatio * static_cast<double>(covered)) {
+        Window half;
+        half.from = half.cursor = w.cursor + remaining / 2;
+        half.to = w.to;
+        w.to = half.from;
+        d.windows.insert(std::next(f.window), std::move(half));
+        ++report.splits;
+      }
+
+      w.buffer.insert(w.buffer.end(), ticks.begin(), ticks.end());
+    }
+
+    /**
+     * @brief Removes records at second `second` already taken by the previous request
+     * @return Number of records removed
+     */
+    static size_t dropBoundary(std::vector<TickRecord>& ticks, std::vector<TickRecord> boundary, int64_t second) {
+      if (boundary.empty()) return 0;
+      const size_t before = ticks.size();
+      std::erase_if(ticks, [&](const TickRecord& t) {
+        if (t.timestampNs / NS != second) return false;
+        auto match = std::find_if(boundary.begin(), boundary.end(), [&](const TickRecord& b) {
+          return b.field == t.field && b.price == t.price && b.size == t.size;
+        });
+        if (match == boundary.end()) return false;
+        boundary.erase(match);
+        return true;
+      });
+      return before - ticks.size();
+    }
+
+    /**
+     * @brief Gives up on a window after its last attempt; the day keeps only the ticks before it
+     *
+     * Later windows are closed too; their requests still out are left to answer or time
+     * out, and the day is retired only after that (see finishedDay).
+     */
+    void fail(Day& d, std::list<Window>::iterator w, const std::string& reason) {
+      LOG_WARN("[TickBackfill] conId=", d.conId, " day=", d.day, " window ", formatUtc(w->cursor), ": ", reason);
+      if (++w->attempts < options_.maxAttempts) return;
+      LOG_ERROR("[TickBackfill] conId=", d.conId, " day=", d.day, " failed at ", formatUtc(w->cursor));
+      d.failed = w->failed = true;
+      for (auto it = w; it != d.windows.end(); ++it) {
+        it->done = true;
+        it->buffer.clear();
+      }
+    }
+
+    /**
+     * @brief Appends finished leading windows (and the running head window) to the archive
+     * @return Records appended
+     */
+    size_t drain(Day& d) {
+      size_t n = 0;
+      for (auto& w : d.windows) {
+        if (w.failed) break;
+        for (const auto& t : w.buffer)
+          while (!archive_.append(d.conId, t)) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        n += w.buffer.size();
+        w.buffer.clear();
+        if (!w.done) break;
+      }
+      return n;
+    }
+
+    /// Publishes day markers once every appended tick is on disk
+    void writeMarkers(uint64_t droppedBefore) {
+      if (markers_.empty()) return;
+      const auto deadline = Clock::now() + std::chrono::seconds(30);
+      while (archive_.written() + archive_.dropped() < archive_.appended() && Clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      if (archive_.dropped() != droppedBefore || archive_.written() + archive_.dropped() < archive_.appended()) {
+        LOG_ERROR("[TickBackfill] Archive dropped or did not flush ticks; days stay unmarked and resume next run");
+      } else {
+        for (const auto& path : markers_) std::ofstream(path, std::ios::trunc);
+      }
+      markers_.clear();
+    }
+
+    /// Drops the promise of a request so a late answer is ignored (tick requests cannot be cancelled)
+    void abandon(const InFlight& f) {
+      ib_.dropPromise(f.reqId);
+    }
+
+    int nextReqId(const std::deque<InFlight>& inFlight) {
+      constexpr int range = 999;
+      for (;;) {
+        const int id = IB::ReqId::HISTORICAL_TICKS_ID + 1 + (reqSeq_++ % range);
+        if (std::none_of(inFlight.begin(), inFlight.end(), [id](const InFlight& f) { return f.reqId == id; }))
+          return id;
+      }
+    }
+
+    IBHistoricalWrapper& ib_;
+    IB::Storage::TickArchiveWriter& archive_;
+    TickBackfillOptions options_;
+    std::atomic<bool> stopped_{false};
+    std::vector<std::filesystem::path> markers_;
+    int reqSeq_ = 0;
+  };
+
+}  // namespace IB::Requests
+
+#endif  // QUANTDREAMCPP_TICK_BACKFILL_H
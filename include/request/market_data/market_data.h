@@ -19,7 +19,7 @@ namespace IB::Requests {
       const Contract& contract,
       int reqId = IB::ReqId::MARKET_DATA_ID)
   {
-    return IB::Helpers::measure([&]() {
+    return IB::Helpers::measure(IBW_PERF_TIMER("getSnapshot"), [&]() {
       auto& snap = ib.snapshotData[reqId];
       snap = {};  // reset clean
       snap.mode = IB::MarketData::PriceType::SNAPSHOT;
@@ -31,7 +31,7 @@ namespace IB::Requests {
       return IBBaseWrapper::getSync<MarketData::MarketSnapshot>(ib, reqId, [&]() {
         ib.client->reqMktData(reqId, contract, "", false, false, nullptr);
       });
-    }, "getSnapshot");
+    });
   }
 
   /**
@@ -71,7 +71,7 @@ namespace IB::Requests {
       const Contract& contract,
       int reqId = IB::ReqId::MARKET_DATA_ID)
   {
-    return IB::Helpers::measure([&]() {
+    return IB::Helpers::measure(IBW_PERF_TIMER("getGreeksOnly"), [&]() {
       auto& snap = ib.snapshotData[reqId];
       snap = {};  // reset
       snap.mode = IB::MarketData::PriceType::GREEKS_ONLY;
@@ -83,7 +83,7 @@ namespace IB::Requests {
       return IBBaseWrapper::getSync<MarketData::MarketSnapshot>(ib, reqId, [&]() {
         ib.client->reqMktData(reqId, contract, "", false, false, nullptr);
       });
-    }, "getGreeksOnly");
+    });
   }
 
   /**
@@ -94,7 +94,7 @@ namespace IB::Requests {
       const Contract& contract,
       int reqId = IB::ReqId::MARKET_DATA_ID)
   {
-    return IB::Helpers::measure([&]() {
+    return IB::Helpers::measure(IBW_PERF_TIMER("getLast"), [&]() {
       auto& snap = ib.snapshotData[reqId];
       snap = {};
       snap.mode = IB::MarketData::PriceType::LAST;
@@ -107,7 +107,7 @@ namespace IB::Requests {
         ib.client->reqMktData(reqId, contract, "", false, false, nullptr);
       });
       return result.last;
-    }, "getLast");
+    });
   }
 
   /**
@@ -118,7 +118,7 @@ namespace IB::Requests {
       const Contract& contract,
       int reqId = IB::ReqId::MARKET_DATA_ID)
   {
-    return IB::Helpers::measure([&]() {
+    return IB::Helpers::measure(IBW_PERF_TIMER("getBid"), [&]() {
       auto& snap = ib.snapshotData[reqId];
       snap = {};
       snap.mode = IB::MarketData::PriceType::BID;
@@ -131,7 +131,7 @@ namespace IB::Requests {
         ib.client->reqMktData(reqId, contract, "", false, false, nullptr);
       });
       return result.bid;
-    }, "getBid");
+    });
   }
 
   /**
@@ -142,7 +142,7 @@ namespace IB::Requests {
       const Contract& contract,
       int reqId = IB::ReqId::MARKET_DATA_ID)
   {
-    return IB::Helpers::measure([&]() {
+    return IB::Helpers::measure(IBW_PERF_TIMER("getAsk"), [&]() {
       auto& snap = ib.snapshotData[reqId];
       snap = {};
       snap.mode = IB::MarketData::PriceType::ASK;
@@ -155,7 +155,7 @@ namespace IB::Requests {
         ib.client->reqMktData(reqId, contract, "", false, false, nullptr);
       });
       return result.ask;
-    }, "getAsk");
+    });
   }
 
   /**
@@ -166,7 +166,7 @@ namespace IB::Requests {
       const Contract& contract,
       int reqId = IB::ReqId::MARKET_DATA_ID)
   {
-    return IB::Helpers::measure([&]() {
+    return IB::Helpers::measure(IBW_PERF_TIMER("getMid"), [&]() {
       auto snap = IB::Requests::getQuotes(ib, contract, true, reqId);  // uses QUOTES_ONLY mode internally
       ib.client->cancelMktData(reqId);
       if (snap.bid <= 0.0 && snap.ask <= 0.0)
@@ -174,7 +174,7 @@ namespace IB::Requests {
       if (snap.bid > 0.0 && snap.ask > 0.0)
         return (snap.bid + snap.ask) / 2.0;
       return (snap.bid > 0.0 ? snap.bid : snap.ask);
-    }, "getMid");
+    });
   }
 
 }  // namespace IB::Requests
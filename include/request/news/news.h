@@ -0,0 +1,83 @@
+#ifndef QUANTDREAMCPP_NEWS_H
+#define QUANTDREAMCPP_NEWS_H
+
+#include <string>
+#include <vector>
+
+#include "IBRequestIds.h"
+#include "helpers/logger.h"
+#include "wrappers/IBNewsWrapper.h"
+
+/**
+ * @file news.h
+ * @brief News requests: streaming headline feeds and historical headlines
+ *
+ * Headlines from both paths are routed through `IBNewsWrapper::news`, so strategies
+ * only register watch-lists and never deal with the individual feeds.
+ */
+
+namespace IB::Requests {
+
+  /**
+   * @brief Subscribes to all headlines of a news provider
+   *
+   * Uses the provider's broad-tape contract (e.g. "BRFG:BRFG_ALL") with generic tick 292.
+   *
+   * Example usage:
+   * @code
+   * IB::Requests::subscribeNewsFeed(ib, "BRFG");
+   * IB::Requests::subscribeNewsFeed(ib, "DJNL", IB::ReqId::NEWS_ID + 1);
+   * @endcode
+   */
+  template <typename T>
+  requires std::is_base_of_v<IBNewsWrapper, T>
+  inline void subscribeNewsFeed(T& ib, const std::string& provider, int reqId = IB::ReqId::NEWS_ID) {
+    Contract contract;
+    contract.symbol = provider + ":" + provider + "_ALL";
+    contract.secType = "NEWS";
+    contract.exchange = provider;
+    ib.client->reqMktData(reqId, contract, "mdoff,292", false, false, TagValueListSPtr());
+    LOG_INFO("[IB] News feed ", provider, " subscribed (reqId=", reqId, ")");
+  }
+
+  /**
+   * @brief Subscribes to headlines about one contract from the given providers
+   *
+   * @param providers Provider codes joined by '+' (e.g. "BRFG+DJNL")
+   */
+  template <typename T>
+  requires std::is_base_of_v<IBNewsWrapper, T>
+  inline void subscribeContractNews(T& ib, const Contract& contract, const std::string& providers,
+                                    int reqId) {
+    ib.client->reqMktData(reqId, contract, "mdoff,292:" + providers, false, false, TagValueListSPtr());
+    LOG_INFO("[IB] Contract news for ", contract.symbol, " subscribed (reqId=", reqId, ")");
+  }
+
+  /// Stops a news feed started with subscribeNewsFeed / subscribeContractNews
+  template <typename T>
+  requires std::is_base_of_v<IBNewsWrapper, T>
+  inline void cancelNewsFeed(T& ib, int reqId) {
+    ib.client->cancelMktData(reqId);
+  }
+
+  /**
+   * @brief Retrieves historical headlines for a contract
+   *
+   * @param conId Contract ID
+   * @param providers Provider codes joined by '+'
+   * @param start,end "yyyy-MM-dd HH:mm:ss.0" bounds (empty for open-ended)
+   * @param count Maximum number of headlines (IB caps at 300)
+   */
+  template <typename T>
+  requires std::is_base_of_v<IBNewsWrapper, T>
+  inline std::vector<NewsItem> getHistoricalNews(T& ib, int conId, const std::string& providers,
+                                                 const std::string& start, const std::string& end,
+                                                 int count = 100, int reqId = IB::ReqId::NEWS_ID + 500) {
+    return IBBaseWrapper::getSync<std::vector<NewsItem>>(ib, reqId, [&]() {
+      ib.client->reqHistoricalNews(reqId, conId, providers, start, end, count, TagValueListSPtr());
+    });
+  }
+
+}  // namespace IB::Requests
+
+#endif  // QUANTDREAMCPP_NEWS_H
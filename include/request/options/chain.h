@@ -97,7 +97,7 @@ namespace IB::Request {
       double strikeRangePct = 0.25,
       const std::string& preferredExchange = "") {
     // Run perf timer
-    return IB::Helpers::measure([&]() -> IB::Options::ChainInfo {
+    return IB::Helpers::measure(IBW_PERF_TIMER("GetOptionChain"), [&]() -> IB::Options::ChainInfo {
       LOG_SECTION("Chain Request");
 
       // --- Step 1: Resolve the underlying contract (ensure conId is valid) ---
@@ -169,7 +169,7 @@ namespace IB::Request {
       LOG_DEBUG("[IB] Defaulting to first available chain: ", allChains.front().exchange);
       return allChains.front();
 
-    }, "GetOptionChain"); // Label for perf timer
+    });
   }
 
 }  // namespace IB::Request
@@ -2,6 +2,7 @@
 #define QUANTDREAMCPP_GREEKS_H
 
 #include <cmath>  // for std::isnan, std::isinf
+#include <unordered_set>
 
 #include "IBRequestIds.h"
 #include "contracts/OptionContract.h"
@@ -43,6 +44,8 @@ namespace IB::Requests {
  * - Registers onOptionGreeks callback to capture incoming Greeks data
  * - Validates received data (IB sends DBL_MAX for unavailable values)
  * - Automatically cancels each market data subscription after Greeks are received
+ * - Keeps only the first valid result per request; ticks arriving before the cancel is
+ *   processed are ignored
  * - Uses atomic counter to track remaining responses
  * - Fulfills promise when all expected responses are received
  *
@@ -113,12 +116,14 @@ inline std::vector<IB::Options::Greeks> getGreeksTable(
     int delayMsBetweenBatches = 1200  // ms delay between batches
 ) {
   using namespace std::chrono_literals;
+  IBW_TRACE_SCOPE("getGreeksTable", underlying.symbol);
 
   // --- Create a promise to fulfill when all Greeks are received ---
   auto future = ib.createPromise<std::vector<IB::Options::Greeks>>(baseReqId);
 
   std::mutex mtx;
   std::vector<IB::Options::Greeks> results;
+  std::unordered_set<TickerId> answered;   // reqIds whose Greeks are already in results
   std::atomic<int> remaining =
       static_cast<int>(chain.expirations.size() * chain.strikes.size());
 
@@ -138,6 +143,9 @@ inline std::vector<IB::Options::Greeks> getGreeksTable(
 
     {
       std::lock_guard<std::mutex> lock(mtx);
+      // Ticks keep arriving until the cancel takes effect; only the first one counts
+      if (!answered.insert(id).second) return;
+      IB::Helpers::TraceEvents::asyncEnd("option greeks", static_cast<uint64_t>(id));
       results.push_back(g);
       ib.client->cancelMktData(id);  // ✅ stop streaming this option
       LOG_DEBUG("[IB] Received valid Greeks, canceled reqId=", id,
@@ -180,6 +188,7 @@ inline std::vector<IB::Options::Greeks> getGreeksTable(
       opt.localSymbol = details.localSymbol;
       opt.tradingClass = details.tradingClass;
 
+      IB::Helpers::TraceEvents::asyncBegin("option greeks", static_cast<uint64_t>(reqId), opt.localSymbol);
       ib.client->reqMktData(reqId++, opt, "106", false, false, nullptr);
       ++count;
 
@@ -187,6 +196,7 @@ inline std::vector<IB::Options::Greeks> getGreeksTable(
       if (count % batchSize == 0) {
         LOG_DEBUG("[IB] Sent ", count, " requests — throttling for ",
                   delayMsBetweenBatches, " ms");
+        IBW_TRACE_SCOPE("greeks throttle");
         std::this_thread::sleep_for(
             std::chrono::milliseconds(delayMsBetweenBatches));
       }
@@ -0,0 +1,93 @@
+#ifndef QUANTDREAMCPP_SCANNER_H
+#define QUANTDREAMCPP_SCANNER_H
+
+#include <string>
+#include <vector>
+
+#include "IBRequestIds.h"
+#include "ScannerSubscription.h"
+#include "helpers/logger.h"
+#include "wrappers/IBScannerWrapper.h"
+
+/**
+ * @file scanner.h
+ * @brief Market scanner requests: one-shot scans and universe-feeding subscriptions
+ *
+ * A one-shot scan returns the ranked rows of the first result set. A universe
+ * subscription keeps running; every result set TWS pushes is diffed into
+ * `IBScannerWrapper::universe`, which subscribes and unsubscribes market data
+ * incrementally.
+ */
+
+namespace IB::Requests {
+
+  /**
+   * @brief Runs a scanner once and returns its ranked rows
+   *
+   * Example usage:
+   * @code
+   * ScannerSubscription sub;
+   * sub.instrument = "STK";
+   * sub.locationCode = "STK.US.MAJOR";
+   * sub.scanCode = "TOP_PERC_GAIN";
+   * sub.numberOfRows = 25;
+   *
+   * auto rows = IB::Requests::scanOnce(ib, sub);
+   * @endcode
+   */
+  template <typename T>
+  requires std::is_base_of_v<IBScannerWrapper, T>
+  inline std::vector<ScanRow> scanOnce(T& ib, const ScannerSubscription& subscription,
+                                       int reqId = IB::ReqId::SCANNER_ID + 1) {
+    auto rows = IBBaseWrapper::getSync<std::vector<ScanRow>>(ib, reqId, [&]() {
+      ib.client->reqScannerSubscription(reqId, subscription, TagValueListSPtr(), TagValueListSPtr());
+    });
+    ib.client->cancelScannerSubscription(reqId);
+    LOG_DEBUG("[IB] Scanner ", subscription.scanCode, " returned ", rows.size(), " rows");
+    return rows;
+  }
+
+  /**
+   * @brief Starts a live scanner subscription whose results drive the universe
+   *
+   * Returns immediately; the universe is updated from the IB reader thread on each
+   * `scannerDataEnd`. Use distinct `reqId`s for concurrent scans.
+   *
+   * @param filterOptions Optional scanner filter tags (e.g. "priceAbove", "marketCapAbove1e6")
+   */
+  template <typename T>
+  requires std::is_base_of_v<IBScannerWrapper, T>
+  inline void subscribeUniverseScanner(T& ib, const ScannerSubscription& subscription,
+                                       int reqId = IB::ReqId::SCANNER_ID + 100,
+                                       const TagValueListSPtr& filterOptions = TagValueListSPtr()) {
+    ib.routeScanToUniverse(reqId, true);
+    ib.client->reqScannerSubscription(reqId, subscription, TagValueListSPtr(), filterOptions);
+    LOG_INFO("[IB] Universe scanner ", subscription.scanCode, " started (reqId=", reqId, ")");
+  }
+
+  /**
+   * @brief Stops a universe scanner and releases the names only it was holding
+   */
+  template <typename T>
+  requires std::is_base_of_v<IBScannerWrapper, T>
+  inline void cancelUniverseScanner(T& ib, int reqId) {
+    ib.client->cancelScannerSubscription(reqId);
+    ib.routeScanToUniverse(reqId, false);
+    ib.universe.removeScan(reqId);
+    LOG_INFO("[IB] Universe scanner stopped (reqId=", reqId, ")");
+  }
+
+  /**
+   * @brief Retrieves the XML document describing all scanner codes, instruments and filters
+   */
+  template <typename T>
+  requires std::is_base_of_v<IBScannerWrapper, T>
+  inline std::string getScannerParameters(T& ib) {
+    return IBBaseWrapper::getSync<std::string>(ib, IB::ReqId::SCANNER_ID, [&]() {
+      ib.client->reqScannerParameters();
+    });
+  }
+
+}  // namespace IB::Requests
+
+#endif  // QUANTDREAMCPP_SCANNER_H
@@ -0,0 +1,700 @@
+#ifndef QUANTDREAMCPP_SIMULATED_BROKER_H
+#define QUANTDREAMCPP_SIMULATED_BROKER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "EWrapper.h"
+#include "Execution.h"
+#include "Order.h"
+#include "OrderState.h"
+#include "helpers/clock.h"
+#include "helpers/logger.h"
+#include "orders/order_gateway.h"
+
+/**
+ * @file simulated_broker.h
+ * @brief In-process broker that matches orders against the live (or replayed) quote stream
+ *
+ * Attached to a wrapper as its `orderGateway`, the broker receives every order the
+ * wrapper would send to TWS and answers through the wrapper's own EWrapper callbacks
+ * (`orderStatus`, `openOrder`, `execDetails`, `position`, `error`), so order paths run
+ * unchanged without an IB account. The wrapper forwards its market data ticks to the
+ * broker, which keeps a top-of-book per conId and matches on it:
+ *
+ * - **Taking**: MKT orders and LMT orders marketable on arrival fill at the opposite
+ *   touch, at most its displayed size per quote update (`respectDisplayedSize`); the
+ *   rest keeps working and fills as size is re-displayed.
+ * - **Resting**: a LMT order at the touch joins the queue behind the displayed size and
+ *   fills only from trades at its price once the queue ahead is consumed (`QueueModel`).
+ *   A trade through the limit, or the opposite touch reaching it, fills it at the limit.
+ * - **Combos** (BAG): fill in full at the legs' natural price once it reaches the
+ *   limit, with one execution and position update per leg.
+ *
+ * **Latency**: orders reach the simulated exchange `orderLatencyNs` after `placeOrder`,
+ * cancels after `cancelLatencyNs`, and every report reaches the wrapper
+ * `reportLatencyNs` after the event (each plus up to `jitterNs`, seeded). Reports keep
+ * their order. Time is `IB::Helpers::steadyNowNs()`, so under a backtest's virtual
+ * clock latencies are in recorded time and results are reproducible.
+ *
+ * Events become due as time passes; they are processed on every tick the wrapper
+ * forwards, on every broker call and on `advance()`. Live, `pumpInterval` starts a
+ * thread that calls `advance()` so reports arrive without further ticks.
+ *
+ * Callbacks run on the thread that makes them due, outside the broker's lock, so they
+ * may place or cancel orders; those reports are delivered after the current ones.
+ *
+ * Example usage:
+ * @code
+ * IBStrategyWrapper ib;
+ * IB::Sim::SimulatedBroker broker(ib, {.orderLatencyNs = 5'000'000, .reportLatencyNs = 1'000'000});
+ * ib.orderGateway = &broker;
+ * ib.initializing = false;          // no connect() handshake
+ * ib.nextValidOrderId = 1;
+ *
+ * // ticks reaching ib.tickPrice / ib.tickSize now drive the matching
+ * IB::Orders::Simple::placeSimpleOrder(ib, contract, "BUY", 100, 150.10);
+ * @endcode
+ */
+
+namespace IB::Sim {
+
+  /// How resting orders advance through the displayed size at their price
+  enum class QueueModel {
+    NONE,           ///< Front of the queue: any trade at the limit fills
+    CONSERVATIVE,   ///< Behind everything displayed at arrival; only trades at the price advance the queue
+    PROPORTIONAL,   ///< As CONSERVATIVE, and displayed size leaving the level shrinks the queue ahead pro rata
+  };
+
+  struct SimulatedBrokerOptions {
+    int64_t orderLatencyNs = 0;                  ///< placeOrder → arrival at the simulated exchange
+    int64_t cancelLatencyNs = 0;                 ///< cancelOrder → cancel effective
+    int64_t reportLatencyNs = 0;                 ///< Exchange event → callback
+    int64_t jitterNs = 0;                        ///< Uniform [0, jitterNs] added to each latency
+    uint64_t seed = 1;                           ///< Jitter RNG seed
+    QueueModel queueModel = QueueModel::PROPORTIONAL;
+    bool respectDisplayedSize = true;            ///< Takers get at most the displayed size per quote update
+    std::string account = "DU0000000";
+    int clientId = 0;
+    std::chrono::milliseconds pumpInterval{0};   ///< > 0: background thread calling advance() (live use)
+  };
+
+  /**
+   * @brief OrderGateway with a top-of-book matching engine
+   *
+   * Thread-safe. The EWrapper must outlive the broker.
+   */
+  class SimulatedBroker : public IB::Orders::OrderGateway {
+  public:
+    using Options = SimulatedBrokerOptions;
+
+    struct Stats {
+      uint64_t orders = 0;          ///< Accepted by placeOrder
+      uint64_t executions = 0;      ///< Fills (per leg for combos)
+      uint64_t cancels = 0;
+      uint64_t rejects = 0;
+    };
+
+    explicit SimulatedBroker(EWrapper& wrapper) : SimulatedBroker(wrapper, Options{}) {}
+
+    SimulatedBroker(EWrapper& wrapper, Options options)
+        : wrapper_(wrapper), options_(std::move(options)), rng_(options_.seed) {
+      if (options_.pumpInterval.count() > 0) pump_ = std::thread([this] { pumpLoop(); });
+    }
+
+    ~SimulatedBroker() override {
+      if (pump_.joinable()) {
+        {
+          std::lock_guard lk(pumpMutex_);
+          stopping_ = true;
+        }
+        pumpCv_.notify_all();
+        pump_.join();
+      }
+    }
+
+    SimulatedBroker(const SimulatedBroker&) = delete;
+    SimulatedBroker& operator=(const SimulatedBroker&) = delete;
+
+    // ------------------------------------------------------------------
+    // OrderGateway
+    // ------------------------------------------------------------------
+
+    void placeOrder(OrderId orderId, const Contract& contract, const Order& order) override {
+      {
+        std::lock_guard lk(mutex_);
+        const int64_t now = IB::Helpers::steadyNowNs();
+        if (std::string why = validate(orderId, contract, order); !why.empty()) {
+          reject(orderId, why, now);
+        } else if (auto it = orders_.find(orderId); it != orders_.end()) {
+          modify(it->second, order, now);
+        } else {
+          accept(orderId, contract, order, now);
+        }
+        process(now);
+      }
+      deliver();
+    }
+
+    void cancelOrder(OrderId orderId, const OrderCancel&) override {
+      {
+        std::lock_guard lk(mutex_);
+        const int64_t now = IB::Helpers::steadyNowNs();
+        auto it = orders_.find(orderId);
+        if (it == orders_.end()) {
+          report(now, [orderId](EWrapper& w) {
+            w.error(orderId, IB::Helpers::wallNowNs() / 1'000'000, 10147,
+                    "OrderId " + std::to_string(orderId) + " that needs to be cancelled is not found.", "");
+          });
+        } else if (it->second.cancelAtNs < 0) {
+          it->second.cancelAtNs = now + latency(options_.cancelLatencyNs);
+        }
+        process(now);
+      }
+      deliver();
+    }
+
+    void reqGlobalCancel(const OrderCancel&) override {
+      {
+        std::lock_guard lk(mutex_);
+        const int64_t now = IB::Helpers::steadyNowNs();
+        const int64_t at = now + latency(options_.cancelLatencyNs);
+        for (auto& [id, o] : orders_)
+          if (o.cancelAtNs < 0) o.cancelAtNs = at;
+        process(now);
+      }
+      deliver();
+    }
+
+    void reqOpenOrders() override {
+      std::vector<Report> answer;
+      {
+        std::lock_guard lk(mutex_);
+        process(IB::Helpers::steadyNowNs());
+        for (const auto& [id, o] : orders_) {
+          OrderState state;
+          state.status = o.working ? "Submitted" : "PreSubmitted";
+          answer.push_back([id = id, c = o.contract, ord = o.order, state](EWrapper& w) {
+            w.openOrder(id, c, ord, state);
+          });
+        }
+        answer.push_back([](EWrapper& w) { w.openOrderEnd(); });
+      }
+      deliver();
+      deliverNow(answer);
+    }
+
+    void reqPositions() override {
+      std::vector<Report> answer;
+      {
+        std::lock_guard lk(mutex_);
+        process(IB::Helpers::steadyNowNs());
+        streamPositions_ = true;
+        for (const auto& [conId, p] : positions_) {
+          answer.push_back([account = options_.account, p = p](EWrapper& w) {
+            w.position(account, p.contract, DecimalFunctions::doubleToDecimal(p.quantity), p.avgCost);
+          });
+        }
+        answer.push_back([](EWrapper& w) { w.positionEnd(); });
+      }
+      deliver();
+      deliverNow(answer);
+    }
+
+    /**
+     * @brief Applies a tick of `contract` and matches the orders it affects
+     *
+     * Fed by the wrapper's tickPrice / tickSize; may also be called directly.
+     */
+    void onMarketData(const Contract& contract, int field, double price, double size) override {
+      if (contract.conId == 0) return;
+      {
+        std::lock_guard lk(mutex_);
+        const int64_t now = IB::Helpers::steadyNowNs();
+        Market& m = markets_[contract.conId];
+        if (m.contract.conId == 0) m.contract = contract;
+        double tradePrice = 0.0, tradeSize = 0.0;
+        switch (field) {
+          case BID: case DELAYED_BID:
+            if (price != m.bid) m.bidTaken = 0.0;
+            m.bid = price;
+            break;
+          case ASK: case DELAYED_ASK:
+            if (price != m.ask) m.askTaken = 0.0;
+            m.ask = price;
+            break;
+          case BID_SIZE: case DELAYED_BID_SIZE:
+            levelChanged(contract.conId, 1, m.bid, m.bidSize, size, m.bidTraded);
+            m.bidSize = size;
+            m.bidTaken = m.bidTraded = 0.0;
+            break;
+          case ASK_SIZE: case DELAYED_ASK_SIZE:
+            levelChanged(contract.conId, -1, m.ask, m.askSize, size, m.askTraded);
+            m.askSize = size;
+            m.askTaken = m.askTraded = 0.0;
+            break;
+          case LAST: case DELAYED_LAST:
+            m.last = price;
+            break;
+          case LAST_SIZE: case DELAYED_LAST_SIZE:
+            tradePrice = m.last;
+            tradeSize = size;
+            if (tradePrice == m.bid) m.bidTraded += size;
+            else if (tradePrice == m.ask) m.askTraded += size;
+            break;
+          default:
+            return;
+        }
+        arrive(now);
+        matchInstrument(contract.conId, tradePrice, tradeSize, now);
+        process(now);
+      }
+      deliver();
+    }
+
+    /// Processes arrivals, cancels and reports due by now
+    void advance() {
+      {
+        std::lock_guard lk(mutex_);
+        process(IB::Helpers::steadyNowNs());
+      }
+      deliver();
+    }
+
+    /**
+     * @brief Makes a contract known before it is quoted
+     *
+     * Combo legs and position reports carry the registered contract; unregistered legs
+     * are reported with their conId only.
+     */
+    void addContract(const Contract& contract) {
+      std::lock_guard lk(mutex_);
+      if (contract.conId) markets_[contract.conId].contract = contract;
+    }
+
+    /// Simulated position in `conId` (0 if flat or unknown)
+    double position(long conId) const {
+      std::lock_guard lk(mutex_);
+      auto it = positions_.find(conId);
+      return it == positions_.end() ? 0.0 : it->second.quantity;
+    }
+
+    /// Orders not yet filled or cancelled
+    size_t openOrders() const {
+      std::lock_guard lk(mutex_);
+      return orders_.size();
+    }
+
+    Stats stats() const {
+      std::lock_guard lk(mutex_);
+      return stats_;
+    }
+
+  private:
+    using Report = std::function<void(EWrapper&)>;
+
+    struct Market {
+      Contract contract;
+      double bid = 0.0, ask = 0.0, last = 0.0;
+      double bidSize = 0.0, askSize = 0.0;
+      double bidTaken = 0.0, askTaken = 0.0;     ///< Displayed size already taken by simulated orders
+      double bidTraded = 0.0, askTraded = 0.0;   ///< Printed at the touch since its last size update
+    };
+
+    struct SimOrder {
+      OrderId id = 0;
+      Contract contract;
+      Order order;
+      long long permId = 0;
+      int side = 0;                 ///< +1 buy, -1 sell
+      double quantity = 0.0;
+      double filled = 0.0;
+      double avgPrice = 0.0;
+      double lastFillPrice = 0.0;
+      bool market = false;
+      double limit = 0.0;
+      int64_t arrivalNs = 0;
+      int64_t cancelAtNs = -1;
+      bool working = false;         ///< Arrived at the simulated exchange
+      bool resting = false;         ///< Worked past its arrival without completing
+      double queueAhead = -1.0;     ///< Displayed size ahead at the limit; -1 while the limit is not the touch
+
+      double remaining() const noexcept { return quantity - filled; }
+      bool combo() const noexcept { return contract.secType == "BAG"; }
+    };
+
+    struct Position {
+      Contract contract;
+      double quantity = 0.0;
+      double avgCost = 0.0;         ///< Per unit, including the multiplier (as TWS reports it)
+    };
+
+    struct Due {
+      int64_t dueNs = 0;
+      Report report;
+    };
+
+    // ------------------------------------------------------------------
+    // Order lifecycle (mutex_ held)
+    // ------------------------------------------------------------------
+
+    std::string validate(OrderId orderId, const Contract& contract, const Order& order) const {
+      if (orderId <= 0) return "invalid order ID";
+      if (order.action != "BUY" && order.action != "SELL" && order.action != "SSHORT") return "invalid action " + order.action;
+      if (DecimalFunctions::decimalToDouble(order.totalQuantity) <= 0.0) return "quantity must be positive";
+      if (order.orderType != "MKT" && order.orderType != "LMT") return "unsupported order type " + order.orderType;
+      if (order.orderType == "LMT" && order.lmtPrice == UNSET_DOUBLE) return "limit price missing";
+      if (contract.secType == "BAG") {
+        if (!contract.comboLegs || contract.comboLegs->empty()) return "combo without legs";
+        for (const auto& leg : *contract.comboLegs)
+          if (!leg || leg->conId == 0 || leg->ratio <= 0) return "invalid combo leg";
+      } else if (contract.conId == 0) {
+        return "contract has no conId";
+      }
+      return {};
+    }
+
+    void accept(OrderId orderId, const Contract& contract, const Order& order, int64_t now) {
+      SimOrder o;
+      o.id = orderId;
+      o.contract = contract;
+      o.order = order;
+      o.order.orderId = orderId;
+      o.permId = o.order.permId = nextPermId_++;
+      o.order.account = options_.account;
+      o.side = order.action == "BUY" ? 1 : -1;
+      o.quantity = DecimalFunctions::decimalToDouble(order.totalQuantity);
+      o.market = order.orderType == "MKT";
+      o.limit = order.lmtPrice;
+      o.arrivalNs = now + latency(options_.orderLatencyNs);
+      ++stats_.orders;
+      reportState(o, "PreSubmitted", now);
+      orders_.emplace(orderId, std::move(o));
+    }
+
+    /// placeOrder on a working ID: new quantity / limit, losing queue position on a price change
+    void modify(SimOrder& o, const Order& order, int64_t now) {
+      const double quantity = DecimalFunctions::decimalToDouble(order.totalQuantity);
+      if (quantity < o.filled || (order.action == "BUY" ? 1 : -1) != o.side || order.orderType != o.order.orderType) {
+        reject(o.id, "modification changes side, type or cuts below the filled quantity", now, false);
+        return;
+      }
+      if (order.lmtPrice != o.limit) o.queueAhead = -1.0;
+      o.quantity = quantity;
+      o.limit = order.lmtPrice;
+      o.order.totalQuantity = order.totalQuantity;
+      o.order.lmtPrice = order.lmtPrice;
+      reportState(o, o.working ? "Submitted" : "PreSubmitted", now);
+    }
+
+    void reject(OrderId orderId, const std::string& why, int64_t now, bool count = true) {
+      if (count) ++stats_.rejects;
+      LOG_WARN("[SimulatedBroker] Order ", orderId, " rejected: ", why);
+      report(now, [orderId, why](EWrapper& w) {
+        w.error(orderId, IB::Helpers::wallNowNs() / 1'000'000, 201, "Order rejected - reason:" + why, "");
+      });
+    }
+
+    /// Due arrivals, cancels and reports
+    void process(int64_t now) {
+      arrive(now);
+      for (auto it = orders_.begin(); it != orders_.end();) {
+        SimOrder& o = it->second;
+        if (o.cancelAtNs >= 0 && o.cancelAtNs <= now) {
+          ++stats_.cancels;
+          reportState(o, "Cancelled", now);
+          it = orders_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+      while (!pending_.empty() && pending_.front().dueNs <= now) {
+        ready_.push_back(std::move(pending_.front().report));
+        pending_.pop_front();
+      }
+    }
+
+    /// Orders reaching the exchange by now: acknowledged, then matched against the book as it is
+    void arrive(int64_t now) {
+      for (auto& [id, o] : orders_) {
+        if (o.working || o.arrivalNs > now || (o.cancelAtNs >= 0 && o.cancelAtNs <= o.arrivalNs)) continue;
+        o.working = true;
+        reportState(o, "Submitted", now);
+        if (o.combo()) matchCombo(o, now);
+        else if (auto m = markets_.find(o.contract.conId); m != markets_.end()) matchOrder(o, m->second, 0.0, 0.0, now);
+        o.resting = true;
+      }
+      std::erase_if(orders_, [](const auto& entry) { return entry.second.remaining() <= 0.0; });
+    }
+
+    // ------------------------------------------------------------------
+    // Matching (mutex_ held)
+    // ------------------------------------------------------------------
+
+    /**
+     * @brief Displayed size at a level changed from `before` to `after`
+     *
+     * Size that left through prints already advanced the queue in matchOrder; the rest of
+     * the decrease is cancellations, which PROPORTIONAL assumes are spread evenly over
+     * the queue ahead of and behind the order.
+     */
+    void levelChanged(long conId, int side, double price, double before, double after, double traded) {
+      const double resting = before - traded;
+      const double cancelled = resting - after;
+      if (after >= before) return;   // new size joins behind the simulated orders
+      for (auto& [id, o] : orders_) {
+        if (!o.working || o.side != side || o.market || o.queueAhead <= 0.0 || o.limit != price ||
+            o.contract.conId != conId)
+          continue;
+        switch (options_.queueModel) {
+          case QueueModel::NONE: o.queueAhead = 0.0; break;
+          case QueueModel::CONSERVATIVE: o.queueAhead = std::min(o.queueAhead, after); break;
+          case QueueModel::PROPORTIONAL:
+            if (cancelled > 0.0 && resting > 0.0) o.queueAhead -= cancelled * std::min(1.0, o.queueAhead / resting);
+            o.queueAhead = std::clamp(o.queueAhead, 0.0, after);
+            break;
+        }
+      }
+    }
+
+    void matchInstrument(long conId, double tradePrice, double tradeSize, int64_t now) {
+      for (auto& [id, o] : orders_) {
+        if (!o.working) continue;
+        if (o.combo()) {
+          for (const auto& leg : *o.contract.comboLegs)
+            if (leg->conId == conId) {
+              matchCombo(o, now);
+              break;
+            }
+        } else if (o.contract.conId == conId) {
+          matchOrder(o, markets_[conId], tradePrice, tradeSize, now);
+        }
+      }
+      std::erase_if(orders_, [](const auto& entry) { return entry.second.remaining() <= 0.0; });
+    }
+
+    void matchOrder(SimOrder& o, Market& m, double tradePrice, double tradeSize, int64_t now) {
+      const double opposite = o.side > 0 ? m.ask : m.bid;
+      const double oppositeSize = o.side > 0 ? m.askSize : m.bidSize;
+      double& taken = o.side > 0 ? m.askTaken : m.bidTaken;
+      const bool crosses = opposite > 0.0 && (o.market || (o.side > 0 ? opposite <= o.limit : opposite >= o.limit));
+
+      if (crosses) {
+        // Taking on arrival pays the touch; a resting limit the touch moved onto trades at its own price
+        double available = o.remaining();
+        if (options_.respectDisplayedSize && oppositeSize > 0.0) available = std::min(available, oppositeSize - taken);
+        if (available <= 0.0) return;
+        taken += available;
+        execute(o, available, o.market || !o.resting ? opposite : o.limit, now);
+        return;
+      }
+      if (o.market) return;
+
+      // Queue position at the limit
+      const double same = o.side > 0 ? m.bid : m.ask;
+      const double sameSize = o.side > 0 ? m.bidSize : m.askSize;
+      const bool improves = same <= 0.0 || (o.side > 0 ? o.limit > same : o.limit < same);
+      if (improves) o.queueAhead = 0.0;
+      else if (o.limit != same) o.queueAhead = -1.0;   // behind the touch: re-queues when the price returns
+      else if (o.queueAhead < 0.0) o.queueAhead = options_.queueModel == QueueModel::NONE ? 0.0 : sameSize;
+
+      if (tradeSize <= 0.0 || tradePrice <= 0.0) return;
+      if (o.side > 0 ? tradePrice < o.limit : tradePrice > o.limit) {
+        execute(o, o.remaining(), o.limit, now);   // traded through
+        return;
+      }
+      if (tradePrice != o.limit) return;
+      if (o.queueAhead < 0.0) o.queueAhead = options_.queueModel == QueueModel::NONE ? 0.0 : sameSize;
+      const double reach = tradeSize - o.queueAhead;
+      o.queueAhead = std::max(0.0, o.queueAhead - tradeSize);
+      if (reach > 0.0) execute(o, std::min(o.remaining(), reach), o.limit, now);
+    }
+
+    /// Fills a combo in full at its natural price once that reaches the limit
+    void matchCombo(SimOrder& o, int64_t now) {
+      double natural = 0.0;
+      for (const auto& leg : *o.contract.comboLegs) {
+        auto m = markets_.find(leg->conId);
+        if (m == markets_.end() || m->second.bid <= 0.0 || m->second.ask <= 0.0) return;
+        const int legSide = o.side * (leg->action == "SELL" ? -1 : 1);
+        natural += leg->ratio * (legSide > 0 ? m->second.ask : -m->second.bid) * o.side;
+      }
+      if (!o.market && (o.side > 0 ? natural > o.limit : natural < o.limit)) return;
+
+      const double quantity = o.remaining();
+      for (const auto& leg : *o.contract.comboLegs) {
+        const Market& m = markets_[leg->conId];
+        const int legSide = o.side * (leg->action == "SELL" ? -1 : 1);
+        Contract legContract = m.contract;
+        legContract.conId = leg->conId;
+        const double price = legSide > 0 ? m.ask : m.bid;
+        recordExecution(o, legContract, legSide, quantity * leg->ratio, price, (o.filled + quantity) * leg->ratio, price,
+                        now);
+      }
+      fill(o, quantity, natural, now);
+    }
+
+    void execute(SimOrder& o, double quantity, double price, int64_t now) {
+      const double cumQty = o.filled + quantity;
+      recordExecution(o, o.contract, o.side, quantity, price, cumQty, (o.avgPrice * o.filled + price * quantity) / cumQty,
+                      now);
+      fill(o, quantity, price, now);
+    }
+
+    /// Order-level fill bookkeeping and status
+    void fill(SimOrder& o, double quantity, double price, int64_t now) {
+      o.avgPrice = (o.avgPrice * o.filled + price * quantity) / (o.filled + quantity);
+      o.filled += quantity;
+      o.lastFillPrice = price;
+      reportState(o, o.remaining() <= 0.0 ? "Filled" : "Submitted", now);
+    }
+
+    /// One execution: execDetails plus the position change
+    void recordExecution(const SimOrder& o, const Contract& contract, int side, double quantity, double price,
+                         double cumQty, double avgPrice, int64_t now) {
+      ++stats_.executions;
+      Position& p = positions_[contract.conId];
+      if (p.contract.conId == 0) {
+        auto known = markets_.find(contract.conId);
+        p.contract = known != markets_.end() && known->second.contract.conId ? known->second.contract : contract;
+      }
+      const double multiplier = p.contract.multiplier.empty() ? 1.0 : std::stod(p.contract.multiplier);
+      const double qty = side * quantity;
+      if (p.quantity == 0.0 || (p.quantity > 0) == (qty > 0))
+        p.avgCost = (p.avgCost * std::abs(p.quantity) + price * multiplier * quantity) / (std::abs(p.quantity) + quantity);
+      else if (std::abs(qty) > std::abs(p.quantity))
+        p.avgCost = price * multiplier;   // flipped through zero
+      p.quantity += qty;
+      if (p.quantity == 0.0) p.avgCost = 0.0;
+
+      Execution e;
+      e.execId = "sim." + std::to_string(++nextExecId_);
+      e.time = formatTime(IB::Helpers::wallNowNs());
+      e.acctNumber = options_.account;
+      e.exchange = contract.exchange.empty() ? "SIM" : contract.exchange;
+      e.side = side > 0 ? "BOT" : "SLD";
+      e.shares = DecimalFunctions::doubleToDecimal(quantity);
+      e.price = price;
+      e.permId = o.permId;
+      e.clientId = options_.clientId;
+      e.orderId = o.id;
+      e.cumQty = DecimalFunctions::doubleToDecimal(cumQty);
+      e.avgPrice = avgPrice;
+      report(now, [c = p.contract, e](EWrapper& w) { w.execDetails(-1, c, e); });
+      if (streamPositions_) {
+        report(now, [account = options_.account, p = p](EWrapper& w) {
+          w.position(account, p.contract, DecimalFunctions::doubleToDecimal(p.quantity), p.avgCost);
+        });
+      }
+    }
+
+    /// openOrder (while working) and orderStatus for the order's current state
+    void reportState(const SimOrder& o, const std::string& status, int64_t now) {
+      OrderState state;
+      state.status = status;
+      const bool open = status == "PreSubmitted" || status == "Submitted";
+      report(now, [o, state, status, open, clientId = options_.clientId](EWrapper& w) {
+        if (open || status == "Filled") w.openOrder(o.id, o.contract, o.order, state);
+        w.orderStatus(o.id, status, DecimalFunctions::doubleToDecimal(o.filled),
+                      DecimalFunctions::doubleToDecimal(std::max(0.0, o.remaining())), o.avgPrice, o.permId, 0,
+                      o.lastFillPrice, clientId, "", 0.0);
+      });
+    }
+
+    // ------------------------------------------------------------------
+    // Reports
+    // ------------------------------------------------------------------
+
+    int64_t latency(int64_t base) {
+      if (options_.jitterNs <= 0) return base;
+      return base + std::uniform_int_distribution<int64_t>(0, options_.jitterNs)(rng_);
+    }
+
+    /// Queues a callback `reportLatencyNs` after `now`, never ahead of earlier reports
+    void report(int64_t now, Report r) {
+      const int64_t due = std::max(now + latency(options_.reportLatencyNs), lastDueNs_);
+      lastDueNs_ = due;
+      if (due <= now) ready_.push_back(std::move(r));
+      else pending_.push_back({due, std::move(r)});
+    }
+
+    /// Runs ready reports outside the lock; one thread at a time, so reports stay ordered
+    void deliver() {
+      std::unique_lock lk(mutex_);
+      if (delivering_) return;   // the delivering thread (maybe this one, re-entered) picks them up
+      delivering_ = true;
+      while (!ready_.empty()) {
+        std::vector<Report> batch(std::make_move_iterator(ready_.begin()), std::make_move_iterator(ready_.end()));
+        ready_.clear();
+        lk.unlock();
+        for (auto& r : batch) r(wrapper_);
+        lk.lock();
+      }
+      delivering_ = false;
+    }
+
+    /// Request answers bypass the report latency
+    void deliverNow(std::vector<Report>& answer) {
+      for (auto& r : answer) r(wrapper_);
+    }
+
+    static std::string formatTime(int64_t ns) {
+      const std::time_t secs = static_cast<std::time_t>(ns / 1'000'000'000);
+      std::tm tm{};
+      gmtime_r(&secs, &tm);
+      char buf[32];
+      std::snprintf(buf, sizeof(buf), "%04d%02d%02d-%02d:%02d:%02d", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+                    tm.tm_hour, tm.tm_min, tm.tm_sec);
+      return buf;
+    }
+
+    void pumpLoop() {
+      std::unique_lock lk(pumpMutex_);
+      while (!pumpCv_.wait_for(lk, options_.pumpInterval, [this] { return stopping_; })) {
+        lk.unlock();
+        advance();
+        lk.lock();
+      }
+    }
+
+    EWrapper& wrapper_;
+    Options options_;
+    std::mt19937_64 rng_;
+
+    mutable std::mutex mutex_;
+    std::map<OrderId, SimOrder> orders_;               ///< Open orders; ID order keeps matching deterministic
+    std::unordered_map<long, Market> markets_;         ///< Top of book by conId
+    std::map<long, Position> positions_;
+    std::deque<Due> pending_;                          ///< Reports not yet due, in due order
+    std::vector<Report> ready_;                        ///< Due reports awaiting delivery
+    int64_t lastDueNs_ = 0;
+    bool delivering_ = false;
+    bool streamPositions_ = false;                     ///< reqPositions was called
+    long long nextPermId_ = 1'000'000;
+    uint64_t nextExecId_ = 0;
+    Stats stats_;
+
+    std::thread pump_;
+    std::mutex pumpMutex_;
+    std::condition_variable pumpCv_;
+    bool stopping_ = false;
+  };
+
+}  // namespace IB::Sim
+
+#endif  // QUANTDREAMCPP_SIMULATED_BROKER_H
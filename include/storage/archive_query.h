@@ -0,0 +1,336 @@
+#ifndef QUANTDREAMCPP_ARCHIVE_QUERY_H
+#define QUANTDREAMCPP_ARCHIVE_QUERY_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "helpers/thread_pool.h"
+#include "storage/tick_archive.h"
+#include "storage/tick_codec.h"
+
+/**
+ * @file archive_query.h
+ * @brief Parallel scans and globally ordered replay over the tick archive
+ *
+ * Work is split into pieces of one instrument over one time range. A piece reads
+ * the raw `.ticks` segment through zero-copy slices when present and falls back to
+ * decoding the sealed `.tcb` copy otherwise, so callers never care which form a day
+ * is stored in.
+ *
+ * Two modes:
+ *  - `scan()` hands every piece to the callback on whichever pool thread loaded it,
+ *    in no particular order. This is the high-throughput path for per-instrument
+ *    analytics (VWAP, bar building, feature extraction) that do not need a global
+ *    clock.
+ *  - `replay()` delivers ticks of all instruments one by one on the calling thread
+ *    in global timestamp order. The range is cut into time windows; pool threads
+ *    load the next window while the caller k-way merges the current one.
+ */
+
+namespace IB::Storage {
+
+struct ArchiveQueryOptions {
+  std::chrono::nanoseconds replayWindow{std::chrono::minutes(10)};  ///< Time slice merged per step in `replay()`
+  size_t piecesPerThread = 4;                                       ///< Target pieces per worker in `scan()`
+};
+
+/**
+ * @brief Parallel read engine over a `TickArchiveReader`
+ *
+ * The reader and pool must outlive the engine. Methods may be called from several
+ * threads at once; call `reader.rescan()` first to pick up new segments.
+ *
+ * Example usage:
+ * @code
+ * IB::Storage::TickArchiveReader reader("/data/ticks");
+ * IB::Helpers::ThreadPool pool;
+ * IB::Storage::ArchiveQuery query(reader, pool);
+ *
+ * // Per-instrument notional, any order
+ * std::map<long, std::atomic<double>> notional;
+ * query.scan(reader.instruments(), from, to, [&](long conId, std::span<const TickRecord> ticks) {
+ *     double sum = 0;
+ *     for (const auto& t : ticks) sum += t.price * t.size;
+ *     notional[conId] += sum;
+ * });
+ *
+ * // Cross-instrument strategy research, one global clock
+ * query.replay({aapl, msft}, from, to, [&](long conId, const TickRecord& t) { strategy.onTick(conId, t); });
+ * @endcode
+ */
+class ArchiveQuery {
+public:
+  struct Stats {
+    uint64_t ticks = 0;    ///< Ticks delivered
+    uint64_t pieces = 0;   ///< Instrument x time-range pieces loaded
+    double seconds = 0.0;  ///< Wall time of the call
+
+    double ticksPerSecond() const { return seconds > 0 ? static_cast<double>(ticks) / seconds : 0.0; }
+  };
+
+  ArchiveQuery(TickArchiveReader& reader, Helpers::ThreadPool& pool)
+      : ArchiveQuery(reader, pool, ArchiveQueryOptions{}) {}
+
+  ArchiveQuery(TickArchiveReader& reader, Helpers::ThreadPool& pool, ArchiveQueryOptions options)
+      : reader_(reader), pool_(pool), options_(options) {}
+
+  /**
+   * @brief Calls `fn(conId, ticks)` for every piece of `[fromNs, toNs)`, concurrently
+   *
+   * Each instrument-day is split into enough time pieces to keep every pool thread
+   * busy; ticks within one call are time ordered, calls are not ordered relative to
+   * each other and run on pool threads (and the caller), so `fn` must be thread-safe.
+   */
+  template <typename Fn>
+  Stats scan(const std::vector<long>& conIds, int64_t fromNs, int64_t toNs, Fn&& fn) {
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<Range> units;
+    for (long conId : conIds)
+      for (int d : reader_.days(conId)) {
+        const int64_t lo = std::max(fromNs, dayStartNs(d));
+        const int64_t hi = std::min(toNs, dayStartNs(d) + NS_PER_DAY);
+        if (lo < hi) units.push_back({conId, d, lo, hi});
+      }
+
+    // Few instrument-days: cut each into equal time pieces so all threads get work
+    const size_t target = (pool_.size() + 1) * options_.piecesPerThread;
+    std::vector<Range> pieces;
+    const size_t split = units.empty() ? 1 : std::max<size_t>(1, (target + units.size() - 1) / units.size());
+    for (const auto& u : units) {
+      const int64_t step = std::max<int64_t>(1, (u.toNs - u.fromNs + static_cast<int64_t>(split) - 1) /
+                                                    static_cast<int64_t>(split));
+      for (int64_t lo = u.fromNs; lo < u.toNs; lo += step)
+        pieces.push_back({u.conId, u.day, lo, std::min(u.toNs, lo + step)});
+    }
+
+    std::atomic<uint64_t> ticks{0};
+    pool_.parallelFor(pieces.size(), 1, [&](size_t begin, size_t end) {
+      Piece piece;
+      for (size_t i = begin; i < end; ++i) {
+        load(pieces[i], piece);
+        uint64_t n = 0;
+        for (const auto& s : piece.spans) {
+          fn(pieces[i].conId, s);
+          n += s.size();
+        }
+        ticks.fetch_add(n, std::memory_order_relaxed);
+      }
+    });
+
+    return {ticks.load(), pieces.size(),
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count()};
+  }
+
+  /**
+   * @brief Calls `fn(conId, tick)` for every tick of `[fromNs, toNs)` in timestamp order
+   *
+   * Runs on the calling thread. Ticks with equal timestamps are delivered in the order
+   * of `conIds`, so replays are deterministic. Return early by throwing from `fn`.
+   */
+  template <typename Fn>
+  Stats replay(const std::vector<long>& conIds, int64_t fromNs, int64_t toNs, Fn&& fn) {
+    const auto t0 = std::chrono::steady_clock::now();
+    Stats stats;
+
+    // Clamp to the days actually archived so open ranges don't walk empty windows
+    int64_t lo = INT64_MAX, hi = INT64_MIN;
+    for (long conId : conIds) {
+      const auto days = reader_.days(conId);
+      if (days.empty()) continue;
+      lo = std::min(lo, dayStartNs(days.front()));
+      hi = std::max(hi, dayStartNs(days.back()) + NS_PER_DAY);
+    }
+    lo = std::max(lo, fromNs);
+    hi = std::min(hi, toNs);
+    if (lo >= hi) return stats;
+
+    const int64_t window = std::max<int64_t>(1, options_.replayWindow.count());
+    auto loadWindow = [this, &conIds, hi, window](int64_t start) {
+      auto batch = std::make_unique<std::vector<Piece>>(conIds.size());
+      const int64_t end = start > hi - window ? hi : start + window;
+      pool_.parallelFor(conIds.size(), 1, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) loadRange(conIds[i], start, end, (*batch)[i]);
+      });
+      return batch;
+    };
+
+    auto current = loadWindow(lo);
+    for (int64_t start = lo; start < hi;) {
+      const int64_t next = start > hi - window ? hi : start + window;
+      std::future<std::unique_ptr<std::vector<Piece>>> prefetch;
+      if (next < hi) prefetch = pool_.submit([&loadWindow, next] { return loadWindow(next); });
+
+      try {
+        stats.ticks += merge(conIds, *current, fn);
+      } catch (...) {
+        if (prefetch.valid()) prefetch.wait();
+        throw;
+      }
+      stats.pieces += conIds.size();
+
+      if (prefetch.valid()) current = prefetch.get();
+      start = next;
+    }
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return stats;
+  }
+
+private:
+  struct Range {
+    long conId;
+    int day;
+    int64_t fromNs;
+    int64_t toNs;
+  };
+
+  /// Ticks of one instrument over one range: mapped slices and/or decoded records
+  struct Piece {
+    struct Part {
+      bool mapped;       ///< `slices[index]` if true, else `decoded[begin, end)`
+      size_t index;
+      size_t begin;
+      size_t end;
+    };
+
+    std::vector<TickSlice> slices;
+    std::vector<TickRecord> decoded;
+    std::vector<Part> parts;                         ///< Day order
+    std::vector<std::span<const TickRecord>> spans;  ///< Non-empty parts, day order
+
+    void clear() {
+      slices.clear();
+      decoded.clear();
+      parts.clear();
+      spans.clear();
+    }
+  };
+
+  /// One instrument over `[fromNs, toNs)`, possibly spanning days
+  void loadRange(long conId, int64_t fromNs, int64_t toNs, Piece& piece) {
+    piece.clear();
+    for (int d : reader_.days(conId)) {
+      const int64_t lo = std::max(fromNs, dayStartNs(d));
+      const int64_t hi = std::min(toNs, dayStartNs(d) + NS_PER_DAY);
+      if (lo < hi) append({conId, d, lo, hi}, piece);
+    }
+    finish(piece);
+  }
+
+  void load(const Range& r, Piece& piece) {
+    piece.clear();
+    append(r, piece);
+    finish(piece);
+  }
+
+  void append(const Range& r, Piece& piece) {
+    if (std::filesystem::exists(segmentPath(reader_.root(), r.conId, r.day))) {
+      for (auto& s : reader_.query(r.conId, r.fromNs, r.toNs)) {
+        if (s.day != r.day) continue;
+        piece.parts.push_back({true, piece.slices.size(), 0, 0});
+        piece.slices.push_back(std::move(s));
+      }
+      return;
+    }
+    if (auto seg = compressed(r.conId, r.day)) {
+      thread_local TickBlockCodec codec;
+      const size_t begin = piece.decoded.size();
+      if (!seg->read(codec, r.fromNs, r.toNs, piece.decoded))
+        LOG_WARN("[ArchiveQuery] Corrupt block in ", segmentPath(reader_.root(), r.conId, r.day, ".tcb").string());
+      piece.parts.push_back({false, 0, begin, piece.decoded.size()});
+    }
+  }
+
+  /// Resolves parts to spans once `decoded` has stopped growing
+  static void finish(Piece& piece) {
+    for (const auto& p : piece.parts) {
+      auto s = p.mapped ? piece.slices[p.index].ticks
+                        : std::span<const TickRecord>(piece.decoded).subspan(p.begin, p.end - p.begin);
+      if (!s.empty()) piece.spans.push_back(s);
+    }
+  }
+
+  std::shared_ptr<const CompressedSegment> compressed(long conId, int day) {
+    std::lock_guard<std::mutex> lk(m_);
+    auto& seg = compressed_[{conId, day}];
+    if (!seg) seg = CompressedSegment::open(segmentPath(reader_.root(), conId, day, ".tcb"));
+    return seg;
+  }
+
+  /// k-way merge of one window; ties resolved by stream index
+  template <typename Fn>
+  static uint64_t merge(const std::vector<long>& conIds, const std::vector<Piece>& pieces, Fn& fn) {
+    struct Cursor {
+      const TickRecord* at;
+      const TickRecord* end;
+      size_t span;
+      size_t stream;
+    };
+    std::vector<Cursor> cursors;
+    for (size_t i = 0; i < pieces.size(); ++i)
+      if (!pieces[i].spans.empty())
+        cursors.push_back({pieces[i].spans[0].data(), pieces[i].spans[0].data() + pieces[i].spans[0].size(), 0, i});
+
+    uint64_t n = 0;
+    if (cursors.size() == 1) {
+      // Single stream: no heap needed
+      const auto& piece = pieces[cursors[0].stream];
+      for (const auto& s : piece.spans)
+        for (const auto& t : s) fn(conIds[cursors[0].stream], t);
+      return std::accumulate(piece.spans.begin(), piece.spans.end(), uint64_t{0},
+                                 [](uint64_t a, const auto& s) { return a + s.size(); });
+    }
+
+    auto later = [&](size_t a, size_t b) {
+      const auto ta = cursors[a].at->timestampNs, tb = cursors[b].at->timestampNs;
+      return ta != tb ? ta > tb : cursors[a].stream > cursors[b].stream;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+    for (size_t i = 0; i < cursors.size(); ++i) heap.push(i);
+
+    while (!heap.empty()) {
+      const size_t c = heap.top();
+      heap.pop();
+      auto& cur = cursors[c];
+      // Drain this stream while it stays ahead of the next best one
+      const int64_t bound = heap.empty() ? INT64_MAX : cursors[heap.top()].at->timestampNs;
+      const bool winsTies = heap.empty() || cur.stream < cursors[heap.top()].stream;
+      do {
+        fn(conIds[cur.stream], *cur.at);
+        ++n;
+        if (++cur.at == cur.end) {
+          const auto& spans = pieces[cur.stream].spans;
+          if (++cur.span == spans.size()) break;
+          cur.at = spans[cur.span].data();
+          cur.end = cur.at + spans[cur.span].size();
+        }
+      } while (cur.at->timestampNs < bound || (winsTies && cur.at->timestampNs == bound));
+      if (cur.span < pieces[cur.stream].spans.size()) heap.push(c);
+    }
+    return n;
+  }
+
+  TickArchiveReader& reader_;
+  Helpers::ThreadPool& pool_;
+  ArchiveQueryOptions options_;
+
+  std::mutex m_;
+  std::map<std::pair<long, int>, std::shared_ptr<const CompressedSegment>> compressed_;  ///< Opened .tcb files
+};
+
+}  // namespace IB::Storage
+
+#endif  // QUANTDREAMCPP_ARCHIVE_QUERY_H
@@ -0,0 +1,298 @@
+#ifndef QUANTDREAMCPP_BAR_STORE_H
+#define QUANTDREAMCPP_BAR_STORE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+#include "helpers/logger.h"
+#include "storage/mapped_file.h"
+
+/**
+ * @file bar_store.h
+ * @brief Columnar, memory-mapped store of historical bars
+ *
+ * **Layout** (`root/<conId>/<series>/<chunkStart>.bars`)
+ * - A series is one conId / bar size / data type / RTH combination, e.g.
+ *   `265598/TRADES_1min_rth`
+ * - Each file holds one fetch chunk `[from, to)` of that series: a 64-byte header
+ *   followed by one contiguous column per field (time, open, high, low, close,
+ *   volume, wap, count), all 8-byte values in ascending time order
+ * - Chunks of a series do not overlap (the backfill cuts them on a fixed grid), so a
+ *   query picks its chunks from the file names alone
+ * - Files are immutable and published by rename, so a chunk file either exists
+ *   complete or not at all. Its presence is what lets the backfill skip work on
+ *   restart; chunks that reached into the future are flagged partial and refetched
+ *
+ * **Reads** map chunk files and return per-column `std::span`s, so indicator warm-up
+ * can stream a single column (say, closes) without touching the others.
+ */
+
+namespace IB::Storage {
+
+  /// One bar as delivered by reqHistoricalData
+  struct BarRow {
+    int64_t time = 0;      ///< Bar start, seconds since epoch (UTC)
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    double volume = 0.0;
+    double wap = 0.0;
+    int64_t count = 0;     ///< Trades in the bar (-1 if not reported)
+  };
+
+  /// Identifies one bar series of an instrument
+  struct BarSeries {
+    long conId = 0;
+    std::string barSize = "1 min";        ///< IB bar size setting ("1 min", "1 hour", "1 day", ...)
+    std::string whatToShow = "TRADES";    ///< TRADES, MIDPOINT, BID, ASK, BID_ASK, ...
+    bool useRTH = true;                   ///< Regular trading hours only
+
+    /// Directory name of the series, e.g. "TRADES_1min_rth"
+    std::string key() const {
+      std::string size;
+      for (char c : barSize)
+        if (!std::isspace(static_cast<unsigned char>(c))) size += c;
+      return whatToShow + "_" + size + (useRTH ? "_rth" : "_all");
+    }
+  };
+
+  constexpr char BAR_MAGIC[8] = {'I', 'B', 'W', 'B', 'A', 'R', '\0', '\1'};
+
+  /// Header of a chunk file
+  struct BarChunkHeader {
+    char magic[8];
+    int64_t from;          ///< Chunk start, seconds since epoch
+    int64_t to;            ///< Chunk end (exclusive)
+    int64_t fetchedAt;     ///< Wall-clock seconds when the chunk was fetched
+    uint64_t count;        ///< Bars per column
+    uint32_t flags;        ///< CHUNK_COMPLETE if `to` was in the past when fetched
+    char reserved[20];
+  };
+  static_assert(sizeof(BarChunkHeader) == 64, "BarChunkHeader must stay 64 bytes");
+
+  constexpr uint32_t CHUNK_COMPLETE = 1;
+
+  /**
+   * @brief Column views of one chunk clipped to a query range
+   *
+   * Holds the mapping alive; all spans have the same length.
+   */
+  struct BarColumns {
+    int64_t from = 0;
+    int64_t to = 0;
+    bool complete = false;
+    std::span<const int64_t> time;
+    std::span<const double> open;
+    std::span<const double> high;
+    std::span<const double> low;
+    std::span<const double> close;
+    std::span<const double> volume;
+    std::span<const double> wap;
+    std::span<const int64_t> count;
+    std::shared_ptr<const MappedFile> file;
+
+    size_t size() const noexcept { return time.size(); }
+
+    BarRow row(size_t i) const {
+      return {time[i], open[i], high[i], low[i], close[i], volume[i], wap[i], count[i]};
+    }
+  };
+
+  /**
+   * @brief Chunked columnar bar store
+   *
+   * Writes and reads may run concurrently from any threads or processes; each write goes
+   * to its own scratch file (removed if the write fails) and is published by rename, so a
+   * chunk being rewritten is replaced atomically and readers holding the old mapping keep
+   * seeing the old data.
+   *
+   * Example usage:
+   * @code
+   * IB::Storage::BarStore store("/data/bars");
+   * IB::Storage::BarSeries series{.conId = 265598, .barSize = "1 min"};
+   * for (const auto& chunk : store.query(series, from, to))
+   *     for (double c : chunk.close) ema.update(c);
+   * @endcode
+   */
+  class BarStore {
+  public:
+    explicit BarStore(std::filesystem::path root) : root_(std::move(root)) {}
+
+    const std::filesystem::path& root() const noexcept { return root_; }
+
+    std::filesystem::path seriesDir(const BarSeries& series) const {
+      return root_ / std::to_string(series.conId) / series.key();
+    }
+
+    std::filesystem::path chunkPath(const BarSeries& series, int64_t from) const {
+      return seriesDir(series) / (std::to_string(from) + ".bars");
+    }
+
+    /**
+     * @brief Writes chunk `[from, to)`, replacing any previous version
+     *
+     * Bars outside the chunk are dropped and the rest sorted by time, so callers can pass
+     * an IB response as is.
+     * @param complete False if the chunk may still grow (its end was in the future)
+     * @return False on I/O failure
+     */
+    bool write(const BarSeries& series, int64_t from, int64_t to, std::vector<BarRow> bars, bool complete,
+               int64_t fetchedAt) {
+      std::erase_if(bars, [&](const BarRow& b) { return b.time < from || b.time >= to; });
+      std::sort(bars.begin(), bars.end(), [](const BarRow& a, const BarRow& b) { return a.time < b.time; });
+      bars.erase(std::unique(bars.begin(), bars.end(), [](const BarRow& a, const BarRow& b) { return a.time == b.time; }),
+                 bars.end());
+
+      BarChunkHeader header{};
+      std::memcpy(header.magic, BAR_MAGIC, sizeof(BAR_MAGIC));
+      header.from = from;
+      header.to = to;
+      header.fetchedAt = fetchedAt;
+      header.count = bars.size();
+      header.flags = complete ? CHUNK_COMPLETE : 0;
+
+      std::error_code ec;
+      std::filesystem::create_directories(seriesDir(series), ec);
+      const auto path = chunkPath(series, from);
+      const auto tmp = tmpPath(path);
+      auto discard = [&] {
+        std::error_code rmEc;
+        std::filesystem::remove(tmp, rmEc);
+        return false;
+      };
+      {
+        std::ofstream f(tmp, std::ios::binary | std::ios::trunc);
+        if (!f) {
+          LOG_ERROR("[BarStore] Cannot create ", tmp.string());
+          return discard();
+        }
+        f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        auto column = [&](auto member) {
+          for (const auto& b : bars) f.write(reinterpret_cast<const char*>(&(b.*member)), sizeof(b.*member));
+        };
+        column(&BarRow::time);
+        column(&BarRow::open);
+        column(&BarRow::high);
+        column(&BarRow::low);
+        column(&BarRow::close);
+        column(&BarRow::volume);
+        column(&BarRow::wap);
+        column(&BarRow::count);
+        if (!f.flush()) {
+          LOG_ERROR("[BarStore] Write failed: ", tmp.string());
+          return discard();
+        }
+      }
+      std::filesystem::rename(tmp, path, ec);
+      if (ec) {
+        LOG_ERROR("[BarStore] Cannot publish ", path.string(), ": ", ec.message());
+        return discard();
+      }
+      return true;
+    }
+
+    /// True if chunk `from` exists and was fetched complete
+    bool hasComplete(const BarSeries& series, int64_t from) const {
+      BarChunkHeader header{};
+      std::ifstream f(chunkPath(series, from), std::ios::binary);
+      return f.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+             std::memcmp(header.magic, BAR_MAGIC, sizeof(BAR_MAGIC)) == 0 && (header.flags & CHUNK_COMPLETE);
+    }
+
+    /// Start times of the stored chunks of a series, ascending
+    std::vector<int64_t> chunks(const BarSeries& series) const {
+      std::vector<int64_t> out;
+      std::error_code ec;
+      for (const auto& f : std::filesystem::directory_iterator(seriesDir(series), ec)) {
+        if (f.path().extension() != ".bars") continue;
+        try {
+          out.push_back(std::stoll(f.path().stem().string()));
+        } catch (...) {}
+      }
+      std::sort(out.begin(), out.end());
+      return out;
+    }
+
+    /**
+     * @brief Bars of a series with `from <= time < to`, one column set per chunk in time order
+     */
+    std::vector<BarColumns> query(const BarSeries& series, int64_t from, int64_t to) const {
+      std::vector<BarColumns> out;
+      // Chunks do not overlap, so only the last one starting at or before `from` can reach into
+      // the range from the left; anything starting at or after `to` is past it. Pick by name
+      // rather than mapping every chunk of the series.
+      const auto starts = chunks(series);
+      auto first = std::upper_bound(starts.begin(), starts.end(), from);
+      if (first != starts.begin()) --first;
+      const auto last = std::lower_bound(first, starts.end(), to);
+      for (auto it = first; it != last; ++it) {
+        const int64_t start = *it;
+        auto file = MappedFile::open(chunkPath(series, start).string());
+        if (!file || file->size() < sizeof(BarChunkHeader)) continue;
+        BarChunkHeader header{};
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (std::memcmp(header.magic, BAR_MAGIC, sizeof(BAR_MAGIC)) != 0 ||
+            file->size() < sizeof(header) + header.count * 8 * sizeof(int64_t)) {
+          LOG_WARN("[BarStore] Skipping malformed chunk ", chunkPath(series, start).string());
+          continue;
+        }
+        if (header.to <= from || header.from >= to) continue;
+
+        const size_t n = header.count;
+        const char* base = file->data() + sizeof(header);
+        BarColumns c;
+        c.from = header.from;
+        c.to = header.to;
+        c.complete = header.flags & CHUNK_COMPLETE;
+        const auto time = column<int64_t>(base, n, 0);
+        const size_t lo = static_cast<size_t>(std::lower_bound(time.begin(), time.end(), from) - time.begin());
+        const size_t hi = static_cast<size_t>(std::lower_bound(time.begin(), time.end(), to) - time.begin());
+        if (lo == hi) continue;
+        c.time = time.subspan(lo, hi - lo);
+        c.open = column<double>(base, n, 1).subspan(lo, hi - lo);
+        c.high = column<double>(base, n, 2).subspan(lo, hi - lo);
+        c.low = column<double>(base, n, 3).subspan(lo, hi - lo);
+        c.close = column<double>(base, n, 4).subspan(lo, hi - lo);
+        c.volume = column<double>(base, n, 5).subspan(lo, hi - lo);
+        c.wap = column<double>(base, n, 6).subspan(lo, hi - lo);
+        c.count = column<int64_t>(base, n, 7).subspan(lo, hi - lo);
+        c.file = std::move(file);
+        out.push_back(std::move(c));
+      }
+      return out;
+    }
+
+  private:
+    /// Scratch file next to `path`, unique per process and write, so concurrent writers never share one
+    static std::filesystem::path tmpPath(const std::filesystem::path& path) {
+      static std::atomic<uint64_t> seq{0};
+      auto tmp = path;
+      tmp += "." + std::to_string(::getpid()) + "." + std::to_string(seq.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+      return tmp;
+    }
+
+    /// Column `index` of a chunk with `n` bars per column
+    template <typename T>
+    static std::span<const T> column(const char* base, size_t n, size_t index) {
+      return {reinterpret_cast<const T*>(base + index * n * sizeof(T)), n};
+    }
+
+    std::filesystem::path root_;
+  };
+
+}  // namespace IB::Storage
+
+#endif  // QUANTDREAMCPP_BAR_STORE_H
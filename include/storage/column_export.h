@@ -0,0 +1,629 @@
+#ifndef QUANTDREAMCPP_COLUMN_EXPORT_H
+#define QUANTDREAMCPP_COLUMN_EXPORT_H
+
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Contract.h"
+#include "Execution.h"
+#include "data_structures/greeks_table.h"
+#include "data_structures/snapshots.h"
+#include "helpers/logger.h"
+#include "storage/bar_store.h"
+
+/**
+ * @file column_export.h
+ * @brief Columnar export of snapshots, greeks, fills and bars for offline research
+ *
+ * **Format** (`.ibcol`, self-describing, little-endian)
+ * - File header: magic, column count, then per column its type and name
+ * - A sequence of blocks, each `BlockHeader` + payload:
+ *   - `BLOCK_DICTIONARY`: strings appended to the file's symbol dictionary
+ *     (`u16 length + bytes` each); codes are assigned in order from 0
+ *   - `BLOCK_BATCH`: `rows` values of each column in schema order, 8 bytes per
+ *     I64/F64 value, a `u32` dictionary code per SYMBOL value, and for a STRING column
+ *     a `u32` end offset per row followed by the concatenated bytes of its values
+ * - A dictionary block always precedes the first batch using its codes, so a file cut
+ *   short by a crash is readable up to its last complete block
+ *
+ * `ColumnFile::read` loads a file back; the layout is simple enough to read with numpy
+ * (`np.frombuffer` per column) without this library. The CSV mode writes the same rows
+ * as text for tools that want it.
+ *
+ * **Writes** are split between the producer and a background thread. The producer only
+ * appends 8-byte values (and STRING bytes) to the current batch and looks symbols up in
+ * the dictionary;
+ * full batches are handed over under a mutex once per `batchRows` rows, and the writer
+ * thread does all formatting (`std::to_chars`) and file I/O.
+ */
+
+namespace IB::Storage {
+
+  enum class ColumnType : uint8_t {
+    I64 = 1,      ///< int64_t (timestamps, IDs, counts)
+    F64 = 2,      ///< double
+    SYMBOL = 3,   ///< Dictionary-encoded string (few distinct values: symbols, sides, accounts)
+    STRING = 4,   ///< String stored inline per row (unique values such as execution IDs)
+  };
+
+  struct ColumnSpec {
+    std::string name;
+    ColumnType type = ColumnType::F64;
+  };
+
+  using ColumnSchema = std::vector<ColumnSpec>;
+
+  constexpr char COLUMN_MAGIC[8] = {'I', 'B', 'W', 'C', 'O', 'L', '\0', '\1'};
+  constexpr uint32_t BLOCK_DICTIONARY = 1;
+  constexpr uint32_t BLOCK_BATCH = 2;
+
+  /// Header of every block after the schema
+  struct BlockHeader {
+    uint32_t kind;         ///< BLOCK_DICTIONARY or BLOCK_BATCH
+    uint32_t count;        ///< Dictionary entries or batch rows
+    uint64_t bytes;        ///< Payload size
+  };
+  static_assert(sizeof(BlockHeader) == 16, "BlockHeader must stay 16 bytes");
+
+  /**
+   * @brief Tuning for ColumnWriter
+   */
+  struct ColumnWriterOptions {
+    enum class Format { COLUMNAR, CSV };
+
+    Format format = Format::COLUMNAR;
+    size_t batchRows = 4096;                          ///< Rows per handed-over batch
+    std::chrono::milliseconds flushInterval{1000};    ///< Max age of a partial batch (checked on append)
+  };
+
+  /**
+   * @brief Batched, dictionary-encoding columnar writer
+   *
+   * One producer thread appends rows with typed setters in schema order and ends each
+   * row with `end()`. Batches are written by a background thread; `flush()` waits until
+   * everything appended so far is on disk.
+   *
+   * Example usage:
+   * @code
+   * IB::Storage::ColumnWriter out("greeks.ibcol", IB::Storage::Export::greeksSchema());
+   * for (const auto& g : chain) IB::Storage::Export::greeks(out, nowNs, g);
+   * @endcode
+   */
+  class ColumnWriter {
+  public:
+    using Options = ColumnWriterOptions;
+
+    ColumnWriter(const std::filesystem::path& path, ColumnSchema schema)
+        : ColumnWriter(path, std::move(schema), Options{}) {}
+
+    ColumnWriter(const std::filesystem::path& path, ColumnSchema schema, Options options)
+        : schema_(std::move(schema)), options_(options) {
+      if (options_.batchRows == 0) options_.batchRows = 1;
+      file_ = std::fopen(path.string().c_str(), "wb");
+      if (!file_) {
+        LOG_ERROR("[ColumnWriter] Cannot create ", path.string());
+      } else {
+        std::setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+        writeHeader();
+      }
+      current_ = newBatch();
+      lastSeal_ = Clock::now();
+      thread_ = std::thread([this] { run(); });
+    }
+
+    ColumnWriter(const ColumnWriter&) = delete;
+    ColumnWriter& operator=(const ColumnWriter&) = delete;
+
+    ~ColumnWriter() {
+      seal();
+      {
+        std::lock_guard<std::mutex> lk(mutex_);
+        stopping_ = true;
+      }
+      cv_.notify_all();
+      thread_.join();
+      if (file_) std::fclose(file_);
+    }
+
+    bool ok() const noexcept { return file_ != nullptr; }
+    const ColumnSchema& schema() const noexcept { return schema_; }
+
+    ColumnWriter& i64(int64_t v) {
+      assert(column_ < schema_.size() && schema_[column_].type == ColumnType::I64);
+      current_->columns[column_++].push_back(static_cast<uint64_t>(v));
+      return *this;
+    }
+
+    ColumnWriter& f64(double v) {
+      assert(column_ < schema_.size() && schema_[column_].type == ColumnType::F64);
+      uint64_t bits;
+      std::memcpy(&bits, &v, sizeof(bits));
+      current_->columns[column_++].push_back(bits);
+      return *this;
+    }
+
+    ColumnWriter& symbol(std::string_view s) {
+      assert(column_ < schema_.size() && schema_[column_].type == ColumnType::SYMBOL);
+      current_->columns[column_++].push_back(code(s));
+      return *this;
+    }
+
+    ColumnWriter& string(std::string_view s) {
+      assert(column_ < schema_.size() && schema_[column_].type == ColumnType::STRING);
+      auto& text = current_->text[column_];
+      text.append(s);
+      current_->columns[column_++].push_back(text.size());
+      return *this;
+    }
+
+    /// Completes the current row; hands the batch over when it is full or old
+    void end() {
+      assert(column_ == schema_.size());
+      column_ = 0;
+      ++current_->rows;
+      ++rows_;
+      if (current_->rows >= options_.batchRows ||
+          ((rows_ & 63) == 0 && Clock::now() - lastSeal_ >= options_.flushInterval))
+        seal();
+    }
+
+    /// Hands over the partial batch and waits until all rows are written
+    void flush() {
+      seal();
+      std::unique_lock<std::mutex> lk(mutex_);
+      idle_.wait(lk, [&] { return queue_.empty() && !writing_; });
+      if (file_) std::fflush(file_);
+    }
+
+    uint64_t rows() const noexcept { return rows_; }
+    size_t dictionarySize() const noexcept { return dictionary_.size(); }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Batch {
+      size_t rows = 0;
+      std::vector<std::vector<uint64_t>> columns;   ///< Values; end offsets into `text` for STRING columns
+      std::vector<std::string> text;                ///< Concatenated bytes per STRING column
+      std::vector<std::string> newSymbols;          ///< Dictionary entries first used in this batch
+    };
+
+    /// Transparent hash so lookups by string_view do not allocate
+    struct SymbolHash {
+      using is_transparent = void;
+      size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    };
+
+    uint32_t code(std::string_view s) {
+      if (auto it = dictionary_.find(s); it != dictionary_.end()) return it->second;
+      const auto id = static_cast<uint32_t>(dictionary_.size());
+      dictionary_.emplace(std::string(s), id);
+      current_->newSymbols.emplace_back(s);
+      return id;
+    }
+
+    std::unique_ptr<Batch> newBatch() {
+      std::unique_ptr<Batch> batch;
+      {
+        std::lock_guard<std::mutex> lk(mutex_);
+        if (!free_.empty()) {
+          batch = std::move(free_.back());
+          free_.pop_back();
+        }
+      }
+      if (!batch) {
+        batch = std::make_unique<Batch>();
+        batch->columns.resize(schema_.size());
+        batch->text.resize(schema_.size());
+        for (auto& c : batch->columns) c.reserve(options_.batchRows);
+      }
+      return batch;
+    }
+
+    void seal() {
+      lastSeal_ = Clock::now();
+      if (current_->rows == 0 && current_->newSymbols.empty()) return;
+      {
+        std::lock_guard<std::mutex> lk(mutex_);
+        queue_.push_back(std::move(current_));
+      }
+      cv_.notify_one();
+      current_ = newBatch();
+    }
+
+    void run() {
+      std::unique_lock<std::mutex> lk(mutex_);
+      for (;;) {
+        cv_.wait(lk, [&] { return stopping_ || !queue_.empty(); });
+        if (queue_.empty()) return;
+        auto batch = std::move(queue_.front());
+        queue_.pop_front();
+        writing_ = true;
+        lk.unlock();
+
+        if (file_) options_.format == Options::Format::CSV ? writeCsv(*batch) : writeColumnar(*batch);
+        batch->rows = 0;
+        batch->newSymbols.clear();
+        for (auto& c : batch->columns) c.clear();
+        for (auto& t : batch->text) t.clear();
+
+        lk.lock();
+        free_.push_back(std::move(batch));
+        writing_ = false;
+        if (queue_.empty()) idle_.notify_all();
+      }
+    }
+
+    void writeHeader() {
+      if (options_.format == Options::Format::CSV) {
+        for (size_t c = 0; c < schema_.size(); ++c) {
+          if (c) std::fputc(',', file_);
+          std::fputs(schema_[c].name.c_str(), file_);
+        }
+        std::fputc('\n', file_);
+        return;
+      }
+      std::fwrite(COLUMN_MAGIC, 1, sizeof(COLUMN_MAGIC), file_);
+      const auto columns = static_cast<uint32_t>(schema_.size());
+      std::fwrite(&columns, sizeof(columns), 1, file_);
+      for (const auto& spec : schema_) {
+        const auto type = static_cast<uint8_t>(spec.type);
+        const auto length = static_cast<uint8_t>(std::min<size_t>(spec.name.size(), 255));
+        std::fputc(type, file_);
+        std::fputc(length, file_);
+        std::fwrite(spec.name.data(), 1, length, file_);
+      }
+    }
+
+    void writeColumnar(const Batch& batch) {
+      if (!batch.newSymbols.empty()) {
+        BlockHeader header{BLOCK_DICTIONARY, static_cast<uint32_t>(batch.newSymbols.size()), 0};
+        for (const auto& s : batch.newSymbols) header.bytes += sizeof(uint16_t) + std::min<size_t>(s.size(), 65535);
+        std::fwrite(&header, sizeof(header), 1, file_);
+        for (const auto& s : batch.newSymbols) {
+          const auto length = static_cast<uint16_t>(std::min<size_t>(s.size(), 65535));
+          std::fwrite(&length, sizeof(length), 1, file_);
+          std::fwrite(s.data(), 1, length, file_);
+        }
+      }
+      if (batch.rows == 0) return;
+
+      BlockHeader header{BLOCK_BATCH, static_cast<uint32_t>(batch.rows), 0};
+      for (size_t c = 0; c < schema_.size(); ++c)
+        header.bytes += batch.rows * valueBytes(schema_[c].type) + batch.text[c].size();
+      std::fwrite(&header, sizeof(header), 1, file_);
+      for (size_t c = 0; c < schema_.size(); ++c) {
+        const auto& values = batch.columns[c];
+        if (schema_[c].type != ColumnType::SYMBOL && schema_[c].type != ColumnType::STRING) {
+          std::fwrite(values.data(), sizeof(uint64_t), values.size(), file_);
+          continue;
+        }
+        codes_.resize(values.size());
+        for (size_t i = 0; i < values.size(); ++i) codes_[i] = static_cast<uint32_t>(values[i]);
+        std::fwrite(codes_.data(), sizeof(uint32_t), codes_.size(), file_);
+        std::fwrite(batch.text[c].data(), 1, batch.text[c].size(), file_);
+      }
+    }
+
+    void writeCsv(const Batch& batch) {
+      for (const auto& s : batch.newSymbols) symbols_.push_back(s);
+      text_.clear();
+      char buf[32];
+      for (size_t r = 0; r < batch.rows; ++r) {
+        for (size_t c = 0; c < schema_.size(); ++c) {
+          if (c) text_ += ',';
+          const uint64_t v = batch.columns[c][r];
+          switch (schema_[c].type) {
+            case ColumnType::I64: {
+              const auto res = std::to_chars(buf, buf + sizeof(buf), static_cast<int64_t>(v));
+              text_.append(buf, res.ptr);
+              break;
+            }
+            case ColumnType::F64: {
+              double d;
+              std::memcpy(&d, &v, sizeof(d));
+              const auto res = std::to_chars(buf, buf + sizeof(buf), d);
+              text_.append(buf, res.ptr);
+              break;
+            }
+            case ColumnType::SYMBOL:
+              appendCsvField(symbols_[v]);
+              break;
+            case ColumnType::STRING: {
+              const size_t begin = r ? batch.columns[c][r - 1] : 0;
+              appendCsvField(std::string_view(batch.text[c]).substr(begin, v - begin));
+              break;
+            }
+          }
+        }
+        text_ += '\n';
+      }
+      std::fwrite(text_.data(), 1, text_.size(), file_);
+    }
+
+    void appendCsvField(std::string_view s) {
+      if (s.find_first_of(",\"\n") == std::string_view::npos) {
+        text_ += s;
+        return;
+      }
+      text_ += '"';
+      for (char ch : s) {
+        if (ch == '"') text_ += '"';
+        text_ += ch;
+      }
+      text_ += '"';
+    }
+
+    static size_t valueBytes(ColumnType type) {
+      return type == ColumnType::SYMBOL || type == ColumnType::STRING ? sizeof(uint32_t) : 8;
+    }
+
+    ColumnSchema schema_;
+    Options options_;
+    std::FILE* file_ = nullptr;
+
+    // Producer side
+    std::unique_ptr<Batch> current_;
+    size_t column_ = 0;
+    uint64_t rows_ = 0;
+    Clock::time_point lastSeal_;
+    std::unordered_map<std::string, uint32_t, SymbolHash, std::equal_to<>> dictionary_;
+
+    // Hand-over
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::condition_variable idle_;
+    std::deque<std::unique_ptr<Batch>> queue_;
+    std::vector<std::unique_ptr<Batch>> free_;      ///< Written batches, reused to avoid reallocating
+    bool writing_ = false;
+    bool stopping_ = false;
+
+    // Writer thread
+    std::vector<uint32_t> codes_;
+    std::vector<std::string> symbols_;             ///< Dictionary as seen by the CSV formatter
+    std::string text_;
+    std::thread thread_;
+  };
+
+  /**
+   * @brief A columnar export file loaded into memory
+   *
+   * Columns are stored as raw 8-byte values (SYMBOL columns hold dictionary codes,
+   * STRING columns end offsets into their `text`); use the typed accessors to read them.
+   */
+  struct ColumnFile {
+    ColumnSchema schema;
+    std::vector<std::string> dictionary;
+    std::vector<std::vector<uint64_t>> columns;
+    std::vector<std::string> text;                ///< Concatenated bytes per STRING column
+
+    size_t rows() const noexcept { return columns.empty() ? 0 : columns.front().size(); }
+
+    /// Index of a column by name, or -1
+    int find(std::string_view name) const {
+      for (size_t c = 0; c < schema.size(); ++c)
+        if (schema[c].name == name) return static_cast<int>(c);
+      return -1;
+    }
+
+    int64_t i64(size_t column, size_t row) const { return static_cast<int64_t>(columns[column][row]); }
+
+    double f64(size_t column, size_t row) const {
+      double d;
+      std::memcpy(&d, &columns[column][row], sizeof(d));
+      return d;
+    }
+
+    const std::string& symbol(size_t column, size_t row) const { return dictionary[columns[column][row]]; }
+
+    std::string_view string(size_t column, size_t row) const {
+      const uint64_t begin = row ? columns[column][row - 1] : 0;
+      return std::string_view(text[column]).substr(begin, columns[column][row] - begin);
+    }
+
+    /**
+     * @brief Reads a file written in the COLUMNAR format
+     *
+     * A truncated trailing block is ignored, and reading stops at the first block whose
+     * lengths, offsets or dictionary codes do not fit its payload. Returns nullopt if the
+     * file cannot be opened or is not a column export.
+     */
+    static std::optional<ColumnFile> read(const std::filesystem::path& path) {
+      std::unique_ptr<std::FILE, int (*)(std::FILE*)> f(std::fopen(path.string().c_str(), "rb"), &std::fclose);
+      if (!f) return std::nullopt;
+      char magic[8];
+      uint32_t count = 0;
+      if (std::fread(magic, 1, sizeof(magic), f.get()) != sizeof(magic) ||
+          std::memcmp(magic, COLUMN_MAGIC, sizeof(magic)) != 0 || std::fread(&count, sizeof(count), 1, f.get()) != 1)
+        return std::nullopt;
+
+      ColumnFile out;
+      for (uint32_t c = 0; c < count; ++c) {
+        const int type = std::fgetc(f.get());
+        const int length = std::fgetc(f.get());
+        if (type == EOF || length == EOF) return std::nullopt;
+        ColumnSpec spec;
+        spec.type = static_cast<ColumnType>(type);
+        spec.name.resize(static_cast<size_t>(length));
+        if (std::fread(spec.name.data(), 1, spec.name.size(), f.get()) != spec.name.size()) return std::nullopt;
+        out.schema.push_back(std::move(spec));
+      }
+      out.columns.resize(out.schema.size());
+      out.text.resize(out.schema.size());
+
+      BlockHeader header{};
+      std::vector<char> payload;
+      std::error_code ec;
+      const uint64_t fileBytes = std::filesystem::file_size(path, ec);
+      while (std::fread(&header, sizeof(header), 1, f.get()) == 1) {
+        // A corrupt length must not turn into a huge allocation
+        const long at = std::ftell(f.get());
+        if (ec || at < 0 || header.bytes > fileBytes - static_cast<uint64_t>(at)) break;
+        payload.resize(header.bytes);
+        if (std::fread(payload.data(), 1, payload.size(), f.get()) != payload.size()) break;
+        const bool ok = header.kind == BLOCK_DICTIONARY ? out.readDictionary(header, payload)
+                        : header.kind == BLOCK_BATCH    ? out.readBatch(header, payload)
+                                                        : true;
+        if (!ok) {
+          LOG_WARN("[ColumnFile] Corrupt block in ", path.string(), ", ignoring the rest of the file");
+          break;
+        }
+      }
+      return out;
+    }
+
+  private:
+    bool readDictionary(const BlockHeader& header, std::span<const char> payload) {
+      const char* p = payload.data();
+      const char* const end = p + payload.size();
+      for (uint32_t i = 0; i < header.count; ++i) {
+        uint16_t length;
+        if (static_cast<size_t>(end - p) < sizeof(length)) return false;
+        std::memcpy(&length, p, sizeof(length));
+        p += sizeof(length);
+        if (static_cast<size_t>(end - p) < length) return false;
+        dictionary.emplace_back(p, length);
+        p += length;
+      }
+      return true;
+    }
+
+    /// Appends one batch; on a malformed batch the columns are left as they were
+    bool readBatch(const BlockHeader& header, std::span<const char> payload) {
+      const char* p = payload.data();
+      const char* const end = p + payload.size();
+      const size_t base = rows();
+      std::vector<size_t> textBase(text.size());
+      for (size_t c = 0; c < text.size(); ++c) textBase[c] = text[c].size();
+      auto fail = [&] {
+        for (auto& column : columns) column.resize(base);
+        for (size_t c = 0; c < text.size(); ++c) text[c].resize(textBase[c]);
+        return false;
+      };
+
+      for (size_t c = 0; c < schema.size(); ++c) {
+        const ColumnType type = schema[c].type;
+        const size_t width = type == ColumnType::SYMBOL || type == ColumnType::STRING ? sizeof(uint32_t) : 8;
+        if (static_cast<size_t>(end - p) < header.count * width) return fail();
+        auto& column = columns[c];
+        column.resize(base + header.count);
+        if (type == ColumnType::SYMBOL) {
+          for (uint32_t r = 0; r < header.count; ++r) {
+            uint32_t code;
+            std::memcpy(&code, p + r * sizeof(code), sizeof(code));
+            if (code >= dictionary.size()) return fail();
+            column[base + r] = code;
+          }
+          p += header.count * sizeof(uint32_t);
+        } else if (type == ColumnType::STRING) {
+          // Offsets are per batch; rebase them onto the column's bytes read so far
+          uint32_t last = 0;
+          for (uint32_t r = 0; r < header.count; ++r) {
+            uint32_t offset;
+            std::memcpy(&offset, p + r * sizeof(offset), sizeof(offset));
+            if (offset < last) return fail();
+            last = offset;
+            column[base + r] = textBase[c] + offset;
+          }
+          p += header.count * sizeof(uint32_t);
+          if (static_cast<size_t>(end - p) < last) return fail();
+          text[c].append(p, last);
+          p += last;
+        } else {
+          std::memcpy(column.data() + base, p, header.count * sizeof(uint64_t));
+          p += header.count * sizeof(uint64_t);
+        }
+      }
+      return true;
+    }
+  };
+
+  /**
+   * @brief Schemas and row appenders for the library's research data
+   *
+   * Timestamps are whatever the caller passes (typically `IB::Helpers::wallNowNs()`); snapshots carry
+   * their own steady-clock `updatedNs` as a separate column.
+   */
+  namespace Export {
+
+    inline ColumnSchema snapshotSchema() {
+      using T = ColumnType;
+      return {{"ts_ns", T::I64},      {"symbol", T::SYMBOL},    {"bid", T::F64},        {"ask", T::F64},
+              {"last", T::F64},       {"bid_size", T::F64},     {"ask_size", T::F64},   {"last_size", T::F64},
+              {"volume", T::F64},     {"open", T::F64},         {"high", T::F64},       {"low", T::F64},
+              {"close", T::F64},      {"quality", T::I64},      {"updated_ns", T::I64}, {"implied_vol", T::F64},
+              {"delta", T::F64},      {"gamma", T::F64},        {"vega", T::F64},       {"theta", T::F64},
+              {"opt_price", T::F64},  {"und_price", T::F64}};
+    }
+
+    inline void snapshot(ColumnWriter& out, int64_t tsNs, std::string_view symbol,
+                         const IB::MarketData::MarketSnapshot& s) {
+      out.i64(tsNs).symbol(symbol).f64(s.bid).f64(s.ask).f64(s.last).f64(s.bidSize).f64(s.askSize)
+          .f64(s.lastSize).f64(s.volume).f64(s.open).f64(s.high).f64(s.low).f64(s.close)
+          .i64(s.quality).i64(s.updatedNs).f64(s.impliedVol).f64(s.delta)
+          .f64(s.gamma).f64(s.vega).f64(s.theta).f64(s.optPrice).f64(s.undPrice).end();
+    }
+
+    inline ColumnSchema greeksSchema() {
+      using T = ColumnType;
+      return {{"ts_ns", T::I64},       {"symbol", T::SYMBOL},   {"right", T::SYMBOL},  {"strike", T::F64},
+              {"expiry", T::SYMBOL},   {"exchange", T::SYMBOL}, {"trading_class", T::SYMBOL},
+              {"implied_vol", T::F64}, {"delta", T::F64},       {"gamma", T::F64},     {"vega", T::F64},
+              {"theta", T::F64},       {"opt_price", T::F64},   {"und_price", T::F64}};
+    }
+
+    inline void greeks(ColumnWriter& out, int64_t tsNs, const IB::Options::Greeks& g) {
+      out.i64(tsNs).symbol(g.symbol).symbol(g.right).f64(g.strike).symbol(g.expiry).symbol(g.exchange)
+          .symbol(g.tradingClass).f64(g.impliedVol).f64(g.delta).f64(g.gamma).f64(g.vega).f64(g.theta)
+          .f64(g.optPrice).f64(g.undPrice).end();
+    }
+
+    inline ColumnSchema barSchema() {
+      using T = ColumnType;
+      return {{"time", T::I64}, {"symbol", T::SYMBOL}, {"open", T::F64},   {"high", T::F64}, {"low", T::F64},
+              {"close", T::F64}, {"volume", T::F64},   {"wap", T::F64},    {"count", T::I64}};
+    }
+
+    inline void bar(ColumnWriter& out, std::string_view symbol, const BarRow& b) {
+      out.i64(b.time).symbol(symbol).f64(b.open).f64(b.high).f64(b.low).f64(b.close).f64(b.volume).f64(b.wap)
+          .i64(b.count).end();
+    }
+
+    inline ColumnSchema fillSchema() {
+      using T = ColumnType;
+      return {{"ts_ns", T::I64},      {"symbol", T::SYMBOL},   {"sec_type", T::SYMBOL}, {"con_id", T::I64},
+              {"side", T::SYMBOL},    {"shares", T::F64},      {"price", T::F64},       {"avg_price", T::F64},
+              {"cum_qty", T::F64},    {"order_id", T::I64},    {"perm_id", T::I64},     {"account", T::SYMBOL},
+              {"exchange", T::SYMBOL}, {"exec_id", T::STRING}};
+    }
+
+    /// One execution as delivered by execDetails
+    inline void fill(ColumnWriter& out, int64_t tsNs, const Contract& contract, const Execution& e) {
+      out.i64(tsNs).symbol(contract.symbol).symbol(contract.secType).i64(contract.conId).symbol(e.side)
+          .f64(DecimalFunctions::decimalToDouble(e.shares)).f64(e.price).f64(e.avgPrice)
+          .f64(DecimalFunctions::decimalToDouble(e.cumQty)).i64(e.orderId).i64(e.permId).symbol(e.acctNumber)
+          .symbol(e.exchange).string(e.execId).end();
+    }
+
+  }  // namespace Export
+
+}  // namespace IB::Storage
+
+#endif  // QUANTDREAMCPP_COLUMN_EXPORT_H
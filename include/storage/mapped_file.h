@@ -0,0 +1,82 @@
+#ifndef QUANTDREAMCPP_MAPPED_FILE_H
+#define QUANTDREAMCPP_MAPPED_FILE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @file mapped_file.h
+ * @brief Read-only memory mapping of a file (POSIX)
+ *
+ * The mapping covers the file size at open time; data appended afterwards is not
+ * visible until the file is mapped again.
+ */
+
+namespace IB::Storage {
+
+/**
+ * @brief RAII read-only mmap of a whole file
+ *
+ * Obtain through `open()`, which returns nullptr if the file is missing or cannot be
+ * mapped. Empty files yield a valid object with `size() == 0`.
+ */
+class MappedFile {
+public:
+  static std::shared_ptr<const MappedFile> open(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      return nullptr;
+    }
+    auto file = std::shared_ptr<MappedFile>(new MappedFile());
+    file->size_ = static_cast<size_t>(st.st_size);
+    if (file->size_ > 0) {
+      void* p = ::mmap(nullptr, file->size_, PROT_READ, MAP_SHARED, fd, 0);
+      if (p == MAP_FAILED) {
+        ::close(fd);
+        return nullptr;
+      }
+      file->data_ = static_cast<const char*>(p);
+    }
+    ::close(fd);
+    return file;
+  }
+
+  ~MappedFile() {
+    if (data_) ::munmap(const_cast<char*>(data_), size_);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* data() const noexcept { return data_; }
+  size_t size() const noexcept { return size_; }
+
+  /// Hints the kernel that [offset, offset + length) will be read sequentially
+  void adviseSequential(size_t offset, size_t length) const noexcept {
+    if (!data_ || offset >= size_) return;
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t begin = offset / page * page;
+    ::madvise(const_cast<char*>(data_) + begin, std::min(length + (offset - begin), size_ - begin),
+              MADV_SEQUENTIAL);
+  }
+
+private:
+  MappedFile() = default;
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+} // namespace IB::Storage
+
+#endif  // QUANTDREAMCPP_MAPPED_FILE_H
@@ -0,0 +1,572 @@
+#ifndef QUANTDREAMCPP_TICK_ARCHIVE_H
+#define QUANTDREAMCPP_TICK_ARCHIVE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "helpers/clock.h"
+#include "helpers/logger.h"
+#include "helpers/spsc_ring.h"
+#include "storage/mapped_file.h"
+
+/**
+ * @file tick_archive.h
+ * @brief Append-only, memory-mapped tick archive partitioned by instrument and day
+ *
+ * **Layout** (`root/YYYYMMDD/<conId>.ticks` + `<conId>.idx`)
+ * - A segment holds one instrument-day: a 64-byte header followed by fixed-size
+ *   32-byte `TickRecord`s in non-decreasing timestamp order
+ * - The `.idx` file is a sparse time index: one `(timestamp, record)` entry every
+ *   `indexStride` records
+ * - The set of day directories and segment files is the conId directory; readers
+ *   build it by scanning the root
+ *
+ * **Reads** map segments read-only. A query for one instrument between two times is a
+ * binary search over the sparse index, a short search inside one index block, and a
+ * zero-copy `std::span` over the mapped records.
+ *
+ * **Writes** come from the IB reader thread through a lock-free SPSC ring; a background
+ * thread batches them per segment and appends with `pwrite`, so the reader thread never
+ * performs I/O.
+ */
+
+namespace IB::Storage {
+
+  /// One archived tick (32 bytes, trivially copyable)
+  struct TickRecord {
+    int64_t timestampNs = 0;   ///< Wall-clock (UTC) nanoseconds since epoch
+    double price = 0.0;        ///< Price for price ticks, 0 for size-only ticks
+    double size = 0.0;         ///< Size for size ticks and trade prints
+    int16_t field = 0;         ///< IB TickType
+    uint16_t flags = 0;        ///< Producer-defined (e.g. QuoteQuality bits)
+    uint32_t reserved = 0;
+  };
+  static_assert(sizeof(TickRecord) == 32, "TickRecord must stay 32 bytes");
+
+  constexpr char SEGMENT_MAGIC[8] = {'I', 'B', 'W', 'T', 'I', 'C', 'K', '\1'};
+  constexpr uint32_t SEGMENT_VERSION = 1;
+
+  /// Segment file header
+  struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    int64_t conId;
+    int32_t day;               ///< YYYYMMDD (UTC)
+    uint32_t indexStride;
+    char reserved[32];
+  };
+  static_assert(sizeof(SegmentHeader) == 64, "SegmentHeader must stay 64 bytes");
+
+  /// Sparse index entry: timestamp of record number `record`
+  struct IndexEntry {
+    int64_t timestampNs;
+    uint64_t record;
+  };
+
+  /// UTC calendar day (YYYYMMDD) containing `tsNs`
+  inline int dayOf(int64_t tsNs) {
+    using namespace std::chrono;
+    const year_month_day ymd{floor<days>(sys_time<nanoseconds>(nanoseconds(tsNs)))};
+    return static_cast<int>(ymd.year()) * 10000 + static_cast<int>(static_cast<unsigned>(ymd.month())) * 100 +
+           static_cast<int>(static_cast<unsigned>(ymd.day()));
+  }
+
+  /// UTC midnight of `day` (YYYYMMDD) in nanoseconds since epoch
+  inline int64_t dayStartNs(int day) {
+    using namespace std::chrono;
+    const year_month_day ymd{year(day / 10000), month(static_cast<unsigned>(day / 100 % 100)),
+                             std::chrono::day(static_cast<unsigned>(day % 100))};
+    return duration_cast<nanoseconds>(sys_days(ymd).time_since_epoch()).count();
+  }
+
+  constexpr int64_t NS_PER_DAY = 86'400'000'000'000LL;
+
+  inline std::filesystem::path segmentPath(const std::filesystem::path& root, long conId, int day,
+                                           const char* ext = ".ticks") {
+    return root / std::to_string(day) / (std::to_string(conId) + ext);
+  }
+
+  /**
+   * @brief Tuning for TickArchiveWriter
+   */
+  struct TickArchiveConfig {
+    std::filesystem::path root;                              ///< Archive root directory
+    size_t ringBytes = 16u << 20;                            ///< Reader thread → writer buffer
+    size_t flushRecords = 1024;                              ///< Per-segment batch size
+    std::chrono::milliseconds flushInterval{200};            ///< Max latency until records hit the file
+    uint32_t indexStride = 256;                              ///< Records per sparse index entry
+  };
+
+  // --------------------------------------------------------------------------
+  // Writer
+  // --------------------------------------------------------------------------
+
+  /**
+   * @brief Background appender of ticks to the archive
+   *
+   * `append()` must be called from a single thread (the IB reader thread). Timestamps
+   * are clamped to be non-decreasing per segment, which keeps binary search valid even
+   * if the wall clock steps back.
+   *
+   * Example usage:
+   * @code
+   * IB::Storage::TickArchiveWriter archive({.root = "/data/ticks"});
+   * ib.tickArchive = &archive;   // IBMarketWrapper archives every tick it receives
+   * @endcode
+   */
+  class TickArchiveWriter {
+  public:
+    explicit TickArchiveWriter(TickArchiveConfig config)
+      : config_(std::move(config)), ring_(config_.ringBytes) {
+      std::filesystem::create_directories(config_.root);
+      running_.store(true, std::memory_order_release);
+      thread_ = std::thread([this] { run(); });
+    }
+
+    ~TickArchiveWriter() { stop(); }
+
+    TickArchiveWriter(const TickArchiveWriter&) = delete;
+    TickArchiveWriter& operator=(const TickArchiveWriter&) = delete;
+
+    /**
+     * @brief Queues a tick (producer thread, never blocks)
+     * @return False if the ring was full and the tick was dropped
+     */
+    bool append(long conId, const TickRecord& record) noexcept {
+      const Entry e{static_cast<int64_t>(conId), record};
+      if (ring_.tryWrite(&e, sizeof(e))) {
+        appended_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    /// Drains every queued tick to disk and closes all segments
+    void stop() {
+      if (!running_.exchange(false, std::memory_order_acq_rel)) return;
+      if (thread_.joinable()) thread_.join();
+      LOG_INFO("[TickArchive] Stopped: ", written_.load(), " ticks written, ", dropped_.load(), " dropped");
+    }
+
+    uint64_t appended() const noexcept { return appended_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t written() const noexcept { return written_.load(std::memory_order_relaxed); }
+    const std::filesystem::path& root() const noexcept { return config_.root; }
+
+  private:
+    struct Entry {
+      int64_t conId;
+      TickRecord record;
+    };
+
+    struct Segment {
+      int fd = -1;
+      int idxFd = -1;
+      long conId = 0;
+      int day = 0;
+      uint64_t count = 0;                 ///< Records on disk
+      uint64_t indexed = 0;               ///< Index entries on disk
+      int64_t lastTs = INT64_MIN;
+      std::vector<TickRecord> pending;
+      std::vector<IndexEntry> pendingIndex;
+    };
+
+    static uint64_t key(long conId, int day) {
+      return (static_cast<uint64_t>(static_cast<uint32_t>(conId)) << 32) | static_cast<uint32_t>(day);
+    }
+
+    void run() {
+      constexpr size_t batch = 4096;
+      std::vector<Entry> buf(batch);
+      auto lastFlush = std::chrono::steady_clock::now();
+      for (;;) {
+        const bool stopping = !running_.load(std::memory_order_acquire);
+        const size_t n = ring_.read(buf.data(), batch * sizeof(Entry)) / sizeof(Entry);
+        for (size_t i = 0; i < n; ++i) ingest(buf[i]);
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastFlush >= config_.flushInterval || (stopping && n == 0)) {
+          flushAll();
+          lastFlush = now;
+        }
+        if (n == 0) {
+          if (stopping) break;
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      }
+      for (auto& [k, seg] : segments_) close(seg);
+      segments_.clear();
+    }
+
+    void ingest(const Entry& e) {
+      TickRecord rec = e.record;
+      const int day = dayOf(rec.timestampNs);
+      newestDay_ = std::max(newestDay_, day);
+
+      Segment& seg = segments_[key(static_cast<long>(e.conId), day)];
+      if (seg.fd < 0 && !open(seg, static_cast<long>(e.conId), day)) return;
+
+      rec.timestampNs = std::max(rec.timestampNs, seg.lastTs);
+      seg.lastTs = rec.timestampNs;
+      const uint64_t n = seg.count + seg.pending.size();
+      if (n % config_.indexStride == 0) seg.pendingIndex.push_back({rec.timestampNs, n});
+      seg.pending.push_back(rec);
+      if (seg.pending.size() >= config_.flushRecords) flush(seg);
+    }
+
+    bool open(Segment& seg, long conId, int day) {
+      seg.conId = conId;
+      seg.day = day;
+      const auto path = segmentPath(config_.root, conId, day);
+      std::error_code ec;
+      std::filesystem::create_directories(path.parent_path(), ec);
+
+      seg.fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+      seg.idxFd = ::open(segmentPath(config_.root, conId, day, ".idx").c_str(), O_RDWR | O_CREAT, 0644);
+      if (seg.fd < 0 || seg.idxFd < 0) {
+        LOG_ERROR("[TickArchive] Cannot open segment ", path.string());
+        close(seg);
+        return false;
+      }
+
+      // Any failure below leaves the segment closed and reset, so the next tick retries cleanly
+      auto fail = [&](const char* what) {
+        LOG_ERROR("[TickArchive] ", what, " failed for segment ", path.string());
+        close(seg);
+        seg.count = seg.indexed = 0;
+        seg.lastTs = INT64_MIN;
+        seg.pendingIndex.clear();
+        return false;
+      };
+
+      struct stat st{};
+      if (::fstat(seg.fd, &st) != 0) return fail("fstat");
+      if (static_cast<size_t>(st.st_size) < sizeof(SegmentHeader)) {
+        SegmentHeader h{};
+        std::memcpy(h.magic, SEGMENT_MAGIC, sizeof(h.magic));
+        h.version = SEGMENT_VERSION;
+        h.recordSize = sizeof(TickRecord);
+        h.conId = conId;
+        h.day = day;
+        h.indexStride = config_.indexStride;
+        if (::ftruncate(seg.fd, 0) != 0 || ::ftruncate(seg.idxFd, 0) != 0) return fail("ftruncate");
+        if (!writeAll(seg.fd, &h, sizeof(h), 0)) return fail("Header write");
+        return true;
+      }
+
+      // Reopen after a restart: drop a torn tail record, then resync the index
+      seg.count = (static_cast<uint64_t>(st.st_size) - sizeof(SegmentHeader)) / sizeof(TickRecord);
+      if (::ftruncate(seg.fd, static_cast<off_t>(recordOffset(seg.count))) != 0) return fail("ftruncate");
+      if (seg.count > 0) {
+        TickRecord last{};
+        if (!readAll(seg.fd, &last, sizeof(last), recordOffset(seg.count - 1))) return fail("pread");
+        seg.lastTs = last.timestampNs;
+      }
+      const uint64_t expected = (seg.count + config_.indexStride - 1) / config_.indexStride;
+      if (::fstat(seg.idxFd, &st) != 0) return fail("fstat");
+      seg.indexed = std::min<uint64_t>(static_cast<uint64_t>(st.st_size) / sizeof(IndexEntry), expected);
+      if (::ftruncate(seg.idxFd, static_cast<off_t>(seg.indexed * sizeof(IndexEntry))) != 0) return fail("ftruncate");
+      for (uint64_t i = seg.indexed; i < expected; ++i) {
+        TickRecord r{};
+        if (!readAll(seg.fd, &r, sizeof(r), recordOffset(i * config_.indexStride))) return fail("pread");
+        seg.pendingIndex.push_back({r.timestampNs, i * config_.indexStride});
+      }
+      return true;
+    }
+
+    static uint64_t recordOffset(uint64_t record) {
+      return sizeof(SegmentHeader) + record * sizeof(TickRecord);
+    }
+
+    /// Records first, then index entries, so the index never points past the data
+    void flush(Segment& seg) {
+      if (seg.fd < 0) return;
+      if (!seg.pending.empty()) {
+        if (!writeAll(seg.fd, seg.pending.data(), seg.pending.size() * sizeof(TickRecord), recordOffset(seg.count))) {
+          LOG_ERROR("[TickArchive] Write failed for conId=", seg.conId, " day=", seg.day);
+          dropped_.fetch_add(seg.pending.size(), std::memory_order_relaxed);
+        } else {
+          seg.count += seg.pending.size();
+          written_.fetch_add(seg.pending.size(), std::memory_order_relaxed);
+        }
+        seg.pending.clear();
+      }
+      if (!seg.pendingIndex.empty()) {
+        // Keep only entries for records that reached the file
+        auto end = std::partition_point(seg.pendingIndex.begin(), seg.pendingIndex.end(),
+                                        [&](const IndexEntry& e) { return e.record < seg.count; });
+        const size_t n = static_cast<size_t>(end - seg.pendingIndex.begin());
+        if (n && writeAll(seg.idxFd, seg.pendingIndex.data(), n * sizeof(IndexEntry), seg.indexed * sizeof(IndexEntry)))
+          seg.indexed += n;
+        seg.pendingIndex.clear();
+      }
+    }
+
+    /// Flushes every segment and closes those of past days
+    void flushAll() {
+      for (auto it = segments_.begin(); it != segments_.end();) {
+        flush(it->second);
+        if (it->second.day < newestDay_) {
+          close(it->second);
+          it = segments_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+
+    static void close(Segment& seg) {
+      if (seg.fd >= 0) ::close(seg.fd);
+      if (seg.idxFd >= 0) ::close(seg.idxFd);
+      seg.fd = seg.idxFd = -1;
+    }
+
+    static bool writeAll(int fd, const void* data, size_t n, uint64_t offset) {
+      const char* p = static_cast<const char*>(data);
+      while (n > 0) {
+        const ssize_t w = ::pwrite(fd, p, n, static_cast<off_t>(offset));
+        if (w <= 0) return false;
+        p += w;
+        n -= static_cast<size_t>(w);
+        offset += static_cast<uint64_t>(w);
+      }
+      return true;
+    }
+
+    static bool readAll(int fd, void* data, size_t n, uint64_t offset) {
+      char* p = static_cast<char*>(data);
+      while (n > 0) {
+        const ssize_t r = ::pread(fd, p, n, static_cast<off_t>(offset));
+        if (r <= 0) return false;
+        p += r;
+        n -= static_cast<size_t>(r);
+        offset += static_cast<uint64_t>(r);
+      }
+      return true;
+    }
+
+    TickArchiveConfig config_;
+    IB::Helpers::SpscByteRing ring_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> appended_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> written_{0};
+
+    // Writer-thread state
+    std::unordered_map<uint64_t, Segment> segments_;
+    int newestDay_ = 0;
+  };
+
+  // --------------------------------------------------------------------------
+  // Reader
+  // --------------------------------------------------------------------------
+
+  /**
+   * @brief Contiguous run of archived ticks from one segment
+   *
+   * `ticks` points into the mapped file; `file` keeps the mapping alive.
+   */
+  struct TickSlice {
+    long conId = 0;
+    int day = 0;
+    std::span<const TickRecord> ticks;
+    std::shared_ptr<const MappedFile> file;
+  };
+
+  /**
+   * @brief Read-only, thread-safe view of a tick archive
+   *
+   * Segments are mapped on first use and remapped when they have grown, so a reader
+   * can follow an archive that is still being written.
+   *
+   * Example usage:
+   * @code
+   * IB::Storage::TickArchiveReader archive("/data/ticks");
+   * for (const auto& slice : archive.query(265598, fromNs, toNs))
+   *   for (const auto& t : slice.ticks) ...
+   * @endcode
+   */
+  class TickArchiveReader {
+  public:
+    explicit TickArchiveReader(std::filesystem::path root) : root_(std::move(root)) { rescan(); }
+
+    /// Rebuilds the conId directory from the files under the root
+    void rescan() {
+      std::map<long, std::vector<int>> dir;
+      std::error_code ec;
+      for (const auto& dayDir : std::filesystem::directory_iterator(root_, ec)) {
+        if (!dayDir.is_directory()) continue;
+        const std::string name = dayDir.path().filename().string();
+        if (name.size() != 8 || !std::all_of(name.begin(), name.end(), ::isdigit)) continue;
+        const int day = std::stoi(name);
+        for (const auto& f : std::filesystem::directory_iterator(dayDir.path(), ec)) {
+          // Raw segments and their compressed copies (see tick_codec.h)
+          if (f.path().extension() != ".ticks" && f.path().extension() != ".tcb") continue;
+          try {
+            dir[std::stol(f.path().stem().string())].push_back(day);
+          } catch (...) {}
+        }
+      }
+      for (auto& [conId, days] : dir) {
+        std::sort(days.begin(), days.end());
+        days.erase(std::unique(days.begin(), days.end()), days.end());
+      }
+      std::lock_guard<std::mutex> lk(m_);
+      directory_ = std::move(dir);
+    }
+
+    const std::filesystem::path& root() const noexcept { return root_; }
+
+    /// Instruments present in the archive
+    std::vector<long> instruments() const {
+      std::lock_guard<std::mutex> lk(m_);
+      std::vector<long> out;
+      out.reserve(directory_.size());
+      for (const auto& [conId, days] : directory_) out.push_back(conId);
+      return out;
+    }
+
+    /// Days (YYYYMMDD) archived for `conId`, raw or compressed
+    std::vector<int> days(long conId) const {
+      std::lock_guard<std::mutex> lk(m_);
+      auto it = directory_.find(conId);
+      return it == directory_.end() ? std::vector<int>{} : it->second;
+    }
+
+    /**
+     * @brief Ticks of `conId` with `fromNs <= timestamp < toNs`, one slice per day
+     *
+     * Covers raw segments only; days that exist solely as compressed `.tcb` files are
+     * read through `ArchiveQuery` (archive_query.h).
+     */
+    std::vector<TickSlice> query(long conId, int64_t fromNs, int64_t toNs) {
+      std::vector<TickSlice> out;
+      if (toNs <= fromNs) return out;
+      const int firstDay = dayOf(fromNs);
+      const int lastDay = dayOf(toNs - 1);
+      for (int day : days(conId)) {
+        if (day < firstDay || day > lastDay) continue;
+        auto seg = segment(conId, day);
+        if (!seg || seg->count == 0) continue;
+        const size_t lo = seg->locate(fromNs);
+        const size_t hi = seg->locate(toNs);
+        if (hi > lo) out.push_back({conId, day, seg->records().subspan(lo, hi - lo), seg->ticks});
+      }
+      return out;
+    }
+
+    /// Every archived tick of `conId` on `day`
+    std::vector<TickSlice> day(long conId, int day) {
+      auto seg = segment(conId, day);
+      if (!seg || seg->count == 0) return {};
+      return {{conId, day, seg->records(), seg->ticks}};
+    }
+
+    /// Number of ticks in [fromNs, toNs) without touching the records in between
+    size_t count(long conId, int64_t fromNs, int64_t toNs) {
+      size_t n = 0;
+      for (const auto& s : query(conId, fromNs, toNs)) n += s.ticks.size();
+      return n;
+    }
+
+  private:
+    /// One mapped segment with its sparse index
+    struct Mapped {
+      std::shared_ptr<const MappedFile> ticks;
+      std::shared_ptr<const MappedFile> index;
+      size_t fileSize = 0;
+      size_t count = 0;
+      size_t indexCount = 0;
+
+      std::span<const TickRecord> records() const {
+        return {reinterpret_cast<const TickRecord*>(ticks->data() + sizeof(SegmentHeader)), count};
+      }
+
+      std::span<const IndexEntry> entries() const {
+        if (!index || indexCount == 0) return {};
+        return {reinterpret_cast<const IndexEntry*>(index->data()), indexCount};
+      }
+
+      /// Position of the first record with timestamp >= ts
+      size_t locate(int64_t ts) const {
+        const auto idx = entries();
+        auto e = std::lower_bound(idx.begin(), idx.end(), ts,
+                                  [](const IndexEntry& a, int64_t t) { return a.timestampNs < t; });
+        const size_t begin = e == idx.begin() ? 0 : static_cast<size_t>((e - 1)->record);
+        const size_t end = e == idx.end() ? count : std::min<size_t>(count, static_cast<size_t>(e->record) + 1);
+        const auto recs = records();
+        return static_cast<size_t>(std::lower_bound(recs.begin() + static_cast<ptrdiff_t>(begin),
+                                                    recs.begin() + static_cast<ptrdiff_t>(end), ts,
+                                                    [](const TickRecord& r, int64_t t) { return r.timestampNs < t; }) -
+                                   recs.begin());
+      }
+    };
+
+    std::shared_ptr<const Mapped> segment(long conId, int day) {
+      const auto path = segmentPath(root_, conId, day);
+      struct stat st{};
+      if (::stat(path.c_str(), &st) != 0) return nullptr;
+      const auto size = static_cast<size_t>(st.st_size);
+
+      const auto k = std::make_pair(conId, day);
+      {
+        std::lock_guard<std::mutex> lk(m_);
+        if (auto it = cache_.find(k); it != cache_.end() && it->second->fileSize == size) return it->second;
+      }
+
+      auto seg = std::make_shared<Mapped>();
+      seg->ticks = MappedFile::open(path.string());
+      if (!seg->ticks || seg->ticks->size() < sizeof(SegmentHeader)) return nullptr;
+      SegmentHeader h{};
+      std::memcpy(&h, seg->ticks->data(), sizeof(h));
+      if (std::memcmp(h.magic, SEGMENT_MAGIC, sizeof(h.magic)) != 0 || h.recordSize != sizeof(TickRecord)) {
+        LOG_WARN("[TickArchive] Skipping invalid segment ", path.string());
+        return nullptr;
+      }
+      seg->fileSize = seg->ticks->size();
+      seg->count = (seg->fileSize - sizeof(SegmentHeader)) / sizeof(TickRecord);
+
+      seg->index = MappedFile::open(segmentPath(root_, conId, day, ".idx").string());
+      if (seg->index) {
+        // The index may run ahead of the mapped data while the writer is active
+        const auto* e = reinterpret_cast<const IndexEntry*>(seg->index->data());
+        size_t n = seg->index->size() / sizeof(IndexEntry);
+        while (n > 0 && e[n - 1].record >= seg->count) --n;
+        seg->indexCount = n;
+      }
+
+      std::lock_guard<std::mutex> lk(m_);
+      cache_[k] = seg;
+      return seg;
+    }
+
+    std::filesystem::path root_;
+    mutable std::mutex m_;
+    std::map<long, std::vector<int>> directory_;                       ///< conId → archived days
+    std::map<std::pair<long, int>, std::shared_ptr<const Mapped>> cache_;  ///< Mapped segments
+  };
+
+}  // namespace IB::Storage
+
+#endif  // QUANTDREAMCPP_TICK_ARCHIVE_H
@@ -0,0 +1,638 @@
+#ifndef QUANTDREAMCPP_TICK_CODEC_H
+#define QUANTDREAMCPP_TICK_CODEC_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "helpers/logger.h"
+#include "storage/mapped_file.h"
+#include "storage/tick_archive.h"
+
+/**
+ * @file tick_codec.h
+ * @brief Columnar block compression for archived ticks
+ *
+ * A block holds up to a few thousand `TickRecord`s of one instrument, split into five
+ * integer columns, each stored as zig-zag residuals of a predictor:
+ *
+ * | Column    | Representation                          | Predictor          |
+ * |-----------|-----------------------------------------|--------------------|
+ * | timestamp | nanoseconds                             | delta-of-delta     |
+ * | price     | integer multiples of the tick size      | delta              |
+ * | size      | integer shares / contracts              | delta              |
+ * | field     | IB TickType                             | delta              |
+ * | flags     | quality bits                            | delta              |
+ *
+ * Prices that are not exact multiples of the tick size, and fractional sizes, fall back
+ * to raw 8-byte doubles for that block, so the codec is always lossless. When the tick
+ * size is the reciprocal of an integer (0.01, 0.0001, 0.25), prices are rebuilt as
+ * `q / ticksPerUnit`: that is the double nearest to the decimal price, which is what
+ * parsing IB's decimal quotes yields, whereas `q * 0.01` misses about one price in seven.
+ *
+ * **Residual packing** (per column, chosen by `CodecOptions::packing`)
+ * - `VARINT`: LEB128 varints (smallest for skewed residuals)
+ * - `BITPACK`: frames of 128 values packed at the frame's maximal bit width; decoding
+ *   runs width-specialised unpack kernels without branches
+ * - `AUTO`: whichever of the two is smaller for the column
+ *
+ * Zig-zag decoding and prefix sums use AVX2 when available.
+ */
+
+namespace IB::Storage {
+
+  enum class Packing : uint8_t { AUTO, VARINT, BITPACK };
+
+  struct CodecOptions {
+    double tickSize = 0.01;           ///< Price grid used for integer price encoding
+    Packing packing = Packing::AUTO;
+    uint32_t blockRecords = 4096;     ///< Records per block when compressing a segment
+  };
+
+  namespace Codec {
+
+    constexpr size_t FRAME = 128;     ///< Values per bit-packed frame
+    constexpr size_t PADDING = 8;     ///< Slack after a block so unpack kernels may over-read
+
+    inline uint64_t zigzag(int64_t v) noexcept {
+      return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+    }
+
+    inline int64_t unzigzag(uint64_t z) noexcept {
+      return static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1);
+    }
+
+    inline unsigned bitWidth(uint64_t v) noexcept {
+      return v == 0 ? 0u : 64u - static_cast<unsigned>(__builtin_clzll(v));
+    }
+
+    inline void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+      while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+      }
+      out.push_back(static_cast<uint8_t>(v));
+    }
+
+    inline size_t varintSize(uint64_t v) noexcept { return v == 0 ? 1 : (bitWidth(v) + 6) / 7; }
+
+    /// Decodes `n` varints; returns bytes consumed or 0 on overrun
+    inline size_t getVarints(const uint8_t* p, size_t avail, uint64_t* out, size_t n) noexcept {
+      const uint8_t* const begin = p;
+      const uint8_t* const end = p + avail;
+      for (size_t i = 0; i < n; ++i) {
+        uint64_t v = 0;
+        unsigned shift = 0;
+        for (;;) {
+          if (p == end || shift > 63) return 0;
+          const uint8_t b = *p++;
+          v |= static_cast<uint64_t>(b & 0x7F) << shift;
+          if (b < 0x80) break;
+          shift += 7;
+        }
+        out[i] = v;
+      }
+      return static_cast<size_t>(p - begin);
+    }
+
+    inline uint64_t load64(const uint8_t* p) noexcept {
+      uint64_t v;
+      std::memcpy(&v, p, sizeof(v));
+      return v;
+    }
+
+    /// Packs `n` (<= FRAME) values at `width` bits
+    inline void packFrame(std::vector<uint8_t>& out, const uint64_t* v, size_t n, unsigned width) {
+      const size_t at = out.size();
+      out.resize(at + (n * width + 7) / 8, 0);
+      if (width == 0) return;
+      uint8_t* dst = out.data() + at;
+      for (size_t i = 0; i < n; ++i) {
+        const size_t bit = i * width;
+        unsigned __int128 x = static_cast<unsigned __int128>(v[i]) << (bit & 7);
+        for (size_t b = bit >> 3; x != 0; ++b, x >>= 8) dst[b] |= static_cast<uint8_t>(x);
+      }
+    }
+
+    /// Width-specialised unpack: constant shifts and masks once the loop is unrolled
+    template <unsigned W>
+    void unpackFrame(const uint8_t* in, uint64_t* out, size_t n) noexcept {
+      if constexpr (W == 0) {
+        std::fill(out, out + n, 0);
+      } else if constexpr (W <= 56) {
+        constexpr uint64_t mask = (uint64_t{1} << W) - 1;
+        for (size_t i = 0; i < n; ++i) {
+          const size_t bit = i * W;
+          out[i] = (load64(in + (bit >> 3)) >> (bit & 7)) & mask;
+        }
+      } else {
+        constexpr uint64_t mask = W == 64 ? ~uint64_t{0} : (uint64_t{1} << W) - 1;
+        for (size_t i = 0; i < n; ++i) {
+          const size_t bit = i * W;
+          const unsigned s = bit & 7;
+          uint64_t v = load64(in + (bit >> 3)) >> s;
+          if (s) v |= static_cast<uint64_t>(in[(bit >> 3) + 8]) << (64 - s);
+          out[i] = v & mask;
+        }
+      }
+    }
+
+    using UnpackFn = void (*)(const uint8_t*, uint64_t*, size_t) noexcept;
+
+    template <size_t... W>
+    constexpr std::array<UnpackFn, sizeof...(W)> makeUnpackTable(std::index_sequence<W...>) {
+      return {&unpackFrame<static_cast<unsigned>(W)>...};
+    }
+
+    inline constexpr auto UNPACK = makeUnpackTable(std::make_index_sequence<65>{});
+
+    /// In place: v[i] = unzigzag(v[i])
+    inline void unzigzagAll(uint64_t* v, size_t n) noexcept {
+      size_t i = 0;
+#if defined(__AVX2__)
+      const __m256i one = _mm256_set1_epi64x(1);
+      const __m256i zero = _mm256_setzero_si256();
+      for (; i + 4 <= n; i += 4) {
+        __m256i z = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i));
+        __m256i sign = _mm256_sub_epi64(zero, _mm256_and_si256(z, one));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(v + i), _mm256_xor_si256(_mm256_srli_epi64(z, 1), sign));
+      }
+#endif
+      for (; i < n; ++i) v[i] = static_cast<uint64_t>(unzigzag(v[i]));
+    }
+
+    /// In place inclusive prefix sum starting from `carry`
+    inline void prefixSum(int64_t* v, size_t n, int64_t carry) noexcept {
+      size_t i = 0;
+#if defined(__AVX2__)
+      __m256i c = _mm256_set1_epi64x(carry);
+      for (; i + 4 <= n; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i));
+        // [a b c d] + [0 a b c] + [0 0 a a+b]
+        x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, 0x90), _mm256_setzero_si256(), 0x03));
+        x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, 0x40), _mm256_setzero_si256(), 0x0F));
+        x = _mm256_add_epi64(x, c);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(v + i), x);
+        c = _mm256_permute4x64_epi64(x, 0xFF);
+      }
+      if (i > 0) carry = v[i - 1];
+#endif
+      for (; i < n; ++i) v[i] = carry += v[i];
+    }
+
+  }  // namespace Codec
+
+  /// Decoded block in column form
+  struct TickColumns {
+    std::vector<int64_t> timestampNs;
+    std::vector<double> price;
+    std::vector<double> size;
+    std::vector<int16_t> field;
+    std::vector<uint16_t> flags;
+
+    size_t rows() const noexcept { return timestampNs.size(); }
+  };
+
+  /**
+   * @brief Encoder / decoder of single tick blocks
+   *
+   * A decoder instance keeps scratch buffers between calls; use one per thread.
+   *
+   * Example usage:
+   * @code
+   * std::vector<uint8_t> bytes;
+   * IB::Storage::TickBlockCodec::encode(ticks, {.tickSize = 0.01}, bytes);
+   *
+   * IB::Storage::TickBlockCodec codec;
+   * std::vector<IB::Storage::TickRecord> out;
+   * codec.decode(bytes.data(), bytes.size(), out);
+   * @endcode
+   */
+  class TickBlockCodec {
+  public:
+    static constexpr uint32_t BLOCK_MAGIC = 0x4B4C4254;   // "TBLK"
+
+    struct BlockHeader {
+      uint32_t magic;
+      uint32_t count;
+      uint32_t bytes;          ///< Whole block including header and padding
+      uint32_t ticksPerUnit;   ///< Prices are q / ticksPerUnit; 0 = q * tickSize (non-reciprocal tick, older blocks)
+      int64_t firstTs;
+      int64_t lastTs;
+      double tickSize;
+    };
+
+    /// Grid of the size column: plain integers
+    static constexpr BlockHeader UNIT{0, 0, 0, 0, 0, 0, 1.0};
+
+    /// 1 / tickSize when that is an integer, else 0
+    static uint32_t ticksPerUnit(double tickSize) noexcept {
+      if (!(tickSize > 0.0) || tickSize > 1.0) return 0;
+      const double inverse = std::nearbyint(1.0 / tickSize);
+      return inverse <= 1e9 && std::fabs(inverse * tickSize - 1.0) < 1e-12 ? static_cast<uint32_t>(inverse) : 0;
+    }
+
+    /// Price of `q` ticks on the grid of a block header
+    static double fromTicks(double q, const BlockHeader& h) noexcept {
+      return h.ticksPerUnit ? q / h.ticksPerUnit : q * h.tickSize;
+    }
+
+    /**
+     * @brief Appends one compressed block holding `ticks` to `out`
+     */
+    static void encode(std::span<const TickRecord> ticks, const CodecOptions& options, std::vector<uint8_t>& out) {
+      const size_t start = out.size();
+      const size_t n = ticks.size();
+      BlockHeader h{BLOCK_MAGIC, static_cast<uint32_t>(n), 0, ticksPerUnit(options.tickSize),
+                    n ? ticks.front().timestampNs : 0, n ? ticks.back().timestampNs : 0, options.tickSize};
+      out.resize(start + sizeof(h));
+
+      std::vector<int64_t> col(n);
+      for (size_t i = 0; i < n; ++i) col[i] = ticks[i].timestampNs;
+      putColumn(out, col, 2, options.packing);
+
+      bool exact = options.tickSize > 0.0;
+      for (size_t i = 0; i < n && exact; ++i) {
+        const double q = h.ticksPerUnit ? std::nearbyint(ticks[i].price * h.ticksPerUnit)
+                                        : std::nearbyint(ticks[i].price / options.tickSize);
+        exact = std::fabs(q) < 9e15 && fromTicks(q, h) == ticks[i].price;
+        col[i] = static_cast<int64_t>(q);
+      }
+      if (exact) putColumn(out, col, 1, options.packing);
+      else putRaw(out, ticks, &TickRecord::price);
+
+      bool integral = true;
+      for (size_t i = 0; i < n && integral; ++i) {
+        integral = std::fabs(ticks[i].size) < 9e15 && std::trunc(ticks[i].size) == ticks[i].size;
+        col[i] = static_cast<int64_t>(ticks[i].size);
+      }
+      if (integral) putColumn(out, col, 1, options.packing);
+      else putRaw(out, ticks, &TickRecord::size);
+
+      for (size_t i = 0; i < n; ++i) col[i] = ticks[i].field;
+      putColumn(out, col, 1, options.packing);
+      for (size_t i = 0; i < n; ++i) col[i] = ticks[i].flags;
+      putColumn(out, col, 1, options.packing);
+
+      out.resize(out.size() + Codec::PADDING, 0);
+      h.bytes = static_cast<uint32_t>(out.size() - start);
+      std::memcpy(out.data() + start, &h, sizeof(h));
+    }
+
+    /**
+     * @brief Decodes the block at `data` into columns (replacing their contents)
+     * @return Bytes consumed, or 0 if the block is malformed
+     */
+    size_t decode(const uint8_t* data, size_t avail, TickColumns& out) {
+      BlockHeader h{};
+      if (avail < sizeof(h)) return 0;
+      std::memcpy(&h, data, sizeof(h));
+      if (h.magic != BLOCK_MAGIC || h.bytes > avail || h.bytes < sizeof(h) + Codec::PADDING) return 0;
+      const size_t n = h.count;
+      const uint8_t* p = data + sizeof(h);
+      const uint8_t* const end = data + h.bytes - Codec::PADDING;
+
+      out.timestampNs.resize(n);
+      out.price.resize(n);
+      out.size.resize(n);
+      out.field.resize(n);
+      out.flags.resize(n);
+
+      if (!(p = getColumn(p, end, n, out.timestampNs.data()))) return 0;
+      if (!(p = getDoubles(p, end, n, h, out.price.data()))) return 0;
+      if (!(p = getDoubles(p, end, n, UNIT, out.size.data()))) return 0;
+      scratch_.resize(n);
+      if (!(p = getColumn(p, end, n, scratch_.data()))) return 0;
+      for (size_t i = 0; i < n; ++i) out.field[i] = static_cast<int16_t>(scratch_[i]);
+      if (!(p = getColumn(p, end, n, scratch_.data()))) return 0;
+      for (size_t i = 0; i < n; ++i) out.flags[i] = static_cast<uint16_t>(scratch_[i]);
+      return h.bytes;
+    }
+
+    /**
+     * @brief Decodes the block at `data`, appending records to `out`
+     * @return Bytes consumed, or 0 if the block is malformed
+     */
+    size_t decode(const uint8_t* data, size_t avail, std::vector<TickRecord>& out) {
+      const size_t used = decode(data, avail, columns_);
+      if (!used) return 0;
+      const size_t n = columns_.rows();
+      const size_t at = out.size();
+      out.resize(at + n);
+      TickRecord* r = out.data() + at;
+      for (size_t i = 0; i < n; ++i) {
+        r[i].timestampNs = columns_.timestampNs[i];
+        r[i].price = columns_.price[i];
+        r[i].size = columns_.size[i];
+        r[i].field = columns_.field[i];
+        r[i].flags = columns_.flags[i];
+        r[i].reserved = 0;
+      }
+      return used;
+    }
+
+    /// Reads the header of the block at `data` (false if malformed)
+    static bool peek(const uint8_t* data, size_t avail, BlockHeader& h) noexcept {
+      if (avail < sizeof(h)) return false;
+      std::memcpy(&h, data, sizeof(h));
+      return h.magic == BLOCK_MAGIC && h.bytes <= avail;
+    }
+
+  private:
+    enum ColumnKind : uint8_t { INTEGER = 0, RAW = 1 };
+
+    struct ColumnHeader {
+      uint8_t kind;
+      uint8_t packing;       ///< Packing::VARINT or Packing::BITPACK
+      uint8_t order;         ///< Predictor order (0 value, 1 delta, 2 delta-of-delta)
+      uint8_t reserved;
+      uint32_t bytes;        ///< Payload bytes after this header
+      int64_t first;         ///< v[0]
+      int64_t firstDelta;    ///< v[1] - v[0] (order 2)
+    };
+
+    static void putColumn(std::vector<uint8_t>& out, const std::vector<int64_t>& v, uint8_t order, Packing packing) {
+      const size_t n = v.size();
+      ColumnHeader h{INTEGER, 0, order, 0, 0, n ? v[0] : 0, n > 1 ? v[1] - v[0] : 0};
+
+      // Residuals after the predictor; the first `order` values live in the header
+      const size_t skip = std::min<size_t>(order, n);
+      std::vector<uint64_t> res(n - skip);
+      for (size_t i = skip; i < n; ++i) {
+        int64_t r = v[i];
+        if (order >= 1) r = v[i] - v[i - 1];
+        if (order == 2) r -= v[i - 1] - v[i - 2];
+        res[i - skip] = Codec::zigzag(r);
+      }
+
+      size_t varBytes = 0, packBytes = 0;
+      if (packing != Packing::BITPACK)
+        for (uint64_t z : res) varBytes += Codec::varintSize(z);
+      if (packing != Packing::VARINT)
+        for (size_t f = 0; f < res.size(); f += Codec::FRAME) {
+          const size_t m = std::min(Codec::FRAME, res.size() - f);
+          uint64_t all = 0;
+          for (size_t i = 0; i < m; ++i) all |= res[f + i];
+          packBytes += 1 + (m * Codec::bitWidth(all) + 7) / 8;
+        }
+      const bool pack = packing == Packing::BITPACK || (packing == Packing::AUTO && packBytes <= varBytes);
+      h.packing = static_cast<uint8_t>(pack ? Packing::BITPACK : Packing::VARINT);
+
+      const size_t at = out.size();
+      out.resize(at + sizeof(h));
+      if (pack) {
+        for (size_t f = 0; f < res.size(); f += Codec::FRAME) {
+          const size_t m = std::min(Codec::FRAME, res.size() - f);
+          uint64_t all = 0;
+          for (size_t i = 0; i < m; ++i) all |= res[f + i];
+          const unsigned w = Codec::bitWidth(all);
+          out.push_back(static_cast<uint8_t>(w));
+          Codec::packFrame(out, res.data() + f, m, w);
+        }
+      } else {
+        for (uint64_t z : res) Codec::putVarint(out, z);
+      }
+      h.bytes = static_cast<uint32_t>(out.size() - at - sizeof(h));
+      std::memcpy(out.data() + at, &h, sizeof(h));
+    }
+
+    static void putRaw(std::vector<uint8_t>& out, std::span<const TickRecord> ticks, double TickRecord::*member) {
+      ColumnHeader h{RAW, 0, 0, 0, static_cast<uint32_t>(ticks.size() * sizeof(double)), 0, 0};
+      const size_t at = out.size();
+      out.resize(at + sizeof(h) + h.bytes);
+      std::memcpy(out.data() + at, &h, sizeof(h));
+      uint8_t* dst = out.data() + at + sizeof(h);
+      for (size_t i = 0; i < ticks.size(); ++i) std::memcpy(dst + i * sizeof(double), &(ticks[i].*member), sizeof(double));
+    }
+
+    /// Decodes an INTEGER column into `out`; returns the position after it or nullptr
+    const uint8_t* getColumn(const uint8_t* p, const uint8_t* end, size_t n, int64_t* out) {
+      ColumnHeader h{};
+      if (static_cast<size_t>(end - p) < sizeof(h)) return nullptr;
+      std::memcpy(&h, p, sizeof(h));
+      p += sizeof(h);
+      if (h.kind != INTEGER || h.order > 2 || h.bytes > static_cast<size_t>(end - p)) return nullptr;
+      const uint8_t* const next = p + h.bytes;
+      if (n == 0) return next;
+
+      const size_t skip = std::min<size_t>(h.order, n);
+      const size_t m = n - skip;
+      auto* z = reinterpret_cast<uint64_t*>(out + skip);
+      if (h.packing == static_cast<uint8_t>(Packing::BITPACK)) {
+        for (size_t f = 0; f < m; f += Codec::FRAME) {
+          const size_t k = std::min(Codec::FRAME, m - f);
+          if (p >= next) return nullptr;
+          const unsigned w = *p++;
+          const size_t bytes = (k * w + 7) / 8;
+          if (w > 64 || bytes > static_cast<size_t>(next - p)) return nullptr;
+          Codec::UNPACK[w](p, z + f, k);   // may over-read into the block padding
+          p += bytes;
+        }
+      } else if (m > 0 && !Codec::getVarints(p, h.bytes, z, m)) {
+        return nullptr;
+      }
+      Codec::unzigzagAll(z, m);
+
+      if (h.order == 0) return next;
+
+      out[0] = h.first;
+      if (h.order == 2 && n > 1) {
+        out[1] = h.firstDelta;                    // residuals become deltas, then values
+        if (n > 2) Codec::prefixSum(out + 2, m, h.firstDelta);
+      }
+      Codec::prefixSum(out + 1, n - 1, out[0]);
+      return next;
+    }
+
+    /// Decodes a price / size column: integers on the grid of `grid` (see fromTicks), or raw doubles
+    const uint8_t* getDoubles(const uint8_t* p, const uint8_t* end, size_t n, const BlockHeader& grid, double* out) {
+      ColumnHeader h{};
+      if (static_cast<size_t>(end - p) < sizeof(h)) return nullptr;
+      std::memcpy(&h, p, sizeof(h));
+      if (h.kind == RAW) {
+        p += sizeof(h);
+        if (h.bytes != n * sizeof(double) || h.bytes > static_cast<size_t>(end - p)) return nullptr;
+        std::memcpy(out, p, h.bytes);
+        return p + h.bytes;
+      }
+      scratch_.resize(n);
+      p = getColumn(p, end, n, scratch_.data());
+      if (!p) return nullptr;
+      if (grid.ticksPerUnit) {
+        const double divisor = grid.ticksPerUnit;
+        for (size_t i = 0; i < n; ++i) out[i] = static_cast<double>(scratch_[i]) / divisor;
+      } else {
+        for (size_t i = 0; i < n; ++i) out[i] = static_cast<double>(scratch_[i]) * grid.tickSize;
+      }
+      return p;
+    }
+
+    std::vector<int64_t> scratch_;
+    TickColumns columns_;
+  };
+
+  // --------------------------------------------------------------------------
+  // Compressed segments
+  // --------------------------------------------------------------------------
+
+  /**
+   * @brief Compressed copy of an archive segment (`<conId>.tcb` next to `<conId>.ticks`)
+   *
+   * Layout: 64-byte SegmentHeader (magic "IBWTCB"), blocks, a block directory of
+   * `BlockEntry`, and the directory offset as the last 8 bytes. Sealed (past) days can
+   * be compressed and their `.ticks` files removed.
+   */
+  class CompressedSegment {
+  public:
+    static constexpr char MAGIC[8] = {'I', 'B', 'W', 'T', 'C', 'B', '\0', '\1'};
+
+    struct BlockEntry {
+      int64_t firstTs;
+      int64_t lastTs;
+      uint64_t offset;
+      uint64_t count;
+    };
+
+    struct Stats {
+      uint64_t records = 0;
+      uint64_t rawBytes = 0;
+      uint64_t compressedBytes = 0;
+      double ratio() const { return compressedBytes ? static_cast<double>(rawBytes) / compressedBytes : 0.0; }
+    };
+
+    /**
+     * @brief Compresses `root/day/conId.ticks` into `root/day/conId.tcb`
+     */
+    static Stats compress(const std::filesystem::path& root, long conId, int day, const CodecOptions& options = {}) {
+      Stats stats;
+      auto file = MappedFile::open(segmentPath(root, conId, day).string());
+      if (!file || file->size() < sizeof(SegmentHeader)) {
+        LOG_WARN("[TickCodec] No segment for conId=", conId, " day=", day);
+        return stats;
+      }
+      const size_t n = (file->size() - sizeof(SegmentHeader)) / sizeof(TickRecord);
+      std::span<const TickRecord> ticks(reinterpret_cast<const TickRecord*>(file->data() + sizeof(SegmentHeader)), n);
+
+      std::vector<uint8_t> out(sizeof(SegmentHeader));
+      SegmentHeader h{};
+      std::memcpy(&h, file->data(), sizeof(h));
+      std::memcpy(h.magic, MAGIC, sizeof(h.magic));
+      std::memcpy(out.data(), &h, sizeof(h));
+
+      std::vector<BlockEntry> dir;
+      const size_t per = std::max<uint32_t>(options.blockRecords, 1);
+      for (size_t i = 0; i < n; i += per) {
+        const auto block = ticks.subspan(i, std::min(per, n - i));
+        dir.push_back({block.front().timestampNs, block.back().timestampNs, out.size(), block.size()});
+        TickBlockCodec::encode(block, options, out);
+      }
+      const uint64_t dirOffset = out.size();
+      const size_t at = out.size();
+      out.resize(at + dir.size() * sizeof(BlockEntry) + sizeof(uint64_t));
+      std::memcpy(out.data() + at, dir.data(), dir.size() * sizeof(BlockEntry));
+      std::memcpy(out.data() + out.size() - sizeof(uint64_t), &dirOffset, sizeof(dirOffset));
+
+      const auto path = segmentPath(root, conId, day, ".tcb");
+      std::ofstream f(path, std::ios::binary | std::ios::trunc);
+      f.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+      if (!f) {
+        LOG_ERROR("[TickCodec] Cannot write ", path.string());
+        return stats;
+      }
+      stats.records = n;
+      stats.rawBytes = file->size();
+      stats.compressedBytes = out.size();
+      LOG_INFO("[TickCodec] conId=", conId, " day=", day, ": ", n, " ticks, ", stats.ratio(), "x");
+      return stats;
+    }
+
+    /**
+     * @brief Maps a compressed segment; nullptr if missing or malformed
+     *
+     * The block directory is copied out of the mapping (it need not be aligned there), and
+     * every block must start between the segment header and the directory.
+     */
+    static std::shared_ptr<const CompressedSegment> open(const std::filesystem::path& path) {
+      auto file = MappedFile::open(path.string());
+      if (!file || file->size() < sizeof(SegmentHeader) + sizeof(uint64_t) ||
+          std::memcmp(file->data(), MAGIC, sizeof(MAGIC)) != 0)
+        return nullptr;
+      const size_t dirEnd = file->size() - sizeof(uint64_t);
+      uint64_t dirOffset = 0;
+      std::memcpy(&dirOffset, file->data() + dirEnd, sizeof(dirOffset));
+      if (dirOffset < sizeof(SegmentHeader) || dirOffset > dirEnd || (dirEnd - dirOffset) % sizeof(BlockEntry))
+        return nullptr;
+
+      auto seg = std::shared_ptr<CompressedSegment>(new CompressedSegment());
+      seg->blocks_.resize((dirEnd - dirOffset) / sizeof(BlockEntry));
+      std::memcpy(seg->blocks_.data(), file->data() + dirOffset, seg->blocks_.size() * sizeof(BlockEntry));
+      for (const auto& b : seg->blocks_) {
+        if (b.offset < sizeof(SegmentHeader) || b.offset >= dirOffset) {
+          LOG_WARN("[TickCodec] Corrupt block directory in ", path.string());
+          return nullptr;
+        }
+      }
+      seg->dataEnd_ = dirOffset;
+      seg->file_ = std::move(file);
+      std::memcpy(&seg->header_, seg->file_->data(), sizeof(SegmentHeader));
+      return seg;
+    }
+
+    const SegmentHeader& header() const noexcept { return header_; }
+    std::span<const BlockEntry> blocks() const noexcept { return blocks_; }
+
+    uint64_t records() const noexcept {
+      uint64_t n = 0;
+      for (const auto& b : blocks_) n += b.count;
+      return n;
+    }
+
+    /**
+     * @brief Appends ticks with `fromNs <= timestamp < toNs` to `out`
+     *
+     * Only blocks overlapping the range are decoded.
+     * @return False if a block is corrupt
+     */
+    bool read(TickBlockCodec& codec, int64_t fromNs, int64_t toNs, std::vector<TickRecord>& out) const {
+      auto b = std::lower_bound(blocks_.begin(), blocks_.end(), fromNs,
+                                [](const BlockEntry& e, int64_t t) { return e.lastTs < t; });
+      const auto* base = reinterpret_cast<const uint8_t*>(file_->data());
+      for (; b != blocks_.end() && b->firstTs < toNs; ++b) {
+        const size_t at = out.size();
+        if (!codec.decode(base + b->offset, dataEnd_ - b->offset, out)) return false;
+        // Trim the partial edges of the first and last block
+        auto lo = std::lower_bound(out.begin() + static_cast<ptrdiff_t>(at), out.end(), fromNs,
+                                   [](const TickRecord& r, int64_t t) { return r.timestampNs < t; });
+        out.erase(out.begin() + static_cast<ptrdiff_t>(at), lo);
+        auto hi = std::lower_bound(out.begin() + static_cast<ptrdiff_t>(at), out.end(), toNs,
+                                   [](const TickRecord& r, int64_t t) { return r.timestampNs < t; });
+        out.erase(hi, out.end());
+      }
+      return true;
+    }
+
+  private:
+    CompressedSegment() = default;
+
+    std::shared_ptr<const MappedFile> file_;
+    std::vector<BlockEntry> blocks_;   ///< Directory, copied out of the mapping
+    uint64_t dataEnd_ = 0;             ///< Offset of the directory (end of the block data)
+    SegmentHeader header_{};
+  };
+
+}  // namespace IB::Storage
+
+#endif  // QUANTDREAMCPP_TICK_CODEC_H
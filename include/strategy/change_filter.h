@@ -0,0 +1,68 @@
+#ifndef QUANTDREAMCPP_CHANGE_FILTER_H
+#define QUANTDREAMCPP_CHANGE_FILTER_H
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * @file change_filter.h
+ * @brief Per-subscriber change filters for PositionManager price callbacks
+ *
+ * IB resends identical prices and a single quote change arrives as separate bid and
+ * ask ticks. A `ChangeFilter` decides, per subscriber and per instrument, whether a
+ * new value is worth a callback:
+ *
+ * - **ALWAYS**: every tick (previous behavior)
+ * - **EXACT**: only when the value differs from the last delivered one
+ * - **MIN_DELTA**: only when it moved by at least `threshold` (e.g. one tick size)
+ * - **RELATIVE**: only when it moved by at least `threshold` × |last delivered|
+ *
+ * Any mode can additionally be throttled to at most one delivery per `minInterval`.
+ * Values suppressed by the throttle are kept (last value wins) and delivered by the
+ * next passing tick or by `PositionManager::flushThrottled()`.
+ */
+
+/**
+ * @brief Change criterion plus optional rate limit for one subscriber
+ *
+ * Example usage:
+ * @code
+ * // Wake on moves of at least 5 bps, at most 4 times per second
+ * auto f = ChangeFilter::relative(0.0005).throttled(std::chrono::milliseconds(250));
+ * pm.subscribeMid([](int id, double mid) { ... }, f);
+ * @endcode
+ */
+struct ChangeFilter {
+  enum Mode : uint8_t { ALWAYS, EXACT, MIN_DELTA, RELATIVE };
+
+  Mode mode = EXACT;                          ///< Change criterion
+  double threshold = 0.0;                     ///< Absolute (MIN_DELTA) or fractional (RELATIVE) move
+  std::chrono::nanoseconds minInterval{0};    ///< Minimum spacing between deliveries (0 = unthrottled)
+
+  static ChangeFilter always() { return {ALWAYS, 0.0, {}}; }
+  static ChangeFilter exact() { return {EXACT, 0.0, {}}; }
+  static ChangeFilter minDelta(double delta) { return {MIN_DELTA, delta, {}}; }
+  static ChangeFilter relative(double fraction) { return {RELATIVE, fraction, {}}; }
+
+  /// Copy of this filter limited to one delivery per `interval`
+  ChangeFilter throttled(std::chrono::nanoseconds interval) const {
+    ChangeFilter f = *this;
+    f.minInterval = interval;
+    return f;
+  }
+
+  /// True if `value` is a meaningful change relative to the last delivered `previous`
+  bool changed(double previous, double value) const noexcept {
+    const double move = std::fabs(value - previous);
+    switch (mode) {
+      case ALWAYS:    return true;
+      case EXACT:     return value != previous;
+      case MIN_DELTA: return move >= threshold && move > 0.0;
+      case RELATIVE:  return move >= threshold * std::fabs(previous) && move > 0.0;
+    }
+    return true;
+  }
+};
+
+#endif  // QUANTDREAMCPP_CHANGE_FILTER_H
@@ -65,13 +65,17 @@ public:
    *
    * This function should be called by the market data handler or IB wrapper
    * whenever new market data is available. It safely updates the internal
-   * snapshot buffer for processing by the strategy loop.
+   * snapshot buffer for processing by the strategy loop. When called from a
+   * PositionManager callback, the tick being dispatched on this thread supplies the
+   * snapshot's trace.
    *
    * @param snap Latest market snapshot data.
    */
   void onSnapshot(const MarketSnapshot& snap) {
     std::lock_guard<std::mutex> lk(inMutex_);
     latest_ = snap;
+    if (const auto* current = IB::Helpers::TickTrace::current()) latest_.trace = *current;
+    latest_.trace.stamp(IB::Helpers::TraceStage::ENGINE_SNAPSHOT);
     newData_ = true;
   }
 
@@ -97,8 +101,10 @@ private:
       // === Example strategy logic ===
       // Replace this with your own trading rules.
       if (snap.last > 0) {
+        snap.trace.stamp(IB::Helpers::TraceStage::ENGINE_DECISION);
         OrderRequest req;
         req.localId = 0;
+        req.trace = snap.trace;
         // Fill Contract / Order according to your system design:
         // req.contract = buildContract(...);
         // req.order = buildMarketOrder("BUY", 1);
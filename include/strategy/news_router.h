@@ -0,0 +1,248 @@
+#ifndef QUANTDREAMCPP_NEWS_ROUTER_H
+#define QUANTDREAMCPP_NEWS_ROUTER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "helpers/aho_corasick.h"
+#include "helpers/logger.h"
+
+/**
+ * @file news_router.h
+ * @brief Routes news headlines to strategies by keyword using one shared automaton
+ *
+ * Every strategy registers a watch-list (symbols, keywords, phrases). The router
+ * compiles all watch-lists into a single Aho-Corasick automaton, so each headline is
+ * scanned once in linear time no matter how many strategies and keywords are active,
+ * and each hit is dispatched only to the strategies that watch the matched keyword.
+ *
+ * Watch-list changes never block the news path: they are coalesced and compiled on a
+ * background thread, and the finished automaton is swapped in atomically. Headlines
+ * arriving during a rebuild are matched against the previous automaton.
+ */
+
+/**
+ * @brief A news headline from tickNews or historicalNews
+ */
+struct NewsItem {
+  int reqId = 0;              ///< tickerId (tickNews) or request ID (historicalNews)
+  std::time_t timestamp = 0;  ///< Seconds since epoch (0 if IB sent a textual time only)
+  std::string time;           ///< Textual time from historicalNews ("yyyy-MM-dd HH:mm:ss.0")
+  std::string providerCode;   ///< e.g. "BRFG", "DJNL"
+  std::string articleId;      ///< Use with reqNewsArticle to fetch the body
+  std::string headline;
+  std::string extraData;
+};
+
+/**
+ * @brief Keywords of one watch-list that matched a headline
+ */
+struct NewsHit {
+  const NewsItem* item = nullptr;        ///< Headline that matched (valid during the callback)
+  std::vector<std::string> keywords;     ///< Distinct matched keywords of the subscriber
+};
+
+/**
+ * @brief One watch-list entry
+ */
+struct NewsKeyword {
+  std::string text;         ///< Keyword or phrase (matched case-insensitively)
+  bool wholeWord = true;    ///< Require non-alphanumeric boundaries (recommended for tickers)
+};
+
+/**
+ * @brief Keyword router over a hot-swappable Aho-Corasick automaton
+ *
+ * `onNews()` may be called from the IB reader thread; callbacks run on that thread and
+ * should hand work off quickly (e.g. push into a ConcurrentQueue).
+ *
+ * Example usage:
+ * @code
+ * auto id = ib.news.subscribe({{"AAPL"}, {"downgrade", false}, {"guidance cut", false}},
+ *                             [&](const NewsHit& hit) { riskQueue.push(*hit.item); });
+ * @endcode
+ */
+class NewsRouter {
+public:
+  using Callback = std::function<void(const NewsHit&)>;
+  using SubscriptionId = uint64_t;
+
+  NewsRouter() : compiled_(std::make_shared<const Compiled>()), worker_([this] { rebuildLoop(); }) {}
+
+  ~NewsRouter() {
+    {
+      std::lock_guard<std::mutex> lk(m_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+  }
+
+  NewsRouter(const NewsRouter&) = delete;
+  NewsRouter& operator=(const NewsRouter&) = delete;
+
+  /**
+   * @brief Registers a watch-list; the automaton is rebuilt in the background
+   * @return Handle for update() / unsubscribe()
+   */
+  SubscriptionId subscribe(std::vector<NewsKeyword> keywords, Callback callback) {
+    std::lock_guard<std::mutex> lk(m_);
+    const SubscriptionId id = nextId_++;
+    lists_[id] = {std::move(keywords), std::make_shared<Callback>(std::move(callback))};
+    requestRebuild();
+    return id;
+  }
+
+  /// Replaces the keywords of an existing watch-list
+  void update(SubscriptionId id, std::vector<NewsKeyword> keywords) {
+    std::lock_guard<std::mutex> lk(m_);
+    auto it = lists_.find(id);
+    if (it == lists_.end()) return;
+    it->second.keywords = std::move(keywords);
+    requestRebuild();
+  }
+
+  void unsubscribe(SubscriptionId id) {
+    std::lock_guard<std::mutex> lk(m_);
+    if (lists_.erase(id)) requestRebuild();
+  }
+
+  /**
+   * @brief Matches a headline once and dispatches hits to the watching subscribers
+   * @return Number of subscribers notified
+   */
+  size_t onNews(const NewsItem& item) {
+    auto compiled = compiled_.load(std::memory_order_acquire);
+    if (compiled->keywords.empty()) return 0;
+
+    // Collect (subscriber slot, keyword) pairs; a keyword may be watched by several subscribers
+    std::vector<std::pair<uint32_t, uint32_t>> hits;
+    compiled->automaton.match(item.headline, [&](uint32_t kw, size_t, size_t) {
+      for (uint32_t slot : compiled->keywords[kw].subscribers) hits.emplace_back(slot, kw);
+    });
+    if (hits.empty()) return 0;
+
+    std::sort(hits.begin(), hits.end());
+    hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+
+    size_t notified = 0;
+    for (size_t i = 0; i < hits.size();) {
+      const uint32_t slot = hits[i].first;
+      NewsHit hit;
+      hit.item = &item;
+      for (; i < hits.size() && hits[i].first == slot; ++i)
+        hit.keywords.push_back(compiled->keywords[hits[i].second].text);
+      (*compiled->callbacks[slot])(hit);
+      ++notified;
+    }
+    matched_.fetch_add(1, std::memory_order_relaxed);
+    return notified;
+  }
+
+  /// Blocks until every watch-list change made so far is live (useful at startup)
+  void waitForRebuild() {
+    std::unique_lock<std::mutex> lk(m_);
+    idle_.wait(lk, [&] { return builtGeneration_ >= generation_ || stop_; });
+  }
+
+  /// Number of distinct keywords in the live automaton
+  size_t keywordCount() const { return compiled_.load(std::memory_order_acquire)->keywords.size(); }
+
+  /// Headlines that matched at least one keyword
+  uint64_t matchedCount() const noexcept { return matched_.load(std::memory_order_relaxed); }
+
+private:
+  struct WatchList {
+    std::vector<NewsKeyword> keywords;
+    std::shared_ptr<Callback> callback;
+  };
+
+  /// Immutable compiled state shared with the news path
+  struct Compiled {
+    struct Keyword {
+      std::string text;
+      std::vector<uint32_t> subscribers;   ///< Indices into callbacks
+    };
+    IB::Helpers::AhoCorasick automaton;
+    std::vector<Keyword> keywords;                       ///< Indexed by automaton pattern ID
+    std::vector<std::shared_ptr<Callback>> callbacks;    ///< One per subscriber
+  };
+
+  /// Caller holds m_
+  void requestRebuild() {
+    ++generation_;
+    cv_.notify_all();
+  }
+
+  void rebuildLoop() {
+    std::unique_lock<std::mutex> lk(m_);
+    for (;;) {
+      cv_.wait(lk, [&] { return stop_ || builtGeneration_ < generation_; });
+      if (stop_) return;
+
+      // Snapshot the watch-lists and compile without holding the lock
+      const uint64_t target = generation_;
+      std::map<SubscriptionId, WatchList> lists = lists_;
+      lk.unlock();
+      auto compiled = compile(lists);
+      compiled_.store(std::move(compiled), std::memory_order_release);
+      lk.lock();
+
+      builtGeneration_ = target;
+      idle_.notify_all();
+    }
+  }
+
+  static std::shared_ptr<const Compiled> compile(const std::map<SubscriptionId, WatchList>& lists) {
+    auto out = std::make_shared<Compiled>();
+    IB::Helpers::AhoCorasick::Builder builder(true);
+    std::map<std::pair<std::string, bool>, uint32_t> index;   // (folded keyword, wholeWord) → pattern ID
+
+    for (const auto& [id, list] : lists) {
+      const auto slot = static_cast<uint32_t>(out->callbacks.size());
+      out->callbacks.push_back(list.callback);
+      for (const auto& kw : list.keywords) {
+        if (kw.text.empty()) continue;
+        std::string folded = kw.text;
+        for (auto& c : folded) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        auto [it, inserted] = index.try_emplace({folded, kw.wholeWord}, static_cast<uint32_t>(out->keywords.size()));
+        if (inserted) {
+          out->keywords.push_back({kw.text, {}});
+          builder.add(kw.text, it->second, kw.wholeWord);
+        }
+        auto& subs = out->keywords[it->second].subscribers;
+        if (subs.empty() || subs.back() != slot) subs.push_back(slot);
+      }
+    }
+    out->automaton = builder.build();
+    LOG_DEBUG("[News] Automaton rebuilt: ", out->keywords.size(), " keywords, ",
+              out->automaton.states(), " states, ", out->callbacks.size(), " watch-lists");
+    return out;
+  }
+
+  std::mutex m_;
+  std::condition_variable cv_;     ///< Wakes the rebuild thread
+  std::condition_variable idle_;   ///< Signals a finished rebuild
+  std::map<SubscriptionId, WatchList> lists_;
+  SubscriptionId nextId_ = 1;
+  uint64_t generation_ = 0;        ///< Bumped on every watch-list change
+  uint64_t builtGeneration_ = 0;   ///< Generation of the live automaton
+  bool stop_ = false;
+
+  std::atomic<std::shared_ptr<const Compiled>> compiled_;
+  std::atomic<uint64_t> matched_{0};
+  std::thread worker_;             ///< Declared last: started after every member above is initialized
+};
+
+#endif  // QUANTDREAMCPP_NEWS_ROUTER_H
@@ -9,6 +9,7 @@
 #include "Contract.h"
 #include "Order.h"
 #include "helpers/logger.h"
+#include "helpers/tick_trace.h"
 #include "strategy/queue.h"
 
 /**
@@ -21,6 +22,7 @@ struct OrderRequest {
   int localId;        ///< Optional local correlation ID for internal tracking.
   Contract contract;  ///< Contract definition (e.g., stock, option, future).
   Order order;        ///< Order parameters (side, limit, quantity, etc.).
+  [[no_unique_address]] IB::Helpers::TickTrace trace;  ///< Stamps of the tick that triggered the order (IBW_TRACE).
 };
 
 /**
@@ -87,12 +89,16 @@ private:
    * Continuously pops order requests from the queue and executes them
    * via the provided @ref ExecuteFn. Any exceptions thrown by the
    * executor function are caught and logged, preventing thread termination.
+   * The request's trace is the thread's current one while the ExecuteFn runs, so
+   * IBBaseWrapper::placeOrder can stamp and complete it.
    */
   void run() const {
     try {
       while (running_) {
         auto req = queue_->pop();
         try {
+          req.trace.stamp(IB::Helpers::TraceStage::EXECUTE);
+          IB::Helpers::TickTrace::Current traced(req.trace);
           execute_(std::move(req));
         } catch (const std::exception& e) {
           LOG_ERROR("[OrderExecutor] execute error: ", e.what());
@@ -1,12 +1,21 @@
 #ifndef QUANTDREAMCPP_POSITION_MANAGER_H
 #define QUANTDREAMCPP_POSITION_MANAGER_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include <functional>
 #include "data_structures/positions.h"
 #include "data_structures/snapshots.h"
+#include "helpers/clock.h"
+#include "helpers/tick_trace.h"
+#include "strategy/change_filter.h"
 
 /**
  * @brief Thread-safe manager for current portfolio positions and market data.
@@ -17,6 +26,8 @@
  *
  * Additionally, it provides callback hooks for market data events (bid, ask, mid, last)
  * that can be registered to receive real-time price updates when they are computed.
+ * Each price subscriber carries a ChangeFilter evaluated here, in the dispatch layer,
+ * so strategies only wake for meaningful moves (see strategy/change_filter.h).
  *
  * Typical usage pattern:
  * @code
@@ -27,6 +38,11 @@
  *     std::cout << "Mid price for " << tickerId << ": " << mid << std::endl;
  * });
  *
+ * // Additional subscribers with their own change filters:
+ * auto id = pm.subscribeLast([](int tickerId, double last) { ... },
+ *                            ChangeFilter::minDelta(0.01).throttled(std::chrono::milliseconds(100)));
+ * pm.unsubscribe(id);
+ *
  * // Called from IB position callback:
  * pm.onPosition(positionInfo);
  *
@@ -41,6 +57,9 @@
  */
 class PositionManager {
 public:
+  using PriceCallback = std::function<void(int, double)>;   ///< (tickerId, price)
+  using SubscriptionId = uint64_t;                          ///< Handle returned by subscribe*()
+
   /**
    * @brief Store or update a position entry.
    *
@@ -98,54 +117,54 @@ public:
   /**
    * @brief Called when a bid price update completes.
    *
-   * Invokes the registered onBid callback if one is set. This is typically
-   * called from IBMarketWrapper::tickPrice() when a BID tick is received.
+   * Invokes every bid subscriber whose change filter accepts the new value. This is
+   * typically called from IBMarketWrapper::tickPrice() when a BID tick is received.
    *
    * @param tickerId The IB request ID for the market data
    * @param bid The current bid price
    */
   void onBid(int tickerId, double bid) {
-    if (onBidCallback_) onBidCallback_(tickerId, bid);
+    dispatch(BID_CHANNEL, tickerId, bid);
   }
 
   /**
    * @brief Called when an ask price update completes.
    *
-   * Invokes the registered onAsk callback if one is set. This is typically
-   * called from IBMarketWrapper::tickPrice() when an ASK tick is received.
+   * Invokes every ask subscriber whose change filter accepts the new value. This is
+   * typically called from IBMarketWrapper::tickPrice() when an ASK tick is received.
    *
    * @param tickerId The IB request ID for the market data
    * @param ask The current ask price
    */
   void onAsk(int tickerId, double ask) {
-    if (onAskCallback_) onAskCallback_(tickerId, ask);
+    dispatch(ASK_CHANNEL, tickerId, ask);
   }
 
   /**
    * @brief Called when a last trade price update completes.
    *
-   * Invokes the registered onLast callback if one is set. This is typically
-   * called from IBMarketWrapper::tickPrice() when a LAST tick is received.
+   * Invokes every last-price subscriber whose change filter accepts the new value.
+   * This is typically called from IBMarketWrapper::tickPrice() when a LAST tick is received.
    *
    * @param tickerId The IB request ID for the market data
    * @param last The last trade price
    */
   void onLast(int tickerId, double last) {
-    if (onLastCallback_) onLastCallback_(tickerId, last);
+    dispatch(LAST_CHANNEL, tickerId, last);
   }
 
   /**
    * @brief Called when a mid price is computed (average of bid/ask).
    *
-   * Invokes the registered onMid callback if one is set. This is typically
-   * called from IBMarketWrapper when both bid and ask are available and
-   * the mid price can be calculated.
+   * Invokes every mid subscriber whose change filter accepts the new value. This is
+   * called from IBMarketWrapper after a BID or ASK tick when both sides are available.
+   * With the default EXACT filter, a tick that leaves the mid unchanged is not delivered.
    *
    * @param tickerId The IB request ID for the market data
    * @param mid The computed mid price (bid + ask) / 2
    */
   void onMid(int tickerId, double mid) {
-    if (onMidCallback_) onMidCallback_(tickerId, mid);
+    dispatch(MID_CHANNEL, tickerId, mid);
   }
 
   /**
@@ -159,7 +178,9 @@ public:
    * @param snapshot The complete market snapshot with all available data
    */
   void onSnapshot(int tickerId, const IB::MarketData::MarketSnapshot& snapshot) {
-    if (onSnapshotCallback_) onSnapshotCallback_(tickerId, snapshot);
+    if (!onSnapshotCallback_) return;
+    IB::Helpers::TickTrace::stampCurrent(IB::Helpers::TraceStage::POSITION_MANAGER);
+    onSnapshotCallback_(tickerId, snapshot);
   }
 
   // =============================================================================
@@ -171,9 +192,12 @@ public:
    *
    * @param callback Function to call when bid price is updated.
    *                 Signature: void(int tickerId, double bid)
+   * @param filter Change filter applied before delivery (default: only actual changes)
+   *
+   * Replaces the callback registered by a previous call.
    */
-  void setOnBidCallback(std::function<void(int, double)> callback) {
-    onBidCallback_ = std::move(callback);
+  void setOnBidCallback(PriceCallback callback, ChangeFilter filter = ChangeFilter::exact()) {
+    replaceLegacy(BID_CHANNEL, std::move(callback), filter);
   }
 
   /**
@@ -181,9 +205,12 @@ public:
    *
    * @param callback Function to call when ask price is updated.
    *                 Signature: void(int tickerId, double ask)
+   * @param filter Change filter applied before delivery (default: only actual changes)
+   *
+   * Replaces the callback registered by a previous call.
    */
-  void setOnAskCallback(std::function<void(int, double)> callback) {
-    onAskCallback_ = std::move(callback);
+  void setOnAskCallback(PriceCallback callback, ChangeFilter filter = ChangeFilter::exact()) {
+    replaceLegacy(ASK_CHANNEL, std::move(callback), filter);
   }
 
   /**
@@ -191,9 +218,12 @@ public:
    *
    * @param callback Function to call when last price is updated.
    *                 Signature: void(int tickerId, double last)
+   * @param filter Change filter applied before delivery (default: only actual changes)
+   *
+   * Replaces the callback registered by a previous call.
    */
-  void setOnLastCallback(std::function<void(int, double)> callback) {
-    onLastCallback_ = std::move(callback);
+  void setOnLastCallback(PriceCallback callback, ChangeFilter filter = ChangeFilter::exact()) {
+    replaceLegacy(LAST_CHANNEL, std::move(callback), filter);
   }
 
   /**
@@ -201,11 +231,93 @@ public:
    *
    * @param callback Function to call when mid price is computed.
    *                 Signature: void(int tickerId, double mid)
+   * @param filter Change filter applied before delivery (default: only actual changes)
+   *
+   * Replaces the callback registered by a previous call.
    */
-  void setOnMidCallback(std::function<void(int, double)> callback) {
-    onMidCallback_ = std::move(callback);
+  void setOnMidCallback(PriceCallback callback, ChangeFilter filter = ChangeFilter::exact()) {
+    replaceLegacy(MID_CHANNEL, std::move(callback), filter);
   }
 
+  /**
+   * @brief Add a bid subscriber with its own change filter
+   * @return Handle for unsubscribe()
+   */
+  SubscriptionId subscribeBid(PriceCallback callback, ChangeFilter filter = ChangeFilter::exact()) {
+    return subscribe(BID_CHANNEL, std::move(callback), filter);
+  }
+
+  /// Add an ask subscriber with its own change filter
+  SubscriptionId subscribeAsk(PriceCallback callback, ChangeFilter filter = ChangeFilter::exact()) {
+    return subscribe(ASK_CHANNEL, std::move(callback), filter);
+  }
+
+  /// Add a last-price subscriber with its own change filter
+  SubscriptionId subscribeLast(PriceCallback callback, ChangeFilter filter = ChangeFilter::exact()) {
+    return subscribe(LAST_CHANNEL, std::move(callback), filter);
+  }
+
+  /// Add a mid-price subscriber with its own change filter
+  SubscriptionId subscribeMid(PriceCallback callback, ChangeFilter filter = ChangeFilter::exact()) {
+    return subscribe(MID_CHANNEL, std::move(callback), filter);
+  }
+
+  /**
+   * @brief Remove a subscriber added by one of the subscribe*() calls
+   *
+   * A dispatch already in progress on another thread may still deliver one last value.
+   */
+  void unsubscribe(SubscriptionId id) {
+    std::lock_guard<std::mutex> lk(subsMutex_);
+    for (auto& slot : channels_) {
+      auto current = slot.load(std::memory_order_acquire);
+      auto next = std::make_shared<SubscriberList>();
+      for (const auto& sub : *current)
+        if (sub->id != id) next->push_back(sub);
+      if (next->size() != current->size()) slot.store(std::move(next), std::memory_order_release);
+    }
+  }
+
+  /**
+   * @brief Deliver throttled values whose rate-limit interval has elapsed
+   *
+   * Call periodically (e.g. from a timer) so the last value of a burst is not held
+   * back until the next tick. Callbacks run on the calling thread.
+   *
+   * @return Number of callbacks invoked
+   */
+  size_t flushThrottled() {
+    const auto now = IB::Helpers::steadyNow();
+    size_t delivered = 0;
+    std::vector<std::pair<int, double>> due;
+    for (const auto& slot : channels_) {
+      auto list = slot.load(std::memory_order_acquire);
+      for (const auto& sub : *list) {
+        due.clear();
+        {
+          std::lock_guard<std::mutex> lk(sub->m);
+          for (auto& [tickerId, st] : sub->states) {
+            if (!st.pending || now - st.deliveredAt < sub->filter.minInterval) continue;
+            st.pending = false;
+            st.delivered = st.pendingValue;
+            st.deliveredAt = now;
+            due.emplace_back(tickerId, st.pendingValue);
+          }
+        }
+        for (const auto& [tickerId, value] : due) sub->callback(tickerId, value);
+        delivered += due.size();
+      }
+    }
+    delivered_.fetch_add(delivered, std::memory_order_relaxed);
+    return delivered;
+  }
+
+  /// Price callbacks delivered so far (all channels)
+  uint64_t deliveredCount() const noexcept { return delivered_.load(std::memory_order_relaxed); }
+
+  /// Price callbacks suppressed by change filters so far (all channels)
+  uint64_t suppressedCount() const noexcept { return suppressed_.load(std::memory_order_relaxed); }
+
   /**
    * @brief Register a callback for complete snapshot updates.
    *
@@ -227,14 +339,97 @@ public:
   }
 
 private:
+  using Clock = std::chrono::steady_clock;
+
+  enum Channel : uint8_t { BID_CHANNEL, ASK_CHANNEL, LAST_CHANNEL, MID_CHANNEL, CHANNEL_COUNT };
+
+  /// Per-instrument filter state of one subscriber
+  struct FilterState {
+    double delivered = 0.0;          ///< Last value passed to the callback
+    Clock::time_point deliveredAt;   ///< When it was passed
+    double pendingValue = 0.0;       ///< Newest value held back by the throttle
+    bool hasDelivered = false;
+    bool pending = false;
+  };
+
+  struct Subscriber {
+    SubscriptionId id;
+    ChangeFilter filter;
+    PriceCallback callback;
+    std::mutex m;                                   ///< Guards states (dispatch vs. flushThrottled)
+    std::unordered_map<int, FilterState> states;    ///< Keyed by ticker ID
+
+    /// Applies the filter and updates state; true if the callback should fire now
+    bool admit(int tickerId, double value, Clock::time_point now) {
+      std::lock_guard<std::mutex> lk(m);
+      FilterState& st = states[tickerId];
+      if (st.hasDelivered && !filter.changed(st.delivered, value)) {
+        st.pending = false;   // back at the delivered value: nothing left to flush
+        return false;
+      }
+      if (st.hasDelivered && filter.minInterval.count() > 0 && now - st.deliveredAt < filter.minInterval) {
+        st.pending = true;
+        st.pendingValue = value;
+        return false;
+      }
+      st.delivered = value;
+      st.deliveredAt = now;
+      st.hasDelivered = true;
+      st.pending = false;
+      return true;
+    }
+  };
+
+  using SubscriberList = std::vector<std::shared_ptr<Subscriber>>;
+
+  /// Runs the change filters of a channel and invokes the subscribers that pass
+  void dispatch(Channel channel, int tickerId, double value) {
+    auto list = channels_[channel].load(std::memory_order_acquire);
+    if (list->empty()) return;
+    const auto now = IB::Helpers::steadyNow();
+    for (const auto& sub : *list) {
+      if (sub->admit(tickerId, value, now)) {
+        delivered_.fetch_add(1, std::memory_order_relaxed);
+        IB::Helpers::TickTrace::stampCurrent(IB::Helpers::TraceStage::POSITION_MANAGER);
+        sub->callback(tickerId, value);
+      } else {
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Copy-on-write insert so dispatch never takes subsMutex_
+  SubscriptionId subscribe(Channel channel, PriceCallback callback, ChangeFilter filter) {
+    auto sub = std::make_shared<Subscriber>();
+    sub->filter = filter;
+    sub->callback = std::move(callback);
+    std::lock_guard<std::mutex> lk(subsMutex_);
+    sub->id = nextId_++;
+    auto next = std::make_shared<SubscriberList>(*channels_[channel].load(std::memory_order_acquire));
+    next->push_back(sub);
+    channels_[channel].store(std::move(next), std::memory_order_release);
+    return sub->id;
+  }
+
+  /// Backs the setOn*Callback() setters: one replaceable subscriber per channel
+  void replaceLegacy(Channel channel, PriceCallback callback, ChangeFilter filter) {
+    SubscriptionId previous = legacyIds_[channel].exchange(0);
+    if (previous != 0) unsubscribe(previous);
+    if (callback) legacyIds_[channel] = subscribe(channel, std::move(callback), filter);
+  }
+
   mutable std::mutex m_;  ///< Mutex protecting concurrent access to the positions map.
   std::map<int, IB::Accounts::PositionInfo> positions_;  ///< Map of positions keyed by IB contract ID.
 
   // Market data callbacks
-  std::function<void(int, double)> onBidCallback_;
-  std::function<void(int, double)> onAskCallback_;
-  std::function<void(int, double)> onLastCallback_;
-  std::function<void(int, double)> onMidCallback_;
+  std::array<std::atomic<std::shared_ptr<const SubscriberList>>, CHANNEL_COUNT> channels_{
+      std::make_shared<const SubscriberList>(), std::make_shared<const SubscriberList>(),
+      std::make_shared<const SubscriberList>(), std::make_shared<const SubscriberList>()};  ///< Price subscribers per channel
+  std::array<std::atomic<SubscriptionId>, CHANNEL_COUNT> legacyIds_{};  ///< Subscribers installed by setOn*Callback
+  std::mutex subsMutex_;                        ///< Serializes subscribe / unsubscribe
+  SubscriptionId nextId_ = 1;                   ///< Next subscription handle (0 = none)
+  std::atomic<uint64_t> delivered_{0};          ///< Price callbacks delivered
+  std::atomic<uint64_t> suppressed_{0};         ///< Price callbacks filtered out
   std::function<void(int, const IB::MarketData::MarketSnapshot&)> onSnapshotCallback_;
   
   // Position callback
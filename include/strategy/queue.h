@@ -5,6 +5,8 @@
 #include <mutex>
 #include <queue>
 
+#include "helpers/tick_trace.h"
+
 /**
  * @brief Thread-safe concurrent blocking queue.
  *
@@ -24,6 +26,9 @@
  * // Consumer thread
  * auto tick = q.pop(); // Blocks until data is available
  * @endcode
+ *
+ * Elements with a `trace` member (an IB::Helpers::TickTrace) get their QUEUE_PUSH and
+ * QUEUE_POP stages stamped.
  */
 template<typename T>
 class ConcurrentQueue {
@@ -37,6 +42,8 @@ public:
    * @param v The element to add. It will be moved into the queue.
    */
   void push(T v) {
+    if constexpr (requires { v.trace.stamp(IB::Helpers::TraceStage::QUEUE_PUSH); })
+      v.trace.stamp(IB::Helpers::TraceStage::QUEUE_PUSH);
     {
       std::lock_guard<std::mutex> lk(m_);
       q_.push(std::move(v));
@@ -60,6 +67,8 @@ public:
     if (stopped_ && q_.empty()) throw std::runtime_error("queue stopped");
     T v = std::move(q_.front());
     q_.pop();
+    if constexpr (requires { v.trace.stamp(IB::Helpers::TraceStage::QUEUE_POP); })
+      v.trace.stamp(IB::Helpers::TraceStage::QUEUE_POP);
     return v;
   }
 
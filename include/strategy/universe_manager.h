@@ -0,0 +1,336 @@
+#ifndef QUANTDREAMCPP_UNIVERSE_MANAGER_H
+#define QUANTDREAMCPP_UNIVERSE_MANAGER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Contract.h"
+#include "data_structures/contract_cache.h"
+#include "data_structures/line_budget.h"
+#include "helpers/logger.h"
+
+/**
+ * @file universe_manager.h
+ * @brief Dynamic trading universe driven by market scanner results
+ *
+ * Each scanner result set is diffed against the previous set of the same scan. Only
+ * the difference is acted upon: names that entered are resolved through the contract
+ * cache and subscribed if a market data line is free (otherwise queued by rank),
+ * names that left are unsubscribed and their line handed to the best-ranked queued
+ * name. Names reported by several scans are held until the last scan drops them.
+ *
+ * A released ticker ID is not handed out again within the same scan: ticks of the
+ * cancelled name may still be in flight, so the ID only becomes reusable from the
+ * next applyScan / removeScan on.
+ */
+
+/**
+ * @brief One row of a scanner result set
+ */
+struct ScanRow {
+  int rank = 0;                 ///< 0-based position in the scan
+  ContractDetails details;      ///< Contract as reported by the scanner
+  std::string distance;         ///< Scanner-specific fields, passed through
+  std::string benchmark;
+  std::string projection;
+};
+
+/**
+ * @brief Incremental universe maintained from one or more scanner subscriptions
+ *
+ * The manager does not talk to TWS itself: subscribe / unsubscribe go through hooks,
+ * which `IBScannerWrapper` binds to `reqMktData` / `cancelMktData`. Hooks are invoked
+ * outside the internal lock on the thread calling `applyScan()` (the IB reader thread).
+ *
+ * Example usage:
+ * @code
+ * UniverseManager universe(ib.contractCache, ib.lineBudget, 10000, {
+ *     [&](int tickerId, const Contract& c) { ... reqMktData ... },
+ *     [&](int tickerId) { ... cancelMktData ... }});
+ *
+ * universe.setOnChange([](const UniverseManager::Diff& d) {
+ *     LOG_INFO("[Universe] +", d.added.size(), " -", d.removed.size());
+ * });
+ * @endcode
+ */
+class UniverseManager {
+public:
+  /// Wrapper actions the manager drives
+  struct Hooks {
+    std::function<void(int tickerId, const Contract& contract)> subscribe;
+    std::function<void(int tickerId)> unsubscribe;
+  };
+
+  /// Current state of one universe member
+  struct Member {
+    long conId = 0;
+    Contract contract;
+    int tickerId = -1;          ///< Market data ticker ID (-1 while queued for a line)
+    int rank = 0;               ///< Best rank across the scans holding it
+  };
+
+  /// Incremental change produced by one applyScan / removeScan call
+  struct Diff {
+    int scanId = 0;
+    std::vector<long> added;        ///< conIds that joined the universe
+    std::vector<long> removed;      ///< conIds that left the universe
+    std::vector<long> subscribed;   ///< conIds that got a market data line
+    std::vector<long> queued;       ///< conIds waiting for a line
+  };
+
+  /**
+   * @param cache Contract cache used to resolve scanner contracts
+   * @param budget Market data line budget shared with other subscribers
+   * @param firstTickerId First ticker ID of the range reserved for universe subscriptions
+   * @param hooks Subscribe / unsubscribe actions
+   */
+  UniverseManager(IB::Contracts::ContractCache& cache, IB::MarketData::LineBudget& budget,
+                  int firstTickerId, Hooks hooks)
+    : cache_(cache), budget_(budget), nextTickerId_(firstTickerId), hooks_(std::move(hooks)) {}
+
+  /// Callback invoked after every non-empty diff
+  void setOnChange(std::function<void(const Diff&)> callback) {
+    std::lock_guard<std::mutex> lk(m_);
+    onChange_ = std::move(callback);
+  }
+
+  /**
+   * @brief Folds a complete scanner result set into the universe
+   * @return The incremental diff that was applied
+   */
+  Diff applyScan(int scanId, const std::vector<ScanRow>& rows) {
+    Diff diff;
+    diff.scanId = scanId;
+    Actions actions;
+    {
+      std::lock_guard<std::mutex> lk(m_);
+      auto& previous = scans_[scanId];
+      std::unordered_map<long, int> current;
+      current.reserve(rows.size());
+      for (const auto& row : rows)
+        if (row.details.contract.conId != 0) current.emplace(row.details.contract.conId, row.rank);
+
+      // Names that left this scan
+      for (auto it = previous.begin(); it != previous.end();) {
+        if (current.count(it->first)) { ++it; continue; }
+        const long conId = it->first;
+        it = previous.erase(it);
+        release(conId, diff, actions);
+      }
+
+      // Names that entered (or re-ranked)
+      for (const auto& row : rows) {
+        const long conId = row.details.contract.conId;
+        if (conId == 0) continue;
+        auto [pos, inserted] = previous.insert_or_assign(conId, row.rank);
+        (void)pos;
+        if (inserted) acquire(row, diff, actions);
+        else rerank(conId);
+      }
+
+      promotePending(diff, actions);
+      recycleTickerIds();
+    }
+    finish(diff, actions);
+    return diff;
+  }
+
+  /**
+   * @brief Drops every name held only by `scanId` (e.g. after cancelling the scanner)
+   */
+  Diff removeScan(int scanId) {
+    Diff diff;
+    diff.scanId = scanId;
+    Actions actions;
+    {
+      std::lock_guard<std::mutex> lk(m_);
+      auto it = scans_.find(scanId);
+      if (it != scans_.end()) {
+        auto names = std::move(it->second);
+        scans_.erase(it);
+        for (const auto& [conId, rank] : names) release(conId, diff, actions);
+      }
+      promotePending(diff, actions);
+      recycleTickerIds();
+    }
+    finish(diff, actions);
+    return diff;
+  }
+
+  /// Copy of all members, subscribed and queued, ordered by rank
+  std::vector<Member> members() const {
+    std::lock_guard<std::mutex> lk(m_);
+    std::vector<Member> out;
+    out.reserve(members_.size());
+    for (const auto& [conId, m] : members_) out.push_back(m);
+    std::sort(out.begin(), out.end(), [](const Member& a, const Member& b) { return a.rank < b.rank; });
+    return out;
+  }
+
+  /// Ticker ID streaming `conId`, or -1
+  int tickerIdOf(long conId) const {
+    std::lock_guard<std::mutex> lk(m_);
+    auto it = members_.find(conId);
+    return it == members_.end() ? -1 : it->second.tickerId;
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return members_.size();
+  }
+
+  size_t queued() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return pending_.size();
+  }
+
+private:
+  struct Actions {
+    std::vector<std::pair<int, Contract>> subscribe;
+    std::vector<int> unsubscribe;
+  };
+
+  /// Best (lowest) rank of `conId` across all scans holding it
+  int bestRank(long conId) const {
+    int best = INT32_MAX;
+    for (const auto& [id, names] : scans_)
+      if (auto it = names.find(conId); it != names.end()) best = std::min(best, it->second);
+    return best;
+  }
+
+  /// Refreshes a member's rank, keeping the pending queue ordered
+  void rerank(long conId) {
+    auto it = members_.find(conId);
+    if (it == members_.end()) return;
+    const int rank = bestRank(conId);
+    if (rank == it->second.rank) return;
+    if (it->second.tickerId < 0 && pending_.erase({it->second.rank, conId}))
+      pending_.insert({rank, conId});
+    it->second.rank = rank;
+  }
+
+  /// Resolves a contract through the cache; falls back to the scanner contract routed via SMART
+  Contract resolve(const ContractDetails& scanned) {
+    if (auto cached = cache_.find(scanned.contract.conId)) return cached->contract;
+    ContractDetails details = scanned;
+    if (details.contract.exchange.empty()) details.contract.exchange = "SMART";
+    cache_.putIfAbsent(details);
+    return details.contract;
+  }
+
+  void acquire(const ScanRow& row, Diff& diff, Actions& actions) {
+    const long conId = row.details.contract.conId;
+    if (++refs_[conId] > 1) {
+      rerank(conId);
+      return;
+    }
+    Member& m = members_[conId];
+    m.conId = conId;
+    m.contract = resolve(row.details);
+    m.rank = row.rank;
+    diff.added.push_back(conId);
+
+    if (budget_.tryAcquire()) {
+      m.tickerId = allocateTickerId();
+      actions.subscribe.emplace_back(m.tickerId, m.contract);
+      diff.subscribed.push_back(conId);
+    } else {
+      pending_.insert({m.rank, conId});
+      diff.queued.push_back(conId);
+    }
+  }
+
+  void release(long conId, Diff& diff, Actions& actions) {
+    auto ref = refs_.find(conId);
+    if (ref == refs_.end()) return;
+    if (--ref->second > 0) {
+      rerank(conId);
+      return;
+    }
+    refs_.erase(ref);
+
+    auto it = members_.find(conId);
+    if (it == members_.end()) return;
+    if (it->second.tickerId >= 0) {
+      actions.unsubscribe.push_back(it->second.tickerId);
+      retiredTickerIds_.push_back(it->second.tickerId);
+      budget_.release();
+    } else {
+      pending_.erase({it->second.rank, conId});
+    }
+    members_.erase(it);
+    diff.removed.push_back(conId);
+  }
+
+  /// Hands free lines to queued names, best rank first
+  void promotePending(Diff& diff, Actions& actions) {
+    while (!pending_.empty()) {
+      auto first = pending_.begin();
+      auto it = members_.find(first->second);
+      if (it == members_.end()) { pending_.erase(first); continue; }
+      if (!budget_.tryAcquire()) break;
+      it->second.tickerId = allocateTickerId();
+      actions.subscribe.emplace_back(it->second.tickerId, it->second.contract);
+      diff.subscribed.push_back(it->first);
+      pending_.erase(first);
+    }
+  }
+
+  int allocateTickerId() {
+    if (!freeTickerIds_.empty()) {
+      int id = freeTickerIds_.back();
+      freeTickerIds_.pop_back();
+      return id;
+    }
+    return nextTickerId_++;
+  }
+
+  /// Makes the IDs released by this scan reusable from the next one
+  void recycleTickerIds() {
+    freeTickerIds_.insert(freeTickerIds_.end(), retiredTickerIds_.begin(), retiredTickerIds_.end());
+    retiredTickerIds_.clear();
+  }
+
+  /// Runs the wrapper hooks and the change callback outside the lock
+  void finish(const Diff& diff, const Actions& actions) {
+    for (int tickerId : actions.unsubscribe)
+      if (hooks_.unsubscribe) hooks_.unsubscribe(tickerId);
+    for (const auto& [tickerId, contract] : actions.subscribe)
+      if (hooks_.subscribe) hooks_.subscribe(tickerId, contract);
+
+    if (diff.added.empty() && diff.removed.empty() && diff.subscribed.empty()) return;
+    LOG_INFO("[Universe] scan ", diff.scanId, ": +", diff.added.size(), " -", diff.removed.size(),
+             " subscribed=", diff.subscribed.size(), " queued=", diff.queued.size(),
+             " lines=", budget_.used(), "/", budget_.capacity());
+
+    std::function<void(const Diff&)> cb;
+    {
+      std::lock_guard<std::mutex> lk(m_);
+      cb = onChange_;
+    }
+    if (cb) cb(diff);
+  }
+
+  IB::Contracts::ContractCache& cache_;
+  IB::MarketData::LineBudget& budget_;
+  int nextTickerId_;
+  Hooks hooks_;
+
+  mutable std::mutex m_;
+  std::unordered_map<int, std::unordered_map<long, int>> scans_;   ///< scanId → (conId → rank)
+  std::unordered_map<long, int> refs_;                             ///< conId → number of scans holding it
+  std::unordered_map<long, Member> members_;                       ///< Universe members by conId
+  std::set<std::pair<int, long>> pending_;                         ///< (rank, conId) waiting for a line
+  std::vector<int> freeTickerIds_;                                 ///< Ticker IDs released by earlier scans
+  std::vector<int> retiredTickerIds_;                              ///< Ticker IDs released by the current scan
+  std::function<void(const Diff&)> onChange_;
+};
+
+#endif  // QUANTDREAMCPP_UNIVERSE_MANAGER_H
@@ -15,9 +15,17 @@
 #include "EReaderOSSignal.h"
 #include "EWrapperDefault.h"
 #include "helpers/logger.h"
+#include "helpers/tick_trace_stats.h"
+#include "helpers/trace_events.h"
+#include "analytics/microstructure.h"
+#include "data_structures/contract_cache.h"
+#include "data_structures/line_budget.h"
+#include "data_structures/quote_book.h"
+#include "data_structures/quote_filter.h"
 #include "data_structures/snapshots.h"
 #include "data_structures/options.h"
 #include "data_structures/positions.h"
+#include "orders/order_gateway.h"
 #include "IBRequestIds.h"
 
 /**
@@ -53,9 +61,15 @@ public:
     std::unordered_map<TickerId, Contract> reqIdToContract; ///< Contract lookup by ticker ID
     std::unordered_map<int, std::vector<IB::Options::ChainInfo>> optionChains; ///< Option chain data by request ID
     std::vector<IB::Accounts::PositionInfo> positionBuffer; ///< Buffer for position information
+    IB::MarketData::QuoteBook quoteBook; ///< Top-of-book prices and sizes (SoA) by ticker ID
+    IB::Analytics::MicrostructureBook microstructure; ///< OFI, microprice, VWAP, trade signs per quote book row
+    IB::MarketData::QuoteFilter quoteFilter; ///< Crossed/locked, band, halt and staleness checks per quote book row
+    IB::Contracts::ContractCache contractCache; ///< Resolved contracts by conId (filled by contractDetails / scannerData)
+    IB::MarketData::LineBudget lineBudget; ///< Simultaneous market data line allowance (100 by default)
 
     EReaderOSSignal signal; ///< OS signal for reader synchronization
     std::unique_ptr<EClientSocket> client; ///< IB API client socket
+    IB::Orders::OrderGateway* orderGateway = nullptr; ///< When set, order entry goes here instead of TWS (e.g. IB::Sim::SimulatedBroker)
 
     /**
      * @brief Default constructor
@@ -101,11 +115,13 @@ public:
 
         running = true;
         reader_thread = std::thread([this]() {
+            IB::Helpers::TraceEvents::nameThread("IB reader");
             EReader reader(client.get(), &signal);
             reader.start();
             signal.issueSignal();
             while (running && client->isConnected()) {
                 signal.waitForSignal();
+                IB::Helpers::TickTrace::markSocketRead();
                 reader.processMsgs();
             }
             LOG_DEBUG("[IB] Reader thread stopped");
@@ -148,7 +164,9 @@ public:
      * @param reqId Unique request identifier
      * @return Future object for retrieving the result
      *
-     * Thread-safe creation of promises stored in genericPromises map.
+     * Thread-safe creation of promises stored in genericPromises map. During a trace
+     * session the request is an async "IB request" span until the promise is fulfilled
+     * or dropped (see erasePromise()).
      */
     template<typename ResultType>
     std::future<ResultType> createPromise(int reqId) {
@@ -156,6 +174,8 @@ public:
         auto f = p->get_future();
         std::lock_guard<std::mutex> lock(promiseMutex);
         genericPromises[reqId] = p;
+        if (IB::Helpers::TraceEvents::recording())
+            IB::Helpers::TraceEvents::asyncBegin("IB request", static_cast<uint64_t>(reqId), "reqId=" + std::to_string(reqId));
         return f;
     }
 
@@ -179,6 +199,32 @@ public:
         } catch (...) {
             LOG_ERROR("[Promise] Type mismatch for reqId=", reqId);
         }
+        erasePromise(it);
+    }
+
+    /**
+     * @brief Drops a pending promise without fulfilling it (e.g. an abandoned request)
+     *
+     * @param reqId Request identifier of the promise to drop
+     * @return True if a promise was pending for reqId
+     *
+     * A late answer for reqId is then ignored.
+     */
+    bool dropPromise(int reqId) {
+        std::lock_guard<std::mutex> lock(promiseMutex);
+        auto it = genericPromises.find(reqId);
+        if (it == genericPromises.end()) return false;
+        erasePromise(it);
+        return true;
+    }
+
+    /**
+     * @brief Removes a promise from genericPromises and ends its "IB request" trace span
+     *
+     * Every removal goes through here so no span stays open. Caller holds promiseMutex.
+     */
+    void erasePromise(std::unordered_map<int, std::any>::iterator it) {
+        IB::Helpers::TraceEvents::asyncEnd("IB request", static_cast<uint64_t>(it->first));
         genericPromises.erase(it);
     }
 
@@ -204,6 +250,32 @@ public:
         return result;
     }
 
+    // ------------------------------------------------------------------
+    // Quote Book
+    // ------------------------------------------------------------------
+
+    /**
+     * @brief QuoteBook row of a snapshot's ticker (IB reader thread)
+     *
+     * The book index (a mutex-guarded map) is consulted only on the first tick; the row
+     * is then cached in the snapshot so the per-tick path takes no lock.
+     *
+     * Rows are keyed by reqId, and request helpers reuse the same reqId for successive
+     * instruments. A fresh snapshot entry therefore starts its row over: the quote book
+     * row, the quote filter's band reference and the microstructure state (OFI, VWAP,
+     * trade signs) of the previous instrument are dropped.
+     */
+    size_t bookRow(TickerId tickerId, IB::MarketData::MarketSnapshot& snap) {
+        if (!snap.hasBookRow) {
+            snap.bookRow = quoteBook.rowFor(static_cast<int>(tickerId));
+            snap.hasBookRow = true;
+            quoteBook.clear(snap.bookRow);
+            quoteFilter.reset(snap.bookRow);
+            microstructure.reset(snap.bookRow);
+        }
+        return snap.bookRow;
+    }
+
     // ------------------------------------------------------------------
     // Misc Callbacks
     // ------------------------------------------------------------------
@@ -235,6 +307,48 @@ public:
      * Thread-safe method to obtain unique order IDs for new orders.
      */
     int nextOrderId() { return nextValidOrderId++; }
+
+    // ------------------------------------------------------------------
+    // Order entry (routed to orderGateway when attached)
+    // ------------------------------------------------------------------
+
+    /// Completes the thread's tick-to-trade trace (OrderExecutor) once the order is sent
+    void placeOrder(OrderId orderId, const Contract& contract, const Order& order) const {
+        if (orderGateway) orderGateway->placeOrder(orderId, contract, order);
+        else client->placeOrder(orderId, contract, order);
+        if (IB::Helpers::TickTrace::stampCurrent(IB::Helpers::TraceStage::PLACE_ORDER))
+            IB::Helpers::TickTraceStats::record(*IB::Helpers::TickTrace::current());
+    }
+
+    void cancelOrder(OrderId orderId, const OrderCancel& cancel) const {
+        if (orderGateway) orderGateway->cancelOrder(orderId, cancel);
+        else client->cancelOrder(orderId, cancel);
+    }
+
+    void reqGlobalCancel(const OrderCancel& cancel) const {
+        if (orderGateway) orderGateway->reqGlobalCancel(cancel);
+        else client->reqGlobalCancel(cancel);
+    }
+
+    void reqOpenOrders() const {
+        if (orderGateway) orderGateway->reqOpenOrders();
+        else client->reqOpenOrders();
+    }
+
+    void reqAllOpenOrders() const {
+        if (orderGateway) orderGateway->reqOpenOrders();
+        else client->reqAllOpenOrders();
+    }
+
+    /// A gateway reports order changes unasked, so this only reaches TWS
+    void reqAutoOpenOrders(bool enable) const {
+        if (!orderGateway) client->reqAutoOpenOrders(enable);
+    }
+
+    void reqPositions() const {
+        if (orderGateway) orderGateway->reqPositions();
+        else client->reqPositions();
+    }
 };
 
 #endif
@@ -0,0 +1,247 @@
+#ifndef QUANTDREAMCPP_IBHISTORICALWRAPPER_H
+#define QUANTDREAMCPP_IBHISTORICALWRAPPER_H
+
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "IBBaseWrapper.h"
+#include "data_structures/historical_pacer.h"
+#include "storage/bar_store.h"
+#include "storage/tick_archive.h"
+
+/**
+ * @file IBHistoricalWrapper.h
+ * @brief Historical bar, tick and head-timestamp callbacks
+ *
+ * Bars of a `reqHistoricalData` response are buffered per request and delivered as one
+ * `HistoricalBars` promise on `historicalDataEnd`; `reqHistoricalTicks` responses become
+ * one `HistoricalTicks` promise when IB flags the last batch as done. Errors addressed
+ * to a historical request ID complete the same promise with the error code, so callers
+ * never hang on a rejected request (no data, pacing violation, missing permissions).
+ */
+
+/**
+ * @brief Error status shared by historical responses
+ */
+struct HistoricalStatus {
+  int errorCode = 0;            ///< IB error code, 0 on success
+  std::string errorMessage;
+
+  bool ok() const noexcept { return errorCode == 0; }
+
+  /// IB reports an empty result as error 162 "HMDS query returned no data"
+  bool noData() const { return errorCode == 162 && errorMessage.find("no data") != std::string::npos; }
+
+  /// Error 162 caused by the historical data pacing limits
+  bool pacingViolation() const {
+    return errorCode == 162 && errorMessage.find("pacing violation") != std::string::npos;
+  }
+};
+
+/**
+ * @brief Result of one historical bar request
+ */
+struct HistoricalBars : HistoricalStatus {
+  std::vector<IB::Storage::BarRow> bars;
+};
+
+/**
+ * @brief Result of one reqHistoricalTicks request, as archive records
+ *
+ * TRADES ticks become LAST records, BID_ASK ticks a BID and an ASK record with the
+ * same timestamp, MIDPOINT ticks records with `field = MIDPOINT_FIELD` (IB has no tick
+ * type for them). Timestamps have IB's one-second resolution.
+ */
+struct HistoricalTicks : HistoricalStatus {
+  static constexpr int16_t MIDPOINT_FIELD = -1;
+
+  std::vector<IB::Storage::TickRecord> ticks;
+  size_t received = 0;          ///< Ticks as counted by IB (before the BID_ASK split)
+};
+
+/**
+ * @class IBHistoricalWrapper
+ * @brief Handles historicalData / historicalDataEnd / headTimestamp / historicalTicks*.
+ *
+ * Extends IBBaseWrapper; see `request/historical/historical.h` for the request helpers,
+ * `request/historical/backfill.h` for the paced bar backfill into a `BarStore` and
+ * `request/historical/tick_backfill.h` for the tick download into the tick archive.
+ */
+class IBHistoricalWrapper : public virtual IBBaseWrapper {
+public:
+  /// Pacing state shared by every historical request sent through this connection
+  IB::MarketData::HistoricalPacer historicalPacer;
+
+  /**
+   * @brief Called once per bar of a reqHistoricalData response
+   */
+  void historicalData(TickerId reqId, const Bar& bar) override {
+    IB::Storage::BarRow row;
+    row.time = parseBarTime(bar.time);
+    row.open = bar.open;
+    row.high = bar.high;
+    row.low = bar.low;
+    row.close = bar.close;
+    row.volume = DecimalFunctions::decimalToDouble(bar.volume);
+    row.wap = DecimalFunctions::decimalToDouble(bar.wap);
+    row.count = bar.count;
+
+    std::lock_guard<std::mutex> lk(historicalMutex_);
+    historicalBuffer_[static_cast<int>(reqId)].bars.push_back(row);
+  }
+
+  /**
+   * @brief Called when all bars of a request were delivered
+   *
+   * Fulfills a `HistoricalBars` promise registered under `reqId`.
+   */
+  void historicalDataEnd(int reqId, const std::string& startDateStr, const std::string& endDateStr) override {
+    HistoricalBars result = take(reqId);
+    LOG_DEBUG("[Historical] historicalDataEnd(", reqId, ") ", startDateStr, " - ", endDateStr,
+              " bars=", result.bars.size());
+    fulfillPromise(reqId, result);
+  }
+
+  /**
+   * @brief Earliest data point available for a contract / data type
+   *
+   * Fulfills a `std::string` promise; with formatDate=2 the value is epoch seconds.
+   */
+  void headTimestamp(int reqId, const std::string& headTimestamp) override {
+    LOG_DEBUG("[Historical] headTimestamp(", reqId, ") = ", headTimestamp);
+    fulfillPromise(reqId, headTimestamp);
+  }
+
+  /// MIDPOINT ticks
+  void historicalTicks(int reqId, const std::vector<HistoricalTick>& ticks, bool done) override {
+    collectTicks(reqId, ticks.size(), done, [&](std::vector<IB::Storage::TickRecord>& out) {
+      for (const auto& t : ticks)
+        out.push_back(tickRecord(t.time, t.price, DecimalFunctions::decimalToDouble(t.size),
+                                 HistoricalTicks::MIDPOINT_FIELD));
+    });
+  }
+
+  /// BID_ASK ticks
+  void historicalTicksBidAsk(int reqId, const std::vector<HistoricalTickBidAsk>& ticks, bool done) override {
+    collectTicks(reqId, ticks.size(), done, [&](std::vector<IB::Storage::TickRecord>& out) {
+      for (const auto& t : ticks) {
+        out.push_back(tickRecord(t.time, t.priceBid, DecimalFunctions::decimalToDouble(t.sizeBid), BID));
+        out.push_back(tickRecord(t.time, t.priceAsk, DecimalFunctions::decimalToDouble(t.sizeAsk), ASK));
+      }
+    });
+  }
+
+  /// TRADES ticks
+  void historicalTicksLast(int reqId, const std::vector<HistoricalTickLast>& ticks, bool done) override {
+    collectTicks(reqId, ticks.size(), done, [&](std::vector<IB::Storage::TickRecord>& out) {
+      for (const auto& t : ticks)
+        out.push_back(tickRecord(t.time, t.price, DecimalFunctions::decimalToDouble(t.size), LAST));
+    });
+  }
+
+  /**
+   * @brief Completes historical requests that IB rejected
+   *
+   * Only IDs in the historical range are handled; warnings (2100-2999) are logged and
+   * leave the request pending.
+   */
+  void error(int id, time_t, int errorCode, const std::string& errorString, const std::string&) override {
+    if (id < IB::ReqId::HISTORICAL_DATA_ID || id >= IB::ReqId::HISTORICAL_TICKS_ID + 1000) return;
+    if (errorCode >= 2100 && errorCode < 3000) {
+      LOG_DEBUG("[Historical] reqId=", id, " warning [", errorCode, "] ", errorString);
+      return;
+    }
+    if (id >= IB::ReqId::HISTORICAL_TICKS_ID) {
+      HistoricalTicks result;
+      {
+        std::lock_guard<std::mutex> lk(historicalMutex_);
+        if (auto it = tickBuffer_.find(id); it != tickBuffer_.end()) {
+          result = std::move(it->second);
+          tickBuffer_.erase(it);
+        }
+      }
+      result.errorCode = errorCode;
+      result.errorMessage = errorString;
+      fulfillPromise(id, result);
+      return;
+    }
+    if (id >= IB::ReqId::HEAD_TIMESTAMP_ID) {
+      LOG_WARN("[Historical] headTimestamp reqId=", id, " failed [", errorCode, "] ", errorString);
+      fulfillPromise(id, std::string());
+      return;
+    }
+    HistoricalBars result = take(id);
+    result.errorCode = errorCode;
+    result.errorMessage = errorString;
+    fulfillPromise(id, result);
+  }
+
+  /**
+   * @brief Bar time as seconds since epoch
+   *
+   * Accepts epoch seconds (formatDate=2 intraday), "yyyyMMdd" (daily bars) and
+   * "yyyyMMdd HH:mm:ss[ zone]" / "yyyyMMdd-HH:mm:ss" (read as UTC). Returns 0 if unparsable.
+   */
+  static int64_t parseBarTime(const std::string& text) {
+    using namespace std::chrono;
+    if (text.empty()) return 0;
+    const bool digits = text.find_first_not_of("0123456789") == std::string::npos;
+    if (digits && text.size() != 8) return std::strtoll(text.c_str(), nullptr, 10);
+    if (text.size() < 8) return 0;
+
+    const int ymd = std::atoi(text.substr(0, 8).c_str());
+    const year_month_day date{year(ymd / 10000), month(static_cast<unsigned>(ymd / 100 % 100)),
+                              day(static_cast<unsigned>(ymd % 100))};
+    if (!date.ok()) return 0;
+    int64_t t = duration_cast<seconds>(sys_days(date).time_since_epoch()).count();
+    if (text.size() >= 17 && (text[8] == ' ' || text[8] == '-'))
+      t += std::atoi(text.substr(9, 2).c_str()) * 3600 + std::atoi(text.substr(12, 2).c_str()) * 60 +
+           std::atoi(text.substr(15, 2).c_str());
+    return t;
+  }
+
+private:
+  static IB::Storage::TickRecord tickRecord(long long time, double price, double size, int field) {
+    IB::Storage::TickRecord r;
+    r.timestampNs = static_cast<int64_t>(time) * 1'000'000'000LL;
+    r.price = price;
+    r.size = size;
+    r.field = static_cast<int16_t>(field);
+    return r;
+  }
+
+  template <typename Convert>
+  void collectTicks(int reqId, size_t received, bool done, Convert&& convert) {
+    HistoricalTicks result;
+    {
+      std::lock_guard<std::mutex> lk(historicalMutex_);
+      auto& buffer = tickBuffer_[reqId];
+      convert(buffer.ticks);
+      buffer.received += received;
+      if (!done) return;
+      result = std::move(buffer);
+      tickBuffer_.erase(reqId);
+    }
+    fulfillPromise(reqId, result);
+  }
+
+  HistoricalBars take(int reqId) {
+    HistoricalBars result;
+    std::lock_guard<std::mutex> lk(historicalMutex_);
+    if (auto it = historicalBuffer_.find(reqId); it != historicalBuffer_.end()) {
+      result = std::move(it->second);
+      historicalBuffer_.erase(it);
+    }
+    return result;
+  }
+
+  std::mutex historicalMutex_;                                   ///< Guards the response buffers
+  std::unordered_map<int, HistoricalBars> historicalBuffer_;     ///< Bar responses being received
+  std::unordered_map<int, HistoricalTicks> tickBuffer_;          ///< Tick responses being received
+};
+
+#endif  // QUANTDREAMCPP_IBHISTORICALWRAPPER_H
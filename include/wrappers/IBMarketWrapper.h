@@ -1,8 +1,13 @@
 #ifndef QUANTDREAMCPP_IBMARKETWRAPPER_H
 #define QUANTDREAMCPP_IBMARKETWRAPPER_H
 
+#include <chrono>
+#include <cstdio>
+
 #include "IBBaseWrapper.h"
+#include "helpers/clock.h"
 #include "helpers/tick_to_string.h"
+#include "storage/tick_archive.h"
 #include "strategy/position_manager.h"
 
 /**
@@ -22,6 +27,9 @@
  */
 class IBMarketWrapper : public virtual IBBaseWrapper {
 public:
+  /// Optional tick archive; when set, every price and size tick of a subscribed ticker is appended
+  IB::Storage::TickArchiveWriter* tickArchive = nullptr;
+
   /**
    * @brief Called when IB sends a price tick (bid, ask, last, open, close, etc.)
    * @param tickerId Unique identifier for the market data request
@@ -29,9 +37,12 @@ public:
    * @param price Price value for the tick
    * @param attrib Tick attributes (e.g., can auto-execute)
    *
-   * Updates the market snapshot with price data. When all required fields are
-   * received based on the request mode, fulfills the associated promise and
-   * optionally cancels the market data subscription for snapshot requests.
+   * Updates the market snapshot with price data. BID, ASK and LAST ticks pass through
+   * the quote sanity filter first: out-of-band prices are dropped, and the snapshot's
+   * quality flags are refreshed so that only usable quotes (not crossed, halted or
+   * stale) reach the PositionManager. When all required fields are received based
+   * on the request mode, fulfills the associated promise and optionally cancels the
+   * market data subscription for snapshot requests.
    */
   void tickPrice(TickerId tickerId, TickType field, double price, const TickAttrib& attrib) override {
     if (price < 0) return;
@@ -39,36 +50,46 @@ public:
     auto it = snapshotData.find(tickerId);
     if (it == snapshotData.end()) return;
     auto& snap = it->second;
+    snap.trace.begin(IB::Helpers::TraceStage::TICK_PRICE);
+    IB::Helpers::TickTrace::Current traced(snap.trace);
 
-    // Optional: detect secType
-    std::string secType;
-    if (auto c = reqIdToContract.find(tickerId); c != reqIdToContract.end())
-      secType = c->second.secType;
+    using Book = IB::MarketData::QuoteBook;
+    using Filter = IB::MarketData::QuoteFilter;
+    const size_t row = bookRow(tickerId, snap);
+    const int64_t nowNs = IB::Helpers::steadyNowNs();
 
     // Update price fields
     switch (field) {
       case BID:
-        snap.bid = price;
-        if (auto* pm = getPositionManager()) pm->onBid(tickerId, price);
+        if (!quoteFilter.apply(row, Filter::BID, price, nowNs, snap)) break;
+        quoteBook.set(row, Book::BID, price);
+        if (auto* pm = getPositionManager(); pm && snap.usable()) pm->onBid(tickerId, price);
         break;
       case ASK:
-        snap.ask = price;
-        if (auto* pm = getPositionManager()) pm->onAsk(tickerId, price);
+        if (!quoteFilter.apply(row, Filter::ASK, price, nowNs, snap)) break;
+        quoteBook.set(row, Book::ASK, price);
+        if (auto* pm = getPositionManager(); pm && snap.usable()) pm->onAsk(tickerId, price);
         break;
       case LAST:
       case DELAYED_LAST:
-        snap.last = price;
-        if (auto* pm = getPositionManager()) pm->onLast(tickerId, price);
+        if (!quoteFilter.apply(row, Filter::LAST, price, nowNs, snap)) break;
+        quoteBook.set(row, Book::LAST, price);
+        if (auto* pm = getPositionManager(); pm && snap.usable()) pm->onLast(tickerId, price);
         break;
-      case OPEN:  snap.open  = price; break;
-      case CLOSE: snap.close = price; break;
-      case HIGH:  snap.high  = price; break;
-      case LOW:   snap.low   = price; break;
+      case OPEN:  snap.open  = price; quoteBook.set(row, Book::OPEN,  price); break;
+      case CLOSE: snap.close = price; quoteBook.set(row, Book::CLOSE, price); break;
+      case HIGH:  snap.high  = price; quoteBook.set(row, Book::HIGH,  price); break;
+      case LOW:   snap.low   = price; quoteBook.set(row, Book::LOW,   price); break;
       default: break;
     }
 
-    // Compute and notify mid price if both bid and ask are available
-    if (snap.hasBidAsk()) {
+    if (tickArchive) archiveTick(tickerId, field, price, 0.0, snap.quality);
+    if (orderGateway) forwardToGateway(tickerId, field, price, 0.0);
+
+    // Notify the mid only when a quote side moved and both sides are available and sane;
+    // PositionManager's change filters drop ticks that leave the mid unchanged
+    const bool quoteTick = field == BID || field == ASK;
+    if (quoteTick && snap.hasBidAsk() && snap.usable()) {
       if (auto* pm = getPositionManager()) {
         double mid = (snap.bid + snap.ask) / 2.0;
         pm->onMid(tickerId, mid);
@@ -78,7 +99,7 @@ public:
     LOG_DEBUG("[tickPrice] ID=", tickerId,
               " Field=", IB::Helpers::tickTypeToString(field),
               " Price=", price,
-              " SecType=", secType.empty() ? "UNKNOWN" : secType);
+              " SecType=", secTypeOf(tickerId));
 
     // --- Unified readiness check ---
     if (!snap.fulfilled && snap.readyForFulfill()) {
@@ -153,14 +174,58 @@ public:
    * @param field Type of size tick
    * @param size Size value for the tick
    *
-   * Logs size information for debugging purposes. Size data is not currently
-   * used to determine snapshot fulfillment.
+   * Stores bid/ask/last sizes and cumulative volume into the market snapshot and
+   * the quote book. Bid/ask size ticks feed the order-flow imbalance with the side's
+   * latest price: IB follows every bid/ask price tick with its size tick, so feeding
+   * the price tick as well would count each quote change twice. A LAST_SIZE
+   * tick completes the trade print started by the preceding LAST price tick and
+   * updates rolling VWAP and trade-sign statistics. Size data is not used to
+   * determine snapshot fulfillment.
    */
   void tickSize(TickerId tickerId, TickType field, Decimal size) override {
-    double val = static_cast<double>(size);
+    double val = DecimalFunctions::decimalToDouble(size);
     LOG_DEBUG("[tickSize]   ID=", tickerId,
               "  Field=", IB::Helpers::tickTypeToString(field),
               "  Size=", val);
+
+    if (val < 0) return;
+
+    auto it = snapshotData.find(tickerId);
+    if (it == snapshotData.end()) return;
+    auto& snap = it->second;
+
+    using Book = IB::MarketData::QuoteBook;
+    const size_t row = bookRow(tickerId, snap);
+
+    switch (field) {
+      case BID_SIZE:
+      case DELAYED_BID_SIZE:
+        snap.bidSize = val;
+        quoteBook.set(row, Book::BID_SIZE, val);
+        microstructure.onQuote(row, snap.bid, snap.bidSize, snap.ask, snap.askSize);
+        break;
+      case ASK_SIZE:
+      case DELAYED_ASK_SIZE:
+        snap.askSize = val;
+        quoteBook.set(row, Book::ASK_SIZE, val);
+        microstructure.onQuote(row, snap.bid, snap.bidSize, snap.ask, snap.askSize);
+        break;
+      case LAST_SIZE:
+      case DELAYED_LAST_SIZE:
+        snap.lastSize = val;
+        quoteBook.set(row, Book::LAST_SIZE, val);
+        microstructure.onTrade(row, snap.last, val);
+        break;
+      case VOLUME:
+      case DELAYED_VOLUME:
+        snap.volume = val;
+        quoteBook.set(row, Book::VOLUME, val);
+        break;
+      default: break;
+    }
+
+    if (tickArchive) archiveTick(tickerId, field, 0.0, val, snap.quality);
+    if (orderGateway) forwardToGateway(tickerId, field, 0.0, val);
   }
 
   /**
@@ -186,11 +251,19 @@ public:
    * @param value Numerical value for the tick
    *
    * Logs generic tick data for debugging purposes (e.g., mark price, option implied vol).
+   * HALTED / DELAYED_HALTED ticks update the halt state in the quote filter.
    */
   void tickGeneric(TickerId tickerId, TickType tickType, double value) override {
     LOG_DEBUG("[tickGeneric] ID=", tickerId,
               "  Field=", IB::Helpers::tickTypeToString(tickType),
               "  Value=", value);
+
+    if (tickType == HALTED || tickType == DELAYED_HALTED) {
+      auto it = snapshotData.find(tickerId);
+      if (it == snapshotData.end()) return;
+      quoteFilter.onHalted(bookRow(tickerId, it->second), value, it->second);
+      if (value > 0.0) LOG_WARN("[IB] Trading halted for reqId=", tickerId, " (code ", value, ")");
+    }
   }
 
   /**
@@ -230,19 +303,9 @@ public:
       return;
     }
 
-    // --- Step 3. Resolve metadata (for logging and mapping) ---
-    std::string sym = "UNKNOWN", right = "?", expiry = "";
-    double strike = 0.0;
-    if (auto it = reqIdToContract.find(tickerId); it != reqIdToContract.end()) {
-      const Contract& opt = it->second;
-      sym = opt.symbol;
-      right = opt.right;
-      strike = opt.strike;
-      expiry = opt.lastTradeDateOrContractMonth;
-    }
-
+    // --- Step 3. Log (the contract is looked up only when debug logging is on) ---
     LOG_DEBUG("[tickOptionComputation] ID=", tickerId,
-              " ", sym, " ", right, " ", strike,
+              " ", optionLabelOf(tickerId),
               " IV=", impliedVol,
               " Δ=", delta,
               " Γ=", gamma,
@@ -368,11 +431,12 @@ public:
    * @param reqId Request identifier for the contract details request
    * @param details Full contract details from IB
    *
-   * Attempts to fulfill promises with either full ContractDetails or just the
-   * Contract portion, depending on the type expected by the promise. This allows
-   * flexibility in what the caller requests.
+   * Stores the details in the contract cache, then attempts to fulfill promises
+   * with either full ContractDetails or just the Contract portion, depending on the
+   * type expected by the promise. This allows flexibility in what the caller requests.
    */
   void contractDetails(int reqId, const ContractDetails& details) override {
+    contractCache.put(details);
     bool fulfilled = false;
 
     {
@@ -383,7 +447,7 @@ public:
           // Case 1: user requested full ContractDetails
           auto ptr = std::any_cast<std::shared_ptr<std::promise<ContractDetails>>>(it->second);
           ptr->set_value(details);
-          genericPromises.erase(it);
+          erasePromise(it);
           fulfilled = true;
           LOG_DEBUG("[IB] fulfillPromise<ContractDetails> for reqId=", reqId);
         } catch (const std::bad_any_cast&) {
@@ -420,6 +484,45 @@ protected:
    * returns the instance from IBAccountWrapper.
    */
   virtual PositionManager* getPositionManager() const { return nullptr; }
+
+  /// Security type of a ticker's contract, for log lines ("UNKNOWN" if not known)
+  std::string secTypeOf(TickerId tickerId) const {
+    auto c = reqIdToContract.find(tickerId);
+    return c == reqIdToContract.end() || c->second.secType.empty() ? "UNKNOWN" : c->second.secType;
+  }
+
+  /// "SYMBOL RIGHT STRIKE" of an option ticker, for log lines
+  std::string optionLabelOf(TickerId tickerId) const {
+    auto c = reqIdToContract.find(tickerId);
+    if (c == reqIdToContract.end()) return "UNKNOWN ? 0";
+    char strike[32];
+    std::snprintf(strike, sizeof(strike), "%g", c->second.strike);
+    return c->second.symbol + " " + c->second.right + " " + strike;
+  }
+
+  /**
+   * @brief Queues a tick for the archive (never blocks; dropped if the archive is saturated)
+   *
+   * Ticks are keyed by the conId of the subscribed contract; tickers without a resolved
+   * conId are not archived.
+   */
+  void archiveTick(TickerId tickerId, TickType field, double price, double size, uint16_t quality) {
+    auto c = reqIdToContract.find(tickerId);
+    if (c == reqIdToContract.end() || c->second.conId == 0) return;
+    IB::Storage::TickRecord rec;
+    rec.timestampNs = IB::Helpers::wallNowNs();
+    rec.price = price;
+    rec.size = size;
+    rec.field = static_cast<int16_t>(field);
+    rec.flags = quality;
+    tickArchive->append(c->second.conId, rec);
+  }
+
+  /// Passes a raw tick to the attached order gateway so a simulated broker matches on it
+  void forwardToGateway(TickerId tickerId, TickType field, double price, double size) {
+    if (auto c = reqIdToContract.find(tickerId); c != reqIdToContract.end())
+      orderGateway->onMarketData(c->second, field, price, size);
+  }
 };
 
 #endif
@@ -0,0 +1,96 @@
+#ifndef QUANTDREAMCPP_IBNEWSWRAPPER_H
+#define QUANTDREAMCPP_IBNEWSWRAPPER_H
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "IBBaseWrapper.h"
+#include "strategy/news_router.h"
+
+/**
+ * @file IBNewsWrapper.h
+ * @brief News headline callbacks routed to strategy watch-lists
+ *
+ * Streaming headlines (`tickNews`) are matched against every registered watch-list
+ * in one pass and dispatched to the interested strategies. Historical headlines are
+ * routed the same way and also collected for the synchronous request helper.
+ */
+
+/**
+ * @class IBNewsWrapper
+ * @brief Handles news ticks and historical news.
+ *
+ * Extends IBBaseWrapper; see `request/news/news.h` for the request helpers.
+ */
+class IBNewsWrapper : public virtual IBBaseWrapper {
+public:
+  /// Keyword router shared by all strategies
+  NewsRouter news;
+
+  /**
+   * @brief Called for each headline of a news tick subscription (generic tick 292)
+   *
+   * @param tickerId Market data request identifier
+   * @param timeStamp Headline time in milliseconds since epoch
+   */
+  void tickNews(int tickerId, time_t timeStamp, const std::string& providerCode,
+                const std::string& articleId, const std::string& headline,
+                const std::string& extraData) override {
+    NewsItem item;
+    item.reqId = tickerId;
+    item.timestamp = timeStamp / 1000;
+    item.providerCode = providerCode;
+    item.articleId = articleId;
+    item.headline = headline;
+    item.extraData = extraData;
+
+    const size_t notified = news.onNews(item);
+    LOG_DEBUG("[News] ", providerCode, " ", articleId, " \"", headline, "\" → ", notified, " watch-lists");
+  }
+
+  /**
+   * @brief Called for each headline returned by reqHistoricalNews
+   *
+   * Routes the headline like a live one and buffers it until historicalNewsEnd.
+   */
+  void historicalNews(int requestId, const std::string& time, const std::string& providerCode,
+                      const std::string& articleId, const std::string& headline) override {
+    NewsItem item;
+    item.reqId = requestId;
+    item.time = time;
+    item.providerCode = providerCode;
+    item.articleId = articleId;
+    item.headline = headline;
+
+    news.onNews(item);
+    std::lock_guard<std::mutex> lk(newsMutex_);
+    newsBuffer_[requestId].push_back(std::move(item));
+  }
+
+  /**
+   * @brief Called when a historical news request is complete
+   *
+   * Fulfills a `std::vector<NewsItem>` promise registered under `requestId`.
+   *
+   * @param hasMore True if more headlines exist beyond the requested count
+   */
+  void historicalNewsEnd(int requestId, bool hasMore) override {
+    std::vector<NewsItem> items;
+    {
+      std::lock_guard<std::mutex> lk(newsMutex_);
+      if (auto it = newsBuffer_.find(requestId); it != newsBuffer_.end()) {
+        items = std::move(it->second);
+        newsBuffer_.erase(it);
+      }
+    }
+    LOG_DEBUG("[News] historicalNewsEnd(", requestId, ") headlines=", items.size(), " hasMore=", hasMore);
+    fulfillPromise(requestId, items);
+  }
+
+private:
+  std::mutex newsMutex_;                                        ///< Guards newsBuffer_
+  std::unordered_map<int, std::vector<NewsItem>> newsBuffer_;   ///< Historical headlines being received
+};
+
+#endif  // QUANTDREAMCPP_IBNEWSWRAPPER_H
@@ -0,0 +1,132 @@
+#ifndef QUANTDREAMCPP_IBSCANNERWRAPPER_H
+#define QUANTDREAMCPP_IBSCANNERWRAPPER_H
+
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "IBBaseWrapper.h"
+#include "strategy/universe_manager.h"
+
+/**
+ * @file IBScannerWrapper.h
+ * @brief Market scanner callbacks feeding a dynamic universe
+ *
+ * Collects `scannerData` rows per request and, on `scannerDataEnd`, either hands the
+ * complete result set to the `UniverseManager` (continuous subscriptions) or fulfills
+ * a pending promise (one-shot scans). The universe opens and closes streaming market
+ * data for the names that enter and leave, within the wrapper's line budget.
+ */
+
+/**
+ * @class IBScannerWrapper
+ * @brief Handles market scanner results and the scanner-driven universe.
+ *
+ * Extends IBBaseWrapper; see `request/scanner/scanner.h` for the request helpers.
+ */
+class IBScannerWrapper : public virtual IBBaseWrapper {
+public:
+  /// Universe of names selected by the active scanner subscriptions
+  UniverseManager universe;
+
+  IBScannerWrapper()
+    : universe(contractCache, lineBudget, IB::ReqId::UNIVERSE_MARKET_DATA_ID,
+               {[this](int tickerId, const Contract& c) { openUniverseLine(tickerId, c); },
+                [this](int tickerId) { closeUniverseLine(tickerId); }}) {}
+
+  /**
+   * @brief Marks a scanner request as feeding the universe (set by the request helpers)
+   */
+  void routeScanToUniverse(int reqId, bool enabled) {
+    std::lock_guard<std::mutex> lk(scannerMutex_);
+    if (enabled) universeScans_.insert(reqId);
+    else universeScans_.erase(reqId);
+  }
+
+  /**
+   * @brief Called with the XML description of available scanner parameters
+   *
+   * Fulfills a `std::string` promise registered under IB::ReqId::SCANNER_ID.
+   */
+  void scannerParameters(const std::string& xml) override {
+    LOG_DEBUG("[IB] scannerParameters received (", xml.size(), " bytes)");
+    fulfillPromise(IB::ReqId::SCANNER_ID, xml);
+  }
+
+  /**
+   * @brief Called once per row of a scanner result set
+   *
+   * @param reqId Scanner request identifier
+   * @param rank 0-based rank of the row
+   * @param details Contract of the row (conId, symbol, secType, primary exchange...)
+   *
+   * Buffers the row and seeds the contract cache without overwriting richer entries
+   * obtained through contractDetails().
+   */
+  void scannerData(int reqId, int rank, const ContractDetails& details,
+                   const std::string& distance, const std::string& benchmark,
+                   const std::string& projection, const std::string& legsStr) override {
+    (void)legsStr;
+    contractCache.putIfAbsent(details);
+    std::lock_guard<std::mutex> lk(scannerMutex_);
+    scanBuffer_[reqId].push_back({rank, details, distance, benchmark, projection});
+  }
+
+  /**
+   * @brief Called when a scanner result set is complete
+   *
+   * IB resends the full set periodically for live subscriptions; each set is diffed
+   * against the previous one by the universe, so only changes touch subscriptions.
+   */
+  void scannerDataEnd(int reqId) override {
+    std::vector<ScanRow> rows;
+    bool toUniverse = false;
+    {
+      std::lock_guard<std::mutex> lk(scannerMutex_);
+      if (auto it = scanBuffer_.find(reqId); it != scanBuffer_.end()) {
+        rows = std::move(it->second);
+        scanBuffer_.erase(it);
+      }
+      toUniverse = universeScans_.count(reqId) != 0;
+    }
+
+    LOG_DEBUG("[IB] scannerDataEnd(", reqId, ") rows=", rows.size());
+    if (toUniverse) universe.applyScan(reqId, rows);
+    fulfillPromise(reqId, rows);
+  }
+
+protected:
+  /**
+   * @brief Opens a streaming quote subscription for a universe member (IB reader thread)
+   *
+   * The ticker ID may have streamed another name before; bookRow() starts every per-row
+   * state keyed by it (quote book row, microstructure, quote filter) over for the fresh
+   * snapshot entry.
+   */
+  virtual void openUniverseLine(int tickerId, const Contract& contract) {
+    auto& snap = snapshotData[tickerId];
+    snap = {};
+    snap.mode = IB::MarketData::PriceType::QUOTES_ONLY;
+    snap.streaming = true;
+    reqIdToContract[tickerId] = contract;
+    bookRow(tickerId, snap);
+    client->reqMktData(tickerId, contract, "", false, false, nullptr);
+    LOG_DEBUG("[Universe] Subscribed ", contract.symbol, " (conId=", contract.conId, ") as tickerId=", tickerId);
+  }
+
+  /// Cancels a universe member's subscription (IB reader thread)
+  virtual void closeUniverseLine(int tickerId) {
+    client->cancelMktData(tickerId);
+    snapshotData.erase(tickerId);
+    reqIdToContract.erase(tickerId);
+    LOG_DEBUG("[Universe] Unsubscribed tickerId=", tickerId);
+  }
+
+private:
+  std::mutex scannerMutex_;                                  ///< Guards scanBuffer_ and universeScans_
+  std::unordered_map<int, std::vector<ScanRow>> scanBuffer_; ///< Rows of the result set being received
+  std::unordered_set<int> universeScans_;                    ///< Scanner reqIds feeding the universe
+};
+
+#endif  // QUANTDREAMCPP_IBSCANNERWRAPPER_H
@@ -4,6 +4,9 @@
 #include "IBOrdersWrapper.h"
 #include "IBMarketWrapper.h"
 #include "IBAccountWrapper.h"
+#include "IBScannerWrapper.h"
+#include "IBNewsWrapper.h"
+#include "IBHistoricalWrapper.h"
 
 /**
  * @file IBStrategyWrapper.h
@@ -19,9 +22,10 @@
  * @class IBStrategyWrapper
  * @brief Unified interface combining orders, market data, and account management.
  *
- * Inherits virtually from IBOrdersWrapper, IBMarketWrapper, and IBAccountWrapper to provide
- * a complete API for trading strategy implementation. This is the recommended wrapper
- * for strategies that need full market access, position tracking, and order management.
+ * Inherits virtually from IBOrdersWrapper, IBMarketWrapper, IBAccountWrapper,
+ * IBScannerWrapper, IBNewsWrapper and IBHistoricalWrapper to provide a complete API
+ * for trading strategy implementation. This is the recommended wrapper for strategies that need full market
+ * access, position tracking, and order management.
  *
  * Uses virtual inheritance to resolve the diamond problem arising from multiple base
  * classes all inheriting from IBBaseWrapper. Rebinds the EClientSocket in the constructor
@@ -30,7 +34,10 @@
 class IBStrategyWrapper :
   public virtual IBOrdersWrapper,
   public virtual IBMarketWrapper,
-  public virtual IBAccountWrapper {
+  public virtual IBAccountWrapper,
+  public virtual IBScannerWrapper,
+  public virtual IBNewsWrapper,
+  public virtual IBHistoricalWrapper {
 public:
   /// Import connect method from IBBaseWrapper to avoid ambiguity
   using IBBaseWrapper::connect;
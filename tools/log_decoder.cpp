@@ -0,0 +1,177 @@
+/**
+ * @file log_decoder.cpp
+ * @brief Renders a binary log (`LogFormat::BINARY`) as text or CSV
+ *
+ * Text output is line-for-line what the text logger would have printed, optionally
+ * prefixed with the record's UTC timestamp. CSV has one row per record:
+ *
+ *   timestamp_ns,level,file,line,message,values
+ *
+ * where `values` are the recorded (non-literal) arguments joined with ';', so the rows
+ * of one call site can be split into columns. `--sites` lists the call-site table with
+ * `{}` for each recorded argument.
+ *
+ * Usage: log_decoder [--csv | --sites] [--time] [file]   (stdin without a file)
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "helpers/log_file.h"
+
+using namespace IB::Helpers::Logging;
+
+namespace {
+
+  enum class Mode { TEXT, CSV, SITES };
+
+  struct Settings {
+    Mode mode = Mode::TEXT;
+    bool time = false;
+    const char* path = nullptr;
+  };
+
+  void appendTime(int64_t ns, std::string& out) {
+    const std::time_t secs = static_cast<std::time_t>(ns / 1'000'000'000);
+    char buf[48];
+    const std::tm* tm = std::gmtime(&secs);
+    if (!tm) return;
+    const size_t n = std::strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", tm);
+    std::snprintf(buf + n, sizeof(buf) - n, ".%09lld ", static_cast<long long>(ns % 1'000'000'000));
+    out += buf;
+  }
+
+  void appendCsvField(std::string_view field, std::string& out) {
+    if (field.find_first_of(",\"\n\r") == std::string_view::npos) {
+      out += field;
+      return;
+    }
+    out.push_back('"');
+    for (char c : field) {
+      if (c == '"') out.push_back('"');
+      out.push_back(c);
+    }
+    out.push_back('"');
+  }
+
+  void appendCsvRow(const RecordHeader& h, const SiteInfo* site, std::string& out) {
+    std::string field;
+    out += std::to_string(h.timestampNs);
+    out.push_back(',');
+    out += levelName(h.level);
+    out.push_back(',');
+    if (site) {
+      appendCsvField(site->file, out);
+      out += "," + std::to_string(site->line);
+    } else {
+      out.push_back(',');
+    }
+    out.push_back(',');
+    renderMessage(h, site, field);
+    appendCsvField(field, out);
+    out.push_back(',');
+
+    field.clear();
+    const char* p = payloadOf(h);
+    const char* const end = recordEnd(h);
+    for (bool first = true;; first = false) {
+      const size_t at = field.size();
+      if (!first) field.push_back(';');
+      if (!formatArg(p, end, field)) {
+        field.resize(at);
+        break;
+      }
+    }
+    appendCsvField(field, out);
+    out.push_back('\n');
+  }
+
+  void appendSiteLine(uint16_t id, const SiteInfo& site, std::string& out) {
+    out += std::to_string(id) + " " + levelName(site.level) + " " + site.file + ":" + std::to_string(site.line) + " \"";
+    for (const auto& seg : site.segments) out += seg.literal ? seg.text : std::string("{}");
+    out += "\"\n";
+  }
+
+  int decode(std::FILE* in, const Settings& settings) {
+    LogFileReader reader(in);
+    if (!reader.open()) {
+      std::fprintf(stderr, "log_decoder: %s\n", reader.error().c_str());
+      return 1;
+    }
+
+    std::string out;
+    if (settings.mode == Mode::CSV) out = "timestamp_ns,level,file,line,message,values\n";
+    int rc = 0;
+    for (;;) {
+      const auto entry = reader.next();
+      if (entry == LogFileReader::Entry::END) break;
+      if (entry == LogFileReader::Entry::CORRUPT) {
+        std::fprintf(stderr, "log_decoder: %s\n", reader.error().c_str());   // e.g. the process died mid-write
+        rc = 1;
+        break;
+      }
+
+      if (entry == LogFileReader::Entry::SITE) {
+        if (settings.mode == Mode::SITES) appendSiteLine(reader.siteId(), reader.site(reader.siteId()), out);
+      } else if (settings.mode == Mode::CSV) {
+        appendCsvRow(reader.record(), reader.siteOf(reader.record()), out);
+      } else if (settings.mode == Mode::TEXT) {
+        if (settings.time) appendTime(reader.record().timestampNs, out);
+        renderRecord(reader.record(), reader.siteOf(reader.record()), out);
+      }
+
+      if (out.size() >= (1 << 16)) {
+        std::fwrite(out.data(), 1, out.size(), stdout);
+        out.clear();
+      }
+    }
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    return rc;
+  }
+
+  void usage() {
+    std::fprintf(stderr,
+                 "usage: log_decoder [--csv | --sites] [--time] [file]\n"
+                 "  reads stdin without a file; --time prefixes text lines with the UTC timestamp\n");
+  }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Settings settings;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--csv") settings.mode = Mode::CSV;
+    else if (arg == "--sites") settings.mode = Mode::SITES;
+    else if (arg == "--time") settings.time = true;
+    else if (!settings.path && arg[0] != '-') settings.path = argv[i];
+    else {
+      usage();
+      return 2;
+    }
+  }
+
+  std::FILE* in = stdin;
+  if (settings.path) {
+    in = std::fopen(settings.path, "rb");
+    if (!in) {
+      std::perror(settings.path);
+      return 1;
+    }
+  } else {
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+#endif
+  }
+  const int rc = decode(in, settings);
+  if (in != stdin) std::fclose(in);
+  return rc;
+}
@@ -0,0 +1,924 @@
+/**
+ * @file mock_tws.cpp
+ * @brief Local stand-in for TWS / IB Gateway speaking a subset of the API wire protocol
+ *
+ * Lets the real `EClientSocket` / `EReader` stack, and everything built on it, run
+ * against localhost without an IB login, e.g. to benchmark the wire → callback path.
+ * Single-threaded, poll-driven; any number of clients.
+ *
+ * Supported:
+ * - Handshake (`API\0` + version range) and `startApi`, answered with managedAccounts,
+ *   nextValidId and the usual market data farm notices
+ * - `reqMktData` / `cancelMktData`: synthetic bid / ask / last streams at `--rate`
+ *   updates per second per subscription (0 = as fast as the socket drains), plus
+ *   model option computations for options; snapshots end with tickSnapshotEnd
+ * - `reqContractDetails` for stocks and options (an option request without strike,
+ *   right or expiry enumerates the matching chain), `reqSecDefOptParams`
+ * - `placeOrder` / `cancelOrder` / `reqGlobalCancel`: orderStatus acknowledgments;
+ *   MKT and marketable LMT orders fill at the synthetic touch, other limits fill when
+ *   the touch reaches them
+ * - `reqIds`, `reqCurrentTime`, `reqPositions` (positions built from the fills),
+ *   `reqOpenOrders` / `reqAllOpenOrders` (openOrderEnd only)
+ *
+ * Messages are encoded as server version 104, the lowest version with
+ * `reqSecDefOptParams`, which every current client still accepts and whose message
+ * layouts carry the fewest optional fields. Other requests are logged and ignored.
+ *
+ * Prices: stocks random-walk on a $0.01 grid from `--symbol SYM=price` (or a price
+ * derived from the symbol); options are priced by Black-Scholes at 25% volatility.
+ *
+ * Usage: mock_tws [--port 7497] [--rate 10] [--symbol AAPL=190.5 ...] [--seed 1] [--verbose]
+ */
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "helpers/logger.h"
+
+namespace {
+
+  using Clock = std::chrono::steady_clock;
+
+  constexpr int SERVER_VERSION = 104;
+  constexpr int MIN_CLIENT_VERSION = 100;
+  constexpr const char* ACCOUNT = "DU0000000";
+  constexpr size_t UNTHROTTLED_BACKLOG = 256 * 1024;   ///< Rate 0: refill the socket below this many queued bytes
+
+  // Client → server message IDs
+  enum Incoming : int {
+    REQ_MKT_DATA = 1,
+    CANCEL_MKT_DATA = 2,
+    PLACE_ORDER = 3,
+    CANCEL_ORDER = 4,
+    REQ_OPEN_ORDERS = 5,
+    REQ_IDS = 8,
+    REQ_CONTRACT_DATA = 9,
+    REQ_ALL_OPEN_ORDERS = 16,
+    REQ_CURRENT_TIME = 49,
+    REQ_GLOBAL_CANCEL = 58,
+    REQ_MARKET_DATA_TYPE = 59,
+    REQ_POSITIONS = 61,
+    START_API = 71,
+    REQ_SEC_DEF_OPT_PARAMS = 78,
+  };
+
+  // Server → client message IDs
+  enum Outgoing : int {
+    TICK_PRICE = 1,
+    TICK_SIZE = 2,
+    ORDER_STATUS = 3,
+    ERR_MSG = 4,
+    NEXT_VALID_ID = 9,
+    CONTRACT_DATA = 10,
+    MANAGED_ACCTS = 15,
+    TICK_OPTION_COMPUTATION = 21,
+    CURRENT_TIME = 49,
+    CONTRACT_DATA_END = 52,
+    OPEN_ORDER_END = 53,
+    TICK_SNAPSHOT_END = 57,
+    MARKET_DATA_TYPE = 58,
+    POSITION_DATA = 61,
+    POSITION_END = 62,
+    SECURITY_DEFINITION_OPTION_PARAMETER = 75,
+    SECURITY_DEFINITION_OPTION_PARAMETER_END = 76,
+  };
+
+  // Tick types
+  constexpr int BID_FIELD = 1, ASK_FIELD = 2, LAST_FIELD = 4, VOLUME_FIELD = 8, MODEL_OPTION_FIELD = 13;
+
+  struct Settings {
+    int port = 7497;
+    double rate = 10.0;                              ///< Updates per second per subscription; 0 = unthrottled
+    uint64_t seed = 1;
+    bool verbose = false;
+    std::unordered_map<std::string, double> prices;  ///< Initial stock prices by symbol
+  };
+
+  // ------------------------------------------------------------------
+  // Wire format
+  // ------------------------------------------------------------------
+
+  /// Outgoing message: NUL-terminated fields, framed by a 4-byte big-endian length
+  class Message {
+  public:
+    explicit Message(int id) { add(id); }
+
+    Message& add(std::string_view s) {
+      body_.append(s);
+      body_.push_back('\0');
+      return *this;
+    }
+    Message& add(const char* s) { return add(std::string_view(s)); }
+    Message& add(const std::string& s) { return add(std::string_view(s)); }
+    Message& add(int v) { return add(std::to_string(v)); }
+    Message& add(long v) { return add(std::to_string(v)); }
+    Message& add(long long v) { return add(std::to_string(v)); }
+    Message& add(double v) {
+      char buf[32];
+      std::snprintf(buf, sizeof(buf), "%.10g", v);
+      return add(std::string_view(buf));
+    }
+
+    const std::string& body() const noexcept { return body_; }
+
+  private:
+    std::string body_;
+  };
+
+  void appendFramed(std::string& out, std::string_view body) {
+    const auto n = static_cast<uint32_t>(body.size());
+    const char len[4] = {static_cast<char>(n >> 24), static_cast<char>(n >> 16), static_cast<char>(n >> 8),
+                         static_cast<char>(n)};
+    out.append(len, 4);
+    out.append(body);
+  }
+
+  /// Fields of one incoming message; reads past the end yield empty values
+  class Fields {
+  public:
+    explicit Fields(std::string_view body) {
+      size_t start = 0;
+      for (size_t i = 0; i < body.size(); ++i) {
+        if (body[i] != '\0') continue;
+        fields_.push_back(body.substr(start, i - start));
+        start = i + 1;
+      }
+    }
+
+    std::string str() { return next_ < fields_.size() ? std::string(fields_[next_++]) : std::string(); }
+    long integer() { return std::strtol(str().c_str(), nullptr, 10); }
+    double number() {
+      const std::string s = str();
+      return s.empty() ? 0.0 : std::strtod(s.c_str(), nullptr);
+    }
+    void skip(size_t n) { next_ = std::min(fields_.size(), next_ + n); }
+
+  private:
+    std::vector<std::string_view> fields_;
+    size_t next_ = 0;
+  };
+
+  /// Contract fields as the client encodes them
+  struct ContractSpec {
+    long conId = 0;
+    std::string symbol, secType, expiry, right, multiplier, exchange, primaryExchange, currency, localSymbol,
+        tradingClass;
+    double strike = 0.0;
+
+    /// conId, symbol, secType, expiry, strike, right, multiplier, exchange, primaryExchange, currency, localSymbol, tradingClass
+    static ContractSpec read(Fields& f) {
+      ContractSpec c;
+      c.conId = f.integer();
+      c.symbol = f.str();
+      c.secType = f.str();
+      c.expiry = f.str();
+      c.strike = f.number();
+      c.right = f.str();
+      c.multiplier = f.str();
+      c.exchange = f.str();
+      c.primaryExchange = f.str();
+      c.currency = f.str();
+      c.localSymbol = f.str();
+      c.tradingClass = f.str();
+      if (c.right == "CALL") c.right = "C";
+      if (c.right == "PUT") c.right = "P";
+      return c;
+    }
+  };
+
+  // ------------------------------------------------------------------
+  // Synthetic market
+  // ------------------------------------------------------------------
+
+  struct Instrument {
+    long conId = 0;
+    std::string symbol, secType, expiry, right;
+    double strike = 0.0;
+    double multiplier = 1.0;
+    long underConId = 0;
+    double price = 0.0;       ///< Stocks: current mid
+    long long volume = 0;
+  };
+
+  struct Greeks {
+    double price, delta, gamma, vega, theta;
+  };
+
+  double normCdf(double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); }
+
+  Greeks blackScholes(double spot, double strike, double years, bool call) {
+    constexpr double rate = 0.03, vol = 0.25;
+    const double t = std::max(years, 1.0 / 365.0);
+    const double sd = vol * std::sqrt(t);
+    const double d1 = (std::log(spot / strike) + (rate + 0.5 * vol * vol) * t) / sd;
+    const double d2 = d1 - sd;
+    const double disc = std::exp(-rate * t);
+    const double pdf = std::exp(-0.5 * d1 * d1) / std::sqrt(2.0 * std::numbers::pi);
+    Greeks g{};
+    g.price = call ? spot * normCdf(d1) - strike * disc * normCdf(d2) : strike * disc * normCdf(-d2) - spot * normCdf(-d1);
+    g.delta = call ? normCdf(d1) : normCdf(d1) - 1.0;
+    g.gamma = pdf / (spot * sd);
+    g.vega = spot * pdf * std::sqrt(t) / 100.0;
+    g.theta = (-spot * pdf * vol / (2.0 * std::sqrt(t)) -
+               (call ? 1.0 : -1.0) * rate * strike * disc * normCdf(call ? d2 : -d2)) / 365.0;
+    return g;
+  }
+
+  std::tm utcNow() {
+    const std::time_t now = std::time(nullptr);
+    std::tm tm{};
+    gmtime_r(&now, &tm);
+    return tm;
+  }
+
+  /// Years from now to the close of an expiry given as YYYYMMDD
+  double yearsTo(const std::string& expiry) {
+    if (expiry.size() < 8) return 30.0 / 365.0;
+    std::tm tm{};
+    tm.tm_year = std::stoi(expiry.substr(0, 4)) - 1900;
+    tm.tm_mon = std::stoi(expiry.substr(4, 2)) - 1;
+    tm.tm_mday = std::stoi(expiry.substr(6, 2));
+    tm.tm_hour = 20;
+    return std::max(0.0, std::difftime(timegm(&tm), std::time(nullptr)) / (365.0 * 86400.0));
+  }
+
+  uint64_t fnv1a(std::string_view s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (char c : s) h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    return h;
+  }
+
+  class Market {
+  public:
+    explicit Market(const Settings& settings) : settings_(settings), rng_(settings.seed) {}
+
+    /// Instrument of a request; created on first use
+    Instrument& resolve(const ContractSpec& c) {
+      if (c.conId)
+        if (auto it = byConId_.find(c.conId); it != byConId_.end()) return *it->second;
+      const std::string secType = c.secType.empty() ? "STK" : c.secType;
+      if (secType == "OPT" || secType == "FOP") return option(c.symbol, c.expiry, c.strike, c.right);
+      return stock(c.symbol, secType);
+    }
+
+    Instrument& stock(const std::string& symbol, const std::string& secType = "STK") {
+      const std::string key = symbol + "|" + secType;
+      auto it = byKey_.find(key);
+      if (it != byKey_.end()) return *it->second;
+      auto inst = std::make_unique<Instrument>();
+      inst->symbol = symbol;
+      inst->secType = secType;
+      inst->conId = conIdOf(key);
+      auto p = settings_.prices.find(symbol);
+      inst->price = p != settings_.prices.end() ? p->second : 20.0 + static_cast<double>(fnv1a(symbol) % 48000) / 100.0;
+      return insert(key, std::move(inst));
+    }
+
+    Instrument& option(const std::string& symbol, const std::string& expiry, double strike, const std::string& right) {
+      char key[128];
+      std::snprintf(key, sizeof(key), "%s|OPT|%s|%.4f|%s", symbol.c_str(), expiry.c_str(), strike, right.c_str());
+      auto it = byKey_.find(key);
+      if (it != byKey_.end()) return *it->second;
+      auto inst = std::make_unique<Instrument>();
+      inst->symbol = symbol;
+      inst->secType = "OPT";
+      inst->expiry = expiry;
+      inst->strike = strike;
+      inst->right = right;
+      inst->multiplier = 100.0;
+      inst->conId = conIdOf(key);
+      inst->underConId = stock(symbol).conId;
+      return insert(key, std::move(inst));
+    }
+
+    Instrument* find(long conId) {
+      auto it = byConId_.find(conId);
+      return it == byConId_.end() ? nullptr : it->second;
+    }
+
+    /// Moves the underlying of `inst` one random step on the $0.01 grid
+    void step(Instrument& inst) {
+      Instrument& u = inst.underConId ? *byConId_.at(inst.underConId) : inst;
+      static constexpr int moves[] = {-1, 0, 0, 1};
+      u.price = std::max(0.01, std::round(u.price * 100.0 + moves[rng_() % 4]) / 100.0);
+    }
+
+    struct Quote {
+      double bid, ask;
+      Greeks greeks;   ///< Options only
+      double underlying;
+    };
+
+    Quote quote(const Instrument& inst) {
+      if (!inst.underConId) return {inst.price - 0.01, inst.price + 0.01, {}, inst.price};
+      const double spot = byConId_.at(inst.underConId)->price;
+      Quote q{};
+      q.underlying = spot;
+      q.greeks = blackScholes(spot, inst.strike, yearsTo(inst.expiry), inst.right != "P");
+      const double mid = std::max(0.01, std::round(q.greeks.price * 100.0) / 100.0);
+      const double half = std::max(0.01, std::round(mid * 0.5) / 100.0);   // 0.5% of the mid, at least a cent
+      q.bid = std::max(0.0, std::round((mid - half) * 100.0) / 100.0);
+      q.ask = std::round((mid + half) * 100.0) / 100.0;
+      return q;
+    }
+
+    int size() { return static_cast<int>(1 + rng_() % 20) * 100; }
+
+    /// Strike grid around the underlying
+    static std::vector<double> strikes(double spot) {
+      const double step = spot >= 200.0 ? 5.0 : spot >= 50.0 ? 2.5 : 1.0;
+      const double atm = std::round(spot / step) * step;
+      std::vector<double> out;
+      for (int i = -20; i <= 20; ++i)
+        if (atm + i * step > 0.0) out.push_back(atm + i * step);
+      return out;
+    }
+
+    /// The next six Friday expiries, YYYYMMDD
+    static std::vector<std::string> expirations() {
+      std::vector<std::string> out;
+      std::time_t t = std::time(nullptr);
+      while (out.size() < 6) {
+        t += 86400;
+        std::tm tm{};
+        gmtime_r(&t, &tm);
+        if (tm.tm_wday != 5) continue;
+        char buf[16];
+        std::strftime(buf, sizeof(buf), "%Y%m%d", &tm);
+        out.emplace_back(buf);
+      }
+      return out;
+    }
+
+  private:
+    long conIdOf(const std::string& key) const { return static_cast<long>(fnv1a(key) % 2000000000ULL) + 1; }
+
+    Instrument& insert(const std::string& key, std::unique_ptr<Instrument> inst) {
+      Instrument& ref = *inst;
+      byConId_[ref.conId] = &ref;
+      byKey_[key] = std::move(inst);
+      return ref;
+    }
+
+    const Settings& settings_;
+    std::mt19937_64 rng_;
+    std::unordered_map<std::string, std::unique_ptr<Instrument>> byKey_;
+    std::unordered_map<long, Instrument*> byConId_;
+  };
+
+  // ------------------------------------------------------------------
+  // Sessions
+  // ------------------------------------------------------------------
+
+  struct Subscription {
+    int reqId = 0;
+    Instrument* instrument = nullptr;
+    bool snapshot = false;
+    Clock::time_point due;
+    uint64_t updates = 0;
+  };
+
+  struct WorkingOrder {
+    long id = 0;
+    Instrument* instrument = nullptr;
+    int side = 0;
+    double quantity = 0.0;
+    bool market = false;
+    double limit = 0.0;
+    long permId = 0;
+  };
+
+  struct Holding {
+    Instrument* instrument = nullptr;
+    double quantity = 0.0;
+    double avgCost = 0.0;
+  };
+
+  class Session {
+  public:
+    Session(int fd, Market& market, const Settings& settings, long& nextPermId)
+        : fd_(fd), market_(market), settings_(settings), nextPermId_(nextPermId) {}
+
+    ~Session() { ::close(fd_); }
+
+    int fd() const noexcept { return fd_; }
+    bool wantsWrite() const noexcept { return !out_.empty(); }
+    bool closed() const noexcept { return closed_; }
+
+    /// Reads what the socket has and handles complete messages
+    void onReadable() {
+      char buf[64 * 1024];
+      for (;;) {
+        const ssize_t n = ::recv(fd_, buf, sizeof(buf), 0);
+        if (n > 0) {
+          in_.append(buf, static_cast<size_t>(n));
+          continue;
+        }
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) closed_ = true;
+        break;
+      }
+      parse();
+    }
+
+    void onWritable() {
+      while (!out_.empty()) {
+        const ssize_t n = ::send(fd_, out_.data(), out_.size(), MSG_NOSIGNAL);
+        if (n > 0) {
+          out_.erase(0, static_cast<size_t>(n));
+          continue;
+        }
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) closed_ = true;
+        break;
+      }
+    }
+
+    /// Sends the updates that are due; returns the next due time
+    Clock::time_point pump(Clock::time_point now) {
+      Clock::time_point next = Clock::time_point::max();
+      if (settings_.rate <= 0.0) {
+        // Unthrottled: round-robin over the subscriptions while the socket keeps up
+        while (!subscriptions_.empty() && out_.size() < UNTHROTTLED_BACKLOG)
+          for (auto it = subscriptions_.begin(); it != subscriptions_.end();)
+            it = update(it->second) ? std::next(it) : subscriptions_.erase(it);
+        return subscriptions_.empty() ? next : now;
+      }
+      const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / settings_.rate));
+      for (auto it = subscriptions_.begin(); it != subscriptions_.end();) {
+        Subscription& s = it->second;
+        bool keep = true;
+        for (int burst = 0; keep && s.due <= now && burst < 1000; ++burst) {
+          s.due += period;
+          keep = update(s);
+        }
+        if (!keep) {
+          it = subscriptions_.erase(it);
+          continue;
+        }
+        if (s.due <= now) s.due = now + period;   // fell behind: skip ahead
+        next = std::min(next, s.due);
+        ++it;
+      }
+      return next;
+    }
+
+  private:
+    enum class State { PREFIX, VERSION, CONNECTED };
+
+    // --- framing -----------------------------------------------------
+
+    void parse() {
+      size_t pos = 0;
+      if (state_ == State::PREFIX) {
+        if (in_.size() < 4) return;
+        if (in_.compare(0, 4, std::string_view("API\0", 4)) != 0) {
+          LOG_WARN("[MockTWS] Client did not send the API prefix");
+          closed_ = true;
+          return;
+        }
+        pos = 4;
+        state_ = State::VERSION;
+      }
+      while (in_.size() - pos >= 4 && !closed_) {
+        const auto* p = reinterpret_cast<const unsigned char*>(in_.data() + pos);
+        const size_t len = (size_t{p[0]} << 24) | (size_t{p[1]} << 16) | (size_t{p[2]} << 8) | size_t{p[3]};
+        if (in_.size() - pos - 4 < len) break;
+        const std::string_view body(in_.data() + pos + 4, len);
+        if (state_ == State::VERSION) handshake(body);
+        else dispatch(body);
+        pos += 4 + len;
+      }
+      in_.erase(0, pos);
+    }
+
+    void send(const Message& m) { appendFramed(out_, m.body()); }
+
+    /// "v100..187" (plus optional connect options) → server version and connection time
+    void handshake(std::string_view body) {
+      int maxVersion = 0;
+      if (body.size() > 1 && body[0] == 'v') {
+        const std::string range(body.substr(1));
+        const auto dots = range.find("..");
+        maxVersion = std::atoi(range.c_str() + (dots == std::string::npos ? 0 : dots + 2));
+      }
+      if (maxVersion < MIN_CLIENT_VERSION) {
+        LOG_WARN("[MockTWS] Unsupported client version range '", std::string(body), "'");
+        closed_ = true;
+        return;
+      }
+      std::tm tm = utcNow();
+      char time[32];
+      std::strftime(time, sizeof(time), "%Y%m%d %H:%M:%S UTC", &tm);
+      std::string reply = std::to_string(SERVER_VERSION);
+      reply.push_back('\0');
+      reply += time;
+      reply.push_back('\0');
+      appendFramed(out_, reply);
+      state_ = State::CONNECTED;
+    }
+
+    // --- requests ----------------------------------------------------
+
+    void dispatch(std::string_view body) {
+      Fields f(body);
+      const int id = static_cast<int>(f.integer());
+      if (settings_.verbose) LOG_DEBUG("[MockTWS] fd ", fd_, " message ", id);
+      switch (id) {
+        case START_API: startApi(f); break;
+        case REQ_MKT_DATA: reqMktData(f); break;
+        case CANCEL_MKT_DATA: f.skip(1); subscriptions_.erase(static_cast<int>(f.integer())); break;
+        case REQ_CONTRACT_DATA: reqContractDetails(f); break;
+        case REQ_SEC_DEF_OPT_PARAMS: reqSecDefOptParams(f); break;
+        case PLACE_ORDER: placeOrder(f); break;
+        case CANCEL_ORDER: f.skip(1); cancelOrder(f.integer()); break;
+        case REQ_GLOBAL_CANCEL:
+          while (!orders_.empty()) cancelOrder(orders_.begin()->first);
+          break;
+        case REQ_IDS: send(Message(NEXT_VALID_ID).add(1).add(nextOrderId_)); break;
+        case REQ_CURRENT_TIME: send(Message(CURRENT_TIME).add(1).add(static_cast<long long>(std::time(nullptr)))); break;
+        case REQ_MARKET_DATA_TYPE: f.skip(1); marketDataType_ = static_cast<int>(f.integer()); break;
+        case REQ_POSITIONS: reqPositions(); break;
+        case REQ_OPEN_ORDERS:
+        case REQ_ALL_OPEN_ORDERS: send(Message(OPEN_ORDER_END).add(1)); break;
+        default:
+          LOG_DEBUG("[MockTWS] Ignoring message ", id);
+          break;
+      }
+    }
+
+    void startApi(Fields& f) {
+      f.skip(1);
+      clientId_ = static_cast<int>(f.integer());
+      LOG_INFO("[MockTWS] Client ", clientId_, " connected (fd ", fd_, ")");
+      send(Message(MANAGED_ACCTS).add(1).add(ACCOUNT));
+      send(Message(NEXT_VALID_ID).add(1).add(nextOrderId_));
+      for (const char* farm : {"Market data farm connection is OK:usfarm", "HMDS data farm connection is OK:ushmds",
+                               "Sec-def data farm connection is OK:secdefnj"})
+        error(-1, farm[0] == 'M' ? 2104 : farm[0] == 'H' ? 2106 : 2158, farm);
+    }
+
+    void error(long id, int code, const std::string& text) { send(Message(ERR_MSG).add(2).add(id).add(code).add(text)); }
+
+    /// version, reqId, contract, [combo legs], [delta neutral], generic ticks, snapshot, options
+    void reqMktData(Fields& f) {
+      f.skip(1);
+      const int reqId = static_cast<int>(f.integer());
+      const ContractSpec c = ContractSpec::read(f);
+      if (c.secType == "BAG") f.skip(static_cast<size_t>(f.integer()) * 4);
+      if (f.integer() == 1) f.skip(3);   // delta neutral contract
+      f.str();                             // generic tick list
+      const bool snapshot = f.integer() == 1;
+
+      if (c.symbol.empty() && !market_.find(c.conId)) {
+        error(reqId, 200, "No security definition has been found for the request");
+        return;
+      }
+      Subscription s;
+      s.reqId = reqId;
+      s.instrument = &market_.resolve(c);
+      s.snapshot = snapshot;
+      s.due = Clock::now();
+      if (marketDataType_ != 1) send(Message(MARKET_DATA_TYPE).add(1).add(reqId).add(marketDataType_));
+      subscriptions_[reqId] = s;
+    }
+
+    /// One quote update of a subscription; false once a snapshot is complete
+    bool update(Subscription& s) {
+      Instrument& inst = *s.instrument;
+      market_.step(inst);
+      const auto q = market_.quote(inst);
+      const int reqId = s.reqId;
+      const int priceOffset = marketDataType_ >= 3 ? 65 : 0;   // delayed tick types: 66 bid, 67 ask, 68 last
+      tickPrice(reqId, BID_FIELD + priceOffset, q.bid, market_.size());
+      tickPrice(reqId, ASK_FIELD + priceOffset, q.ask, market_.size());
+      if (s.updates % 4 == 0) {
+        const int size = market_.size();
+        inst.volume += size;
+        tickPrice(reqId, priceOffset ? 68 : LAST_FIELD, (q.bid + q.ask) / 2.0, size);
+        send(Message(TICK_SIZE).add(6).add(reqId).add(priceOffset ? 74 : VOLUME_FIELD).add(inst.volume));
+      }
+      if (inst.underConId) {
+        const auto& g = q.greeks;
+        send(Message(TICK_OPTION_COMPUTATION).add(6).add(reqId).add(MODEL_OPTION_FIELD).add(0.25).add(g.delta)
+                 .add(g.price).add(0.0).add(g.gamma).add(g.vega).add(g.theta).add(q.underlying));
+      }
+      ++s.updates;
+      matchOrders(inst, q.bid, q.ask);
+      if (!s.snapshot) return true;
+      send(Message(TICK_SNAPSHOT_END).add(1).add(reqId));
+      return false;
+    }
+
+    void tickPrice(int reqId, int field, double price, int size) {
+      send(Message(TICK_PRICE).add(6).add(reqId).add(field).add(price).add(size).add(0));
+    }
+
+    /// version, reqId, contract, includeExpired, secIdType, secId
+    void reqContractDetails(Fields& f) {
+      f.skip(1);
+      const int reqId = static_cast<int>(f.integer());
+      ContractSpec c = ContractSpec::read(f);
+      if (c.symbol.empty() && !market_.find(c.conId)) {
+        error(reqId, 200, "No security definition has been found for the request");
+        return;
+      }
+      if (c.symbol.empty()) {
+        const Instrument* known = market_.find(c.conId);
+        c.symbol = known->symbol;
+        c.secType = known->secType;
+        c.expiry = known->expiry;
+        c.strike = known->strike;
+        c.right = known->right;
+      }
+      if (c.secType == "OPT" && (c.expiry.size() < 8 || c.strike <= 0.0 || c.right.empty())) {
+        // Chain query: every listed contract matching the given fields
+        const double spot = market_.stock(c.symbol).price;
+        for (const auto& expiry : Market::expirations()) {
+          if (!c.expiry.empty() && expiry.compare(0, c.expiry.size(), c.expiry) != 0) continue;
+          for (double strike : Market::strikes(spot)) {
+            if (c.strike > 0.0 && std::abs(strike - c.strike) > 1e-9) continue;
+            for (const char* right : {"C", "P"})
+              if (c.right.empty() || c.right == right) contractData(reqId, market_.option(c.symbol, expiry, strike, right));
+          }
+        }
+      } else {
+        contractData(reqId, market_.resolve(c));
+      }
+      send(Message(CONTRACT_DATA_END).add(1).add(reqId));
+    }
+
+    /// Contract details message, version 8 layout
+    void contractData(int reqId, const Instrument& i) {
+      const bool option = i.secType == "OPT";
+      std::string localSymbol = i.symbol;
+      if (option) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%-6s%s%s%08ld", i.symbol.c_str(), i.expiry.substr(2).c_str(), i.right.c_str(),
+                      std::lround(i.strike * 1000.0));
+        localSymbol = buf;
+      }
+      Message m(CONTRACT_DATA);
+      m.add(8).add(reqId).add(i.symbol).add(i.secType).add(i.expiry).add(i.strike).add(i.right)
+          .add("SMART").add("USD").add(localSymbol).add(i.symbol).add(i.symbol).add(i.conId).add(0.01)
+          .add(option ? "100" : "").add("LMT,MKT,STP").add(option ? "SMART,CBOE,AMEX,ISE" : "SMART,NASDAQ,NYSE,ARCA")
+          .add(1).add(i.underConId).add(i.symbol).add(option ? "" : "NASDAQ")
+          .add(option ? i.expiry.substr(0, 6) : "").add("").add("").add("").add("US/Eastern")
+          .add("").add("").add("").add(0.0).add(0);
+      send(m);
+    }
+
+    /// reqId, underlyingSymbol, futFopExchange, underlyingSecType, underlyingConId
+    void reqSecDefOptParams(Fields& f) {
+      const int reqId = static_cast<int>(f.integer());
+      const std::string symbol = f.str();
+      f.skip(2);
+      const long conId = f.integer();
+      const Instrument* u = market_.find(conId);
+      const Instrument& under = u ? *u : market_.stock(symbol);
+      const auto expirations = Market::expirations();
+      const auto strikes = Market::strikes(under.price);
+      Message m(SECURITY_DEFINITION_OPTION_PARAMETER);
+      m.add(reqId).add("SMART").add(under.conId).add(under.symbol).add("100").add(static_cast<int>(expirations.size()));
+      for (const auto& e : expirations) m.add(e);
+      m.add(static_cast<int>(strikes.size()));
+      for (double s : strikes) m.add(s);
+      send(m);
+      send(Message(SECURITY_DEFINITION_OPTION_PARAMETER_END).add(reqId));
+    }
+
+    // --- orders ------------------------------------------------------
+
+    /// version, orderId, contract, secIdType, secId, action, totalQuantity, orderType, lmtPrice, auxPrice, ...
+    void placeOrder(Fields& f) {
+      f.skip(1);
+      const long orderId = f.integer();
+      ContractSpec c = ContractSpec::read(f);
+      f.skip(2);
+      const std::string action = f.str();
+      const double quantity = f.number();
+      const std::string type = f.str();
+      const double limit = f.number();
+
+      if (orderId >= nextOrderId_) nextOrderId_ = orderId + 1;
+      if (type != "MKT" && type != "LMT") {
+        error(orderId, 201, "Order rejected - reason:mock TWS supports MKT and LMT orders only");
+        return;
+      }
+      if (c.secType == "BAG" || (c.symbol.empty() && !market_.find(c.conId))) {
+        error(orderId, 201, "Order rejected - reason:mock TWS cannot price this contract");
+        return;
+      }
+      WorkingOrder& o = orders_[orderId];
+      if (o.permId == 0) o.permId = nextPermId_++;
+      o.id = orderId;
+      o.instrument = &market_.resolve(c);
+      o.side = action == "BUY" ? 1 : -1;
+      o.quantity = quantity;
+      o.market = type == "MKT";
+      o.limit = limit;
+      orderStatus(o, "Submitted", 0.0, 0.0);
+      const auto q = market_.quote(*o.instrument);
+      matchOrders(*o.instrument, q.bid, q.ask);
+    }
+
+    void cancelOrder(long orderId) {
+      auto it = orders_.find(orderId);
+      if (it == orders_.end()) {
+        error(orderId, 10147, "OrderId " + std::to_string(orderId) + " that needs to be cancelled is not found.");
+        return;
+      }
+      orderStatus(it->second, "Cancelled", 0.0, 0.0);
+      orders_.erase(it);
+    }
+
+    /// Fills the working orders on `inst` that the touch reaches
+    void matchOrders(Instrument& inst, double bid, double ask) {
+      for (auto it = orders_.begin(); it != orders_.end();) {
+        WorkingOrder& o = it->second;
+        const double touch = o.side > 0 ? ask : bid;
+        if (o.instrument != &inst || touch <= 0.0 || (!o.market && (o.side > 0 ? touch > o.limit : touch < o.limit))) {
+          ++it;
+          continue;
+        }
+        Holding& h = holdings_[inst.conId];
+        h.instrument = &inst;
+        const double qty = o.side * o.quantity;
+        const double cost = touch * inst.multiplier;
+        if (h.quantity == 0.0 || (h.quantity > 0) == (qty > 0))
+          h.avgCost = (h.avgCost * std::abs(h.quantity) + cost * o.quantity) / (std::abs(h.quantity) + o.quantity);
+        else if (std::abs(qty) > std::abs(h.quantity))
+          h.avgCost = cost;
+        h.quantity += qty;
+        if (h.quantity == 0.0) h.avgCost = 0.0;
+        orderStatus(o, "Filled", o.quantity, touch);
+        it = orders_.erase(it);
+      }
+    }
+
+    /// version, orderId, status, filled, remaining, avgFillPrice, permId, parentId, lastFillPrice, clientId, whyHeld
+    void orderStatus(const WorkingOrder& o, const char* status, double filled, double price) {
+      send(Message(ORDER_STATUS).add(6).add(o.id).add(status).add(filled).add(o.quantity - filled).add(price)
+               .add(o.permId).add(0).add(price).add(clientId_).add(""));
+    }
+
+    /// version 3: account, contract, position, avgCost
+    void reqPositions() {
+      for (const auto& [conId, h] : holdings_) {
+        const Instrument& i = *h.instrument;
+        send(Message(POSITION_DATA).add(3).add(ACCOUNT).add(i.conId).add(i.symbol).add(i.secType).add(i.expiry)
+                 .add(i.strike).add(i.right).add(i.underConId ? "100" : "").add("SMART").add("USD").add(i.symbol)
+                 .add(i.symbol).add(h.quantity).add(h.avgCost));
+      }
+      send(Message(POSITION_END).add(1));
+    }
+
+    int fd_;
+    Market& market_;
+    const Settings& settings_;
+    long& nextPermId_;
+    State state_ = State::PREFIX;
+    bool closed_ = false;
+    std::string in_, out_;
+    int clientId_ = 0;
+    int marketDataType_ = 1;
+    long nextOrderId_ = 1;
+    std::map<int, Subscription> subscriptions_;
+    std::map<long, WorkingOrder> orders_;
+    std::map<long, Holding> holdings_;
+  };
+
+  // ------------------------------------------------------------------
+  // Server
+  // ------------------------------------------------------------------
+
+  volatile std::sig_atomic_t stopRequested = 0;
+
+  int listenOn(int port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    const int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, 16) < 0) {
+      ::close(fd);
+      return -1;
+    }
+    ::fcntl(fd, F_SETFL, O_NONBLOCK);
+    return fd;
+  }
+
+  int serve(const Settings& settings) {
+    const int listener = listenOn(settings.port);
+    if (listener < 0) {
+      LOG_ERROR("[MockTWS] Cannot listen on 127.0.0.1:", settings.port, ": ", std::strerror(errno));
+      return 1;
+    }
+    LOG_INFO("[MockTWS] Listening on 127.0.0.1:", settings.port, " (server version ", SERVER_VERSION, ", ",
+             settings.rate > 0.0 ? std::to_string(settings.rate) + " updates/s" : std::string("unthrottled"),
+             " per subscription)");
+
+    Market market(settings);
+    long nextPermId = 1'000'000;
+    std::vector<std::unique_ptr<Session>> sessions;
+    std::vector<pollfd> fds;
+
+    while (!stopRequested) {
+      const auto now = Clock::now();
+      Clock::time_point next = Clock::time_point::max();
+      for (auto& s : sessions) {
+        next = std::min(next, s->pump(now));
+        s->onWritable();
+      }
+
+      fds.assign(1, pollfd{listener, POLLIN, 0});
+      for (auto& s : sessions)
+        fds.push_back(pollfd{s->fd(), static_cast<short>(POLLIN | (s->wantsWrite() ? POLLOUT : 0)), 0});
+      int timeoutMs = 200;
+      if (next != Clock::time_point::max())
+        timeoutMs = static_cast<int>(std::clamp<int64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(next - Clock::now()).count(), 0, 200));
+      if (::poll(fds.data(), fds.size(), timeoutMs) < 0 && errno != EINTR) break;
+
+      if (fds[0].revents & POLLIN) {
+        for (int fd; (fd = ::accept(listener, nullptr, nullptr)) >= 0;) {
+          ::fcntl(fd, F_SETFL, O_NONBLOCK);
+          const int one = 1;
+          ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+          sessions.push_back(std::make_unique<Session>(fd, market, settings, nextPermId));
+        }
+      }
+      for (size_t i = 1; i < fds.size(); ++i) {
+        Session& s = *sessions[i - 1];
+        if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) s.onReadable();
+        if (fds[i].revents & POLLOUT) s.onWritable();
+      }
+      std::erase_if(sessions, [](const auto& s) {
+        if (s->closed()) LOG_INFO("[MockTWS] Client on fd ", s->fd(), " disconnected");
+        return s->closed();
+      });
+    }
+    ::close(listener);
+    return 0;
+  }
+
+  void usage() {
+    std::fprintf(stderr,
+                 "usage: mock_tws [--port 7497] [--rate 10] [--symbol SYM=price ...] [--seed 1] [--verbose]\n"
+                 "  --rate 0 streams as fast as the client reads\n");
+  }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Settings settings;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (arg == "--port" && hasValue) settings.port = std::atoi(argv[++i]);
+    else if (arg == "--rate" && hasValue) settings.rate = std::atof(argv[++i]);
+    else if (arg == "--seed" && hasValue) settings.seed = std::strtoull(argv[++i], nullptr, 10);
+    else if (arg == "--verbose") settings.verbose = true;
+    else if (arg == "--symbol" && hasValue) {
+      const std::string spec = argv[++i];
+      const auto eq = spec.find('=');
+      if (eq == std::string::npos) {
+        usage();
+        return 2;
+      }
+      settings.prices[spec.substr(0, eq)] = std::atof(spec.c_str() + eq + 1);
+    } else {
+      usage();
+      return 2;
+    }
+  }
+  if (!settings.verbose) Logger::setLevel(Logger::Level::INFO);
+  std::signal(SIGINT, [](int) { stopRequested = 1; });
+  std::signal(SIGTERM, [](int) { stopRequested = 1; });
+  return serve(settings);
+}